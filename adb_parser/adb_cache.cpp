@@ -0,0 +1,521 @@
+/*
+ * Copyright (c) 2021 NVIDIA CORPORATION & AFFILIATES. ALL RIGHTS RESERVED.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *  Version: $Id$
+ */
+/*************************** AdbCache ***************************/
+
+#include "adb_cache.h"
+#include "adb_parser.h"
+#include <algorithm>
+
+#if !defined(__WIN__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <common/tools_cache_dir.h>
+#define ADB_CACHE_SUPPORTED
+#endif
+
+#define ADB_CACHE_MAGIC 0x43424441 /* ADBC */
+#define ADB_CACHE_VERSION 1
+#define ADB_CACHE_SUFFIX ".adbc"
+#define ADB_CACHE_DISABLE_ENV "ADB_NO_BINARY_CACHE"
+
+#define FNV64_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FNV64_PRIME 0x100000001b3ULL
+
+#ifdef ADB_CACHE_SUPPORTED
+namespace
+{
+/*
+ * The cache is a sequence of little endian integers and length prefixed strings:
+ *   header:  magic, version, key, source count, then per source: path, size, FNV-1a hash
+ *   model:   Adb members, configs, nodes with their fields
+ */
+class CacheWriter
+{
+public:
+    void u8(u_int8_t v) { buf.push_back((char)v); }
+    void u32(u_int32_t v)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            buf.push_back((char)(v >> (8 * i)));
+        }
+    }
+    void u64(u_int64_t v)
+    {
+        u32((u_int32_t)v);
+        u32((u_int32_t)(v >> 32));
+    }
+    void str(const string& s)
+    {
+        u32((u_int32_t)s.size());
+        buf.append(s);
+    }
+    void attrs(const AttrsMap& m)
+    {
+        u32((u_int32_t)m.size());
+        for (AttrsMap::const_iterator it = m.begin(); it != m.end(); it++)
+        {
+            str(it->first);
+            str(it->second);
+        }
+    }
+
+    string buf;
+};
+
+class CacheReader
+{
+public:
+    CacheReader(const u_int8_t* data, size_t size) : ok(true), p(data), end(data + size) {}
+
+    u_int8_t u8() { return check(1) ? *p++ : 0; }
+    u_int32_t u32()
+    {
+        u_int32_t v = 0;
+        if (check(4))
+        {
+            v = p[0] | (p[1] << 8) | (p[2] << 16) | ((u_int32_t)p[3] << 24);
+            p += 4;
+        }
+        return v;
+    }
+    u_int64_t u64()
+    {
+        u_int64_t lo = u32();
+        return lo | ((u_int64_t)u32() << 32);
+    }
+    string str()
+    {
+        u_int32_t len = u32();
+        if (!check(len))
+        {
+            return string();
+        }
+        p += len;
+        return string((const char*)p - len, len);
+    }
+    void attrs(AttrsMap& m)
+    {
+        u_int32_t count = u32();
+        for (u_int32_t i = 0; i < count && ok; i++)
+        {
+            string key = str();
+            m.emplace_hint(m.end(), key, str());
+        }
+    }
+    // A count of items taking at least min_size bytes each, 0 if it can't fit in what is left
+    u_int32_t count(size_t min_size)
+    {
+        u_int32_t n = u32();
+        return check((size_t)n * min_size) ? n : 0;
+    }
+
+    bool ok;
+
+private:
+    bool check(size_t len)
+    {
+        if (!ok || (size_t)(end - p) < len)
+        {
+            ok = false;
+        }
+        return ok;
+    }
+
+    const u_int8_t* p;
+    const u_int8_t* end;
+};
+
+// Map a whole file read only, NULL on failure or if it is empty
+const u_int8_t* mapFile(const string& path, size_t& size, struct stat* st = nullptr)
+{
+    struct stat tmp;
+    struct stat* pst = st ? st : &tmp;
+    int fd = open(path.c_str(), O_RDONLY);
+    void* data;
+
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+    if (fstat(fd, pst) || !S_ISREG(pst->st_mode) || pst->st_size == 0)
+    {
+        close(fd);
+        return nullptr;
+    }
+    size = pst->st_size;
+    data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    return data == MAP_FAILED ? nullptr : (const u_int8_t*)data;
+}
+
+bool hashFile(const string& path, u_int64_t& size, u_int64_t& hash)
+{
+    size_t len = 0;
+    const u_int8_t* data = mapFile(path, len);
+
+    if (!data)
+    {
+        return false;
+    }
+    hash = FNV64_OFFSET_BASIS;
+    for (size_t i = 0; i < len; i++)
+    {
+        hash = (hash ^ data[i]) * FNV64_PRIME;
+    }
+    size = len;
+    munmap((void*)data, len);
+    return true;
+}
+
+void writeField(CacheWriter& w, AdbField* field)
+{
+    w.str(field->name);
+    w.u32(field->size);
+    w.u32(field->offset);
+    w.str(field->desc);
+    w.u32(field->lowBound);
+    w.u32(field->highBound);
+    w.u8((u_int8_t)field->array_type);
+    w.str(field->subNode);
+    w.attrs(field->attrs);
+    w.u8(field->isReserved);
+    w.str(field->condition);
+}
+
+void readFields(CacheReader& r, FieldsList& fields)
+{
+    u_int32_t count = r.count(1);
+    fields.reserve(count);
+    for (u_int32_t i = 0; i < count && r.ok; i++)
+    {
+        AdbField* field = new AdbField;
+        fields.push_back(field);
+        field->name = r.str();
+        field->size = r.u32();
+        field->offset = r.u32();
+        field->desc = r.str();
+        field->lowBound = r.u32();
+        field->highBound = r.u32();
+        field->array_type = (AdbField::ArrayType)r.u8();
+        field->subNode = r.str();
+        r.attrs(field->attrs);
+        field->isReserved = r.u8();
+        field->condition = r.str();
+    }
+}
+
+void clearModel(Adb* adb)
+{
+    for (size_t i = 0; i < adb->configs.size(); i++)
+    {
+        delete adb->configs[i];
+    }
+    adb->configs.clear();
+    for (NodesMap::iterator it = adb->nodesMap.begin(); it != adb->nodesMap.end(); it++)
+    {
+        delete it->second;
+    }
+    adb->nodesMap.clear();
+    adb->instAttrs.clear();
+    adb->includePaths.clear();
+    adb->defines_map.clear();
+    adb->includedFiles.clear();
+    adb->warnings.clear();
+}
+
+// The files the model was parsed from: the main file and everything it included
+vector<string> sourceFiles(Adb* adb, const string& fname)
+{
+    vector<string> sources(1, fname);
+    for (IncludeFileMap::iterator it = adb->includedFiles.begin(); it != adb->includedFiles.end(); it++)
+    {
+        if (find(sources.begin(), sources.end(), it->second.fullPath) == sources.end())
+        {
+            sources.push_back(it->second.fullPath);
+        }
+    }
+    return sources;
+}
+} // namespace
+#endif
+
+/**
+ * Function: AdbCache::isEnabled
+ **/
+bool AdbCache::isEnabled()
+{
+#ifdef ADB_CACHE_SUPPORTED
+    return getenv(ADB_CACHE_DISABLE_ENV) == NULL;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Function: AdbCache::cachePath
+ **/
+string AdbCache::cachePath(const string& fname)
+{
+#ifdef ADB_CACHE_SUPPORTED
+    char path[PATH_MAX];
+    if (!tools_cache_file(fname.c_str(), ADB_CACHE_SUFFIX, path, sizeof(path)))
+    {
+        return path;
+    }
+#endif
+    return string();
+}
+
+/**
+ * Function: AdbCache::load
+ **/
+bool AdbCache::load(Adb* adb, const string& fname, const string& key)
+{
+#ifdef ADB_CACHE_SUPPORTED
+    struct stat st;
+    size_t size = 0;
+    const u_int8_t* data = mapFile(cachePath(fname), size, &st);
+
+    if (!data)
+    {
+        return false;
+    }
+    // The cache decides what the layouts look like, don't take one anybody else could have written
+    if ((st.st_uid != 0 && st.st_uid != geteuid()) || (st.st_mode & (S_IWGRP | S_IWOTH)))
+    {
+        munmap((void*)data, size);
+        return false;
+    }
+
+    CacheReader r(data, size);
+    if (r.u32() != ADB_CACHE_MAGIC || r.u32() != ADB_CACHE_VERSION || r.str() != key)
+    {
+        munmap((void*)data, size);
+        return false;
+    }
+    u_int32_t sourceCount = r.count(16);
+    for (u_int32_t i = 0; i < sourceCount && r.ok; i++)
+    {
+        string path = r.str();
+        u_int64_t srcSize = r.u64();
+        u_int64_t srcHash = r.u64();
+        u_int64_t curSize = 0, curHash = 0;
+        if (!r.ok || !hashFile(path, curSize, curHash) || curSize != srcSize || curHash != srcHash)
+        {
+            munmap((void*)data, size);
+            return false;
+        }
+    }
+
+    clearModel(adb);
+    adb->version = r.str();
+    adb->rootNode = r.str();
+    adb->bigEndianArr = r.u8();
+    adb->singleEntryArrSupp = r.u8();
+    adb->srcDocName = r.str();
+    adb->srcDocVer = r.str();
+    u_int32_t count = r.count(4);
+    for (u_int32_t i = 0; i < count && r.ok; i++)
+    {
+        adb->includePaths.push_back(r.str());
+    }
+    r.attrs(adb->defines_map);
+    count = r.count(12);
+    for (u_int32_t i = 0; i < count && r.ok; i++)
+    {
+        string name = r.str();
+        IncludeFileInfo& info = adb->includedFiles[name];
+        info.fullPath = r.str();
+        info.includedFromFile = r.str();
+        info.includedFromLine = (int)r.u32();
+    }
+    count = r.count(4);
+    for (u_int32_t i = 0; i < count && r.ok; i++)
+    {
+        adb->warnings.push_back(r.str());
+    }
+    count = r.count(8);
+    for (u_int32_t i = 0; i < count && r.ok; i++)
+    {
+        string path = r.str();
+        r.attrs(adb->instAttrs.emplace_hint(adb->instAttrs.end(), path, AttrsMap())->second);
+    }
+    count = r.count(8);
+    for (u_int32_t i = 0; i < count && r.ok; i++)
+    {
+        AdbConfig* config = new AdbConfig;
+        adb->configs.push_back(config);
+        r.attrs(config->attrs);
+        r.attrs(config->enums);
+    }
+    count = r.count(1);
+    for (u_int32_t i = 0; i < count && r.ok; i++)
+    {
+        AdbNode* node = new AdbNode;
+        string nodeKey = r.str();
+        adb->nodesMap.emplace_hint(adb->nodesMap.end(), nodeKey, node);
+        node->name = r.str();
+        node->size = r.u32();
+        node->_maxLeafSize = r.u32();
+        node->isUnion = r.u8();
+        node->desc = r.str();
+        r.attrs(node->attrs);
+        node->fileName = r.str();
+        node->lineNumber = (int)r.u32();
+        readFields(r, node->fields);
+        readFields(r, node->condFields);
+    }
+    munmap((void*)data, size);
+
+    if (!r.ok || adb->nodesMap.size() != count)
+    {
+        clearModel(adb);
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Function: AdbCache::save
+ **/
+void AdbCache::save(Adb* adb, const string& fname, const string& key)
+{
+#ifdef ADB_CACHE_SUPPORTED
+    CacheWriter w;
+    vector<string> sources = sourceFiles(adb, fname);
+
+    w.u32(ADB_CACHE_MAGIC);
+    w.u32(ADB_CACHE_VERSION);
+    w.str(key);
+    w.u32((u_int32_t)sources.size());
+    for (size_t i = 0; i < sources.size(); i++)
+    {
+        u_int64_t srcSize = 0, srcHash = 0;
+        if (!hashFile(sources[i], srcSize, srcHash))
+        {
+            return;
+        }
+        w.str(sources[i]);
+        w.u64(srcSize);
+        w.u64(srcHash);
+    }
+
+    w.str(adb->version);
+    w.str(adb->rootNode);
+    w.u8(adb->bigEndianArr);
+    w.u8(adb->singleEntryArrSupp);
+    w.str(adb->srcDocName);
+    w.str(adb->srcDocVer);
+    w.u32((u_int32_t)adb->includePaths.size());
+    for (size_t i = 0; i < adb->includePaths.size(); i++)
+    {
+        w.str(adb->includePaths[i]);
+    }
+    w.attrs(adb->defines_map);
+    w.u32((u_int32_t)adb->includedFiles.size());
+    for (IncludeFileMap::iterator it = adb->includedFiles.begin(); it != adb->includedFiles.end(); it++)
+    {
+        w.str(it->first);
+        w.str(it->second.fullPath);
+        w.str(it->second.includedFromFile);
+        w.u32((u_int32_t)it->second.includedFromLine);
+    }
+    w.u32((u_int32_t)adb->warnings.size());
+    for (size_t i = 0; i < adb->warnings.size(); i++)
+    {
+        w.str(adb->warnings[i]);
+    }
+    w.u32((u_int32_t)adb->instAttrs.size());
+    for (InstanceAttrs::iterator it = adb->instAttrs.begin(); it != adb->instAttrs.end(); it++)
+    {
+        w.str(it->first);
+        w.attrs(it->second);
+    }
+    w.u32((u_int32_t)adb->configs.size());
+    for (size_t i = 0; i < adb->configs.size(); i++)
+    {
+        w.attrs(adb->configs[i]->attrs);
+        w.attrs(adb->configs[i]->enums);
+    }
+    w.u32((u_int32_t)adb->nodesMap.size());
+    for (NodesMap::iterator it = adb->nodesMap.begin(); it != adb->nodesMap.end(); it++)
+    {
+        AdbNode* node = it->second;
+        w.str(it->first);
+        w.str(node->name);
+        w.u32(node->size);
+        w.u32(node->_maxLeafSize);
+        w.u8(node->isUnion);
+        w.str(node->desc);
+        w.attrs(node->attrs);
+        w.str(node->fileName);
+        w.u32((u_int32_t)node->lineNumber);
+        w.u32((u_int32_t)node->fields.size());
+        for (size_t i = 0; i < node->fields.size(); i++)
+        {
+            writeField(w, node->fields[i]);
+        }
+        w.u32((u_int32_t)node->condFields.size());
+        for (size_t i = 0; i < node->condFields.size(); i++)
+        {
+            writeField(w, node->condFields[i]);
+        }
+    }
+
+    // Write to a temporary name and rename, so concurrent loads never see a partial cache
+    string path = cachePath(fname);
+    if (path.empty())
+    {
+        return;
+    }
+    string tmpPath = path + "." + to_string(getpid());
+    int fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (fd < 0)
+    {
+        return;
+    }
+    bool ok = write(fd, w.buf.data(), w.buf.size()) == (ssize_t)w.buf.size();
+    ok = (close(fd) == 0) && ok;
+    if (!ok || rename(tmpPath.c_str(), path.c_str()))
+    {
+        unlink(tmpPath.c_str());
+    }
+#endif
+}
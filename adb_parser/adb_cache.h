@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2021 NVIDIA CORPORATION & AFFILIATES. ALL RIGHTS RESERVED.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *  Version: $Id$
+ */
+/*************************** AdbCache ***************************/
+
+#ifndef ADB_CACHE_H
+#define ADB_CACHE_H
+
+#include <string>
+
+using namespace std;
+
+class Adb;
+
+/*
+ * Binary form of a loaded Adb model (nodes, fields, configs and enums, include and instance info), written
+ * to the per-user cache directory on the first load and read back with mmap on later loads, the ADB files
+ * themselves are only read. A cache is used only for the same load parameters (key) and while every source
+ * file keeps the size and content hash recorded in it.
+ */
+class AdbCache
+{
+public:
+    static bool isEnabled();
+    // Empty when there is no cache directory to use
+    static string cachePath(const string& fname);
+
+    // Fill adb from the cache of fname, false if there is no valid one (adb is left empty then)
+    static bool load(Adb* adb, const string& fname, const string& key);
+
+    // Best effort, a failure to write the cache is ignored
+    static void save(Adb* adb, const string& fname, const string& key);
+};
+
+#endif
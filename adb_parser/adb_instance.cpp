@@ -37,6 +37,7 @@
  **/
 
 #include "adb_instance.h"
+#include "adb_parser.h"
 #include "adb_node.h"
 #include "adb_field.h"
 #include "adb_expr.h"
@@ -633,6 +634,7 @@ AdbInstance* AdbInstance::getChildByPath(const string& path, bool isCaseSensitiv
 
     // Search for childName
     AdbInstance* child = NULL;
+    instantiateSubItems();
     for (size_t i = 0; i < subItems.size(); i++)
     {
         string subName = isCaseSensitive ? subItems[i]->layout_item_name :
@@ -677,6 +679,7 @@ vector<AdbInstance*> AdbInstance::findChild(const string& childName, bool isCase
     }
 
     // do that recursively for all child items
+    instantiateSubItems();
     for (size_t i = 0; i < subItems.size(); i++)
     {
         vector<AdbInstance*> l = subItems[i]->findChild(effName, true);
@@ -1038,6 +1041,7 @@ AdbInstance* AdbInstance::getUnionSelectedNodeName(const u_int64_t& selectorVal)
         {
             const string& selectorEnum = it->first;
             // search for the sub instance with the "selected_by" attribute == selectorEnum
+            instantiateSubItems();
             for (size_t i = 0; i < subItems.size(); i++)
             {
                 if (getInstanceAttr("selected_by", sel_by) && sel_by == selectorEnum)
@@ -1071,6 +1075,7 @@ AdbInstance* AdbInstance::getUnionSelectedNodeName(const string& selectorEnum)
     }
 
     string sel_by;
+    instantiateSubItems();
     for (auto subItem : subItems)
     {
         if (subItem->getInstanceAttr("selected_by", sel_by) && sel_by == selectorEnum)
@@ -1151,6 +1156,7 @@ vector<AdbInstance*> AdbInstance::getLeafFields(bool extendenName)
 {
     vector<AdbInstance*> fields;
 
+    instantiateSubItems();
     for (size_t i = 0; i < subItems.size(); i++)
     {
         if (subItems[i]->isNode())
@@ -1180,6 +1186,17 @@ vector<AdbInstance*> AdbInstance::getLeafFields(bool extendenName)
     return fields;
 }
 
+/**
+ * Function: AdbInstance::instantiateSubItems
+ **/
+void AdbInstance::instantiateSubItems()
+{
+    if (lazyAdb)
+    {
+        lazyAdb->createSubInstances(this);
+    }
+}
+
 /**
  * Function: AdbInstance::pushBuf
  **/
@@ -1207,6 +1224,7 @@ void AdbInstance::print(int indent)
 
     if (isNode())
     {
+        instantiateSubItems();
         for (size_t i = 0; i < subItems.size(); i++)
             subItems[i]->print(indent + 1);
     }
@@ -49,6 +49,7 @@ using namespace std;
 using namespace xmlCreator;
 
 typedef map<string, string> AttrsMap;
+class Adb;
 class AdbField;
 class AdbNode;
 struct PartitionTree;
@@ -214,6 +215,7 @@ public:
     void pushBuf(u_int8_t* buf, u_int64_t value);
     u_int64_t popBuf(u_int8_t* buf);
     void initInstOps(bool is_root = false);
+    void instantiateSubItems(); // For lazy layouts, no-op once done
     // FOR DEBUG
     void print(int indent = 0);
 
@@ -237,6 +239,7 @@ public:
     u_int32_t maxLeafSize{0};     // in bits for DS alignment check
     InstancePropertiesMask inst_props{};
     PartitionTree* partition_tree{nullptr};
+    Adb* lazyAdb{nullptr}; // Set while the sub items of a lazy layout node are yet to be instantiated
 };
 
 #endif
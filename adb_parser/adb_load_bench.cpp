@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2021 NVIDIA CORPORATION & AFFILIATES. ALL RIGHTS RESERVED.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *  Version: $Id$
+ */
+
+/*
+ * Startup cost of an mlxreg style ADB load: parsing the XML vs reading the binary cache, each followed by
+ * the layout of the register access selector and the lookup of one register, with a full or a lazy layout.
+ *
+ * Usage: adb_load_bench [-i iterations] [-r root_node] [-g register] <file>.adb
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <common/tools_bench.h>
+#include "adb_parser.h"
+#include "adb_cache.h"
+
+static int bench_load(const char* fname, const string& root, const string& reg, bool use_cache, bool lazy, int iterations)
+{
+    double load_time = 0;
+    double layout_time = 0;
+    double lookup_time = 0;
+    size_t fields = 0;
+
+    if (use_cache)
+    {
+        unsetenv("ADB_NO_BINARY_CACHE");
+    }
+    else
+    {
+        setenv("ADB_NO_BINARY_CACHE", "1", 1);
+    }
+    for (int i = 0; i < iterations; i++)
+    {
+        Adb adb;
+        double start = bench_now_secs();
+        if (!adb.load(fname, false, false, false))
+        {
+            fprintf(stderr, "-E- Failed to load %s: %s\n", fname, adb.getLastError().c_str());
+            return 1;
+        }
+        double loaded = bench_now_secs();
+        AdbInstance* layout = adb.createLayout(root, false, -1, false, false, false, 0, "", nullptr, lazy);
+        if (!layout)
+        {
+            fprintf(stderr, "-E- Failed to create the layout of %s: %s\n", root.c_str(), adb.getLastError().c_str());
+            return 1;
+        }
+        double laid_out = bench_now_secs();
+        try
+        {
+            AdbInstance* regs = layout->getChildByPath("access_reg_summary");
+            fields = regs ? regs->getUnionSelectedNodeName(reg)->getLeafFields(true).size() : 0;
+        }
+        catch (AdbException& exp)
+        {
+            fprintf(stderr, "-E- Failed to look up %s: %s\n", reg.c_str(), exp.what());
+            delete layout;
+            return 1;
+        }
+        lookup_time += bench_now_secs() - laid_out;
+        layout_time += laid_out - loaded;
+        load_time += loaded - start;
+        delete layout;
+    }
+    printf("%-6s %-6s %10.1f usecs per load, %10.1f per layout, %8.1f per lookup, %zu fields\n",
+           use_cache ? "cache" : "xml", lazy ? "lazy" : "full", load_time * 1e6 / iterations,
+           layout_time * 1e6 / iterations, lookup_time * 1e6 / iterations, fields);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    string root = "access_reg_summary_selector_ext";
+    string reg = "PPCNT";
+    int iterations = 10;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "i:r:g:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'i':
+                iterations = atoi(optarg);
+                break;
+            case 'r':
+                root = optarg;
+                break;
+            case 'g':
+                reg = optarg;
+                break;
+            default:
+                return bench_usage(argv[0], "[-i iterations] [-r root_node] [-g register] <file>.adb");
+        }
+    }
+    if (optind >= argc || iterations <= 0)
+    {
+        return bench_usage(argv[0], "[-i iterations] [-r root_node] [-g register] <file>.adb");
+    }
+
+    // The first cached load writes the cache when it is missing or stale
+    Adb adb;
+    if (!adb.load(argv[optind], false, false, false))
+    {
+        fprintf(stderr, "-E- Failed to load %s: %s\n", argv[optind], adb.getLastError().c_str());
+        return 1;
+    }
+    if (access(AdbCache::cachePath(argv[optind]).c_str(), R_OK))
+    {
+        fprintf(stderr, "-W- No cache could be written for %s\n", argv[optind]);
+    }
+    if (bench_load(argv[optind], root, reg, false, false, iterations) ||
+        bench_load(argv[optind], root, reg, true, false, iterations) ||
+        bench_load(argv[optind], root, reg, true, true, iterations))
+    {
+        return 1;
+    }
+    return 0;
+}
@@ -38,6 +38,7 @@
 
 #include "adb_parser.h"
 #include "adb_xml_parser.h"
+#include "adb_cache.h"
 
 #include "adb_instance.h"
 #include "adb_condition.h"
@@ -174,10 +175,26 @@ bool Adb::load(string fname,
             AdbParser::setAllowMultipleExceptionsTrue();
         }
         _logFile->init(logFileStr, allowMultipleExceptions);
-        AdbParser p(fname, this, root_node_name, addReserved, evalExpr, strict, includePath, enforceExtraChecks, checkDsAlign,
-                    enforceGuiChecks, force_pad_32, variable_alignment);
         _checkDsAlign = checkDsAlign;
         _enforceGuiChecks = enforceGuiChecks;
+
+        // The cache can't replay parse time diagnostics, nor notice files added to includeDir
+        bool useCache = AdbCache::isEnabled() && !allowMultipleExceptions && logFileStr == "" && includeDir == "";
+        string cacheKey;
+        if (useCache)
+        {
+            stringstream key;
+            key << addReserved << evalExpr << strict << enforceExtraChecks << checkDsAlign << enforceGuiChecks
+                << force_pad_32 << variable_alignment << ";" << includePath << ";" << root_node_name;
+            cacheKey = key.str();
+            if (AdbCache::load(this, fname, cacheKey))
+            {
+                return true;
+            }
+        }
+
+        AdbParser p(fname, this, root_node_name, addReserved, evalExpr, strict, includePath, enforceExtraChecks, checkDsAlign,
+                    enforceGuiChecks, force_pad_32, variable_alignment);
         if (!p.load())
         {
             _lastError = p.getError();
@@ -205,6 +222,10 @@ bool Adb::load(string fname,
         {
             status = false;
         }
+        if (status && useCache)
+        {
+            AdbCache::save(this, fname, cacheKey);
+        }
         return status;
     }
     catch (AdbException& e)
@@ -418,7 +439,8 @@ AdbInstance* Adb::createLayout(string rootNodeName,
                                bool optimize_time,
                                uint32_t root_offset,
                                string root_display_name,
-                               PartitionTree* partition_tree)
+                               PartitionTree* partition_tree,
+                               bool lazy)
 {
     try
     {
@@ -449,6 +471,7 @@ AdbInstance* Adb::createLayout(string rootNodeName,
         }
 
         map<string, string> emptyVars;
+        lazy = lazy && !isExprEval;
         _unionSelectorEvalDeffered.clear();
         _conditionInstances.clear();
         _conditionalArrays.clear();
@@ -471,7 +494,7 @@ AdbInstance* Adb::createLayout(string rootNodeName,
                 }
             }
             createInstance(nodeDesc->fields[i], rootItem, emptyVars, isExprEval, depth == -1 ? -1 : depth - 1,
-                           ignoreMissingNodes, allowMultipleExceptions, optimize_time, next_partition_tree);
+                           ignoreMissingNodes, allowMultipleExceptions, optimize_time, next_partition_tree, lazy);
         }
 
         nodeDesc->inLayout = false;
@@ -503,124 +526,7 @@ AdbInstance* Adb::createLayout(string rootNodeName,
             }
         }
 
-        /* Evaluate unions selector fields*/
-        for (list<AdbInstance*>::iterator it = _unionSelectorEvalDeffered.begin();
-             it != _unionSelectorEvalDeffered.end();
-             it++)
-        {
-            bool foundSelector = true;
-            vector<string> path;
-            AdbInstance* inst = *it;
-            AdbInstance* curInst = inst;
-            const string splitVal = inst->getInstanceAttr("union_selector");
-            mstflint::common::algorithm::split(path, splitVal, mstflint::common::algorithm::is_any_of(string(".")));
-            for (size_t i = 0; i < path.size(); i++)
-            {
-                // TODO: The code below is shady, looks buggy
-                if (path[i] == "#(parent)" || path[i] == "$(parent)")
-                {
-                    curInst = curInst->parent;
-                    if (curInst == NULL || i == path.size() - 1)
-                    {
-                        foundSelector = false;
-                        if (rootNodeName == rootNode)
-                        { // give this warning only if this root instantiation
-                            if (allowMultipleExceptions)
-                                cout << "allow multiple";
-                            raiseException(allowMultipleExceptions,
-                                           "Invalid union selector (" + inst->fullName() +
-                                             "), must be a leaf field, cannot be a parent of root",
-                                           ExceptionHolder::ERROR_EXCEPTION);
-                        }
-                        break;
-                    }
-                }
-                else
-                {
-                    size_t j;
-                    bool inPath = false;
-                    for (j = 0; j < curInst->subItems.size(); j++)
-                    {
-                        if (curInst->subItems[j]->get_field_name() == path[i])
-                        {
-                            curInst = curInst->subItems[j];
-                            inPath = true;
-                            break;
-                        }
-                    }
-
-                    if (j == curInst->subItems.size() && !inPath)
-                    {
-                        foundSelector = false;
-                        if (rootNodeName == rootNode)
-                        { // give this warning only if this root instantiation
-                            raiseException(allowMultipleExceptions,
-                                           "Failed to find union selector for union (" + inst->fullName() +
-                                             ") Can't find field (" + path[i] + ") under (" + curInst->fullName() + ")",
-                                           ExceptionHolder::ERROR_EXCEPTION);
-                        }
-                        break;
-                    }
-                }
-            }
-
-            if (foundSelector)
-            {
-                string selector_val;
-                inst->unionSelector = curInst;
-                for (size_t i = 0; i < inst->subItems.size(); i++)
-                {
-                    if (inst->subItems[i]->isReserved())
-                    {
-                        continue;
-                    }
-
-                    // make sure all union subnodes define "selected_by" attribute
-                    bool found = inst->subItems[i]->getInstanceAttr("selected_by", selector_val);
-                    if (!found)
-                    {
-                        raiseException(allowMultipleExceptions,
-                                       "In union (" + inst->fullName() + ") the union subnode (" +
-                                         inst->subItems[i]->get_field_name() + ") doesn't define selection value",
-                                       ExceptionHolder::ERROR_EXCEPTION);
-                    }
-
-                    // make sure that all union subnodes selector values are defined in the selector field enum
-                    if (selector_val == "")
-                    {
-                        continue;
-                    }
-
-                    if (!inst->unionSelector->isEnumExists())
-                    {
-                        string exceptionTxt = "In union (" + inst->fullName() + ") the union selector (" +
-                                              inst->unionSelector->fullName() + ") is not an enum";
-                        raiseException(allowMultipleExceptions, exceptionTxt, ExceptionHolder::ERROR_EXCEPTION);
-                        break;
-                    }
-
-                    map<string, u_int64_t>::iterator it;
-                    map<string, u_int64_t> selectorValMap = inst->unionSelector->getEnumMap();
-                    for (it = selectorValMap.begin(); it != selectorValMap.end(); it++)
-                    {
-                        if (it->first == selector_val)
-                        {
-                            break;
-                        }
-                    }
-
-                    // if not found in map throw exeption
-                    if (it == selectorValMap.end())
-                    {
-                        string exceptionTxt = "In union (" + inst->fullName() + ") the union subnode (" +
-                                              inst->subItems[i]->get_field_name() + ") uses a selector value (" +
-                                              selector_val + ") which isn't defined in the selector field (" +
-                                              inst->unionSelector->fullName() + ")";
-                        raiseException(allowMultipleExceptions, exceptionTxt, ExceptionHolder::ERROR_EXCEPTION);
-                    }
-                }
-            }
-        }
+        evalUnionSelectors(rootNodeName, allowMultipleExceptions);
 
         // initialize condition variables objects
         if (isExprEval)
@@ -682,6 +588,129 @@ AdbInstance* Adb::createLayout(string rootNodeName,
     }
 }
 
+/**
+ * Function: Adb::evalUnionSelectors
+ * Resolve the selector field of the unions in _unionSelectorEvalDeffered and check their subnodes against it
+ **/
+void Adb::evalUnionSelectors(const string& rootNodeName, bool allowMultipleExceptions)
+{
+    while (!_unionSelectorEvalDeffered.empty())
+    {
+        bool foundSelector = true;
+        vector<string> path;
+        AdbInstance* inst = _unionSelectorEvalDeffered.front();
+        _unionSelectorEvalDeffered.pop_front();
+        AdbInstance* curInst = inst;
+        const string splitVal = inst->getInstanceAttr("union_selector");
+        mstflint::common::algorithm::split(path, splitVal, mstflint::common::algorithm::is_any_of(string(".")));
+        for (size_t i = 0; i < path.size(); i++)
+        {
+            // TODO: The code below is shady, looks buggy
+            if (path[i] == "#(parent)" || path[i] == "$(parent)")
+            {
+                curInst = curInst->parent;
+                if (curInst == NULL || i == path.size() - 1)
+                {
+                    foundSelector = false;
+                    if (rootNodeName == rootNode)
+                    { // give this warning only if this root instantiation
+                        if (allowMultipleExceptions)
+                            cout << "allow multiple";
+                        raiseException(allowMultipleExceptions,
+                                       "Invalid union selector (" + inst->fullName() +
+                                         "), must be a leaf field, cannot be a parent of root",
+                                       ExceptionHolder::ERROR_EXCEPTION);
+                    }
+                    break;
+                }
+            }
+            else
+            {
+                size_t j;
+                bool inPath = false;
+                curInst->instantiateSubItems();
+                for (j = 0; j < curInst->subItems.size(); j++)
+                {
+                    if (curInst->subItems[j]->get_field_name() == path[i])
+                    {
+                        curInst = curInst->subItems[j];
+                        inPath = true;
+                        break;
+                    }
+                }
+
+                if (j == curInst->subItems.size() && !inPath)
+                {
+                    foundSelector = false;
+                    if (rootNodeName == rootNode)
+                    { // give this warning only if this root instantiation
+                        raiseException(allowMultipleExceptions,
+                                       "Failed to find union selector for union (" + inst->fullName() +
+                                         ") Can't find field (" + path[i] + ") under (" + curInst->fullName() + ")",
+                                       ExceptionHolder::ERROR_EXCEPTION);
+                    }
+                    break;
+                }
+            }
+        }
+
+        if (foundSelector)
+        {
+            string selector_val;
+            map<string, u_int64_t> selectorValMap;
+            inst->unionSelector = curInst;
+            inst->instantiateSubItems();
+            for (size_t i = 0; i < inst->subItems.size(); i++)
+            {
+                if (inst->subItems[i]->isReserved())
+                {
+                    continue;
+                }
+
+                // make sure all union subnodes define "selected_by" attribute
+                bool found = inst->subItems[i]->getInstanceAttr("selected_by", selector_val);
+                if (!found)
+                {
+                    raiseException(allowMultipleExceptions,
+                                   "In union (" + inst->fullName() + ") the union subnode (" +
+                                     inst->subItems[i]->get_field_name() + ") doesn't define selection value",
+                                   ExceptionHolder::ERROR_EXCEPTION);
+                }
+
+                // make sure that all union subnodes selector values are defined in the selector field enum
+                if (selector_val == "")
+                {
+                    continue;
+                }
+
+                if (!inst->unionSelector->isEnumExists())
+                {
+                    string exceptionTxt = "In union (" + inst->fullName() + ") the union selector (" +
+                                          inst->unionSelector->fullName() + ") is not an enum";
+                    raiseException(allowMultipleExceptions, exceptionTxt, ExceptionHolder::ERROR_EXCEPTION);
+                    break;
+                }
+
+                // parsed once per union, a register union has an enum value per register
+                if (selectorValMap.empty())
+                {
+                    selectorValMap = inst->unionSelector->getEnumMap();
+                }
+
+                // if not found in map throw exeption
+                if (selectorValMap.find(selector_val) == selectorValMap.end())
+                {
+                    string exceptionTxt = "In union (" + inst->fullName() + ") the union subnode (" +
+                                          inst->subItems[i]->get_field_name() + ") uses a selector value (" +
+                                          selector_val + ") which isn't defined in the selector field (" +
+                                          inst->unionSelector->fullName() + ")";
+                    raiseException(allowMultipleExceptions, exceptionTxt, ExceptionHolder::ERROR_EXCEPTION);
+                }
+            }
+        }
+    }
+}
+
 /**
  * Function: Adb::getNodeDeps
  **/
@@ -722,7 +751,8 @@ bool Adb::createInstance(AdbField* field,
                          bool ignoreMissingNodes,
                          bool allowMultipleExceptions,
                          bool optimize_time,
-                         PartitionTree* partition_tree)
+                         PartitionTree* partition_tree,
+                         bool lazy)
 
 {
     // Stop on exclude tree leaf
@@ -797,72 +827,14 @@ bool Adb::createInstance(AdbField* field,
 
             if (field->isStruct() && !inst->nodeDesc->fields.empty() && (depth == -1 || depth > 0))
             {
-                if (inst->nodeDesc->inLayout)
+                if (lazy)
                 {
-                    delete inst;
-                    inst = nullptr;
-                    raiseException(false,
-                                "Cyclic definition of nodes, node: " + field->name + " was already added to the layout",
-                                ExceptionHolder::ERROR_EXCEPTION);
+                    inst->lazyAdb = this;
                 }
                 else
                 {
-                    inst->nodeDesc->inLayout = true && depth == -1;
-                }
-
-
-                // // validation 2 TODO: move validation to adbXMLParser
-                // if (inst->size != inst->nodeDesc->size)
-                // {
-                //     inst->nodeDesc->size = inst->size;
-                //     /*throw AdbException("Node +(" + inst->name + ") size (" + to_string(inst->size)) +
-                //      " isn't the same as its instance (" + inst->nodeDesc->name +
-                //      ") (" +  to_string(inst->nodeDesc->size) + ")";*/
-                // }
-
-                for (auto it = inst->nodeDesc->fields.begin(); it != inst->nodeDesc->fields.end(); it++)
-                {
-                    PartitionTree* next_partition_tree = nullptr;
-                    if (partition_tree)
-                    {
-                        auto found_partition_tree =
-                          find_if(partition_tree->sub_items.begin(), partition_tree->sub_items.end(),
-                                  [&it](PartitionTree* si) { return si->name == (*it)->name; });
-                        if (found_partition_tree != partition_tree->sub_items.end())
-                        {
-                            next_partition_tree = *found_partition_tree;
-                        }
-                    }
-                    createInstance(*it, inst, vars, isExprEval, depth == -1 ? -1 : depth - 1, ignoreMissingNodes,
-                                allowMultipleExceptions, next_partition_tree);
-                }
-                inst->nodeDesc->inLayout = false;
-
-                if (_checkDsAlign && inst->maxLeafSize != 0 && inst->size % inst->maxLeafSize != 0)
-                {
-                    raiseException(allowMultipleExceptions,
-                                "Node: " + inst->nodeDesc->name + " size(" + to_string(inst->size) +
-                                    ") is not aligned with largest leaf(" + to_string(inst->maxLeafSize) + ")",
-                                ExceptionHolder::ERROR_EXCEPTION);
-                }
-
-                if (!inst->isUnion() && inst->subItems.size() > 0)
-                {
-                    std::stable_sort(inst->subItems.begin(), inst->subItems.end(),
-                                compareFieldsPtr<AdbInstance>); // TODO: try to remove this shit
-
-                    for (size_t j = 0; j < inst->subItems.size() - 1; j++)
-                    {
-                        if (inst->subItems[j + 1]->offset < inst->subItems[j]->offset + inst->subItems[j]->size)
-                        {
-                            string exceptionTxt =
-                            "Field (" + inst->subItems[j + 1]->get_field_name() + ") (" +
-                            formatAddr(inst->subItems[j + 1]->offset, inst->subItems[j + 1]->size).c_str() +
-                            ") overlaps with (" + inst->subItems[j]->get_field_name() + ") (" +
-                            formatAddr(inst->subItems[j]->offset, inst->subItems[j]->size).c_str() + ")";
-                            raiseException(allowMultipleExceptions, exceptionTxt, ExceptionHolder::ERROR_EXCEPTION);
-                        }
-                    }
+                    createSubInstances(inst, vars, isExprEval, depth, ignoreMissingNodes, allowMultipleExceptions,
+                                       partition_tree, false);
                 }
             }
 
@@ -884,6 +856,103 @@ bool Adb::createInstance(AdbField* field,
     return true;
 }
 
+/**
+ * Function: Adb::createSubInstances
+ **/
+void Adb::createSubInstances(AdbInstance* inst,
+                             map<string, string>& vars,
+                             bool isExprEval,
+                             int depth,
+                             bool ignoreMissingNodes,
+                             bool allowMultipleExceptions,
+                             PartitionTree* partition_tree,
+                             bool lazy)
+{
+    if (inst->nodeDesc->inLayout)
+    {
+        string fieldName = inst->fieldDesc->name;
+        delete inst;
+        inst = nullptr;
+        raiseException(false, "Cyclic definition of nodes, node: " + fieldName + " was already added to the layout",
+                       ExceptionHolder::ERROR_EXCEPTION);
+    }
+    else
+    {
+        inst->nodeDesc->inLayout = true && depth == -1;
+    }
+
+    // // validation 2 TODO: move validation to adbXMLParser
+    // if (inst->size != inst->nodeDesc->size)
+    // {
+    //     inst->nodeDesc->size = inst->size;
+    //     /*throw AdbException("Node +(" + inst->name + ") size (" + to_string(inst->size)) +
+    //      " isn't the same as its instance (" + inst->nodeDesc->name +
+    //      ") (" +  to_string(inst->nodeDesc->size) + ")";*/
+    // }
+
+    for (auto it = inst->nodeDesc->fields.begin(); it != inst->nodeDesc->fields.end(); it++)
+    {
+        PartitionTree* next_partition_tree = nullptr;
+        if (partition_tree)
+        {
+            auto found_partition_tree =
+              find_if(partition_tree->sub_items.begin(), partition_tree->sub_items.end(),
+                      [&it](PartitionTree* si) { return si->name == (*it)->name; });
+            if (found_partition_tree != partition_tree->sub_items.end())
+            {
+                next_partition_tree = *found_partition_tree;
+            }
+        }
+        createInstance(*it, inst, vars, isExprEval, depth == -1 ? -1 : depth - 1, ignoreMissingNodes,
+                       allowMultipleExceptions, next_partition_tree, nullptr, lazy);
+    }
+    inst->nodeDesc->inLayout = false;
+
+    if (_checkDsAlign && inst->maxLeafSize != 0 && inst->size % inst->maxLeafSize != 0)
+    {
+        raiseException(allowMultipleExceptions,
+                       "Node: " + inst->nodeDesc->name + " size(" + to_string(inst->size) +
+                         ") is not aligned with largest leaf(" + to_string(inst->maxLeafSize) + ")",
+                       ExceptionHolder::ERROR_EXCEPTION);
+    }
+
+    if (!inst->isUnion() && inst->subItems.size() > 0)
+    {
+        std::stable_sort(inst->subItems.begin(), inst->subItems.end(),
+                         compareFieldsPtr<AdbInstance>); // TODO: try to remove this shit
+
+        for (size_t j = 0; j < inst->subItems.size() - 1; j++)
+        {
+            if (inst->subItems[j + 1]->offset < inst->subItems[j]->offset + inst->subItems[j]->size)
+            {
+                string exceptionTxt =
+                  "Field (" + inst->subItems[j + 1]->get_field_name() + ") (" +
+                  formatAddr(inst->subItems[j + 1]->offset, inst->subItems[j + 1]->size).c_str() +
+                  ") overlaps with (" + inst->subItems[j]->get_field_name() + ") (" +
+                  formatAddr(inst->subItems[j]->offset, inst->subItems[j]->size).c_str() + ")";
+                raiseException(allowMultipleExceptions, exceptionTxt, ExceptionHolder::ERROR_EXCEPTION);
+            }
+        }
+    }
+}
+
+/**
+ * Function: Adb::createSubInstances
+ * Instantiate the sub items of an instance of a lazy layout, one level down
+ **/
+void Adb::createSubInstances(AdbInstance* inst)
+{
+    map<string, string> emptyVars;
+
+    if (inst->lazyAdb != this)
+    {
+        return;
+    }
+    inst->lazyAdb = nullptr;
+    createSubInstances(inst, emptyVars, false, -1, false, false, nullptr, true);
+    evalUnionSelectors(inst->get_root()->nodeDesc->name, false);
+}
+
 /**
  * Function: Adb::checkInstanceOffsetValidity
  **/
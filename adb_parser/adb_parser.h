@@ -148,6 +148,9 @@ public:
                  string addPrefix = "");
 
     AdbInstance* addMissingNodes(int depth, bool allowMultipleExceptions);
+    // lazy: instantiate the sub items of a node only when first accessed through the AdbInstance lookup
+    // methods (getChildByPath, getUnionSelectedNodeName, getLeafFields, ...), not applicable with isExprEval.
+    // The Adb must outlive such a layout
     AdbInstance* createLayout(string rootNodeName,
                               bool isExprEval = false,
                               int depth = -1, /* -1 means instantiate full tree */
@@ -156,7 +159,9 @@ public:
                               bool optimize_time = false,
                               uint32_t root_offset = 0,
                               string root_display_name = "",
-                              PartitionTree* partition_tree = nullptr);
+                              PartitionTree* partition_tree = nullptr,
+                              bool lazy = false);
+    void createSubInstances(AdbInstance* inst);
     vector<string> getNodeDeps(string nodeName);
     void add_include(string fileName, string filePath, string included_from, int lineNumber);
     string getLastError();
@@ -196,7 +201,17 @@ private:
                         bool ignoreMissingNodes = false,
                         bool getAllExceptions = false,
                         bool optimize_time = false,
-                        PartitionTree* partition_tree = nullptr);
+                        PartitionTree* partition_tree = nullptr,
+                        bool lazy = false);
+    void createSubInstances(AdbInstance* inst,
+                            map<string, string>& vars,
+                            bool isExprEval,
+                            int depth,
+                            bool ignoreMissingNodes,
+                            bool allowMultipleExceptions,
+                            PartitionTree* partition_tree,
+                            bool lazy);
+    void evalUnionSelectors(const string& rootNodeName, bool allowMultipleExceptions);
     string evalExpr(string expr, AttrsMap* vars);
     bool checkInstSizeConsistency(bool getAllExceptions = false);
     static PartitionTree* prune_up(PartitionTree* partition_tree);
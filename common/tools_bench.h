@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. ALL RIGHTS RESERVED.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TOOLS_BENCH_H
+#define TOOLS_BENCH_H
+
+/*
+ * Helpers shared by the benchmarks that are built on demand (EXTRA_PROGRAMS).
+ */
+
+#include <stdio.h>
+#include <sys/types.h>
+#include <time.h>
+
+static inline u_int64_t bench_now_nsecs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u_int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static inline u_int64_t bench_now_usecs(void)
+{
+    return bench_now_nsecs() / 1000;
+}
+
+static inline double bench_now_secs(void)
+{
+    return bench_now_nsecs() / 1e9;
+}
+
+/* Prints the usage line of a bench, returns its exit code for a bad command line */
+static inline int bench_usage(const char* prog, const char* args)
+{
+    fprintf(stderr, "Usage: %s %s\n", prog, args);
+    return 1;
+}
+
+#endif /* TOOLS_BENCH_H */
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. ALL RIGHTS RESERVED.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TOOLS_CACHE_DIR_H
+#define TOOLS_CACHE_DIR_H
+
+/*
+ * Per-user directory for files derived from installed data, such as compiled tables. Installed data files are
+ * only ever read, what is derived from them goes to $XDG_CACHE_HOME/mstflint or ~/.cache/mstflint.
+ */
+
+#if !defined(__WIN__)
+#include <errno.h>
+#include <limits.h>
+#include <pwd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#define TOOLS_CACHE_SUBDIR "mstflint"
+
+/* Creates dir (0700) if missing, 0 if it is then a directory only the caller can write to */
+static inline int tools_cache_mkdir(const char* dir)
+{
+    struct stat st;
+
+    if (mkdir(dir, 0700) && errno != EEXIST)
+    {
+        return -1;
+    }
+    if (lstat(dir, &st) || !S_ISDIR(st.st_mode) || st.st_uid != geteuid() || (st.st_mode & (S_IWGRP | S_IWOTH)))
+    {
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * Fills dir with the cache directory of the caller, creating it if needed. The environment is used only when
+ * it points at a directory of the caller, so that tools run under sudo don't fill the invoking user's home with
+ * files owned by root. Returns 0 on success.
+ */
+static inline int tools_cache_dir(char* dir, size_t size)
+{
+    const char* base = getenv("XDG_CACHE_HOME");
+    const char* home = getenv("HOME");
+    char parent[PATH_MAX];
+    struct stat st;
+    struct passwd* pw;
+
+    if (base && base[0] == '/' && !stat(base, &st) && st.st_uid == geteuid())
+    {
+        snprintf(parent, sizeof(parent), "%s", base);
+    }
+    else
+    {
+        if (!home || home[0] != '/' || stat(home, &st) || st.st_uid != geteuid())
+        {
+            pw = getpwuid(geteuid());
+            home = pw ? pw->pw_dir : NULL;
+        }
+        if (!home || (size_t)snprintf(parent, sizeof(parent), "%s/.cache", home) >= sizeof(parent) ||
+            tools_cache_mkdir(parent))
+        {
+            return -1;
+        }
+    }
+    if ((size_t)snprintf(dir, size, "%s/" TOOLS_CACHE_SUBDIR, parent) >= size)
+    {
+        return -1;
+    }
+    return tools_cache_mkdir(dir);
+}
+
+/*
+ * Fills path with the cache file for source_path: <cache dir>/<source file name>-<hash of its full path><suffix>,
+ * so that the same file name in two data directories gets two caches. Returns 0 on success.
+ */
+static inline int tools_cache_file(const char* source_path, const char* suffix, char* path, size_t size)
+{
+    char dir[PATH_MAX];
+    char full_path[PATH_MAX];
+    const char* name;
+    const char* p;
+    unsigned long long hash = 0xcbf29ce484222325ULL; /* FNV-1a */
+
+    if (tools_cache_dir(dir, sizeof(dir)))
+    {
+        return -1;
+    }
+    if (!realpath(source_path, full_path))
+    {
+        snprintf(full_path, sizeof(full_path), "%s", source_path);
+    }
+    for (p = full_path; *p; p++)
+    {
+        hash = (hash ^ (unsigned char)*p) * 0x100000001b3ULL;
+    }
+    name = strrchr(full_path, '/');
+    name = name ? name + 1 : full_path;
+    if ((size_t)snprintf(path, size, "%s/%s-%016llx%s", dir, name, hash, suffix) >= size)
+    {
+        return -1;
+    }
+    return 0;
+}
+#endif
+
+#endif /* TOOLS_CACHE_DIR_H */
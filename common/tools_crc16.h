@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. ALL RIGHTS RESERVED.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef MSTFLINT_CRC16_H
+#define MSTFLINT_CRC16_H
+
+#include <stdint.h>
+
+namespace mstflint
+{
+namespace common
+{
+namespace crc16
+{
+/*
+ * Table driven core of the image CRC16 (polynomial 0x100b). The message bits are shifted into the low end of
+ * the register, so 16 steps of the register never depend on the 16 bits shifted in during them:
+ *     crc' = (next 16 message bits) ^ F(crc)
+ * where F is 16 steps with zero input, which is linear. A dword is then lo ^ F(hi) ^ F^2(crc) and two dwords
+ * are lo2 ^ F(hi2) ^ F^2(lo1) ^ F^3(hi1) ^ F^4(crc), each F^k being looked up by byte (slice-by-8).
+ */
+static const uint16_t POLY = 0x100b;
+
+struct Tables
+{
+    uint16_t hi[4][256]; // hi[k - 1][b] = F^k(b << 8)
+    uint16_t lo[4][256]; // lo[k - 1][b] = F^k(b)
+};
+
+inline uint16_t shift16(uint16_t crc)
+{
+    for (int i = 0; i < 16; i++)
+    {
+        crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ POLY) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+inline Tables build_tables()
+{
+    Tables tbl;
+    for (int b = 0; b < 256; b++)
+    {
+        uint16_t hi = (uint16_t)(b << 8);
+        uint16_t lo = (uint16_t)b;
+        for (int k = 0; k < 4; k++)
+        {
+            hi = shift16(hi);
+            lo = shift16(lo);
+            tbl.hi[k][b] = hi;
+            tbl.lo[k][b] = lo;
+        }
+    }
+    return tbl;
+}
+
+inline const Tables& tables()
+{
+    static const Tables tbl = build_tables();
+    return tbl;
+}
+
+// F^(power + 1)(x)
+inline uint16_t f(const Tables& tbl, int power, uint16_t x)
+{
+    return tbl.hi[power][x >> 8] ^ tbl.lo[power][x & 0xff];
+}
+
+inline uint16_t add_dword(uint16_t crc, uint32_t dw)
+{
+    const Tables& tbl = tables();
+    uint16_t hi = (uint16_t)(dw >> 16);
+    return (uint16_t)((dw & 0xffff) ^ f(tbl, 0, hi) ^ f(tbl, 1, crc));
+}
+
+inline uint16_t add_dwords(uint16_t crc, const uint32_t* data, uint32_t num_dwords)
+{
+    const Tables& tbl = tables();
+    uint32_t i = 0;
+    for (; i + 1 < num_dwords; i += 2)
+    {
+        uint16_t hi1 = (uint16_t)(data[i] >> 16);
+        uint16_t lo1 = (uint16_t)(data[i] & 0xffff);
+        uint16_t hi2 = (uint16_t)(data[i + 1] >> 16);
+        crc = (uint16_t)((data[i + 1] & 0xffff) ^ f(tbl, 0, hi2) ^ f(tbl, 1, lo1) ^ f(tbl, 2, hi1) ^ f(tbl, 3, crc));
+    }
+    if (i < num_dwords)
+    {
+        crc = add_dword(crc, data[i]);
+    }
+    return crc;
+}
+
+// Feed the 16 zero bits closing the message and invert.
+inline uint16_t finish(uint16_t crc)
+{
+    const Tables& tbl = tables();
+    return (uint16_t)(f(tbl, 0, crc) ^ 0xffff);
+}
+
+} // namespace crc16
+} // namespace common
+} // namespace mstflint
+
+#endif // MSTFLINT_CRC16_H
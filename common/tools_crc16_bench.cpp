@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. ALL RIGHTS RESERVED.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*
+ * Throughput of the image CRC16: the bitwise loop flint used, the per-dword table and the two-dword
+ * (slice-by-8) block path. Each result is checked bit-exact against the bitwise loop first.
+ *
+ * With -t, also checks the image as independent sections on a worker pool, the way section verification does.
+ *
+ * Usage: tools_crc16_bench [-s size_mb] [-i iterations] [-t threads]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <vector>
+#include <common/tools_bench.h>
+#include "tools_crc16.h"
+#include "tools_parallel.h"
+
+namespace crc16 = mstflint::common::crc16;
+
+static uint16_t bitwise_add(uint16_t crc, uint32_t o)
+{
+    for (int i = 0; i < 32; i++)
+    {
+        if (crc & 0x8000)
+        {
+            crc = (uint16_t)((((crc << 1) | (o >> 31)) ^ 0x100b) & 0xffff);
+        }
+        else
+        {
+            crc = (uint16_t)(((crc << 1) | (o >> 31)) & 0xffff);
+        }
+        o = (o << 1) & 0xffffffff;
+    }
+    return crc;
+}
+
+static uint16_t bitwise_finish(uint16_t crc)
+{
+    for (int i = 0; i < 16; i++)
+    {
+        crc = (crc & 0x8000) ? (uint16_t)(((crc << 1) ^ 0x100b) & 0xffff) : (uint16_t)((crc << 1) & 0xffff);
+    }
+    return (uint16_t)(crc ^ 0xffff);
+}
+
+static uint16_t crc_bitwise(const uint32_t* data, uint32_t n)
+{
+    uint16_t crc = 0xffff;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        crc = bitwise_add(crc, data[i]);
+    }
+    return bitwise_finish(crc);
+}
+
+static uint16_t crc_table(const uint32_t* data, uint32_t n)
+{
+    uint16_t crc = 0xffff;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        crc = crc16::add_dword(crc, data[i]);
+    }
+    return crc16::finish(crc);
+}
+
+static uint16_t crc_block(const uint32_t* data, uint32_t n)
+{
+    return crc16::finish(crc16::add_dwords(0xffff, data, n));
+}
+
+typedef uint16_t (*crc_func_t)(const uint32_t*, uint32_t);
+
+static bool verify(const char* name, crc_func_t func)
+{
+    std::vector<uint32_t> buf(4099);
+    for (int round = 0; round < 64; round++)
+    {
+        for (size_t i = 0; i < buf.size(); i++)
+        {
+            buf[i] = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+        }
+        // Odd and even lengths, including the empty and single dword cases
+        for (uint32_t n = 0; n < buf.size(); n += 1 + (n % 37))
+        {
+            if (func(&buf[0], n) != crc_bitwise(&buf[0], n))
+            {
+                printf("-E- %s: mismatch at %u dwords (round %d)\n", name, n, round);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void bench(const char* name, crc_func_t func, const std::vector<uint32_t>& buf, int iterations)
+{
+    uint16_t crc = 0;
+    double start = bench_now_secs();
+    for (int i = 0; i < iterations; i++)
+    {
+        crc = func(&buf[0], (uint32_t)buf.size());
+    }
+    double elapsed = bench_now_secs() - start;
+    double mb = (double)buf.size() * 4 * iterations / (1024 * 1024);
+    printf("%-12s %8.1f MB/s  (%.3f s, crc 0x%04x)\n", name, mb / elapsed, elapsed, crc);
+}
+
+#define BENCH_SECTIONS 48
+
+static void bench_sections(const std::vector<uint32_t>& buf, int iterations, unsigned threads)
+{
+    // Uneven section sizes, as in a real image where the main code dominates
+    std::vector<size_t> starts(1, 0);
+    size_t left = buf.size();
+    for (int i = 0; i < BENCH_SECTIONS - 1 && left > 1; i++)
+    {
+        size_t len = left / (i % 4 == 0 ? 3 : 16) + 1;
+        starts.push_back(starts.back() + len);
+        left -= len;
+    }
+    starts.push_back(buf.size());
+    size_t num_sections = starts.size() - 1;
+    std::vector<uint16_t> crcs(num_sections);
+    for (unsigned workers = 1;; workers = std::min(workers * 2, threads))
+    {
+        double start = bench_now_secs();
+        for (int i = 0; i < iterations; i++)
+        {
+            mstflint::common::parallel::for_each_index(num_sections, workers, [&](size_t s) {
+                crcs[s] = crc_block(&buf[starts[s]], (uint32_t)(starts[s + 1] - starts[s]));
+            });
+        }
+        double elapsed = bench_now_secs() - start;
+        double mb = (double)buf.size() * 4 * iterations / (1024 * 1024);
+        printf("%2u workers  %8.1f MB/s  (%.3f s, %u sections)\n", workers, mb / elapsed, elapsed,
+               (unsigned)num_sections);
+        if (workers >= threads)
+        {
+            break;
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int size_mb = 32;
+    int iterations = 4;
+    unsigned threads = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "s:i:t:")) != -1)
+    {
+        switch (opt)
+        {
+            case 's':
+                size_mb = atoi(optarg);
+                break;
+            case 'i':
+                iterations = atoi(optarg);
+                break;
+            case 't':
+                threads = (unsigned)atoi(optarg);
+                break;
+            default:
+                return bench_usage(argv[0], "[-s size_mb] [-i iterations] [-t threads]");
+        }
+    }
+    if (size_mb <= 0 || iterations <= 0)
+    {
+        fprintf(stderr, "-E- size and iterations must be positive\n");
+        return 1;
+    }
+
+    srand(0x100b);
+    if (!verify("table", crc_table) || !verify("block", crc_block))
+    {
+        return 1;
+    }
+    printf("table and block CRC16 are bit-exact with the bitwise loop\n");
+
+    std::vector<uint32_t> buf((size_t)size_mb * 1024 * 1024 / 4);
+    for (size_t i = 0; i < buf.size(); i++)
+    {
+        buf[i] = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+    }
+    printf("%d MB image, %d iterations\n", size_mb, iterations);
+    bench("bitwise", crc_bitwise, buf, iterations);
+    bench("table", crc_table, buf, iterations);
+    bench("slice-by-8", crc_block, buf, iterations);
+    if (threads > 0)
+    {
+        bench_sections(buf, iterations, threads);
+    }
+    return 0;
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. ALL RIGHTS RESERVED.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef MSTFLINT_PARALLEL_H
+#define MSTFLINT_PARALLEL_H
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#if !defined(UEFI_BUILD)
+#include <atomic>
+#include <thread>
+#include <vector>
+#endif
+
+namespace mstflint
+{
+namespace common
+{
+namespace parallel
+{
+/*
+ * Number of workers for CPU bound loops: the value of env_name when set (1 means run serially), otherwise the
+ * online CPUs capped by max_workers.
+ */
+inline unsigned workers_from_env(const char* env_name, unsigned max_workers)
+{
+    const char* env = env_name ? getenv(env_name) : NULL;
+    if (env)
+    {
+        int n = atoi(env);
+        return n > 0 ? (unsigned)n : 1;
+    }
+#if !defined(UEFI_BUILD)
+    unsigned n = std::thread::hardware_concurrency();
+    if (n == 0)
+    {
+        n = 1;
+    }
+    return n < max_workers ? n : max_workers;
+#else
+    (void)max_workers;
+    return 1;
+#endif
+}
+
+/*
+ * Calls func(worker, i) for every i in [0, count), spread over up to num_workers threads (the caller is one of
+ * them). worker is in [0, num_workers) and is the same for all the items one thread runs, so func can use state
+ * set up per worker (a device handle, a parser). Items are handed out one at a time and in order, so uneven
+ * items balance out. func must not throw and must only touch state owned by item i or by its worker.
+ */
+template<typename Func>
+void for_each_index_worker(size_t count, unsigned num_workers, Func func)
+{
+#if !defined(UEFI_BUILD)
+    if (num_workers > count)
+    {
+        num_workers = (unsigned)count;
+    }
+    if (num_workers > 1)
+    {
+        std::atomic<size_t> next(0);
+        std::vector<std::thread> threads;
+        threads.reserve(num_workers - 1);
+        for (unsigned t = 0; t < num_workers; t++)
+        {
+            auto worker = [&next, count, &func, t]() {
+                for (size_t i = next++; i < count; i = next++)
+                {
+                    func(t, i);
+                }
+            };
+            if (t + 1 < num_workers)
+            {
+                threads.push_back(std::thread(worker));
+            }
+            else
+            {
+                worker();
+            }
+        }
+        for (size_t t = 0; t < threads.size(); t++)
+        {
+            threads[t].join();
+        }
+        return;
+    }
+#else
+    (void)num_workers;
+#endif
+    for (size_t i = 0; i < count; i++)
+    {
+        func(0, i);
+    }
+}
+
+/*
+ * Calls func(i) for every i in [0, count), spread over up to num_workers threads (the caller is one of them).
+ * Items are handed out one at a time, so uneven items balance out. func must not throw and must only touch
+ * state owned by item i; anything order dependent is left to the caller after this returns.
+ */
+template<typename Func>
+void for_each_index(size_t count, unsigned num_workers, Func func)
+{
+    for_each_index_worker(count, num_workers, [&func](unsigned, size_t i) { func(i); });
+}
+
+} // namespace parallel
+} // namespace common
+} // namespace mstflint
+
+#endif // MSTFLINT_PARALLEL_H
@@ -192,6 +192,7 @@ FlagMetaData::FlagMetaData()
     _flags.push_back(new Flag("", "override_cache_replacement", 0));
     _flags.push_back(new Flag("", "ocr", 0));
     _flags.push_back(new Flag("", "no_flash_verify", 0));
+    _flags.push_back(new Flag("", "diff_burn", 0));
     _flags.push_back(new Flag("s", "silent", 0));
     _flags.push_back(new Flag("y", "yes", 0));
     _flags.push_back(new Flag("", "no", 0));
@@ -688,6 +689,13 @@ void Flint::initCmdParser()
 
     AddOptions("no_flash_verify", ' ', "", "Do not verify each write on the flash.");
 
+    AddOptions("diff_burn",
+               ' ',
+               "",
+               "Burn only what changed: sectors already holding the new data are neither erased nor written,\n"
+               "sectors that are blank are written without erase. Sector counts and the estimated time\n"
+               "saved are written to the burn log.");
+
     AddOptions("use_fw", ' ', "", "Flash access will be done using FW (ConnectX-3/ConnectX-3Pro only).");
 
     AddOptions("silent",
@@ -1109,6 +1117,10 @@ ParseStatus Flint::HandleOption(string name, string value)
     {
         _flintParams.no_flash_verify = true;
     }
+    else if (name == "diff_burn")
+    {
+        _flintParams.diff_burn = true;
+    }
     else if (name == "silent" || name == "s")
     {
         _flintParams.silent = true;
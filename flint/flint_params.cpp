@@ -66,6 +66,7 @@ FlintParams::FlintParams()
     override_cache_replacement = false;
     use_fw = false; // access flash via FW on CX3/CX3Pro
     no_flash_verify = false;
+    diff_burn = false;
     silent = false;
     yes = false;
     no = false;
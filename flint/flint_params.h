@@ -131,6 +131,7 @@ public:
     bool override_cache_replacement;
     bool use_fw;
     bool no_flash_verify;
+    bool diff_burn;
     bool silent;
     bool yes;
     bool no;
@@ -583,6 +583,7 @@ void SubCommand::initDeviceFwParams(char* errBuff, FwOperations::fw_ops_params_t
     fwParams.numOfBanks = _flintParams.banks;
     fwParams.readOnly = false;
     fwParams.noFlashVerify = _flintParams.no_flash_verify;
+    fwParams.diffBurn = _flintParams.diff_burn;
     fwParams.cx3FwAccess = _flintParams.use_fw;
     fwParams.noFwCtrl = _flintParams.no_fw_ctrl;
     fwParams.mccUnsupported = !_mccSupported;
@@ -2763,6 +2764,28 @@ bool BurnSubCommand::checkPSID()
     return true;
 }
 
+bool BurnSubCommand::finishDiffBurn()
+{
+    FBase* io = _fwOps->GetIoAccess();
+    if (!_flintParams.diff_burn || !io || !io->is_flash())
+    {
+        return true;
+    }
+    Flash* flash = (Flash*)io;
+    if (!flash->diff_burn_flush())
+    {
+        reportErr(true, "Differential burn failed: %s\n", flash->err());
+        return false;
+    }
+    const Flash::diff_burn_stats_t& stats = flash->get_diff_burn_stats();
+    print_line_to_log("Differential burn: %u sectors skipped, %u erased, %u written without erase, "
+                      "%llu bytes skipped, %llu bytes written, ~%llu ms saved\n",
+                      stats.sectors_skipped, stats.sectors_erased, stats.sectors_written,
+                      (unsigned long long)stats.bytes_skipped, (unsigned long long)stats.bytes_written,
+                      (unsigned long long)(stats.saved_usecs / 1000));
+    return true;
+}
+
 FlintStatus BurnSubCommand::burnFs3()
 {
     bool printPreparing = false;
@@ -2882,6 +2905,10 @@ FlintStatus BurnSubCommand::burnFs3()
         }
     }
 
+    if (!finishDiffBurn())
+    {
+        return FLINT_FAILED;
+    }
     PRINT_PROGRESS(_burnParams.progressFunc, 101);
     write_result_to_log(FLINT_SUCCESS, "", _flintParams.log_specified);
     const char* resetRec = _fwOps->FwGetResetRecommandationStr();
@@ -3015,6 +3042,10 @@ FlintStatus BurnSubCommand::burnFs2()
         reportErr(true, FLINT_FS2_BURN_ERROR, _fwOps->err());
         return FLINT_FAILED;
     }
+    if (!finishDiffBurn())
+    {
+        return FLINT_FAILED;
+    }
     PRINT_PROGRESS(_burnParams.progressFunc, 101);
     write_result_to_log(FLINT_SUCCESS, "", _flintParams.log_specified);
     if (_burnParams.burnStatus.imageCachedSuccessfully)
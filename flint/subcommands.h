@@ -231,6 +231,7 @@ private:
     FwCompsMgr* fwCompsAccess;
     FlintStatus burnFs3();
     FlintStatus burnFs2();
+    bool finishDiffBurn();
     bool checkFwVersion(bool CreateFromImgInfo = true,
                         u_int16_t fw_ver0 = 0,
                         u_int16_t fw_ver1 = 0,
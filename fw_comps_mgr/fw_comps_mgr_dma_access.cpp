@@ -79,6 +79,11 @@ static int allocate_uefi_dma_memory_page(mfile* mf, mtcr_alloc_page* user_alloc_
 
 #define TIMETOSLEEP (1000 * PAGE_SIZE / FLASH_WRITE_SPEED) // 6 msec
 #define MAXIMUM_SLEEP_TIME_MS 20000
+#define MAILBOX_MIN_POLL_USECS 100 // polling backs off from here up to TIMETOSLEEP
+#define DMA_RING_MIN_DEPTH FMPT_MAILBOX_PAGE // the two data pages of the original layout
+#define DMA_RING_DEFAULT_DEPTH 4
+#define DMA_RING_MAX_DEPTH (MAX_PAGES_SIZE - 1) // one page is the mailbox
+#define DMA_RING_DEPTH_ENV "FW_COMPS_DMA_RING_PAGES"
 #define _MCDD_DEBUG_ 0
 
 #if _MCDD_DEBUG_
@@ -103,50 +108,72 @@ void printData(u_int32_t* data, int data_size, int format)
 }
 #endif
 
+static u_int64_t dmaNowUsecs()
+{
+    return (u_int64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
 bool DMAComponentAccess::prepareParameters(u_int32_t updateHandle,
                                            mcddReg* accessData,
-                                           int offset,
-                                           u_int32_t* data,
-                                           int data_size,
-                                           int access,
-                                           int leftSize,
+                                           u_int32_t offset,
+                                           u_int32_t size,
                                            mtcr_page_addresses page,
                                            mtcr_page_addresses mailbox_page)
 {
     accessData->update_handle = updateHandle;
     accessData->offset = offset;
-    accessData->size = leftSize > PAGE_SIZE ? PAGE_SIZE : leftSize;
+    accessData->size = size;
     accessData->data_page_phys_addr_lsb = EXTRACT64(page.dma_address, 0, 32);
     accessData->data_page_phys_addr_msb = EXTRACT64(page.dma_address, 32, 32);
     accessData->mailbox_page_phys_addr_lsb = EXTRACT64(mailbox_page.dma_address, 0, 32);
     accessData->mailbox_page_phys_addr_msb = EXTRACT64(mailbox_page.dma_address, 32, 32);
-    int currentOffset = data_size - leftSize;
-    if (access == MCC_WRITE_COMP)
+    return true;
+}
+
+void DMAComponentAccess::writeToDataPage(mtcr_page_addresses page, const u_int32_t* data, u_int32_t size)
+{
+    u_int32_t* data_ptr = (u_int32_t*)page.virtual_address;
+    for (u_int32_t i = 0; i < size / 4; i++)
     {
-        u_int32_t* data_ptr = (u_int32_t*)page.virtual_address;
-        for (int i = 0; i < accessData->size / 4; i++)
-        {
-            *data_ptr = ___my_swab32(data[(currentOffset) / 4 + i]);
-            data_ptr++;
-        }
+        *data_ptr = ___my_swab32(data[i]);
+        data_ptr++;
     }
-    return true;
 }
 
 bool DMAComponentAccess::allocateMemory()
 {
     mtcr_page_info page_info;
+    int ringDepth = DMA_RING_DEFAULT_DEPTH;
 
 #ifndef UEFI_BUILD
-    if (get_dma_pages(_mf, &page_info, FMPT_ALLOCATED_LIST_LENGTH))
+    const char* ringDepthEnv = getenv(DMA_RING_DEPTH_ENV);
+    if (ringDepthEnv)
     {
-        return false;
+        ringDepth = atoi(ringDepthEnv);
+        ringDepth = ringDepth < DMA_RING_MIN_DEPTH ? DMA_RING_MIN_DEPTH : ringDepth;
+        ringDepth = ringDepth > DMA_RING_MAX_DEPTH ? DMA_RING_MAX_DEPTH : ringDepth;
+    }
+    if (get_dma_pages(_mf, &page_info, ringDepth + 1))
+    {
+        if (ringDepth == DMA_RING_MIN_DEPTH)
+        {
+            return false;
+        }
+        DPRINTF(("DMAComponentAccess::allocateMemory %d pages failed, trying %d\n", ringDepth + 1,
+                 DMA_RING_MIN_DEPTH + 1));
+        ringDepth = DMA_RING_MIN_DEPTH;
+        if (get_dma_pages(_mf, &page_info, ringDepth + 1))
+        {
+            return false;
+        }
     }
 #else
     return false;
 #endif
 
-    for (int page_counter = 0; page_counter < FMPT_ALLOCATED_LIST_LENGTH; page_counter++)
+    for (int page_counter = 0; page_counter < ringDepth + 1; page_counter++)
     {
 #if _MCDD_DEBUG_
         u_int32_t va_lsb = EXTRACT64(page_info.page_addresses_array[page_counter]->virtual_address, 0, 32);
@@ -158,6 +185,8 @@ bool DMAComponentAccess::allocateMemory()
 #endif
         _allocatedListVect.push_back(page_info.page_addresses_array[page_counter]);
     }
+    _ringDepth = ringDepth;
+    DPRINTF(("DMAComponentAccess::allocateMemory ring of %d data pages\n", ringDepth));
     return true;
 }
 
@@ -185,23 +214,51 @@ bool DMAComponentAccess::isBMESet(mfile* mf)
     return res;
 }
 
-bool DMAComponentAccess::readFromDataPage(mcddReg* accessData,
-                                          mtcr_page_addresses page,
-                                          u_int32_t* data,
-                                          int data_size,
-                                          int leftSize)
+void DMAComponentAccess::readFromDataPage(mtcr_page_addresses page, u_int32_t* data, u_int32_t size)
 {
     u_int32_t* data_ptr = (u_int32_t*)page.virtual_address;
-    int currentOffset = (data_size - leftSize) / 4;
-    for (int i = 0; i < accessData->size / 4; i++)
+    for (u_int32_t i = 0; i < size / 4; i++)
     {
-        data[currentOffset + i] = ___my_swab32(*data_ptr);
+        data[i] = ___my_swab32(*data_ptr);
         data_ptr++;
 #if _MCDD_DEBUG_
         if (i % 100 == 0)
-            DPRINTF(("\nReading data[%#02x]: %#08x\n", (i)*4, data[(data_size - leftSize) / 4 + i]));
+            DPRINTF(("\nReading data[%#02x]: %#08x\n", (i)*4, data[i]));
 #endif
     }
+}
+
+bool DMAComponentAccess::waitForMailbox(mtcr_page_addresses mailbox_page, mcddDescriptor* mailbox)
+{
+    // The FW changes the status from 0 to BUSY when it starts the reading/writing operation, and to DONE or ERROR
+    // when it ends. Poll often first, a page usually completes within a few milliseconds, and back off to
+    // TIMETOSLEEP for slow transfers.
+    u_int32_t pollUsecs = MAILBOX_MIN_POLL_USECS;
+    u_int32_t sleptUsecs = 0;
+    u_int8_t lastStatus = FFS_FW_UNKNOWN;
+    tools_open_mcdd_descriptor_unpack(mailbox, (const u_int8_t*)mailbox_page.virtual_address);
+    while (mailbox->status == FFS_FW_UNKNOWN || mailbox->status == FFS_FW_BUSY)
+    {
+        if (mailbox->status != lastStatus)
+        {
+            // Each stage gets its own timeout, as before
+            DPRINTF(("AccessComponent status %d err %d reserved3 %d\n", mailbox->status, mailbox->error,
+                     mailbox->reserved3));
+            lastStatus = mailbox->status;
+            sleptUsecs = 0;
+        }
+        nbu::mft::common::mft_usleep(pollUsecs);
+        sleptUsecs += pollUsecs;
+        if (sleptUsecs >= MAXIMUM_SLEEP_TIME_MS * 1000)
+        {
+            setLastError(FWCOMPS_ABORTED);
+            return false;
+        }
+        pollUsecs = pollUsecs * 2 > TIMETOSLEEP * 1000 ? TIMETOSLEEP * 1000 : pollUsecs * 2;
+        tools_open_mcdd_descriptor_unpack(mailbox, (const u_int8_t*)mailbox_page.virtual_address);
+    }
+    DPRINTF(("AccessComponent status %d err %d reserved3 %d\n", mailbox->status, mailbox->error,
+             mailbox->reserved3));
     return true;
 }
 
@@ -228,43 +285,52 @@ bool DMAComponentAccess::accessComponent(u_int32_t updateHandle,
                 return false; // this will trigger a fallback to direct_access instead of dma_access
             }
         }
-        int leftSize = (int)data_size;
-        int CurrentPage = FMPT_FIRST_PAGE;
         char stage[MAX_MSG_SIZE] = {0};
         int progressPercentage = -1;
-        int currentOffset = 0;
-        int nMaximumSleepTime = 0;
-        tools_open_mcdd_descriptor mailboxVirtPtr_1;
+        mcddDescriptor mailboxVirtPtr_1;
         if (progressFuncAdv && progressFuncAdv->func)
         {
             snprintf(stage, MAX_MSG_SIZE, "%s %s component", (access == MCC_READ_COMP) ? "Reading" : "Writing",
                      currComponentStr);
         }
         // updateHandle &= ~0xff000000;
-        DPRINTF(("DMAComponentAccess::AccessComponent BEGIN size %d access %s\n", data_size,
-                 (access == MCC_READ_COMP) ? "READ" : "WRITE"));
+        DPRINTF(("DMAComponentAccess::AccessComponent BEGIN size %d access %s ring %d\n", data_size,
+                 (access == MCC_READ_COMP) ? "READ" : "WRITE", _ringDepth));
         mcddReg accessData;
-        mtcr_page_addresses page = _allocatedListVect[CurrentPage];
-        mtcr_page_addresses mailboxPage = _allocatedListVect[FMPT_MAILBOX_PAGE];
-        // tools_open_mcdd_descriptor* mailboxVirtPtr = (tools_open_mcdd_descriptor*)mailboxPage.va;
-        int maxDataSize = data_size > PAGE_SIZE ? PAGE_SIZE : data_size;
+        mtcr_page_addresses mailboxPage = _allocatedListVect[_ringDepth];
         memset(&accessData, 0, TOOLS_OPEN_MCDD_REG_SIZE);
 
         if (access == MCC_READ_COMP)
         {
             memset(data, 0, data_size);
         }
-        prepareParameters(updateHandle, &accessData, offset + (data_size - leftSize), data, data_size, access, leftSize,
-                          page, mailboxPage);
-        int nIteration = 0;
-        while (leftSize > 0)
+
+        // Chunk i uses data page i % _ringDepth. While chunk i is in flight, the pages of the next chunks are filled
+        // (write), or the page of chunk i - 1 is copied out (read).
+        u_int32_t numChunks = (data_size + PAGE_SIZE - 1) / PAGE_SIZE;
+        u_int32_t filledChunks = 0;
+        int pendingReadChunk = -1;
+        u_int64_t accessStart = dmaNowUsecs();
+        u_int64_t transferUsecsSum = 0; // register access until the mailbox reports completion
+        u_int64_t maxTransferUsecs = 0;
+        u_int64_t pageCopyUsecs = 0; // filling or draining data pages while a transfer is in flight
+        for (u_int32_t chunk = 0; chunk < numChunks; chunk++)
         {
-            DPRINTF(("0x%x bytes left to %s\n", leftSize, access == MCC_READ_COMP ? "read" : "burn"));
+            u_int32_t chunkOffset = chunk * PAGE_SIZE;
+            u_int32_t chunkSize = data_size - chunkOffset > PAGE_SIZE ? PAGE_SIZE : data_size - chunkOffset;
+            mtcr_page_addresses page = _allocatedListVect[chunk % _ringDepth];
+            DPRINTF(("0x%x bytes left to %s\n", data_size - chunkOffset, access == MCC_READ_COMP ? "read" : "burn"));
+            if (access == MCC_WRITE_COMP && filledChunks <= chunk)
+            {
+                writeToDataPage(page, data + chunkOffset / 4, chunkSize);
+                filledChunks = chunk + 1;
+            }
+            prepareParameters(updateHandle, &accessData, offset + chunkOffset, chunkSize, page, mailboxPage);
             memset((u_int8_t*)mailboxPage.virtual_address, 0, TOOLS_OPEN_MCDD_DESCRIPTOR_SIZE);
             memset(&mailboxVirtPtr_1, 0, TOOLS_OPEN_MCDD_DESCRIPTOR_SIZE); // set zero before each transaction
-            maxDataSize = leftSize > PAGE_SIZE ? PAGE_SIZE : leftSize;
             mft_signal_set_handling(1);
 
+            u_int64_t transferStart = dmaNowUsecs();
             reg_access_status_t rc = reg_access_mcdd(
               _mf, (access == MCC_READ_COMP) ? REG_ACCESS_METHOD_GET : REG_ACCESS_METHOD_SET, &accessData);
             _manager->deal_with_signal();
@@ -276,64 +342,30 @@ bool DMAComponentAccess::accessComponent(u_int32_t updateHandle,
                 return false;
             }
 
-            // if we write a data, meawhile use a time for prepare next data page
+            // Use the transfer time to prepare the next data pages / drain the previous one
+            u_int64_t copyStart = dmaNowUsecs();
             if (access == MCC_WRITE_COMP)
             {
-                leftSize -= maxDataSize;
-                if (leftSize > 0)
+                while (filledChunks < numChunks && filledChunks < chunk + _ringDepth)
                 {
-                    if (FMPT_FIRST_PAGE == CurrentPage)
-                        CurrentPage = FMPT_SECOND_PAGE;
-                    else
-                        CurrentPage = FMPT_FIRST_PAGE;
-
-                    page = _allocatedListVect[CurrentPage];
-                    currentOffset = offset + (data_size - leftSize);
-                    prepareParameters(updateHandle, &accessData, currentOffset, data, data_size, access, leftSize, page,
-                                      mailboxPage);
+                    u_int32_t nextOffset = filledChunks * PAGE_SIZE;
+                    u_int32_t nextSize = data_size - nextOffset > PAGE_SIZE ? PAGE_SIZE : data_size - nextOffset;
+                    writeToDataPage(_allocatedListVect[filledChunks % _ringDepth], data + nextOffset / 4, nextSize);
+                    filledChunks++;
                 }
             }
-
-            // This is because the FW will change the status from 0 to BUSY, when it starts the reading/writing
-            // operation. meanwhile, the SW has to wait until FW is really starting. It's possible, though, that we will
-            // not enter to this loop at all or only sometimes.
-            tools_open_mcdd_descriptor_unpack(&mailboxVirtPtr_1, (const u_int8_t*)mailboxPage.virtual_address);
-            DPRINTF(("AccessComponent1 status %d err %d reserved3 %d\n", mailboxVirtPtr_1.status,
-                     mailboxVirtPtr_1.error, mailboxVirtPtr_1.reserved3));
-            nMaximumSleepTime = 0;
-            while (mailboxVirtPtr_1.status == FFS_FW_UNKNOWN)
+            else if (pendingReadChunk >= 0)
             {
-                msleep(TIMETOSLEEP);
-                tools_open_mcdd_descriptor_unpack(&mailboxVirtPtr_1, (const u_int8_t*)mailboxPage.virtual_address);
-                nMaximumSleepTime += TIMETOSLEEP;
-                if (nMaximumSleepTime >= MAXIMUM_SLEEP_TIME_MS)
-                {
-                    setLastError(FWCOMPS_ABORTED);
-                    return false;
-                }
+                u_int32_t prevOffset = pendingReadChunk * PAGE_SIZE;
+                readFromDataPage(_allocatedListVect[pendingReadChunk % _ringDepth], data + prevOffset / 4, PAGE_SIZE);
+                pendingReadChunk = -1;
             }
+            pageCopyUsecs += dmaNowUsecs() - copyStart;
 
-            // here the FW started to work
-            msleep(TIMETOSLEEP);
-            tools_open_mcdd_descriptor_unpack(&mailboxVirtPtr_1, (const u_int8_t*)mailboxPage.virtual_address);
-            DPRINTF(("AccessComponent2 status %d err %d reserved3 %d\n", mailboxVirtPtr_1.status,
-                     mailboxVirtPtr_1.error, mailboxVirtPtr_1.reserved3));
-
-            nMaximumSleepTime = 0;
-            while (mailboxVirtPtr_1.status == FFS_FW_BUSY)
+            if (!waitForMailbox(mailboxPage, &mailboxVirtPtr_1))
             {
-                msleep(TIMETOSLEEP);
-                tools_open_mcdd_descriptor_unpack(&mailboxVirtPtr_1, (const u_int8_t*)mailboxPage.virtual_address);
-                nMaximumSleepTime += TIMETOSLEEP;
-                if (nMaximumSleepTime >= MAXIMUM_SLEEP_TIME_MS)
-                {
-                    setLastError(FWCOMPS_ABORTED);
-                    return false;
-                }
+                return false;
             }
-            tools_open_mcdd_descriptor_unpack(&mailboxVirtPtr_1, (const u_int8_t*)mailboxPage.virtual_address);
-            DPRINTF(("AccessComponent3 status %d err %d reserved3 %d\n", mailboxVirtPtr_1.status,
-                     mailboxVirtPtr_1.error, mailboxVirtPtr_1.reserved3));
 
             if (mailboxVirtPtr_1.status == FFS_FW_ERROR)
             {
@@ -346,23 +378,23 @@ bool DMAComponentAccess::accessComponent(u_int32_t updateHandle,
                 return false;
             }
 
-            // read the data from FW (from page.virtual_address -> to 'data' array)
+            u_int64_t transferUsecs = dmaNowUsecs() - transferStart;
+            transferUsecsSum += transferUsecs;
+            if (transferUsecs > maxTransferUsecs)
+            {
+                maxTransferUsecs = transferUsecs;
+            }
+            DPRINTF(("MCDD transfer %u: page %u, 0x%x bytes, %llu usecs\n", chunk, chunk % _ringDepth, chunkSize,
+                     (unsigned long long)transferUsecs));
+
+            // the FW wrote the data to the page, it is copied to 'data' while the next chunk is in flight
             if (access == MCC_READ_COMP)
             {
-                DPRINTF(("READ mailboxVirtPtr->status = %d\r\n", mailboxVirtPtr_1.status));
-                readFromDataPage(&accessData, page, data, data_size, leftSize);
-                leftSize -= maxDataSize;
-                if (leftSize > 0)
-                {
-                    CurrentPage == FMPT_FIRST_PAGE ? CurrentPage = FMPT_SECOND_PAGE : CurrentPage = FMPT_FIRST_PAGE;
-                    page = _allocatedListVect[CurrentPage]; // change the page
-                    prepareParameters(updateHandle, &accessData, offset + (data_size - leftSize), data, data_size,
-                                      access, leftSize, page, mailboxPage);
-                    // prepare auxilary data for next iteration
-                }
+                pendingReadChunk = chunk;
             }
-            nIteration++;
-            int newPercentage = (((data_size - leftSize) * 100) / data_size);
+
+            u_int32_t doneSize = chunkOffset + chunkSize;
+            int newPercentage = (int)(((u_int64_t)doneSize * 100) / data_size);
 #ifdef UEFI_BUILD
             if (newPercentage > progressPercentage && progressFuncAdv && progressFuncAdv->uefi_func)
             {
@@ -385,6 +417,12 @@ bool DMAComponentAccess::accessComponent(u_int32_t updateHandle,
         }
 #endif
         }
+        if (pendingReadChunk >= 0)
+        {
+            u_int32_t lastOffset = pendingReadChunk * PAGE_SIZE;
+            readFromDataPage(_allocatedListVect[pendingReadChunk % _ringDepth], data + lastOffset / 4,
+                             data_size - lastOffset);
+        }
 
         if (progressFuncAdv && progressFuncAdv->func)
         {
@@ -394,7 +432,13 @@ bool DMAComponentAccess::accessComponent(u_int32_t updateHandle,
                 return false;
             }
         }
-        DPRINTF(("DMAComponentAccess::AccessComponent END \n"));
+        u_int64_t accessUsecs = dmaNowUsecs() - accessStart;
+        DPRINTF(("DMAComponentAccess::AccessComponent END %u transfers, %u bytes in %llu usecs (%.2f MB/s), ring %d\n",
+                 numChunks, data_size, (unsigned long long)accessUsecs,
+                 accessUsecs ? (double)data_size / accessUsecs : 0.0, _ringDepth));
+        DPRINTF(("DMAComponentAccess::AccessComponent transfers %llu usecs (max %llu), page copies %llu usecs\n",
+                 (unsigned long long)transferUsecsSum, (unsigned long long)maxTransferUsecs,
+                 (unsigned long long)pageCopyUsecs));
         return true;
 #ifndef UEFI_BUILD
     }
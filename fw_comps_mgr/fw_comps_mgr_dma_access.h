@@ -45,11 +45,18 @@
 #include "fw_comps_mgr_abstract_access.h"
 
 typedef struct tools_open_mcdd_reg mcddReg;
+typedef struct tools_open_mcdd_descriptor mcddDescriptor;
 
 class DMAComponentAccess : public AbstractComponentAccess
 {
 public:
-    DMAComponentAccess(FwCompsMgr* Manager, mfile* Mf) : AbstractComponentAccess(Manager, Mf) {}
+    DMAComponentAccess(FwCompsMgr* Manager, mfile* Mf) :
+        AbstractComponentAccess(Manager, Mf),
+        _ringDepth(0),
+        _lastFwError(FWCOMPS_SUCCESS),
+        _lastRegisterAccessStatus(ME_OK)
+    {
+    }
     virtual ~DMAComponentAccess() {}
     virtual bool accessComponent(u_int32_t updateHandle,
                                  u_int32_t offset,
@@ -66,15 +73,16 @@ public:
 private:
     bool prepareParameters(u_int32_t _updateHandle,
                            mcddReg* accessData,
-                           int offset,
-                           u_int32_t* data,
-                           int data_size,
-                           int access,
-                           int leftSize,
+                           u_int32_t offset,
+                           u_int32_t size,
                            mtcr_page_addresses page,
                            mtcr_page_addresses mailbox_page);
-    bool readFromDataPage(mcddReg* accessData, mtcr_page_addresses page, u_int32_t* data, int data_size, int leftSize);
+    void writeToDataPage(mtcr_page_addresses page, const u_int32_t* data, u_int32_t size);
+    void readFromDataPage(mtcr_page_addresses page, u_int32_t* data, u_int32_t size);
+    bool waitForMailbox(mtcr_page_addresses mailbox_page, mcddDescriptor* mailbox);
+    // Data pages form a ring of _ringDepth pages, the mailbox page follows them
     std::vector<mtcr_page_addresses> _allocatedListVect;
+    int _ringDepth;
     fw_comps_error_t _lastFwError;
     reg_access_status_t _lastRegisterAccessStatus;
     void setLastError(fw_comps_error_t error) { _lastFwError = error; }
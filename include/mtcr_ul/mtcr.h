@@ -148,6 +148,11 @@ extern "C"
 
     int icmd_clear_semaphore(mfile* mf);
 
+    /* Hold the ICMD semaphore across a batch of commands, see mtcr_icmd_cif.h */
+    int icmd_session_open(mfile* mf);
+
+    int icmd_session_close(mfile* mf);
+
     int tools_cmdif_send_inline_cmd(mfile* mf,
                                     u_int64_t in_param,
                                     u_int64_t* out_param,
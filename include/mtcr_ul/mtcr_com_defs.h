@@ -429,6 +429,12 @@ typedef struct icmd_params_t
     u_int32_t dma_size;
     int dma_icmd;
     mtcr_status_e icmd_ready;
+    /* icmd_session_open/close */
+    int session_open;
+    u_int32_t session_cmds;
+    u_int64_t session_usecs;
+    u_int32_t poll_hint_usecs; // learned completion time, paces the busy-bit polling inside a session
+    u_int32_t semaphore_key;   // written to the VSEC semaphore to take it, unique per handle
 } icmd_params;
 
 typedef struct ctx_params_t
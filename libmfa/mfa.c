@@ -40,6 +40,18 @@
 #include <errno.h>
 #include <string.h>
 #include <compatibility.h>
+#ifndef _MSC_VER
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if defined(__linux__)
+#include <sys/vfs.h>
+#elif defined(__FreeBSD__)
+#include <sys/param.h>
+#include <sys/mount.h>
+#endif
+#endif
 
 //                                         0x(major)(minor)
 //                           0x00000001;  #0x(0000)(0001)
@@ -73,6 +85,8 @@ struct mfa_desc
     u_int8_t* map;
     u_int8_t* toc;
     u_int8_t* data_ptr;
+    mfasec_data_reader* data_reader; // Opened on the first image extraction
+    int crc_verified;                // The archive CRC is checked before the first image extraction unless strict
     int open_method;
     char err_str[256];
 };
@@ -80,7 +94,8 @@ struct mfa_desc
 enum mfa_open_methods
 {
     MFA_OPEN_BUF,
-    MFA_OPEN_FILE
+    MFA_OPEN_FILE,
+    MFA_OPEN_MMAP
 };
 
 enum header_types
@@ -89,12 +104,15 @@ enum header_types
     PSID_HEADER
 };
 
-int mfa_verify_archive(u_int8_t* buf, long sz);
+int mfa_verify_header(u_int8_t* buf, long sz);
+int mfa_verify_crc(u_int8_t* buf, long sz);
+int mfa_verify_sections(u_int8_t* buf, long sz);
 int mfa_read_map(mfa_desc* mfa_d);
 int parse_section_header(char* buf, int len, int* header_type, int* nrecs);
 int mfa_read_toc(struct mfa_desc* mfa_d);
+int mfa_verify_map_toc(struct mfa_desc* mfa_d);
 
-static int _mfa_open_buf(mfa_desc** mfa_d, u_int8_t* arbuf, int size)
+static int _mfa_open_buf(mfa_desc** mfa_d, u_int8_t* arbuf, int size, int flags)
 {
     int res = 0;
 
@@ -105,7 +123,19 @@ static int _mfa_open_buf(mfa_desc** mfa_d, u_int8_t* arbuf, int size)
     }
     memset(*mfa_d, 0, sizeof(mfa_desc));
 
-    if ((res = mfa_verify_archive(arbuf, size)))
+    if ((res = mfa_verify_header(arbuf, size)))
+    {
+        goto clean_up;
+    }
+    if (flags & MFA_OPEN_STRICT)
+    {
+        if ((res = mfa_verify_crc(arbuf, size)))
+        {
+            goto clean_up;
+        }
+        (*mfa_d)->crc_verified = 1;
+    }
+    if ((res = mfa_verify_sections(arbuf, size)))
     {
         goto clean_up;
     }
@@ -121,9 +151,15 @@ static int _mfa_open_buf(mfa_desc** mfa_d, u_int8_t* arbuf, int size)
     {
         goto clean_up_map;
     }
+    if ((res = mfa_verify_map_toc(*mfa_d)))
+    {
+        goto clean_up_toc;
+    }
 
     return MFA_OK;
 
+clean_up_toc:
+    free((*mfa_d)->toc);
 clean_up_map:
     free((*mfa_d)->map);
 clean_up:
@@ -140,7 +176,7 @@ int mfa_open_buf(mfa_desc** mfa_d, u_int8_t* arbuf, int size)
 {
     int res;
 
-    res = _mfa_open_buf(mfa_d, arbuf, size);
+    res = _mfa_open_buf(mfa_d, arbuf, size, MFA_OPEN_STRICT);
     if (res == MFA_OK)
     {
         (*mfa_d)->open_method = MFA_OPEN_BUF;
@@ -148,7 +184,7 @@ int mfa_open_buf(mfa_desc** mfa_d, u_int8_t* arbuf, int size)
     return res;
 }
 
-int mfa_open_file(mfa_desc** mfa_d, char* fname)
+static int _mfa_open_file_read(mfa_desc** mfa_d, char* fname, int flags)
 {
     int res = MFA_OK;
     FILE* fp;
@@ -189,7 +225,7 @@ int mfa_open_file(mfa_desc** mfa_d, char* fname)
         goto err_clean_up;
     }
 
-    if ((res = _mfa_open_buf(mfa_d, buf, fsize)) != MFA_OK)
+    if ((res = _mfa_open_buf(mfa_d, buf, fsize, flags)) != MFA_OK)
     {
         goto err_clean_up;
     }
@@ -208,6 +244,98 @@ err_clean_up:
     return res;
 }
 
+#ifndef _MSC_VER
+// A mapped file that is truncated or replaced in place raises SIGBUS on access instead of a read error. Other
+// clients can do that behind our back on a network file system, so such files are read into memory instead.
+static int mfa_is_local_file(int fd)
+{
+#if defined(__linux__)
+    struct statfs sfs;
+
+    if (fstatfs(fd, &sfs))
+    {
+        return 0;
+    }
+    switch ((unsigned long)sfs.f_type)
+    {
+        case 0x6969:     // NFS
+        case 0x517B:     // SMB
+        case 0xFF534D42: // CIFS
+        case 0xFE534D42: // SMB2
+        case 0x65735546: // FUSE (sshfs and the like)
+        case 0x00C36400: // Ceph
+        case 0x01021997: // 9P
+        case 0x5346414F: // AFS
+        case 0x73757245: // Coda
+            return 0;
+        default:
+            return 1;
+    }
+#elif defined(__FreeBSD__)
+    struct statfs sfs;
+
+    if (fstatfs(fd, &sfs))
+    {
+        return 0;
+    }
+    return (sfs.f_flags & MNT_LOCAL) != 0;
+#else
+    (void)fd;
+    return 1;
+#endif
+}
+#endif
+
+int mfa_open_file_ex(mfa_desc** mfa_d, char* fname, int flags)
+{
+#ifdef _MSC_VER
+    return _mfa_open_file_read(mfa_d, fname, flags);
+#else
+    int res;
+    int fd;
+    struct stat st;
+    void* buf;
+
+    if ((fd = open(fname, O_RDONLY)) < 0)
+    {
+        return _ERR(MFA_ERR_FILE_OPEN);
+    }
+    if (fstat(fd, &st) || !S_ISREG(st.st_mode) || !mfa_is_local_file(fd))
+    {
+        // Not something that can be mapped safely (e.g. a pipe or an NFS file), read it instead
+        close(fd);
+        return _mfa_open_file_read(mfa_d, fname, flags);
+    }
+    if (st.st_size <= 0)
+    {
+        close(fd);
+        return _ERR(MFA_ERR_FTELL);
+    }
+
+    // Only the pages that are used get read, so querying the map and TOC does not read the image data
+    buf = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (buf == MAP_FAILED)
+    {
+        return _ERR(MFA_ERR_FILE_READ);
+    }
+
+    if ((res = _mfa_open_buf(mfa_d, (u_int8_t*)buf, st.st_size, flags)) != MFA_OK)
+    {
+        munmap(buf, st.st_size);
+        return res;
+    }
+    (*mfa_d)->open_method = MFA_OPEN_MMAP;
+
+    return MFA_OK;
+#endif
+}
+
+int mfa_open_file(mfa_desc** mfa_d, char* fname)
+{
+    return mfa_open_file_ex(mfa_d, fname, 0);
+}
+
 int mfa_close(struct mfa_desc* mfa_d)
 {
     if (mfa_d->map != NULL)
@@ -220,20 +348,26 @@ int mfa_close(struct mfa_desc* mfa_d)
         free(mfa_d->buffer);
         mfa_d->buffer = NULL;
     }
+#ifndef _MSC_VER
+    else if (mfa_d->open_method == MFA_OPEN_MMAP)
+    {
+        munmap(mfa_d->buffer, mfa_d->bufsz);
+        mfa_d->buffer = NULL;
+    }
+#endif
     if (mfa_d->toc != NULL)
     {
         free(mfa_d->toc);
         mfa_d->toc = NULL;
     }
+    mfasec_close_data_reader(mfa_d->data_reader);
     free(mfa_d);
     return MFA_OK;
 }
 
-int mfa_verify_archive(u_int8_t* buf, long sz)
+int mfa_verify_header(u_int8_t* buf, long sz)
 {
     int i;
-    u_int32_t crc;
-    u_int32_t ar_crc;
     u_int32_t ver;
     u_int32_t major;
     u_int32_t minor;
@@ -267,6 +401,14 @@ int mfa_verify_archive(u_int8_t* buf, long sz)
         return _ERR(MFA_ERR_ARCHV_VER_UNSUPP);
     }
 
+    return MFA_OK;
+}
+
+int mfa_verify_crc(u_int8_t* buf, long sz)
+{
+    u_int32_t crc;
+    u_int32_t ar_crc;
+
     // Archive CRC
     ar_crc = *((u_int32_t*)&buf[sz - 4]);
     ar_crc = __be32_to_cpu(ar_crc);
@@ -281,6 +423,30 @@ int mfa_verify_archive(u_int8_t* buf, long sz)
     return MFA_OK;
 }
 
+// Checks that the map, TOC and data sections lie within the archive, before the CRC that covers them is verified
+int mfa_verify_sections(u_int8_t* buf, long sz)
+{
+    long pos = MAP_SECTION_OFFSET;
+    long end = sz - 4; // Archive CRC
+    int i;
+
+    for (i = MFA_MAP_SECTION; i < MFA_NUM_SECTIONS; i++)
+    {
+        if (pos + (long)sizeof(section_hdr) > end)
+        {
+            return _ERR(MFA_ERR_ARCHV_FORMAT);
+        }
+        section_hdr* hdr = (section_hdr*)&buf[pos];
+        pos += sizeof(section_hdr) + (long)__be32_to_cpu(hdr->size);
+        if (pos > end)
+        {
+            return _ERR(MFA_ERR_ARCHV_FORMAT);
+        }
+    }
+
+    return MFA_OK;
+}
+
 int mfa_get_crc32(u_int8_t* arbuf, long sz, u_int32_t* ar_crc, u_int32_t* calc_crc)
 {
     *ar_crc = *((u_int32_t*)&arbuf[sz - 4]);
@@ -293,7 +459,7 @@ int mfa_get_crc32(u_int8_t* arbuf, long sz, u_int32_t* ar_crc, u_int32_t* calc_c
 
 int mfa_read_map(struct mfa_desc* mfa_d)
 {
-    u_int8_t* buf;
+    u_int8_t* buf = NULL;
     int res;
 
     section_hdr* map_hdr = (section_hdr*)&mfa_d->buffer[MAP_SECTION_OFFSET];
@@ -316,7 +482,7 @@ clean_up:
 
 int mfa_read_toc(struct mfa_desc* mfa_d)
 {
-    u_int8_t* buf;
+    u_int8_t* buf = NULL;
     int res;
 
     section_hdr* map_hdr = (section_hdr*)&mfa_d->buffer[MAP_SECTION_OFFSET];
@@ -341,6 +507,84 @@ clean_up:
     return res;
 }
 
+static int mfa_verify_metadata(map_entry_hdr* me)
+{
+    char* ptr = (char*)me + sizeof(map_entry_hdr);
+    char* end = ptr + me->metadata_size;
+    metadata_hdr* md_hdr = (metadata_hdr*)ptr;
+    char* nul;
+    int i;
+
+    // mfasec_get_map already checked that a non-empty metadata holds at least its header
+    if (me->metadata_size == 0 || md_hdr->type != MDT_KEY_VALUE_PAIR)
+    {
+        return MFA_OK;
+    }
+    ptr += sizeof(metadata_hdr);
+    for (i = 0; i < 2 * md_hdr->modifier; i++)
+    {
+        nul = (char*)memchr(ptr, 0, end - ptr);
+        if (nul == NULL)
+        {
+            return _ERR(MFA_ERR_ARCHV_FORMAT);
+        }
+        ptr = nul + 1;
+    }
+
+    return MFA_OK;
+}
+
+// The map and TOC are used as soon as the archive is open, while the CRC that covers them is only checked before the
+// first image is extracted. Check every string, TOC offset and data range they hold against the section it points into.
+int mfa_verify_map_toc(struct mfa_desc* mfa_d)
+{
+    section_hdr* map_hdr = (section_hdr*)mfa_d->map;
+    section_hdr* toc_hdr = (section_hdr*)mfa_d->toc;
+    u_int8_t* crc_ptr = mfa_d->buffer + mfa_d->bufsz - 4;
+    ssize_t toc_total = sizeof(section_hdr) + toc_hdr->size;
+    ssize_t map_total = sizeof(section_hdr) + map_hdr->size;
+    ssize_t data_len;
+    ssize_t pos;
+    int i;
+
+    data_len = mfasec_get_data_len(mfa_d->data_ptr, crc_ptr - mfa_d->data_ptr);
+    CHECK_RC(data_len);
+
+    // mfasec_get_toc checked that the entries and their metadata fill the TOC exactly
+    for (pos = sizeof(section_hdr); pos < toc_total;)
+    {
+        toc_entry* toc_e = (toc_entry*)&mfa_d->toc[pos];
+        u_int64_t data_offset = ((u_int64_t)toc_e->data_offset_msb << 32) + toc_e->data_offset;
+        if (data_offset + toc_e->data_size > (u_int64_t)data_len)
+        {
+            return _ERR(MFA_ERR_ARCHV_FORMAT);
+        }
+        pos += sizeof(toc_entry) + toc_e->metadata_size;
+    }
+
+    // mfasec_get_map checked that each entry's header, metadata and images lie within the map
+    for (pos = sizeof(section_hdr); pos < map_total;)
+    {
+        map_entry_hdr* map_entry = (map_entry_hdr*)&mfa_d->map[pos];
+        if (memchr(map_entry->board_type_id, 0, sizeof(map_entry->board_type_id)) == NULL)
+        {
+            return _ERR(MFA_ERR_ARCHV_FORMAT);
+        }
+        CHECK_RC(mfa_verify_metadata(map_entry));
+        for (i = 0; i < map_entry->nimages; i++)
+        {
+            map_image_entry* img_e = mfa_get_map_image(map_entry, i);
+            if ((ssize_t)(img_e->toc_offset + sizeof(section_hdr) + sizeof(toc_entry)) > toc_total)
+            {
+                return _ERR(MFA_ERR_ARCHV_FORMAT);
+            }
+        }
+        pos += sizeof(map_entry_hdr) + map_entry->metadata_size + map_entry->nimages * sizeof(map_image_entry);
+    }
+
+    return MFA_OK;
+}
+
 int mfa_map_get_num_images(map_entry_hdr* me)
 {
     return me->nimages;
@@ -414,7 +658,10 @@ map_entry_hdr* mfa_get_next_mentry(mfa_desc* mfa_d, map_entry_hdr* curr_me)
     if (curr_me == NULL)
     {
         pos = sizeof(section_hdr);
-        next_me = (map_entry_hdr*)&map[pos];
+        if (pos < total)
+        {
+            next_me = (map_entry_hdr*)&map[pos];
+        }
         return next_me;
     }
 
@@ -458,6 +705,10 @@ char* mfa_get_map_entry_metadata(map_entry_hdr* map_entry, char* key)
     }
 
     count = md_hdr->modifier;
+    if (count == 0)
+    {
+        return NULL;
+    }
 
     for (i = 0; i < count; i++)
     {
@@ -503,6 +754,15 @@ ssize_t mfa_get_image(mfa_desc* mfa_d, char* board_type_id, u_int8_t type, char*
     }
 
     *buffer = NULL;
+    // Nothing is allocated from the TOC sizes before the archive is known to be intact
+    if (!mfa_d->crc_verified)
+    {
+        if (mfa_verify_crc(mfa_d->buffer, mfa_d->bufsz))
+        {
+            return _ERR_STR(mfa_d, MFA_ERR_ARCHV_CRC, "Archive CRC check failed");
+        }
+        mfa_d->crc_verified = 1;
+    }
     int n = mfa_map_get_num_images(map_entry);
     ssize_t total_size = 0;
 
@@ -567,6 +827,17 @@ ssize_t mfa_get_image(mfa_desc* mfa_d, char* board_type_id, u_int8_t type, char*
         memset(*buffer, 0, total_size * sizeof(u_int8_t));
     }
 
+    if (mfa_d->data_reader == NULL)
+    {
+        int rc = mfasec_open_data_reader(&mfa_d->data_reader, mfa_d->data_ptr,
+                                         (mfa_d->buffer + mfa_d->bufsz) - mfa_d->data_ptr);
+        if (rc < 0)
+        {
+            res = _ERR_STR(mfa_d, -rc, "Failed to get image");
+            goto img_alloc_clean_up;
+        }
+    }
+
     accum_size = 0;
     for (i = 0; i < toce_num; i++)
     {
@@ -579,8 +850,8 @@ ssize_t mfa_get_image(mfa_desc* mfa_d, char* board_type_id, u_int8_t type, char*
         u_int64_t data_offset = toce_ar[i]->data_offset_msb;
         data_offset = data_offset << 32;
         data_offset += toce_ar[i]->data_offset;
-        int rc = mfasec_get_data_chunk(mfa_d->data_ptr, (mfa_d->buffer + mfa_d->bufsz) - mfa_d->data_ptr, data_offset,
-                                       toce_ar[i]->data_size, &((*buffer)[accum_size]));
+        int rc = mfasec_read_data_chunk(mfa_d->data_reader, data_offset, toce_ar[i]->data_size,
+                                        &((*buffer)[accum_size]));
         if (rc < 0)
         {
             res = _ERR_STR(mfa_d, -rc, "Failed to get image");
@@ -49,11 +49,21 @@ extern "C"
         MFA_EXPROM_IMAGE = 2
     };
 
+    enum mfa_open_flags
+    {
+        // Verify the archive CRC on open. Otherwise only the header, the section bounds and the offsets held in the
+        // map and TOC are checked on open, and the CRC is verified before the first image is extracted.
+        MFA_OPEN_STRICT = 1
+    };
+
     typedef struct mfa_desc mfa_desc;
 
     void mfa_init(); // Must be called before any MFA function to perform one time initializations
     int mfa_open_buf(mfa_desc**, u_int8_t* arbuf, int size);
+    // Local regular files are mapped rather than read. Truncating or rewriting such a file in place while it is
+    // open raises SIGBUS; replace it by renaming a new file over it instead.
     int mfa_open_file(mfa_desc**, char* fname);
+    int mfa_open_file_ex(mfa_desc**, char* fname, int flags);
     int mfa_close(mfa_desc* mfa_d);
     ssize_t mfa_get_image(mfa_desc* mfa_d, char* board_type_id, u_int8_t type, char* selector_tag, u_int8_t** buffer);
     char* mfa_get_board_metadata(mfa_desc* mfa_d, char* board_type_id, char* key);
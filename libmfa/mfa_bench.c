@@ -0,0 +1,381 @@
+/*
+ * Copyright (C) Jan 2006 Mellanox Technologies Ltd. All rights reserved.
+ * Copyright (c) 2021 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+/*
+ * Full archive walk over a synthetic MFA: every board image is extracted in archive order through one descriptor,
+ * as a bundle inventory does. The archive has a single xz compressed data section holding one FW image per board.
+ * With -q the archive is only queried instead, as a PSID listing does (board entries and image TOCs), from a cold
+ * page cache and in a process of its own per open mode, to report the latency and peak RSS of the open.
+ *
+ * Usage: mfa_bench [-i iterations] [-n images] [-s image_size_kb] [-q]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <lzma.h>
+#include <compatibility.h>
+#include <common/tools_bench.h>
+#include "mfa.h"
+#include "mfa_section.h"
+
+#define MFA_HDR_SZ 16
+
+static void fill_image(u_int8_t* buf, size_t size, int index)
+{
+    u_int32_t seed = 0x9e3779b9 * (index + 1);
+    size_t i;
+    for (i = 0; i < size; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        buf[i] = (u_int8_t)(((seed >> 24) & 0x0f) | ((i >> 10) & 0xf0));
+    }
+}
+
+static void put_be32(u_int8_t* p, u_int32_t v)
+{
+    v = __cpu_to_be32(v);
+    memcpy(p, &v, 4);
+}
+
+static void put_be16(u_int8_t* p, u_int16_t v)
+{
+    v = __cpu_to_be16(v);
+    memcpy(p, &v, 2);
+}
+
+static void put_section_hdr(u_int8_t* p, u_int8_t type, u_int8_t flags, u_int32_t size)
+{
+    section_hdr hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.type = type;
+    hdr.flags = flags;
+    memcpy(p, &hdr, sizeof(hdr));
+    put_be32(p + 4, size);
+}
+
+// Writes the archive to fname, returns its size or -1
+static long build_archive(const char* fname, int num_images, size_t image_size)
+{
+    size_t map_size = num_images * (sizeof(map_entry_hdr) + sizeof(map_image_entry));
+    size_t toc_size = num_images * sizeof(toc_entry);
+    size_t data_size = num_images * image_size;
+    u_int8_t* data = (u_int8_t*)malloc(data_size);
+    size_t xz_bound = lzma_stream_buffer_bound(data_size);
+    size_t total = MFA_HDR_SZ + 3 * sizeof(section_hdr) + map_size + toc_size + xz_bound + 4;
+    u_int8_t* ar = (u_int8_t*)calloc(1, total);
+    size_t xz_size = 0;
+    u_int8_t* p;
+    int i;
+
+    if (data == NULL || ar == NULL)
+    {
+        return -1;
+    }
+    for (i = 0; i < num_images; i++)
+    {
+        fill_image(data + i * image_size, image_size, i);
+    }
+
+    memcpy(ar, "MFAR", 4);
+    put_be32(ar + 4, 0x00000001);
+
+    p = ar + MFA_HDR_SZ;
+    put_section_hdr(p, MFA_MAP_SECTION, 0, map_size);
+    p += sizeof(section_hdr);
+    for (i = 0; i < num_images; i++)
+    {
+        map_entry_hdr* me = (map_entry_hdr*)p;
+        map_image_entry* img = (map_image_entry*)(p + sizeof(map_entry_hdr));
+        snprintf(me->board_type_id, sizeof(me->board_type_id), "BENCH%08d", i);
+        me->nimages = 1;
+        put_be32((u_int8_t*)&img->toc_offset, i * sizeof(toc_entry));
+        put_be16((u_int8_t*)&img->image_type, MFA_FW_IMAGE);
+        img->group_id = 1;
+        p += sizeof(map_entry_hdr) + sizeof(map_image_entry);
+    }
+
+    put_section_hdr(p, MFA_TOC_SECTION, 0, toc_size);
+    p += sizeof(section_hdr);
+    for (i = 0; i < num_images; i++)
+    {
+        toc_entry* toc = (toc_entry*)p;
+        u_int64_t offset = (u_int64_t)i * image_size;
+        put_be32((u_int8_t*)&toc->data_offset, (u_int32_t)offset);
+        put_be16((u_int8_t*)&toc->data_offset_msb, (u_int16_t)(offset >> 32));
+        put_be32((u_int8_t*)&toc->data_size, image_size);
+        put_be16((u_int8_t*)&toc->subimage_type, SIT_FW);
+        p += sizeof(toc_entry);
+    }
+
+    u_int8_t* data_hdr = p;
+    p += sizeof(section_hdr);
+    if (lzma_easy_buffer_encode(6, LZMA_CHECK_CRC32, NULL, data, data_size, p, &xz_size, xz_bound) != LZMA_OK)
+    {
+        return -1;
+    }
+    put_section_hdr(data_hdr, MFA_DATA_SECTION, SFLAG_XZ_COMPRESSED, xz_size);
+    p += xz_size;
+
+    put_be32(p, mfasec_crc32(ar, p - ar, 0));
+    p += 4;
+
+    long ar_size = p - ar;
+    FILE* fp = fopen(fname, "wb");
+    if (fp == NULL || fwrite(ar, 1, ar_size, fp) != (size_t)ar_size)
+    {
+        ar_size = -1;
+    }
+    if (fp != NULL)
+    {
+        fclose(fp);
+    }
+    free(ar);
+    free(data);
+    return ar_size;
+}
+
+// Extracts every board image in archive order, returns the number of bytes extracted or -1
+static ssize_t walk_archive(char* fname, size_t image_size, u_int32_t* crc)
+{
+    mfa_desc* md;
+    map_entry_hdr* me = NULL;
+    u_int8_t* expected = (u_int8_t*)malloc(image_size);
+    ssize_t total = 0;
+    int i = 0;
+
+    if (expected == NULL || mfa_open_file(&md, fname))
+    {
+        free(expected);
+        return -1;
+    }
+    while ((me = mfa_get_next_mentry(md, me)) != NULL)
+    {
+        u_int8_t* img = NULL;
+        char psid[33];
+        strncpy(psid, me->board_type_id, 32);
+        psid[32] = '\0';
+        ssize_t sz = mfa_get_image(md, psid, MFA_FW_IMAGE, NULL, &img);
+        if (sz != (ssize_t)image_size)
+        {
+            fprintf(stderr, "-E- %s: %s\n", psid, sz < 0 ? mfa_get_last_error(md) : "wrong image size");
+            total = -1;
+            break;
+        }
+        fill_image(expected, image_size, i++);
+        if (memcmp(img, expected, image_size))
+        {
+            fprintf(stderr, "-E- %s: image data mismatch\n", psid);
+            total = -1;
+        }
+        *crc = mfasec_crc32(img, sz, *crc);
+        mfa_release_image(img);
+        if (total < 0)
+        {
+            break;
+        }
+        total += sz;
+    }
+    mfa_close(md);
+    free(expected);
+    return total;
+}
+
+// Drops the archive from the page cache so that the next open reads it from the disk
+static void evict_file(const char* fname)
+{
+    int fd = open(fname, O_RDONLY);
+    if (fd < 0)
+    {
+        return;
+    }
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+// Reads what a PSID listing reads, returns the number of images seen or -1
+static int query_archive(char* fname, int flags, u_int32_t* versions)
+{
+    mfa_desc* md;
+    map_entry_hdr* me = NULL;
+    int num_images = 0;
+    int i;
+
+    if (mfa_open_file_ex(&md, fname, flags))
+    {
+        return -1;
+    }
+    while ((me = mfa_get_next_mentry(md, me)) != NULL)
+    {
+        char* pn = mfa_get_map_entry_metadata(me, (char*)"PN");
+        free(pn);
+        for (i = 0; i < me->nimages; i++)
+        {
+            toc_entry* toc = mfa_get_image_toc(md, mfa_get_map_image(me, i));
+            *versions += toc->num_ver_fields + toc->subimage_type;
+            num_images++;
+        }
+    }
+    mfa_close(md);
+    return num_images;
+}
+
+static void run_query(const char* name, char* fname, int flags, int iterations)
+{
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        perror("fork");
+        exit(1);
+    }
+    if (pid == 0)
+    {
+        u_int32_t versions = 0;
+        int num_images = 0;
+        double secs = 0;
+        int i;
+        for (i = 0; i < iterations && num_images >= 0; i++)
+        {
+            evict_file(fname);
+            double start = bench_now_secs();
+            num_images = query_archive(fname, flags, &versions);
+            secs += bench_now_secs() - start;
+        }
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        if (num_images < 0)
+        {
+            fprintf(stderr, "-E- %s: failed to open the archive\n", name);
+            exit(1);
+        }
+        printf("%-8s %6d images %10.2f msec %10.1f MB peak RSS\n", name, num_images, secs * 1000 / iterations,
+               usage.ru_maxrss / 1024.0);
+        exit(0);
+    }
+    int status = 0;
+    if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status))
+    {
+        exit(1);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int iterations = 3;
+    int num_images = 32;
+    int image_size_kb = 1024;
+    int query = 0;
+    char fname[] = "/tmp/mfa_bench_XXXXXX";
+    int opt;
+    int i;
+
+    while ((opt = getopt(argc, argv, "i:n:s:q")) != -1)
+    {
+        switch (opt)
+        {
+            case 'i':
+                iterations = atoi(optarg);
+                break;
+            case 'n':
+                num_images = atoi(optarg);
+                break;
+            case 's':
+                image_size_kb = atoi(optarg);
+                break;
+            case 'q':
+                query = 1;
+                break;
+            default:
+                return bench_usage(argv[0], "[-i iterations] [-n images] [-s image_size_kb] [-q]");
+        }
+    }
+    if (iterations <= 0 || num_images <= 0 || image_size_kb <= 0)
+    {
+        fprintf(stderr, "-E- iterations, images and image size must be positive\n");
+        return 1;
+    }
+
+    mfa_init();
+    int fd = mkstemp(fname);
+    if (fd < 0)
+    {
+        perror("mkstemp");
+        return 1;
+    }
+    close(fd);
+
+    size_t image_size = (size_t)image_size_kb * 1024;
+    long ar_size = build_archive(fname, num_images, image_size);
+    if (ar_size < 0)
+    {
+        fprintf(stderr, "-E- Failed to build the archive\n");
+        unlink(fname);
+        return 1;
+    }
+
+    printf("%d images of %d KB, archive %ld bytes\n", num_images, image_size_kb, ar_size);
+    if (query)
+    {
+        run_query("lazy", fname, 0, iterations);
+        run_query("strict", fname, MFA_OPEN_STRICT, iterations);
+        unlink(fname);
+        return 0;
+    }
+
+    u_int32_t crc = 0;
+    ssize_t extracted = 0;
+    double start = bench_now_secs();
+    for (i = 0; i < iterations && extracted >= 0; i++)
+    {
+        crc = 0;
+        extracted = walk_archive(fname, image_size, &crc);
+    }
+    double msecs = (bench_now_secs() - start) * 1000 / iterations;
+    unlink(fname);
+    if (extracted < 0)
+    {
+        return 1;
+    }
+
+    printf("full walk: %.1f msec, %.1f MB/s extracted, crc 0x%08x\n", msecs,
+           extracted / (msecs / 1000) / (1024 * 1024), crc);
+    return 0;
+}
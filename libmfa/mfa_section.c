@@ -136,24 +136,32 @@ ssize_t mfasec_get_map(u_int8_t* inbuf, size_t inbufsz, u_int8_t** outbuf)
 
     while (pos < total)
     {
+        if (pos + (ssize_t)sizeof(map_entry_hdr) > total)
+        {
+            return _ERR(MFA_ERR_ARCHV_FORMAT);
+        }
         map_entry_hdr* map_entry = (map_entry_hdr*)&((*outbuf)[pos]);
         int n = map_entry->nimages;
         map_entry->metadata_size = __be16_to_cpu(map_entry->metadata_size);
         // printf("%s %d\n", map_entry->board_type_id, n);
         pos += sizeof(map_entry_hdr);
-        if (pos >= total)
+        if (pos + map_entry->metadata_size > total)
         {
-            break;
+            return _ERR(MFA_ERR_ARCHV_FORMAT);
         }
         if (map_entry->metadata_size > 0)
         {
+            if (map_entry->metadata_size < sizeof(metadata_hdr))
+            {
+                return _ERR(MFA_ERR_ARCHV_FORMAT);
+            }
             metadata_hdr* md_hdr = (metadata_hdr*)&((*outbuf)[pos]);
             md_hdr->modifier = __be16_to_cpu(md_hdr->modifier);
         }
         pos += map_entry->metadata_size;
-        if (pos >= total)
+        if (pos + n * (ssize_t)sizeof(map_image_entry) > total)
         {
-            break;
+            return _ERR(MFA_ERR_ARCHV_FORMAT);
         }
         for (j = 0; j < n; j++)
         {
@@ -187,6 +195,10 @@ ssize_t mfasec_get_toc(u_int8_t* inbuf, size_t inbufsz, u_int8_t** outbuf)
     }
     while (pos < total)
     {
+        if (pos + (ssize_t)sizeof(toc_entry) > total)
+        {
+            return _ERR(MFA_ERR_ARCHV_FORMAT);
+        }
         toc_entry* toc_e = (toc_entry*)&((*outbuf)[pos]);
         toc_e->data_offset = __be32_to_cpu(toc_e->data_offset);
         toc_e->data_size = __be32_to_cpu(toc_e->data_size);
@@ -200,133 +212,209 @@ ssize_t mfasec_get_toc(u_int8_t* inbuf, size_t inbufsz, u_int8_t** outbuf)
         pos += sizeof(toc_entry);
         pos += toc_e->metadata_size;
     }
+    if (pos != total)
+    {
+        return _ERR(MFA_ERR_ARCHV_FORMAT);
+    }
 
     return res;
 }
 
-#define BUF_SIZE 1024
+ssize_t mfasec_get_data_len(u_int8_t* data_sec_ptr, size_t data_sec_len)
+{
+    section_hdr* hdr = (section_hdr*)data_sec_ptr;
+    size_t src_sz;
+    ssize_t sz;
+
+    if (data_sec_len < sizeof(section_hdr))
+    {
+        return _ERR(MFA_ERR_BUFF_SIZE);
+    }
+    src_sz = __be32_to_cpu(hdr->size);
+    if (src_sz > data_sec_len - sizeof(section_hdr))
+    {
+        return _ERR(MFA_ERR_BUFF_SIZE);
+    }
+    if (!(hdr->flags & SFLAG_XZ_COMPRESSED))
+    {
+        return src_sz;
+    }
+    sz = xz_stream_len(data_sec_ptr + sizeof(section_hdr), src_sz);
+    if (sz <= 0)
+    {
+        return _ERR(MFA_ERR_DECOMPRESSION);
+    }
+    return sz;
+}
+
+#define SKIP_BUF_SIZE (64 * 1024)
+#define MAX_XZ_READ (1 << 30)
 
-enum read_states
+struct mfasec_data_reader
 {
-    SEEK,
-    COPY
+    u_int8_t* src;
+    size_t src_sz;
+    size_t data_sec_len;
+    int compressed;
+    u_int64_t stream_len;
+    xzhandle_t* xzh;
+    u_int64_t pos; // Uncompressed offset xzh is positioned at
+    u_int8_t* skip_buf;
 };
 
-int mfasec_get_data_chunk(u_int8_t* data_sec_ptr,
-                          size_t data_sec_len,
-                          u_int64_t chunk_offset,
-                          size_t length,
-                          u_int8_t* outbuf)
+int mfasec_open_data_reader(mfasec_data_reader** reader, u_int8_t* data_sec_ptr, size_t data_sec_len)
 {
-    int res = 0;
-    int rc;
-    xzhandle_t* xzh;
-    u_int8_t* buf = NULL;
-    size_t src_sz;
+    mfasec_data_reader* r;
 
-    u_int8_t* ptr = data_sec_ptr;
     if (data_sec_len < sizeof(section_hdr))
     {
         return _ERR(MFA_ERR_BUFF_SIZE);
     }
-    ptr += sizeof(section_hdr);
-    data_sec_len -= sizeof(section_hdr);
+
+    r = (mfasec_data_reader*)malloc(sizeof(mfasec_data_reader));
+    if (r == NULL)
+    {
+        return _ERR(MFA_ERR_MEM_ALLOC);
+    }
+    memset(r, 0, sizeof(mfasec_data_reader));
 
     section_hdr* hdr = (section_hdr*)data_sec_ptr;
-    src_sz = __be32_to_cpu(hdr->size);
+    r->src = data_sec_ptr + sizeof(section_hdr);
+    r->src_sz = __be32_to_cpu(hdr->size);
+    r->data_sec_len = data_sec_len - sizeof(section_hdr);
+    r->compressed = hdr->flags & SFLAG_XZ_COMPRESSED;
 
-    if (hdr->flags & SFLAG_XZ_COMPRESSED)
+    if (r->compressed)
     {
-        size_t sz;
-        buf = (u_int8_t*)malloc(BUF_SIZE);
-        if (buf == NULL)
+        if (r->data_sec_len < r->src_sz)
         {
-            return _ERR(MFA_ERR_MEM_ALLOC);
-        }
-        if (data_sec_len < src_sz)
-        {
-            res = _ERR(MFA_ERR_BUFF_SIZE);
-            goto clean_up;
+            free(r);
+            return _ERR(MFA_ERR_BUFF_SIZE);
         }
-        sz = xz_stream_len(ptr, src_sz);
+        // The uncompressed length is taken from the xz index, once per section
+        ssize_t sz = xz_stream_len(r->src, r->src_sz);
         if (sz <= 0)
         {
-            res = _ERR(MFA_ERR_DECOMPRESSION);
-            goto clean_up;
+            free(r);
+            return _ERR(MFA_ERR_DECOMPRESSION);
         }
-        if (sz < (chunk_offset + length))
+        r->stream_len = sz;
+        r->skip_buf = (u_int8_t*)malloc(SKIP_BUF_SIZE);
+        if (r->skip_buf == NULL)
         {
-            res = _ERR(MFA_ERR_DECOMPRESSION);
-            goto clean_up;
+            free(r);
+            return _ERR(MFA_ERR_MEM_ALLOC);
         }
+    }
 
-        // Read section into buffer
-        xzh = xz_open_buf(ptr, src_sz);
-        if (xzh == NULL)
+    *reader = r;
+    return MFA_OK;
+}
+
+static void mfasec_reset_data_reader(mfasec_data_reader* reader)
+{
+    if (reader->xzh != NULL)
+    {
+        xz_close(reader->xzh);
+        reader->xzh = NULL;
+    }
+    reader->pos = 0;
+}
+
+int mfasec_read_data_chunk(mfasec_data_reader* reader, u_int64_t chunk_offset, size_t length, u_int8_t* outbuf)
+{
+    int rc;
+    size_t rlen;
+
+    if (!reader->compressed)
+    {
+        if (chunk_offset + length > reader->data_sec_len)
         {
-            res = _ERR(MFA_ERR_DECOMPRESSION);
-            goto clean_up;
+            return _ERR(MFA_ERR_BUFF_SIZE);
         }
+        memcpy(outbuf, reader->src + chunk_offset, length);
+        return MFA_OK;
+    }
 
-        size_t index = 0;
-        size_t rlen = 0;
-        int state = SEEK;
-        do
-        {
-            rc = xz_read(xzh, buf, BUF_SIZE);
-            if (rc > 0)
-            {
-                index += rc;
-            }
-            else
-            {
-                break;
-            }
+    if (chunk_offset + length > reader->stream_len)
+    {
+        return _ERR(MFA_ERR_DECOMPRESSION);
+    }
 
-            if (state == SEEK)
-            {
-                if (index > chunk_offset)
-                {
-                    rlen += index - chunk_offset;
-                    memcpy(outbuf, &buf[rc - (rlen)], rlen);
-                    state = COPY;
-                }
-            }
-            else if (state == COPY)
-            {
-                size_t delta = rc;
-                if ((rlen + rc) > length)
-                {
-                    delta = length - rlen;
-                }
-                memcpy(&outbuf[rlen], buf, delta);
-                rlen += delta;
-            }
-            if (rlen == length)
-            {
-                break;
-            }
-        } while (rc == BUF_SIZE);
+    // The stream can only be decompressed forward, start over only for a chunk behind the current position
+    if (reader->xzh == NULL || chunk_offset < reader->pos)
+    {
+        mfasec_reset_data_reader(reader);
+        reader->xzh = xz_open_buf(reader->src, reader->src_sz);
+        if (reader->xzh == NULL)
+        {
+            return _ERR(MFA_ERR_DECOMPRESSION);
+        }
+    }
 
-        xz_close(xzh);
+    while (reader->pos < chunk_offset)
+    {
+        rlen = SKIP_BUF_SIZE;
+        if (chunk_offset - reader->pos < rlen)
+        {
+            rlen = chunk_offset - reader->pos;
+        }
+        rc = xz_read(reader->xzh, reader->skip_buf, rlen);
+        if (rc <= 0)
+        {
+            goto err_clean_up;
+        }
+        reader->pos += rc;
+    }
 
-        if (rlen != length)
+    // Decompress straight into the caller's buffer
+    for (rlen = 0; rlen < length; rlen += rc)
+    {
+        size_t n = length - rlen;
+        if (n > MAX_XZ_READ)
         {
-            res = _ERR(MFA_ERR_DECOMPRESSION);
-            goto clean_up;
+            n = MAX_XZ_READ;
+        }
+        rc = xz_read(reader->xzh, &outbuf[rlen], n);
+        if (rc <= 0)
+        {
+            goto err_clean_up;
         }
+        reader->pos += rc;
     }
-    else
+
+    return MFA_OK;
+
+err_clean_up:
+    mfasec_reset_data_reader(reader);
+    return _ERR(MFA_ERR_DECOMPRESSION);
+}
+
+void mfasec_close_data_reader(mfasec_data_reader* reader)
+{
+    if (reader == NULL)
     {
-        ptr += chunk_offset;
-        memcpy(outbuf, ptr, length);
+        return;
     }
+    mfasec_reset_data_reader(reader);
+    free(reader->skip_buf);
+    free(reader);
+}
 
-clean_up:
-    if (buf != NULL)
+int mfasec_get_data_chunk(u_int8_t* data_sec_ptr,
+                          size_t data_sec_len,
+                          u_int64_t chunk_offset,
+                          size_t length,
+                          u_int8_t* outbuf)
+{
+    mfasec_data_reader* reader;
+    int res = mfasec_open_data_reader(&reader, data_sec_ptr, data_sec_len);
+    if (res < 0)
     {
-        free(buf);
+        return res;
     }
+    res = mfasec_read_data_chunk(reader, chunk_offset, length, outbuf);
+    mfasec_close_data_reader(reader);
     return res;
 }
 
@@ -135,6 +135,14 @@ void mfasec_init();
 u_int32_t mfasec_crc32(const u_int8_t* buf, size_t size, u_int32_t crc);
 ssize_t mfasec_get_map(u_int8_t* inbuf, size_t inbufsz, u_int8_t** outbuf);
 ssize_t mfasec_get_toc(u_int8_t* inbuf, size_t inbufsz, u_int8_t** outbuf);
+// Uncompressed length of a data section, as the TOC data offsets address it
+ssize_t mfasec_get_data_len(u_int8_t* data_sec_ptr, size_t data_sec_len);
+// Keeps the decompression state of a data section between reads, so that chunks read in increasing offset order
+// are extracted in a single forward pass over the section
+typedef struct mfasec_data_reader mfasec_data_reader;
+int mfasec_open_data_reader(mfasec_data_reader** reader, u_int8_t* data_sec_ptr, size_t data_sec_len);
+int mfasec_read_data_chunk(mfasec_data_reader* reader, u_int64_t chunk_offset, size_t length, u_int8_t* outbuf);
+void mfasec_close_data_reader(mfasec_data_reader* reader);
 int mfasec_get_data_chunk(u_int8_t* data_sec_ptr,
                           size_t data_sec_len,
                           u_int64_t chunk_offset,
@@ -151,29 +151,37 @@ ssize_t xz_stream_len(u_int8_t* buffer, ssize_t len)
 {
     // long sz = 0;
     ssize_t pos = len - 1;
-    unsigned i;
+    u_int64_t i;
 
-    while (buffer[pos] == 0)
+    // The stream may be read before the archive CRC is checked, so every offset taken from it is bounds checked
+    while (pos > 0 && buffer[pos] == 0)
     {
         pos--;
     }
 
-    if ((buffer[pos] != 'Z') || (buffer[pos - 1] != 'Y'))
+    if (pos < 11 || (buffer[pos] != 'Z') || (buffer[pos - 1] != 'Y'))
     {
         return -1;
     }
 
     pos -= 7;
-    u_int32_t backward_size = *((u_int32_t*)&buffer[pos]); // TODO: Must use le2cpu function here
-    backward_size = __le32_to_cpu(backward_size);
-    backward_size = (backward_size + 1) * 4;
-    pos -= 4;                 // CRC32
+    u_int32_t backward_size_field = *((u_int32_t*)&buffer[pos]); // TODO: Must use le2cpu function here
+    u_int64_t backward_size = ((u_int64_t)__le32_to_cpu(backward_size_field) + 1) * 4;
+    pos -= 4; // CRC32
+    if (backward_size - 1 > (u_int64_t)pos)
+    {
+        return -1;
+    }
     pos -= backward_size - 1; // pos will point at number of records field inside Index
 
     u_int64_t num_blocks = 0;
     int idx = decode_xz_num(&buffer[pos], len - pos, &num_blocks);
     // printf("idx: %d\n", idx);
     // sz = num_blocks;
+    if (idx == 0)
+    {
+        return -1;
+    }
     pos += idx;
 
     ssize_t total_unpadded = 0;
@@ -184,8 +192,16 @@ ssize_t xz_stream_len(u_int8_t* buffer, ssize_t len)
         u_int64_t unpadded = 0;
         u_int64_t uncompressed = 0;
         idx = decode_xz_num(&buffer[pos], len - pos, &unpadded);
+        if (idx == 0)
+        {
+            return -1;
+        }
         pos += idx;
         idx = decode_xz_num(&buffer[pos], len - pos, &uncompressed);
+        if (idx == 0)
+        {
+            return -1;
+        }
         pos += idx;
         // printf("Block #%3d: Unpadded: %8u  Uncompressed: %8u\n", i, unpadded, uncompressed);
         total_unpadded += unpadded;
@@ -994,15 +994,38 @@ int st_spi_fill_attr(mflash* mfl, flash_params_t* flash_params)
     return MFE_OK;
 }
 
+static u_int64_t mfl_now_usecs()
+{
+#ifdef __WIN__
+    return 0;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u_int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+}
+
 int read_chunks(mflash* mfl, u_int32_t addr, u_int32_t len, u_int8_t* data, bool verbose)
 {
+    static bool env_vars_evaluated = false;
+    static bool legacy_read = false;
     int rc = 0;
     u_int8_t* p = (u_int8_t*)data;
+    u_int64_t start_usecs = 0;
+    u_int64_t usecs = 0;
 
     if (!mfl)
     {
         return MFE_BAD_PARAMS;
     }
+    if (!env_vars_evaluated)
+    {
+        /* MFLASH_LEGACY_READ: read block by block even if a range read is available */
+        legacy_read = getenv("MFLASH_LEGACY_READ") ? true : false;
+        env_vars_evaluated = true;
+    }
+    bool use_range = mfl->f_read_range && !legacy_read;
+    start_usecs = mfl_now_usecs();
     u_int32_t original_len = len;
     /* Note: */
     /* Assuming read block is the same as write block size. */
@@ -1052,7 +1075,20 @@ int read_chunks(mflash* mfl, u_int32_t addr, u_int32_t len, u_int8_t* data, bool
             data_size -= prefix_pad_size;
             block_data = tmp_buff;
         }
-        rc = mfl->f_read_blk(mfl, block_addr, block_size, block_data, false);
+        if (use_range && !suffix_pad_size && !prefix_pad_size)
+        {
+            /* All the whole blocks left are read in one range, chunked only to keep the progress moving */
+            data_size = len & block_mask;
+            if (verbose && data_size > READ_RANGE_VERBOSE_CHUNK)
+            {
+                data_size = READ_RANGE_VERBOSE_CHUNK;
+            }
+            rc = mfl->f_read_range(mfl, block_addr, data_size, block_data, false);
+        }
+        else
+        {
+            rc = mfl->f_read_blk(mfl, block_addr, block_size, block_data, false);
+        }
         CHECK_RC(rc);
 
         if (suffix_pad_size || prefix_pad_size)
@@ -1083,6 +1119,9 @@ int read_chunks(mflash* mfl, u_int32_t addr, u_int32_t len, u_int8_t* data, bool
         }
     }
 
+    usecs = mfl_now_usecs() - start_usecs;
+    FLASH_DPRINTF(("read_chunks: %#x bytes in %llu usec, %.2f MB/s (%s)\n", original_len, (unsigned long long)usecs,
+                   usecs ? (double)original_len / usecs : 0.0, use_range ? "range" : "per block"));
     return MFE_OK;
 }
 
@@ -1947,6 +1986,7 @@ int gen6_flash_init_com(mflash* mfl, flash_params_t* flash_params)
     /* TODO: Enable page_read (slightly better perf) */
     mfl->f_read = read_chunks;
     mfl->f_read_blk = cntx_st_spi_block_read; /* need fix */
+    mfl->f_read_range = new_gw_st_spi_read_range;
     mfl->f_set_bank = empty_set_bank;
     mfl->f_get_info = cntx_get_flash_info; /* need fix */
     mfl->f_get_jedec_id = cntx_get_jedec_id_direct_access;
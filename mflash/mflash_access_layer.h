@@ -99,6 +99,8 @@ enum FlashConstant
 
     MAX_WRITE_BUFFER_SIZE = 256, // Max buffer size for buffer write devices
 
+    READ_RANGE_VERBOSE_CHUNK = 0x40000, // Bytes read per range between progress updates
+
     WRITE_STATUS_REGISTER_DELAY_CYPRESS = 750,
     WRITE_STATUS_REGISTER_DELAY_MICRON = 1000,
     WRITE_STATUS_REGISTER_DELAY_MIN = 40,
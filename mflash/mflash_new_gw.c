@@ -54,6 +54,9 @@
 #define usleep(x) Sleep(((x + 999) / 1000))
 
 #endif // __WIN_
+// Bounds the time the flash semaphore is held by a read session.
+#define NEW_GW_READ_SESSION_SIZE (4 * 1024 * 1024)
+
 #define CHECK_RC_REL_SEM(mfl, rc)      \
     do                                 \
     {                                  \
@@ -539,3 +542,90 @@ int new_gw_st_spi_block_read_ex(mflash* mfl,
     }
     return MFE_OK;
 }
+
+/*
+ * Read a block aligned range with back-to-back gateway commands.
+ * The semaphore is taken once per session (up to NEW_GW_READ_SESSION_SIZE bytes inside one bank)
+ * and the command and data size are set up once, only the flash address is rewritten per block.
+ */
+int new_gw_st_spi_read_range(mflash* mfl, u_int32_t addr, u_int32_t len, u_int8_t* data, bool verbose)
+{
+    (void)verbose;
+    int rc = 0;
+    u_int32_t i = 0;
+    u_int32_t blk_size = 0;
+    u_int32_t gw_cmd = 0;
+    u_int32_t flash_addr = 0;
+    u_int32_t session_len = 0;
+    u_int64_t bank_end = 0;
+
+    if (!mfl || !data)
+    {
+        return MFE_BAD_PARAMS;
+    }
+    blk_size = (u_int32_t)mfl->attr.block_write;
+    if ((addr & (blk_size - 1)) || (len & (blk_size - 1)))
+    {
+        return MFE_BAD_ALIGN;
+    }
+
+    gw_cmd = MERGE(gw_cmd, 1, mfl->gw_cmd_phase_bit_offset, 1);
+    gw_cmd = MERGE(gw_cmd, 1, mfl->gw_addr_phase_bit_offset, 1);
+    gw_cmd = MERGE(gw_cmd, mfl->attr.access_commands.sfc_read, mfl->gw_cmd_bit_offset, mfl->gw_cmd_bit_len);
+    gw_cmd = MERGE(gw_cmd, 1, mfl->gw_rw_bit_offset, 1);
+    gw_cmd = MERGE(gw_cmd, 1, mfl->gw_data_phase_bit_offset, 1);
+
+    while (len)
+    {
+        bank_end = ((u_int64_t)(addr >> mfl->attr.log2_bank_size) + 1) << mfl->attr.log2_bank_size;
+        session_len = len < NEW_GW_READ_SESSION_SIZE ? len : NEW_GW_READ_SESSION_SIZE;
+        if (addr + (u_int64_t)session_len > bank_end)
+        {
+            session_len = (u_int32_t)(bank_end - addr);
+        }
+
+        rc = set_bank(mfl, addr);
+        CHECK_RC(rc);
+
+        rc = mfl_com_lock(mfl);
+        CHECK_RC(rc);
+
+        // On 7th gen flash the data size is a register, keep it under the semaphore.
+        // A failed register write has already released the semaphore, only a gen mismatch leaves it held.
+        rc = set_gw_data_size(mfl, blk_size, &gw_cmd);
+        if (rc == MFE_ERROR)
+        {
+            release_semaphore(mfl, 0);
+        }
+        CHECK_RC(rc);
+
+        DPRINTF(("new_gw_st_spi_read_range: addr = %#x, len = %#x, gw_cmd = %#x\n", addr, session_len, gw_cmd));
+        for (i = 0; i < session_len; i += blk_size)
+        {
+            rc = get_flash_offset(addr + i, mfl->attr.log2_bank_size, &flash_addr);
+            CHECK_RC_REL_SEM(mfl, rc);
+            if (mwrite4(mfl->mf, mfl->gw_addr_field_addr, flash_addr) != 4)
+            {
+                release_semaphore(mfl, 0);
+                return MFE_CR_ERROR;
+            }
+            rc = new_gw_exec_cmd(mfl, gw_cmd, "Read range");
+            CHECK_RC_REL_SEM(mfl, rc);
+            if (mread4_block(mfl->mf, mfl->gw_data_field_addr, (u_int32_t*)(data + i), blk_size) != (int)blk_size)
+            {
+                release_semaphore(mfl, 0);
+                return MFE_CR_ERROR;
+            }
+        }
+        release_semaphore(mfl, 0);
+
+        for (i = 0; i < session_len; i += 4)
+        {
+            *(u_int32_t*)(data + i) = __be32_to_cpu(*(u_int32_t*)(data + i));
+        }
+        addr += session_len;
+        data += session_len;
+        len -= session_len;
+    }
+    return MFE_OK;
+}
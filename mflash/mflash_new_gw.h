@@ -60,5 +60,6 @@ int new_gw_st_spi_block_read_ex(mflash* mfl,
                                 u_int8_t is_first,
                                 u_int8_t is_last,
                                 bool verbose);
+int new_gw_st_spi_read_range(mflash* mfl, u_int32_t addr, u_int32_t len, u_int8_t* data, bool verbose);
 int new_gw_spi_write_status_reg(mflash* mfl, u_int32_t status_reg, u_int8_t write_cmd, u_int8_t bytes_num);
 #endif
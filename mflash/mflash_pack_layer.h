@@ -213,6 +213,7 @@ struct mflash
     f_mf_write f_write;
     f_mf_write f_write_blk; // write and write_block have the same signateure, but theyr'e not the same func !
     f_mf_read f_read_blk;   // read  and read_block have the same signateure, but theyr'e not the same func !
+    f_mf_read f_read_range; // optional, reads block aligned ranges with one semaphore hold per session
     f_mf_erase_sect f_erase_sect;
     f_mf_reset f_reset;
 
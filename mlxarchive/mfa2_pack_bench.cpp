@@ -0,0 +1,138 @@
+
+/*
+ * Copyright (C) Jan 2013 Mellanox Technologies Ltd. All rights reserved.
+ * Copyright (c) 2021 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * End to end MFA2 bundle generation (MFA2::generateBinary) over synthetic components, each given its own device
+ * descriptor, as FWDirectoryBuilder does for a directory of FW images.
+ *
+ * Usage: mfa2_pack_bench [-i iterations] [-n components] [-s component_size_kb]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <mlxsign_lib/mlxsign_lib.h>
+#include <common/tools_bench.h>
+#include "mlxarchive_mfa2.h"
+
+using namespace mfa2;
+
+// Loosely FW shaped: runs of repeated words mixed with noise, so that the data compresses but not trivially
+static void fillComponent(vector<u_int8_t>& data, size_t size, int index)
+{
+    u_int32_t seed = 0x9e3779b9 * (index + 1);
+    data.resize(size);
+    for (size_t i = 0; i < size; i += 4)
+    {
+        seed = seed * 1103515245 + 12345;
+        u_int32_t word = (seed >> 16) & 0x3 ? (u_int32_t)(i >> 12) : seed;
+        for (size_t j = 0; j < 4 && i + j < size; j++)
+        {
+            data[i + j] = (u_int8_t)(word >> (8 * j));
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int iterations = 1;
+    int numComponents = 8;
+    int componentSizeKb = 4096;
+    int opt;
+    while ((opt = getopt(argc, argv, "i:n:s:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'i':
+                iterations = atoi(optarg);
+                break;
+            case 'n':
+                numComponents = atoi(optarg);
+                break;
+            case 's':
+                componentSizeKb = atoi(optarg);
+                break;
+            default:
+                return bench_usage(argv[0], "[-i iterations] [-n components] [-s component_size_kb]");
+        }
+    }
+    if (iterations <= 0 || numComponents <= 0 || componentSizeKb <= 0)
+    {
+        fprintf(stderr, "-E- iterations, components and component size must be positive\n");
+        return 1;
+    }
+
+    vector<DeviceDescriptor> deviceDescriptors;
+    vector<Component> components;
+    u_int16_t fwVersion[3] = {22, 41, 1000};
+    u_int16_t fwDate[3] = {16, 10, 2026};
+    u_int16_t pkgVersion[3] = {1, 0, 0};
+    for (int i = 0; i < numComponents; i++)
+    {
+        char psid[17];
+        snprintf(psid, sizeof(psid), "MT_%010d", i);
+        vector<ComponentPointerExtension> componentPointers;
+        componentPointers.push_back(ComponentPointerExtension(i));
+        deviceDescriptors.push_back(DeviceDescriptor(componentPointers, PSIDExtension(psid)));
+        vector<u_int8_t> data;
+        fillComponent(data, (size_t)componentSizeKb * 1024, i);
+        components.push_back(Component(ComponentDescriptor(VersionExtension(fwVersion, fwDate), data)));
+    }
+
+    vector<u_int8_t> buff;
+    double secs = 0;
+    for (int i = 0; i < iterations; i++)
+    {
+        // A fixed date rather than the current time, so that the bundle is reproducible
+        MFA2 mfa2(PackageDescriptor(numComponents, numComponents, VersionExtension(pkgVersion, fwDate)),
+                  deviceDescriptors, components);
+        buff.clear();
+        double start = bench_now_secs();
+        mfa2.generateBinary(buff);
+        secs += bench_now_secs() - start;
+    }
+
+    vector<u_int8_t> digest;
+    MlxSignSHA256 mlxSignSHA256;
+    mlxSignSHA256 << buff;
+    mlxSignSHA256.getDigest(digest);
+    printf("%d components of %d KB, bundle %zu bytes, sha256 ", numComponents, componentSizeKb, buff.size());
+    for (size_t i = 0; i < digest.size(); i++)
+    {
+        printf("%02x", digest[i]);
+    }
+    printf("\ngenerateBinary: %.1f msec\n", secs * 1000 / iterations);
+    return 0;
+}
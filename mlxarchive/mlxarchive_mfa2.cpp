@@ -90,62 +90,48 @@ void MFA2::pack(vector<u_int8_t>& buff)
     }
     _packageDescriptor.setComponentsBlockSize(componentsBlockSize);
 
-    _fingerPrint.pack(buff);
-
-    _packageDescriptor.pack(buff);
-
-    CONST_VECTOR_ITERATOR(DeviceDescriptor, _deviceDescriptors, it)
-    {
-        (*it).pack(buff);
-    }
-
-    CONST_VECTOR_ITERATOR(Component, _components, it)
-    {
-        (*it).packDescriptor(buff);
-    }
-    
-    _packageDescriptor.setComponentsBlockOffset(buff.size());
-
-    // compress components block
+    // compress components block, the components offsets are relative to the block
     vector<u_int8_t> componentsBlockBuff;
     VECTOR_ITERATOR(Component, _components, it)
     {
         (*it).setComponentBinaryOffset(componentsBlockBuff.size());
         (*it).packData(componentsBlockBuff);
     }
-    u_int32_t zippedSize = componentsBlockBuff.size();
-    zippedSize = xz_compress_crc32(9, componentsBlockBuff.data(), componentsBlockBuff.size(), NULL, 0);
+    vector<u_int8_t> zippedComponentBlockBuff(xz_compress_bound(componentsBlockBuff.size()));
+    int32_t zippedSize = xz_compress_crc32(9, componentsBlockBuff.data(), componentsBlockBuff.size(),
+                                           zippedComponentBlockBuff.data(), zippedComponentBlockBuff.size());
     if (zippedSize <= 0)
     {
         // TODO throw exception
         printf("-E- Error while compressing\n");
         exit(1);
     }
+    zippedComponentBlockBuff.resize(zippedSize);
     _packageDescriptor.setComponentsBlockArchiveSize(zippedSize);
-    vector<u_int8_t> zippedComponentBlockBuff(zippedSize);
-    u_int32_t actualZippedSize = xz_compress_crc32(9, componentsBlockBuff.data(), componentsBlockBuff.size(),
-                                                   zippedComponentBlockBuff.data(), zippedSize);
-    if (zippedSize != actualZippedSize)
-    {
-        printf("-E- zipped size not as expected\n");
-        exit(1);
-    }
-    // compute descriptors SHA256
+
+    // the descriptors size does not depend on the values of their fields, so the offset of the components block
+    // is known before the descriptors are final
     vector<u_int8_t> descriptorsBuff;
     packDescriptors(descriptorsBuff);
+    _packageDescriptor.setComponentsBlockOffset(buff.size() + descriptorsBuff.size());
+
+    // compute descriptors SHA256
+    descriptorsBuff.clear();
+    packDescriptors(descriptorsBuff);
     vector<u_int8_t> digest;
     MlxSignSHA256 mlxSignSHA256;
     mlxSignSHA256 << descriptorsBuff;
     mlxSignSHA256.getDigest(digest);
     _packageDescriptor.setDescriptorsSHA256(digest);
 
-    // append the zipped components block
-    packBytesArray(zippedComponentBlockBuff.data(), zippedComponentBlockBuff.size(), buff);
-
     // compute SHA256
     mlxSignSHA256 << zippedComponentBlockBuff;
     mlxSignSHA256.getDigest(digest);
     _packageDescriptor.setSHA256(digest);
+
+    // pack the final descriptors and append the zipped components block
+    packDescriptors(buff);
+    packBytesArray(zippedComponentBlockBuff.data(), zippedComponentBlockBuff.size(), buff);
 }
 
 /*void MFA2::update(vector<u_int8_t>& buff)
@@ -158,15 +144,7 @@ void MFA2::pack(vector<u_int8_t>& buff)
 
 void MFA2::generateBinary(vector<u_int8_t>& buff)
 {
-    vector<u_int8_t> tmpBuff;
-
-    // do first pass
-    pack(tmpBuff);
-
-    // do second pass
     pack(buff);
-
-    // compute SHA256
 }
 
 MFA2* MFA2::LoadMFA2Package(const string& file_name)
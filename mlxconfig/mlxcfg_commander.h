@@ -46,6 +46,15 @@
 #include "mlxcfg_utils.h"
 #include "mlxcfg_status.h"
 
+struct QueryStats
+{
+    QueryStats() : tlvsQueried(0), tlvsSkipped(0), regAccesses(0), usecs(0) {}
+    u_int32_t tlvsQueried;
+    u_int32_t tlvsSkipped; // not supported by the FW, no query issued
+    u_int32_t regAccesses; // NV configuration register accesses
+    u_int64_t usecs;
+};
+
 class Commander
 {
 public:
@@ -75,6 +84,7 @@ public:
     void setExtResourceType(bool extT) { _extResource = extT; }
     static string getDefaultDBName(bool isSwitch);
     mfile* mf() { return _mf; }
+    const QueryStats& getQueryStats() const { return _queryStats; }
     Commander(mfile* mf) : _mf(mf), _extResource(true), _isSwitch(false){};
     virtual ~Commander();
 
@@ -82,5 +92,6 @@ protected:
     mfile* _mf;
     bool _extResource;
     bool _isSwitch;
+    QueryStats _queryStats;
 };
 #endif /* MLXCFG_COMMANDER_H_ */
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2021 NVIDIA CORPORATION & AFFILIATES. ALL RIGHTS RESERVED.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *  Version: $Id$
+ */
+
+/*
+ * Parameter lookup cost of MlxcfgDBManager on the mlxconfig databases: every parameter of the database is
+ * resolved to its TLV the way "mlxconfig set" does it (each run with a fresh manager, as every mlxconfig
+ * process starts with one), and the way "mlxconfig query" does it after all the TLVs were loaded.
+ * Port and module parameters are looked up with a _P1/_M0 suffix. No device is opened.
+ *
+ * Usage: mlxcfg_db_bench [-i iterations] db_file...
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <functional>
+#include <string>
+#include <vector>
+#include <common/tools_bench.h>
+#include "mlxcfg_db_manager.h"
+#include "mlxcfg_utils.h"
+
+using namespace std;
+
+static void get_param_names(const string& db, vector<string>& names, vector<string>& baseNames)
+{
+    MlxcfgDBManager dbManager(db);
+    dbManager.getAllTLVs();
+    VECTOR_ITERATOR(TLVConf*, dbManager.fetchedTLVs, it)
+    {
+        if ((*it)->_cap)
+        {
+            continue;
+        }
+        string suffix = (*it)->isPortTargetClass() ? "_P1" : (*it)->isModuleTargetClass() ? "_M0" : "";
+        VECTOR_ITERATOR(std::shared_ptr<Param>, (*it)->_params, p)
+        {
+            if (!(*p)->_mlxconfigName.empty())
+            {
+                names.push_back((*p)->_mlxconfigName + suffix);
+                baseNames.push_back((*p)->_mlxconfigName);
+            }
+        }
+    }
+}
+
+// Resolves all the names, returns the number of names resolved and a checksum of the TLVs they resolved to
+static size_t lookup_all(MlxcfgDBManager& dbManager,
+                         const vector<string>& names,
+                         const vector<string>& baseNames,
+                         size_t& checksum)
+{
+    size_t found = 0;
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        try
+        {
+            if (!dbManager.isParamMlxconfigNameExist(baseNames[i]))
+            {
+                continue;
+            }
+            TLVConf* tlv = dbManager.getTLVByParamMlxconfigName(names[i], 0, NULL);
+            checksum += hash<string>()(tlv->_name) + tlv->_port * 31 + (tlv->_module + 1) * 17;
+            found++;
+        }
+        catch (MlxcfgException& e)
+        {
+        }
+    }
+    return found;
+}
+
+static int bench_db(const string& db, int iterations)
+{
+    vector<string> names, baseNames;
+    double set_time = 0, query_time = 0;
+    size_t set_found = 0, query_found = 0, set_checksum = 0, query_checksum = 0;
+
+    try
+    {
+        get_param_names(db, names, baseNames);
+        for (int i = 0; i < iterations; i++)
+        {
+            double start = bench_now_secs();
+            MlxcfgDBManager setManager(db);
+            set_found = lookup_all(setManager, names, baseNames, set_checksum);
+            set_time += bench_now_secs() - start;
+
+            start = bench_now_secs();
+            MlxcfgDBManager queryManager(db);
+            queryManager.getAllTLVs();
+            query_found = lookup_all(queryManager, names, baseNames, query_checksum);
+            query_time += bench_now_secs() - start;
+        }
+    }
+    catch (MlxcfgException& e)
+    {
+        fprintf(stderr, "-E- %s: %s\n", db.c_str(), e._err.c_str());
+        return 1;
+    }
+    printf("%s: %zu parameters\n", db.c_str(), names.size());
+    printf("    set:   %10.1f msec, %zu resolved (checksum %016zx)\n", set_time * 1e3 / iterations, set_found,
+           set_checksum);
+    printf("    query: %10.1f msec, %zu resolved (checksum %016zx)\n", query_time * 1e3 / iterations, query_found,
+           query_checksum);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    int iterations = 5;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "i:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'i':
+                iterations = atoi(optarg);
+                break;
+            default:
+                return bench_usage(argv[0], "[-i iterations] db_file...");
+        }
+    }
+    if (iterations <= 0 || optind >= argc)
+    {
+        return bench_usage(argv[0], "[-i iterations] db_file...");
+    }
+    for (int i = optind; i < argc; i++)
+    {
+        if (bench_db(argv[i], iterations))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
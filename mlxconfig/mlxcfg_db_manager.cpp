@@ -53,21 +53,16 @@
 
 #define SQL_SELECT_ALL_PARAMS \
     "SELECT * FROM params"
-
-#define SQL_SELECT_TLV_BY_NAME \
-    "SELECT * FROM tlvs WHERE name='%s'"
-
-#define SQL_SELECT_TLV_BY_INDEX_AND_CLASS \
-    "SELECT * FROM tlvs WHERE id=%d and class=%d"
-
-#define SQL_SELECT_PARAMS_BY_TLV_NAME \
-    "SELECT * FROM params WHERE tlv_name='%s'"
-
-#define SQL_SELECT_PARAM_BY_MLXCONFIG_NAME \
-    "SELECT * FROM params WHERE mlxconfig_name='%s'"
 // clang-format on
 MlxcfgDBManager::MlxcfgDBManager(string dbName) :
-    _dbName(dbName), _db(NULL), _supportedVersion(0x0), _callBackErr(""), _isAllFetched(false), _paramSqlResult(NULL)
+    _dbName(dbName),
+    _db(NULL),
+    _supportedVersion(0x0),
+    _isDBLoaded(false),
+    _paramTlvNameCol(0),
+    _callBackErr(""),
+    _isAllFetched(false),
+    _paramSqlResult(NULL)
 {
     openDB();
 }
@@ -151,137 +146,171 @@ void MlxcfgDBManager::execSQL(sqlite3_callback f, void* obj, const char* stat, .
     }
 }
 
-int MlxcfgDBManager::selectTLVCallBack(void* object, int argc, char** argv, char** azColName)
+int MlxcfgDBManager::selectRowCallBack(void* object, int argc, char** argv, char** azColName)
 {
-    MlxcfgDBManager* dbManager = reinterpret_cast<MlxcfgDBManager*>(object); // TODOO check this casting
+    DBTable* table = reinterpret_cast<DBTable*>(object);
 
-    try
+    if (table->columns.empty())
     {
-        TLVConf* tlv = new TLVConf(argc, argv, azColName);
-        dbManager->fetchedTLVs.push_back(tlv);
+        table->columns.assign(azColName, azColName + argc);
     }
-    catch (MlxcfgException& e)
+    table->values.push_back(std::vector<std::string>(argc));
+    table->isNull.push_back(std::vector<bool>(argc));
+    for (int i = 0; i < argc; i++)
     {
-        dbManager->_callBackErr = e._err;
-        return SQLITE_ABORT;
+        table->values.back()[i] = argv[i] ? argv[i] : "";
+        table->isNull.back()[i] = (argv[i] == NULL);
     }
-
     return 0;
 }
 
-int MlxcfgDBManager::selectAndCreateNewTLVCallBack(void* object, int argc, char** argv, char** azColName)
+static size_t getColumn(const DBTable& table, const char* name)
 {
-    TLVConf** tlv = reinterpret_cast<TLVConf**>(object);
-
-    try
+    for (size_t c = 0; c < table.columns.size(); c++)
     {
-        *tlv = new TLVConf(argc, argv, azColName);
-    }
-    catch (MlxcfgException& /*e*/)
-    {
-        return SQLITE_ABORT;
+        if (table.columns[c] == name)
+        {
+            return c;
+        }
     }
-
-    return 0;
+    throw MlxcfgException("The database has no %s column", name);
 }
 
-int MlxcfgDBManager::selectAndCreateParamCallBack(void* object, int argc, char** argv, char** azColName)
+void MlxcfgDBManager::loadDB()
 {
-    TLVConf* tlv = reinterpret_cast<TLVConf*>(object);
+    if (_isDBLoaded)
+    {
+        return;
+    }
+
+    execSQL(selectRowCallBack, &_tlvRows, SQL_SELECT_ALL_TLVS);
+    execSQL(selectRowCallBack, &_paramRows, SQL_SELECT_ALL_PARAMS);
 
-    try
+    if (!_tlvRows.values.empty())
     {
-        std::shared_ptr<Param> param = std::make_shared<Param>(argc, argv, azColName);
-        tlv->_params.push_back(param);
+        size_t nameCol = getColumn(_tlvRows, "name"), idCol = getColumn(_tlvRows, "id"),
+               classCol = getColumn(_tlvRows, "class");
+        for (size_t r = 0; r < _tlvRows.values.size(); r++)
+        {
+            const vector<string>& row = _tlvRows.values[r];
+            _tlvRowByName.insert(make_pair(row[nameCol], r));
+            _tlvRowByIdClass.insert(make_pair(TLVIdClass(atoi(row[idCol].c_str()), atoi(row[classCol].c_str())), r));
+        }
+    }
+    if (!_paramRows.values.empty())
+    {
+        _paramTlvNameCol = getColumn(_paramRows, "tlv_name");
+        size_t mlxconfigNameCol = getColumn(_paramRows, "mlxconfig_name");
+        for (size_t r = 0; r < _paramRows.values.size(); r++)
+        {
+            const vector<string>& row = _paramRows.values[r];
+            _paramRowsByTlvName[row[_paramTlvNameCol]].push_back(r);
+            if (!_paramRows.isNull[r][mlxconfigNameCol])
+            {
+                _paramRowByMlxconfigName.insert(make_pair(row[mlxconfigNameCol], r));
+            }
+        }
     }
-    catch (MlxcfgException& e)
+    _isDBLoaded = true;
+}
+
+static void getRowPointers(DBTable& table, size_t row, vector<char*>& argv, vector<char*>& azColName)
+{
+    for (size_t c = 0; c < table.columns.size(); c++)
     {
-        return SQLITE_ABORT;
+        argv.push_back(table.isNull[row][c] ? NULL : &table.values[row][c][0]);
+        azColName.push_back(&table.columns[c][0]);
     }
+}
 
-    return 0;
+TLVConf* MlxcfgDBManager::newTLVConf(size_t row)
+{
+    vector<char*> argv, azColName;
+    getRowPointers(_tlvRows, row, argv, azColName);
+    return new TLVConf((int)argv.size(), argv.data(), azColName.data());
 }
 
-int MlxcfgDBManager::selectParamCallBack(void* object, int argc, char** argv, char** azColName)
+std::shared_ptr<Param> MlxcfgDBManager::newParam(size_t row)
 {
-    MlxcfgDBManager* dbManager = reinterpret_cast<MlxcfgDBManager*>(object); // TODOO check this casting
+    vector<char*> argv, azColName;
+    getRowPointers(_paramRows, row, argv, azColName);
+    return std::make_shared<Param>((int)argv.size(), argv.data(), azColName.data());
+}
 
-    try
-    {
-        std::shared_ptr<Param> param = std::make_shared<Param>(argc, argv, azColName);
-        dbManager->fetchedParams.push_back(param);
-    }
-    catch (MlxcfgException& e)
-    {
-        dbManager->_callBackErr = e._err;
-        return SQLITE_ABORT;
-    }
-    // printf("-D- Added new Param = %s\n", param->_name.c_str());
-    return 0;
+void MlxcfgDBManager::addFetchedTLV(TLVConf* tlv)
+{
+    fetchedTLVs.push_back(tlv);
+    _fetchedTLVsByName[tlv->_name].push_back(tlv);
+    _fetchedTLVByIdClass.insert(make_pair(TLVIdClass(tlv->_id, tlv->_tlvClass), tlv));
 }
 
-int MlxcfgDBManager::selectParamByMlxconfigNameCallBack(void* object, int argc, char** argv, char** azColName)
+void MlxcfgDBManager::addFetchedParam(std::shared_ptr<Param> param)
 {
-    MlxcfgDBManager* dbManager = reinterpret_cast<MlxcfgDBManager*>(object);
-    try
+    fetchedParams.push_back(param);
+    _fetchedParamsByTlvName[param->_tlvName].push_back(param);
+}
+
+void MlxcfgDBManager::fetchParamsOfTLV(const string& tlvName)
+{
+    std::unordered_map<string, vector<size_t> >::const_iterator rows = _paramRowsByTlvName.find(tlvName);
+    if (rows == _paramRowsByTlvName.end())
     {
-        dbManager->_paramSqlResult = std::make_shared<Param>(argc, argv, azColName);
+        return;
     }
-    catch (MlxcfgException& e)
+    CONST_VECTOR_ITERATOR(size_t, rows->second, r)
     {
-        dbManager->_callBackErr = e._err;
-        return SQLITE_ABORT;
+        addFetchedParam(newParam(*r));
     }
-    return 0;
 }
 
 void MlxcfgDBManager::getAllTLVs()
 {
-    size_t i = 0, j = 0;
-
     if (_isAllFetched)
     {
         return;
     }
 
-    // fetch from db all tlvs
-    execSQL(selectTLVCallBack, this, SQL_SELECT_ALL_TLVS);
-
-    // fetch from db all params
-    execSQL(selectParamCallBack, this, SQL_SELECT_ALL_PARAMS);
+    loadDB();
+    for (size_t r = 0; r < _paramRows.values.size(); r++)
+    {
+        if (_tlvRowByName.find(_paramRows.values[r][_paramTlvNameCol]) == _tlvRowByName.end())
+        {
+            throw MlxcfgException("A parameter without a TLV configuration: %s",
+                                  _paramRows.values[r][getColumn(_paramRows, "name")].c_str());
+        }
+    }
 
-    /*
-       Fill in TLV.params vector
-       we assume that params table is grouped by tlv name
-     */
-    while (j < fetchedTLVs.size() && i < fetchedParams.size())
+    // Create all the TLVs, each with its own instances of its params
+    for (size_t r = 0; r < _tlvRows.values.size(); r++)
     {
-        std::shared_ptr<Param> p = fetchedParams[i];
-        if (p->_tlvName == fetchedTLVs[j]->_name && p->_port == fetchedTLVs[j]->_port &&
-            p->_module == fetchedTLVs[j]->_module)
+        TLVConf* tlv = newTLVConf(r);
+        addFetchedTLV(tlv);
+        std::unordered_map<string, vector<size_t> >::const_iterator rows = _paramRowsByTlvName.find(tlv->_name);
+        if (rows == _paramRowsByTlvName.end())
         {
-            fetchedTLVs[j]->_params.push_back(p);
-            i++; // move to next parameter
+            continue;
         }
-        else
+        CONST_VECTOR_ITERATOR(size_t, rows->second, p)
         {
-            j++; // move to next tlv
+            std::shared_ptr<Param> param = newParam(*p);
+            addFetchedParam(param);
+            tlv->_params.push_back(param);
         }
     }
-    if (j >= fetchedTLVs.size() && i < fetchedParams.size())
-    {
-        throw MlxcfgException("A parameter without a TLV configuration: %s", fetchedParams[i]->_name.c_str());
-    }
-    // TODO check if there is a tlv that does not have params
     _isAllFetched = true;
 }
 
 TLVConf* MlxcfgDBManager::getTLVByNameAux(string tlv_name, u_int32_t port, int32_t module)
 {
-    VECTOR_ITERATOR(TLVConf*, fetchedTLVs, it)
+    std::unordered_map<string, vector<TLVConf*> >::const_iterator tlvs = _fetchedTLVsByName.find(tlv_name);
+    if (tlvs == _fetchedTLVsByName.end())
+    {
+        return NULL;
+    }
+    CONST_VECTOR_ITERATOR(TLVConf*, tlvs->second, it)
     {
         TLVConf* t = *it;
-        if (t->_name == tlv_name && t->_port == port && t->_module == module)
+        if (t->_port == port && t->_module == module)
         {
             return t;
         }
@@ -291,10 +320,15 @@ TLVConf* MlxcfgDBManager::getTLVByNameAux(string tlv_name, u_int32_t port, int32
 
 TLVConf* MlxcfgDBManager::getAndSetTLVByNameAuxNotInitialized(string tlv_name, u_int32_t port, int32_t module)
 {
-    VECTOR_ITERATOR(TLVConf*, fetchedTLVs, it)
+    std::unordered_map<string, vector<TLVConf*> >::const_iterator tlvs = _fetchedTLVsByName.find(tlv_name);
+    if (tlvs == _fetchedTLVsByName.end())
+    {
+        return NULL;
+    }
+    CONST_VECTOR_ITERATOR(TLVConf*, tlvs->second, it)
     {
         TLVConf* tlv = *it;
-        if (tlv->_name == tlv_name && tlv->_port == 0 && tlv->_module == -1)
+        if (tlv->_port == 0 && tlv->_module == -1)
         {
             if (port != 0)
             {
@@ -312,13 +346,13 @@ TLVConf* MlxcfgDBManager::getAndSetTLVByNameAuxNotInitialized(string tlv_name, u
 
 void MlxcfgDBManager::fillInRelevantParamsOfTlv(TLVConf* tlv, u_int32_t port, int32_t module)
 {
-    VECTOR_ITERATOR(std::shared_ptr<Param>, fetchedParams, p)
+    VECTOR_ITERATOR(std::shared_ptr<Param>, _fetchedParamsByTlvName[tlv->_name], p)
     {
-        if ((*p)->_tlvName == tlv->_name && (*p)->_port == port && (*p)->_module == module)
+        if ((*p)->_port == port && (*p)->_module == module)
         {
             tlv->_params.push_back(*p);
         }
-        else if ((*p)->_tlvName == tlv->_name && (*p)->_port == 0 && (*p)->_module == -1)
+        else if ((*p)->_port == 0 && (*p)->_module == -1)
         {
             if (port != 0)
             {
@@ -338,7 +372,12 @@ TLVConf* MlxcfgDBManager::fetchTLVByName(string tlvName, u_int32_t port, int32_t
     TLVConf* tlv;
     const char* nc = tlvName.c_str();
 
-    execSQL(selectTLVCallBack, this, SQL_SELECT_TLV_BY_NAME, nc);
+    loadDB();
+    std::unordered_map<string, size_t>::const_iterator row = _tlvRowByName.find(tlvName);
+    if (row != _tlvRowByName.end())
+    {
+        addFetchedTLV(newTLVConf(row->second));
+    }
     tlv = getTLVByNameAux(tlvName, port, module);
     if (!tlv)
     {
@@ -349,7 +388,7 @@ TLVConf* MlxcfgDBManager::fetchTLVByName(string tlvName, u_int32_t port, int32_t
         }
     }
     // fetch the parameters
-    execSQL(selectParamCallBack, this, SQL_SELECT_PARAMS_BY_TLV_NAME, nc);
+    fetchParamsOfTLV(tlvName);
 
     // fill in params vector of the tlv
     this->fillInRelevantParamsOfTlv(tlv, port, module);
@@ -359,7 +398,12 @@ TLVConf* MlxcfgDBManager::fetchTLVByName(string tlvName, u_int32_t port, int32_t
 TLVConf* MlxcfgDBManager::fetchTLVByIndexAndClass(u_int32_t id, TLVClass c)
 {
     TLVConf* t;
-    execSQL(selectTLVCallBack, this, SQL_SELECT_TLV_BY_INDEX_AND_CLASS, id, c);
+    loadDB();
+    std::map<TLVIdClass, size_t>::const_iterator row = _tlvRowByIdClass.find(TLVIdClass(id, c));
+    if (row != _tlvRowByIdClass.end())
+    {
+        addFetchedTLV(newTLVConf(row->second));
+    }
     t = getTLVByIndexAndClassAux(id, c);
     if (!t)
     {
@@ -367,12 +411,12 @@ TLVConf* MlxcfgDBManager::fetchTLVByIndexAndClass(u_int32_t id, TLVClass c)
     }
 
     // fetch the parameters
-    execSQL(selectParamCallBack, this, SQL_SELECT_PARAMS_BY_TLV_NAME, t->_name.c_str());
+    fetchParamsOfTLV(t->_name);
 
     // fill in params vector of the tlv
-    VECTOR_ITERATOR(std::shared_ptr<Param>, fetchedParams, p)
+    VECTOR_ITERATOR(std::shared_ptr<Param>, _fetchedParamsByTlvName[t->_name], p)
     {
-        if ((*p)->_tlvName == t->_name && (*p)->_port == t->_port)
+        if ((*p)->_port == t->_port)
         {
             t->_params.push_back(*p);
         }
@@ -386,11 +430,13 @@ TLVConf* MlxcfgDBManager::getAndCreateTLVByName(string tlvName, u_int32_t port,
     TLVConf* tlv = NULL;
     const char* nc = tlvName.c_str();
 
-    execSQL(selectAndCreateNewTLVCallBack, &tlv, SQL_SELECT_TLV_BY_NAME, nc);
-    if (!tlv)
+    loadDB();
+    std::unordered_map<string, size_t>::const_iterator row = _tlvRowByName.find(tlvName);
+    if (row == _tlvRowByName.end())
     {
         throw MlxcfgTLVNotFoundException(nc);
     }
+    tlv = newTLVConf(row->second);
     if (port != 0)
     {
         tlv->_port = port;
@@ -401,7 +447,14 @@ TLVConf* MlxcfgDBManager::getAndCreateTLVByName(string tlvName, u_int32_t port,
     }
 
     // fetch the parameters
-    execSQL(selectAndCreateParamCallBack, tlv, SQL_SELECT_PARAMS_BY_TLV_NAME, nc);
+    std::unordered_map<string, vector<size_t> >::const_iterator rows = _paramRowsByTlvName.find(tlvName);
+    if (rows != _paramRowsByTlvName.end())
+    {
+        CONST_VECTOR_ITERATOR(size_t, rows->second, r)
+        {
+            tlv->_params.push_back(newParam(*r));
+        }
+    }
     VECTOR_ITERATOR(std::shared_ptr<Param>, tlv->_params, p)
     {
         (*p)->_port = port;
@@ -419,15 +472,12 @@ TLVConf* MlxcfgDBManager::getAndCreateTLVByName(string tlvName, u_int32_t port,
 
 TLVConf* MlxcfgDBManager::getTLVByNameOnlyAux(string tlv_name)
 {
-    VECTOR_ITERATOR(TLVConf*, fetchedTLVs, it)
+    std::unordered_map<string, vector<TLVConf*> >::const_iterator tlvs = _fetchedTLVsByName.find(tlv_name);
+    if (tlvs == _fetchedTLVsByName.end())
     {
-        TLVConf* t = *it;
-        if (t->_name == tlv_name)
-        {
-            return t;
-        }
+        return NULL;
     }
-    return NULL;
+    return tlvs->second.front();
 }
 
 TLVConf* MlxcfgDBManager::getTLVByName(string tlvName, u_int32_t port, int32_t module)
@@ -468,22 +518,18 @@ TLVConf* MlxcfgDBManager::getDependencyTLVByName(string tlvName, u_int32_t cTLVP
 
 TLVConf* MlxcfgDBManager::getTLVByIndexAndClassAux(u_int32_t id, TLVClass c)
 {
-    VECTOR_ITERATOR(TLVConf*, fetchedTLVs, it)
+    std::map<TLVIdClass, TLVConf*>::const_iterator it = _fetchedTLVByIdClass.find(TLVIdClass(id, c));
+    if (it == _fetchedTLVByIdClass.end())
     {
-        TLVConf* t = *it;
-        if (t->_id == id && t->_tlvClass == c)
-        {
-            return t;
-        }
+        return NULL;
     }
-    return NULL;
+    return it->second;
 }
 
 bool MlxcfgDBManager::isParamMlxconfigNameExist(std::string mlxconfigName)
 {
-    execSQL(selectParamByMlxconfigNameCallBack, this, SQL_SELECT_PARAM_BY_MLXCONFIG_NAME, mlxconfigName.c_str());
-
-    return (mlxconfigName == _paramSqlResult->_mlxconfigName);
+    loadDB();
+    return _paramRowByMlxconfigName.find(mlxconfigName) != _paramRowByMlxconfigName.end();
 }
 
 tuple<string, int> MlxcfgDBManager::splitMlxcfgNameAndPortOrModule(std::string mlxconfigName, SPLITBY splitBy, mfile* mf)
@@ -542,7 +588,33 @@ TLVConf* MlxcfgDBManager::findTLVInExisting(std::string mlxconfigName,
                                             u_int32_t index,
                                             int32_t module)
 {
-    VECTOR_ITERATOR(TLVConf*, fetchedTLVs, it)
+    // Only the TLVs the names belong to can have them, unless none of them is a DB name
+    // (a name with an out of range port/module suffix), then look in all the fetched TLVs
+    string names[] = {noPortModuleMlxcfgName, mlxconfigName, mlxconfigName + getArraySuffixByInterval(index)};
+    vector<TLVConf*> candidates;
+    bool isDBName = false;
+    loadDB();
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+    {
+        std::unordered_map<string, size_t>::const_iterator row = _paramRowByMlxconfigName.find(names[i]);
+        if (row == _paramRowByMlxconfigName.end())
+        {
+            continue;
+        }
+        isDBName = true;
+        std::unordered_map<string, vector<TLVConf*> >::const_iterator tlvs =
+          _fetchedTLVsByName.find(_paramRows.values[row->second][_paramTlvNameCol]);
+        if (tlvs != _fetchedTLVsByName.end())
+        {
+            candidates.insert(candidates.end(), tlvs->second.begin(), tlvs->second.end());
+        }
+    }
+    if (!isDBName)
+    {
+        candidates = fetchedTLVs;
+    }
+
+    VECTOR_ITERATOR(TLVConf*, candidates, it)
     {
         if (((port != 0 || module != -1) &&
              (*it)->findParamByMlxconfigNamePortModule(noPortModuleMlxcfgName, port, module)) ||
@@ -560,14 +632,19 @@ TLVConf* MlxcfgDBManager::findTLVInExisting(std::string mlxconfigName,
 
 void MlxcfgDBManager::findTLVInDB(string mlxconfigName, u_int32_t index)
 {
-    // Try to find it in DB:dd
-    execSQL(selectParamByMlxconfigNameCallBack, this, SQL_SELECT_PARAM_BY_MLXCONFIG_NAME, mlxconfigName.c_str());
+    // Try to find it in DB
+    loadDB();
+    _paramSqlResult.reset();
+    std::unordered_map<string, size_t>::const_iterator row = _paramRowByMlxconfigName.find(mlxconfigName);
 
     // if not found try to find it with continuance array suffix
-    if (!_paramSqlResult)
+    if (row == _paramRowByMlxconfigName.end())
+    {
+        row = _paramRowByMlxconfigName.find(mlxconfigName + getArraySuffixByInterval(index));
+    }
+    if (row != _paramRowByMlxconfigName.end())
     {
-        string newName = mlxconfigName + getArraySuffixByInterval(index);
-        execSQL(selectParamByMlxconfigNameCallBack, this, SQL_SELECT_PARAM_BY_MLXCONFIG_NAME, newName.c_str());
+        _paramSqlResult = newParam(row->second);
     }
 
     if (!_paramSqlResult)
@@ -42,6 +42,8 @@
 
 #include <vector>
 #include <exception>
+#include <map>
+#include <unordered_map>
 
 #include "mlxcfg_tlv.h"
 #include "mlxcfg_param.h"
@@ -53,21 +55,48 @@ enum SPLITBY
     MODULE,
 };
 
+// The rows of a DB table, as passed by sqlite to a callback
+struct DBTable
+{
+    std::vector<std::string> columns;
+    std::vector<std::vector<std::string> > values;
+    std::vector<std::vector<bool> > isNull;
+};
+
 class MlxcfgDBManager
 {
 private:
+    typedef std::pair<u_int32_t, u_int32_t> TLVIdClass;
+
     std::string _dbName;
     sqlite3* _db;
     const unsigned int _supportedVersion;
 
-    static int selectAndCreateNewTLVCallBack(void* object, int argc, char** argv, char** azColName);
-    static int selectTLVCallBack(void*, int, char**, char**);
-    static int selectAndCreateParamCallBack(void* object, int argc, char** argv, char** azColName);
-    static int selectParamCallBack(void*, int, char**, char**);
-    static int selectParamByMlxconfigNameCallBack(void*, int, char**, char**);
+    // The tlvs and params tables are read once, the TLVConf and Param objects are created from their rows
+    bool _isDBLoaded;
+    DBTable _tlvRows;
+    DBTable _paramRows;
+    size_t _paramTlvNameCol;
+    std::unordered_map<std::string, size_t> _tlvRowByName;
+    std::map<TLVIdClass, size_t> _tlvRowByIdClass;
+    std::unordered_map<std::string, std::vector<size_t> > _paramRowsByTlvName;
+    std::unordered_map<std::string, size_t> _paramRowByMlxconfigName;
+
+    // Indexes of fetchedTLVs and fetchedParams
+    std::unordered_map<std::string, std::vector<TLVConf*> > _fetchedTLVsByName;
+    std::map<TLVIdClass, TLVConf*> _fetchedTLVByIdClass;
+    std::unordered_map<std::string, std::vector<std::shared_ptr<Param> > > _fetchedParamsByTlvName;
+
+    static int selectRowCallBack(void* object, int argc, char** argv, char** azColName);
     void openDB();
     void checkDBVersion();
+    void loadDB();
     inline bool isDBFileExists(const std::string& name);
+    TLVConf* newTLVConf(size_t row);
+    std::shared_ptr<Param> newParam(size_t row);
+    void addFetchedTLV(TLVConf* tlv);
+    void addFetchedParam(std::shared_ptr<Param> param);
+    void fetchParamsOfTLV(const std::string& tlvName);
     TLVConf* fetchTLVByName(std::string tlvName, u_int32_t port, int32_t module);
     TLVConf* fetchTLVByIndexAndClass(u_int32_t id, TLVClass c);
 
@@ -38,6 +38,7 @@
  */
 
 #include <algorithm>
+#include <chrono>
 #include <memory>
 #include <mft_sig_handler.h>
 #include <mft_utils.h>
@@ -161,7 +162,8 @@ void GenericCommander::supportsNVData()
     return;
 }
 
-GenericCommander::GenericCommander(mfile* mf, string dbName, Device_Type deviceType) : Commander(mf), _dbManager(NULL)
+GenericCommander::GenericCommander(mfile* mf, string dbName, Device_Type deviceType) :
+    Commander(mf), _dbManager(NULL), _deviceId(DeviceUnknown), _cacheDependencies(false)
 {
     if (_mf != NULL && deviceType != Device_Type::Retimer)
     {
@@ -234,6 +236,7 @@ void GenericCommander::queryConfigViews(std::vector<TLVConfView>& confs, const s
     bool added = false;
     bool config_found = false;
     std::map<std::string, size_t> tlvViewMap;
+    int maxPort = -1;
 
     _dbManager->getAllTLVs();
     VECTOR_ITERATOR(TLVConf*, _dbManager->fetchedTLVs, it)
@@ -253,7 +256,11 @@ void GenericCommander::queryConfigViews(std::vector<TLVConfView>& confs, const s
         vector<ParamView> result;
         if (tlv->isPortTargetClass())
         {
-            for (int i = 1; i <= (*it)->getMaxPort(_mf); i++)
+            if (maxPort < 0)
+            {
+                maxPort = TLVConf::getMaxPort(_mf);
+            }
+            for (int i = 1; i <= maxPort; i++)
             {
                 (*it)->_port = i;
                 (*it)->_module = -1;
@@ -514,17 +521,7 @@ bool GenericCommander::checkDependency(TLVConf* cTLV, string dStr)
 {
     if (dStr.empty())
     {
-        dm_dev_id_t deviceId = DeviceUnknown;
-        u_int32_t hwDevId, hwRevId;
-        if (dm_get_device_id(_mf, &deviceId, &hwDevId, &hwRevId))
-        {
-            throw MlxcfgException("Failed to identify the device");
-        }
-        if (dm_dev_is_switch(deviceId))
-        {
-            return true;
-        }
-        return false;
+        return isSwitchDevice();
     }
     else
     {
@@ -554,12 +551,28 @@ bool GenericCommander::checkDependency(TLVConf* cTLV, string dStr)
             {
                 throw MlxcfgTLVNotFoundException(dTLVName.c_str());
             }
-            if (!dTLV->isFWSupported(_mf, false))
+            TLVInstanceKey key(dTLVName, dTLV->_port, dTLV->_module);
+            if (_cacheDependencies)
+            {
+                map<string, u_int32_t>& values = _dependencyValues[key];
+                map<string, u_int32_t>::const_iterator v = values.find(dParamName);
+                if (v != values.end())
+                {
+                    expression.setVarVal((*it), v->second);
+                    continue;
+                }
+            }
+            if (!isFWReadSupported(dTLV))
             {
                 return false;
             }
             dTLV->query(_mf, QueryNext);
-            expression.setVarVal((*it), dTLV->getParamValueByName(dParamName));
+            u_int32_t dVal = dTLV->getParamValueByName(dParamName);
+            if (_cacheDependencies)
+            {
+                _dependencyValues[key][dParamName] = dVal;
+            }
+            expression.setVarVal((*it), dVal);
         }
     }
 
@@ -582,18 +595,56 @@ void GenericCommander::filterByDependency(TLVConf* cTLV,
     }
 }
 
-void GenericCommander::queryTLV(TLVConf* tlv, vector<ParamView>& paramsConf, bool isWriteOperation, QueryType qt)
+bool GenericCommander::isSwitchDevice()
 {
-    if (!tlv->_cap && tlv->isMlxconfigSupported() && tlv->isFWSupported(_mf, isWriteOperation))
+    if (_deviceId == DeviceUnknown)
     {
-        vector<pair<ParamView, string>> dependencyTable = tlv->query(_mf, qt);
-        filterByDependency(tlv, dependencyTable, paramsConf);
-        for (auto& p : paramsConf)
+        u_int32_t hwDevId, hwRevId;
+        if (dm_get_device_id(_mf, &_deviceId, &hwDevId, &hwRevId))
         {
-            p.isReadOnlyParam = tlv->_isReadOnly;
+            _deviceId = DeviceUnknown;
+            throw MlxcfgException("Failed to identify the device");
         }
     }
-    return;
+    return dm_dev_is_switch(_deviceId);
+}
+
+bool GenericCommander::isFWReadSupported(TLVConf* tlv)
+{
+    TLVInstanceKey key(tlv->_name, tlv->_port, tlv->_module);
+    map<TLVInstanceKey, FWReadSupport>::const_iterator it = _fwReadSupport.find(key);
+    if (it != _fwReadSupport.end())
+    {
+        tlv->_isReadOnly = tlv->_isReadOnly || it->second.readOnly;
+        tlv->_maxTlvVersionSuppByFw = it->second.maxVersion;
+        return it->second.supported;
+    }
+    FWReadSupport support;
+    support.supported = tlv->isFWSupported(_mf, false);
+    support.readOnly = tlv->_isReadOnly;
+    support.maxVersion = tlv->_maxTlvVersionSuppByFw;
+    _fwReadSupport[key] = support;
+    return support.supported;
+}
+
+// Returns false if the TLV was not queried (capability TLV or not supported)
+bool GenericCommander::queryTLV(TLVConf* tlv, vector<ParamView>& paramsConf, bool isWriteOperation, QueryType qt)
+{
+    if (tlv->_cap || !tlv->isMlxconfigSupported())
+    {
+        return false;
+    }
+    if (!(isWriteOperation ? tlv->isFWSupported(_mf, true) : isFWReadSupported(tlv)))
+    {
+        return false;
+    }
+    vector<pair<ParamView, string>> dependencyTable = tlv->query(_mf, qt);
+    filterByDependency(tlv, dependencyTable, paramsConf);
+    for (auto& p : paramsConf)
+    {
+        p.isReadOnlyParam = tlv->_isReadOnly;
+    }
+    return true;
 }
 
 void GenericCommander::queryParamViews(vector<ParamView>& params, bool isWriteOperation, QueryType qt)
@@ -692,37 +743,93 @@ void GenericCommander::queryParamViews(vector<ParamView>& params, bool isWriteOp
     }
 }
 
+namespace
+{
+// Holds the ICMD semaphore across a batch of register accesses, on devices that send them over ICMD
+class IcmdSession
+{
+public:
+    explicit IcmdSession(mfile* mf) : _mf(mf), _open(mf && icmd_session_open(mf) == ME_OK) {}
+    ~IcmdSession()
+    {
+        if (_open)
+        {
+            icmd_session_close(_mf);
+        }
+    }
+
+private:
+    IcmdSession(const IcmdSession&);
+    IcmdSession& operator=(const IcmdSession&);
+
+    mfile* _mf;
+    bool _open;
+};
+} // namespace
+
 void GenericCommander::queryAll(vector<ParamView>& params, vector<string>& failedTLVs, QueryType qt)
 {
+    auto start = chrono::steady_clock::now();
+    u_int32_t regAccesses = getNVRegAccessCount();
+    _queryStats = QueryStats();
+
     _dbManager->getAllTLVs();
+    int maxPort = TLVConf::getMaxPort(_mf);
+    int maxModule = TLVConf::getMaxModule();
+    _dependencyValues.clear();
+    _cacheDependencies = true;
+    IcmdSession icmdSession(_mf);
     VECTOR_ITERATOR(TLVConf*, _dbManager->fetchedTLVs, it)
     {
         try
         {
             vector<ParamView> result;
+            // Issue the queries of all the instances of a TLV back to back, NVQC support is
+            // cached per instance so each port/module is still queried on its own merit
             if ((*it)->isPortTargetClass())
             {
-                for (int i = 1; i <= (*it)->getMaxPort(_mf); i++)
+                for (int i = 1; i <= maxPort; i++)
                 {
                     (*it)->_port = i;
                     (*it)->_module = -1;
-                    queryTLV((*it), result, false, qt);
+                    if (queryTLV((*it), result, false, qt))
+                    {
+                        _queryStats.tlvsQueried++;
+                    }
+                    else
+                    {
+                        _queryStats.tlvsSkipped++;
+                    }
                 }
             }
             else if ((*it)->isModuleTargetClass())
             {
-                for (int i = 0; i <= (*it)->getMaxModule(); i++)
+                for (int i = 0; i <= maxModule; i++)
                 {
                     (*it)->_port = 0;
                     (*it)->_module = i;
-                    queryTLV((*it), result, false, qt);
+                    if (queryTLV((*it), result, false, qt))
+                    {
+                        _queryStats.tlvsQueried++;
+                    }
+                    else
+                    {
+                        _queryStats.tlvsSkipped++;
+                    }
                 }
             }
             else
             {
                 (*it)->_port = 0;
                 (*it)->_module = -1;
-                queryTLV((*it), result, false, qt);
+                if (queryTLV((*it), result, false, qt))
+                {
+                    _queryStats.tlvsQueried++;
+                }
+                else
+                {
+                    _queryStats.tlvsSkipped++;
+                }
             }
             params.insert(params.end(), result.begin(), result.end());
         }
@@ -731,6 +838,11 @@ void GenericCommander::queryAll(vector<ParamView>& params, vector<string>& faile
             failedTLVs.push_back((*it)->_name);
         }
     }
+
+    _cacheDependencies = false;
+    _dependencyValues.clear();
+    _queryStats.regAccesses = getNVRegAccessCount() - regAccesses;
+    _queryStats.usecs = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
 }
 
 void GenericCommander::getCfg(ParamView& pv, QueryType qt)
@@ -40,6 +40,9 @@
 #ifndef MLXCFG_GENERIC_COMMANDER_H_
 #define MLXCFG_GENERIC_COMMANDER_H_
 
+#include <map>
+#include <tuple>
+
 #include <errmsg.h>
 #include <tools_layouts/tools_open_layouts.h>
 
@@ -54,15 +57,31 @@
 class GenericCommander : public Commander
 {
 private:
+    typedef std::tuple<std::string, u_int32_t, int32_t> TLVInstanceKey; // name, port, module
+    struct FWReadSupport
+    {
+        bool supported;
+        bool readOnly;
+        u_int32_t maxVersion;
+    };
+
     MlxcfgDBManager* _dbManager;
+    dm_dev_id_t _deviceId;
+    // NVQC answers of read queries, they do not change while the FW is running
+    std::map<TLVInstanceKey, FWReadSupport> _fwReadSupport;
+    // Dependency parameter values, kept for the duration of a single queryAll
+    bool _cacheDependencies;
+    std::map<TLVInstanceKey, std::map<std::string, u_int32_t> > _dependencyValues;
 
     void supportsNVData();
+    bool isSwitchDevice();
+    bool isFWReadSupported(TLVConf* tlv);
     void printEnums(const ParamView& p, string& s);
     bool checkDependency(TLVConf* cTLV, string dStr);
     void filterByDependency(TLVConf* cTLV,
                             const vector<pair<ParamView, string> >& dependencyTable,
                             vector<ParamView>& result);
-    void queryTLV(TLVConf* conf, std::vector<ParamView>& paramsConf, bool isWriteOperation, QueryType qt);
+    bool queryTLV(TLVConf* conf, std::vector<ParamView>& paramsConf, bool isWriteOperation, QueryType qt);
     void getAllConfigurations(std::vector<TLVConfView>& confs);
     void excludeDuplicatedTLVs(vector<TLVConfView>& s, vector<TLVConfView>& d);
     void printTLVConfViews(FILE* f, vector<TLVConfView>& v);
@@ -484,7 +484,8 @@ void queryAux(Commander* commander,
               vector<ParamView>& paramsToQuery,
               vector<string>& failedTLVs,
               QueryType qT,
-              bool isWriteOperation)
+              bool isWriteOperation,
+              QueryStats& stats)
 {
     if (paramsToQuery.size() != 0)
     {
@@ -494,6 +495,11 @@ void queryAux(Commander* commander,
     else
     {
         commander->queryAll(params, failedTLVs, qT);
+        const QueryStats& s = commander->getQueryStats();
+        stats.tlvsQueried += s.tlvsQueried;
+        stats.tlvsSkipped += s.tlvsSkipped;
+        stats.regAccesses += s.regAccesses;
+        stats.usecs += s.usecs;
     }
 }
 
@@ -595,6 +601,7 @@ mlxCfgStatus MlxCfg::queryDevCfg(Commander* commander,
     printf("\n");
 
     vector<string> defaultFailedTLVs, currentFailedTLVs, nextFailedTLVs;
+    QueryStats queryStats;
 
     try
     {
@@ -627,13 +634,15 @@ mlxCfgStatus MlxCfg::queryDevCfg(Commander* commander,
 
         if (showDefault)
         {
-            queryAux(commander, defaultParams, _mlxParams.setParams, defaultFailedTLVs, QueryDefault, isWriteOperation);
+            queryAux(commander, defaultParams, _mlxParams.setParams, defaultFailedTLVs, QueryDefault, isWriteOperation,
+                     queryStats);
         }
         if (showCurrent)
         {
-            queryAux(commander, currentParams, _mlxParams.setParams, currentFailedTLVs, QueryCurrent, isWriteOperation);
+            queryAux(commander, currentParams, _mlxParams.setParams, currentFailedTLVs, QueryCurrent, isWriteOperation,
+                     queryStats);
         }
-        queryAux(commander, params, _mlxParams.setParams, nextFailedTLVs, QueryNext, isWriteOperation);
+        queryAux(commander, params, _mlxParams.setParams, nextFailedTLVs, QueryNext, isWriteOperation, queryStats);
     }
     catch (MlxcfgException& e)
     {
@@ -694,6 +703,12 @@ mlxCfgStatus MlxCfg::queryDevCfg(Commander* commander,
         {
             printf(DEFAULT_CURRENT_NOT_SUPPORTED_PREFIX "current configurations\n");
         }
+        if (queryStats.tlvsQueried || queryStats.tlvsSkipped)
+        {
+            printf("\nQueried %u TLV instances (%u not supported by the FW) with %u register accesses in %llu msec\n",
+                   queryStats.tlvsQueried, queryStats.tlvsSkipped, queryStats.regAccesses,
+                   (unsigned long long)(queryStats.usecs / 1000));
+        }
     }
 
     if (params.size() == 0)
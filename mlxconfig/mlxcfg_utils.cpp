@@ -59,6 +59,13 @@ using namespace std;
 typedef struct reg_access_hca_mqis_reg_ext mqisReg;
 #define MAX_REG_DATA 128
 
+static u_int32_t nvRegAccessCount = 0;
+
+u_int32_t getNVRegAccessCount()
+{
+    return nvRegAccessCount;
+}
+
 void dealWithSignal()
 {
     int sig;
@@ -108,6 +115,7 @@ MError
     // "suspend" signals as we are going to take semaphores
     mft_signal_set_handling(1);
     // DEBUG_PRINT_SEND(&mnvaTlv, nvda);
+    nvRegAccessCount++;
     rc = reg_access_mnvda(mf, method, &mnvaTlv);
     // DEBUG_PRINT_RECEIVE(&mnvaTlv, nvda);
     dealWithSignal();
@@ -129,6 +137,7 @@ MError nvqcCom5thGen(mfile* mf, u_int32_t tlvType, bool& suppRead, bool& suppWri
     MError rc;
     // "suspend" signals as we are going to take semaphores
     mft_signal_set_handling(1);
+    nvRegAccessCount++;
     rc = reg_access_mnvqc(mf, REG_ACCESS_METHOD_GET, &nvqcTlv);
     dealWithSignal();
     if (rc)
@@ -161,6 +170,7 @@ MError nvdiCom5thGen(mfile* mf, u_int32_t tlvType)
     // "suspend" signals as we are going to take semaphores
     mft_signal_set_handling(1);
     // DEBUG_PRINT_SEND(&nvdiTlv, nvdi);
+    nvRegAccessCount++;
     rc = reg_access_mnvdi(mf, REG_ACCESS_METHOD_SET, &nvdiTlv);
     // DEBUG_PRINT_RECEIVE(&nvdiTlv, nvdi);
     dealWithSignal();
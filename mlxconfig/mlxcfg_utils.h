@@ -157,6 +157,9 @@ MError nvqcCom5thGen(mfile* mf, u_int32_t tlvType, bool& suppRead, bool& suppWri
 
 MError nvdiCom5thGen(mfile* mf, u_int32_t tlvType);
 
+// Number of MNVDA/MNVQC/MNVDI accesses issued by this process so far
+u_int32_t getNVRegAccessCount();
+
 bool strToNum(std::string str, u_int32_t& num, int base = 0);
 
 std::string numToStr(u_int32_t num, bool isHex = false);
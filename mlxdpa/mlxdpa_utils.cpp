@@ -38,6 +38,7 @@
 #include <cstring>
 #include <algorithm>
 #include "compatibility.h"
+#include "tools_crc16.h"
 
 void RunCommand(string cmd, string errorMsg)
 {
@@ -135,10 +136,22 @@ void Crc16::operator<<(std::vector<u_int8_t> v)
         fprintf(stderr, "Internal error: Image section size should be 4-bytes aligned");
         exit(1);
     }
-    for (u_int32_t i = 0; i < v.size(); i += 4)
+    std::vector<u_int32_t> dws(v.size() / 4);
+    for (u_int32_t i = 0; i < dws.size(); i++)
     {
-        u_int32_t dw_be = __cpu_to_be32(*((u_int32_t*)(&v[i])));
-        add(dw_be);
+        dws[i] = __cpu_to_be32(*((u_int32_t*)(&v[i * 4])));
+    }
+    if (_debug)
+    {
+        for (u_int32_t i = 0; i < dws.size(); i++)
+        {
+            add(dws[i]);
+        }
+        return;
+    }
+    if (!dws.empty())
+    {
+        _crc = mstflint::common::crc16::add_dwords(_crc, &dws[0], (u_int32_t)dws.size());
     }
 }
 
@@ -148,36 +161,12 @@ void Crc16::add(u_int32_t o)
     {
         printf("Crc16::add(%08x)\n", o);
     }
-    for (int i = 0; i < 32; i++)
-    {
-        if (_crc & 0x8000)
-        {
-            _crc = (((_crc << 1) | (o >> 31)) ^ 0x100b) & 0xffff;
-        }
-        else
-        {
-            _crc = ((_crc << 1) | (o >> 31)) & 0xffff;
-        }
-        o = (o << 1) & 0xffffffff;
-    }
+    _crc = mstflint::common::crc16::add_dword(_crc, o);
 }
 
 void Crc16::finish()
 {
-    for (int i = 0; i < 16; i++)
-    {
-        if (_crc & 0x8000)
-        {
-            _crc = ((_crc << 1) ^ 0x100b) & 0xffff;
-        }
-        else
-        {
-            _crc = (_crc << 1) & 0xffff;
-        }
-    }
-
-    // Revert 16 low bits
-    _crc = _crc ^ 0xffff;
+    _crc = mstflint::common::crc16::finish(_crc);
 }
 
 MlxDpaException::MlxDpaException(const char* fmt, ...)
@@ -39,6 +39,7 @@
 
 #include <stdarg.h>
 #include "flint_base.h"
+#include "tools_crc16.h"
 
 #define DPRINTF(args)                                      \
     do                                                     \
@@ -251,38 +252,27 @@ void Crc16::add(u_int32_t o)
     {
         printf("Crc16::add(%08x)\n", o);
     }
-    for (int i = 0; i < 32; i++)
-    {
-        if (_crc & 0x8000)
-        {
-            _crc = (u_int16_t)((((_crc << 1) | (o >> 31)) ^ 0x100b) & 0xffff);
-        }
-        else
-        {
-            _crc = (u_int16_t)(((_crc << 1) | (o >> 31)) & 0xffff);
-        }
-        o = (o << 1) & 0xffffffff;
-    }
+    _crc = mstflint::common::crc16::add_dword(_crc, o);
 } // Crc16::add
 
 ////////////////////////////////////////////////////////////////////////
-void Crc16::finish()
+void Crc16::add(const u_int32_t* data, u_int32_t num_dwords)
 {
-    for (int i = 0; i < 16; i++)
+    if (_debug)
     {
-        if (_crc & 0x8000)
+        for (u_int32_t i = 0; i < num_dwords; i++)
         {
-            _crc = ((_crc << 1) ^ 0x100b) & 0xffff;
-        }
-        else
-        {
-            _crc = (_crc << 1) & 0xffff;
+            add(data[i]);
         }
+        return;
     }
+    _crc = mstflint::common::crc16::add_dwords(_crc, data, num_dwords);
+} // Crc16::add
 
-    // Revert 16 low bits
-    _crc = _crc ^ 0xffff;
-
+////////////////////////////////////////////////////////////////////////
+void Crc16::finish()
+{
+    _crc = mstflint::common::crc16::finish(_crc);
 } // Crc16::finish
 
 #ifdef UEFI_BUILD
@@ -165,13 +165,7 @@ using namespace std;
         for (u_int32_t ii = 0; ii < sizeof(s) / sizeof(u_int32_t); ii++) \
             c << *p++;                                                   \
     } while (0)
-#define CRCn(c, s, n)                          \
-    do                                         \
-    {                                          \
-        u_int32_t* p = (u_int32_t*)(s);        \
-        for (u_int32_t ii = 0; ii < (n); ii++) \
-            c << *p++;                         \
-    } while (0)
+#define CRCn(c, s, n) (c).add((u_int32_t*)(s), (n))
 #define CRCBY(c, s)                                                      \
     do                                                                   \
     {                                                                    \
@@ -186,13 +180,7 @@ using namespace std;
         for (u_int32_t ii = 0; ii < sizeof(s) / sizeof(u_int32_t) - 1; ii++) \
             c << *p++;                                                       \
     } while (0)
-#define CRC1n(c, s, n)                           \
-    do                                           \
-    {                                            \
-        u_int32_t* p = (u_int32_t*)(s);          \
-        for (u_int32_t ii = 0; ii < (n)-1; ii++) \
-            c << *p++;                           \
-    } while (0)
+#define CRC1n(c, s, n) (c).add((u_int32_t*)(s), (n)-1)
 #define CRC1BY(c, s)                                                         \
     do                                                                       \
     {                                                                        \
@@ -556,6 +544,7 @@ public:
     void clear() { _crc = 0xffff; }
     void operator<<(u_int32_t val) { add(val); }
     void add(u_int32_t val);
+    void add(const u_int32_t* data, u_int32_t num_dwords);
     void finish();
 
 private:
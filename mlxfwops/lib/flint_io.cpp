@@ -38,6 +38,10 @@
  */
 
 #include <errno.h>
+#include <algorithm>
+#ifndef UEFI_BUILD
+#include <chrono>
+#endif
 #include <tools_dev_types.h>
 #include "flint_io.h"
 
@@ -482,6 +486,9 @@ void Flash::close()
         return;
     }
 
+    // A burn that completed has flushed its last sector, one still pending was left by a burn that failed
+    _diff_sector = 0xffffffff;
+
     mf_close(_mfl);
     _mfl = 0;
 } // Flash::close
@@ -674,10 +681,24 @@ bool Flash::write(u_int32_t addr, void* data, int cnt, bool noerase)
 
     Aligner align(first_set);
     align.Init(addr, cnt);
+    bool diff_burn = _diff_burn && !noerase && !_no_burn;
+    if (!diff_burn && !diff_burn_flush())
+    {
+        return false;
+    }
+
     while (align.GetNextChunk(chunk_addr, chunk_size))
     {
         // Write / Erase in sector_size aligned chunks
-        int rc;
+        if (diff_burn)
+        {
+            if (!diff_write_chunk(chunk_addr, chunk_size, p))
+            {
+                return false;
+            }
+            p += chunk_size;
+            continue;
+        }
 
         if (!noerase)
         {
@@ -698,46 +719,231 @@ bool Flash::write(u_int32_t addr, void* data, int cnt, bool noerase)
         }
 
         // Actual write:
-        u_int32_t phys_addr = cont2phys(chunk_addr);
-        // printf("-D- write: addr = %#x, phys_addr = %#x\n", chunk_addr, phys_addr);
-        mft_signal_set_handling(1);
-        if (_cputUtilizationApplied)
+        if (!write_chunk(chunk_addr, chunk_size, p))
         {
-            mf_set_cpu_utilization(_mfl, _cpuPercent);
+            return false;
         }
-        rc = mf_write(_mfl, phys_addr, chunk_size, p);
-        deal_with_signal();
 
-        if (rc != MFE_OK)
+        // Loop advance
+        p += chunk_size;
+    }
+
+    return true;
+}
+
+bool Flash::write_chunk(u_int32_t chunk_addr, u_int32_t chunk_size, u_int8_t* p)
+{
+    int rc;
+    u_int32_t phys_addr = cont2phys(chunk_addr);
+    // printf("-D- write: addr = %#x, phys_addr = %#x\n", chunk_addr, phys_addr);
+    mft_signal_set_handling(1);
+    if (_cputUtilizationApplied)
+    {
+        mf_set_cpu_utilization(_mfl, _cpuPercent);
+    }
+    rc = mf_write(_mfl, phys_addr, chunk_size, p);
+    deal_with_signal();
+
+    if (rc != MFE_OK)
+    {
+        if (rc == MFE_ICMD_BAD_PARAM || rc == MFE_REG_ACCESS_BAD_PARAM)
         {
-            if (rc == MFE_ICMD_BAD_PARAM || rc == MFE_REG_ACCESS_BAD_PARAM)
-            {
-                return errmsg(
-                  "Flash write of %d bytes to address %s0x%x failed: %s\n"
-                  "    This may indicate that a FW image was already updated on flash, but not loaded by the device.\n"
-                  "    Please load FW on the device (reset device or reboot machine) before burning a new FW.",
-                  chunk_size,
-                  _log2_chunk_size ? "physical " : "",
-                  chunk_addr,
-                  mf_err2str(rc));
-            }
-            else
+            return errmsg(
+              "Flash write of %d bytes to address %s0x%x failed: %s\n"
+              "    This may indicate that a FW image was already updated on flash, but not loaded by the device.\n"
+              "    Please load FW on the device (reset device or reboot machine) before burning a new FW.",
+              chunk_size,
+              _log2_chunk_size ? "physical " : "",
+              chunk_addr,
+              mf_err2str(rc));
+        }
+        else
+        {
+            return errmsg("Flash write of %d bytes to address %s0x%x failed: %s",
+                          chunk_size,
+                          _log2_chunk_size ? "physical " : "",
+                          chunk_addr,
+                          mf_err2str(rc));
+        }
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////
+// Differential burn
+//
+// A regular burn erases every sector on its first touch and programs the data written to it, so bytes of
+// the sector that the burn doesn't write end up blank. Here the sector is read once and each chunk is:
+//   - skipped if the flash already holds it,
+//   - programmed without erase if the flash area is blank,
+//   - otherwise the sector is erased and everything written to it so far is programmed again.
+// When the burn leaves the sector, bytes it didn't write that aren't blank are cleared the same way.
+
+// Typical SPI NOR timings, used to estimate the time saved before any erase/program was measured.
+#define DIFF_BURN_NOMINAL_ERASE_4K_USECS 50000
+#define DIFF_BURN_NOMINAL_ERASE_64K_USECS 250000
+#define DIFF_BURN_NOMINAL_PROGRAM_NSECS_PER_BYTE 3000
+
+static u_int64_t diff_burn_now_usecs()
+{
+#ifdef UEFI_BUILD
+    return 0;
+#else
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+static bool is_blank(const u_int8_t* data, u_int32_t size)
+{
+    for (u_int32_t i = 0; i < size; i++)
+    {
+        if (data[i] != 0xff)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Flash::diff_erase_and_program()
+{
+    u_int32_t sect_size = (u_int32_t)_diff_target.size();
+    u_int64_t start = diff_burn_now_usecs();
+
+    if (!erase_sector_int(_diff_sector))
+    {
+        return false;
+    }
+    _diff_stats.erase_usecs += diff_burn_now_usecs() - start;
+    _diff_sector_erased = true;
+
+    // Program what the burn wrote to the sector so far, blank blocks are skipped by mflash.
+    start = diff_burn_now_usecs();
+    if (!write_chunk(_diff_sector, sect_size, &_diff_target[0]))
+    {
+        return false;
+    }
+    _diff_stats.write_usecs += diff_burn_now_usecs() - start;
+    _diff_stats.bytes_written += std::count(_diff_touched.begin(), _diff_touched.end(), 1);
+    _diff_sector_written = true;
+    _diff_flash = _diff_target;
+    return true;
+}
+
+bool Flash::diff_write_chunk(u_int32_t chunk_addr, u_int32_t chunk_size, u_int8_t* p)
+{
+    u_int32_t sect_size = get_current_sector_size();
+    u_int32_t sector = chunk_addr & ~(sect_size - 1);
+    u_int32_t offset = chunk_addr - sector;
+    u_int64_t start;
+
+    if (sector != _diff_sector || sect_size != _diff_target.size())
+    {
+        if (!diff_burn_flush())
+        {
+            return false;
+        }
+        _diff_flash.resize(sect_size);
+        start = diff_burn_now_usecs();
+        if (!read(sector, &_diff_flash[0], sect_size))
+        {
+            return false;
+        }
+        _diff_stats.read_usecs += diff_burn_now_usecs() - start;
+        _diff_target.assign(sect_size, 0xff);
+        _diff_touched.assign(sect_size, 0);
+        _diff_sector = sector;
+        _diff_sector_erased = false;
+        _diff_sector_written = false;
+    }
+
+    memcpy(&_diff_target[offset], p, chunk_size);
+    memset(&_diff_touched[offset], 1, chunk_size);
+
+    if (!memcmp(&_diff_flash[offset], p, chunk_size))
+    {
+        _diff_stats.bytes_skipped += chunk_size;
+        return true;
+    }
+    if (is_blank(&_diff_flash[offset], chunk_size))
+    {
+        start = diff_burn_now_usecs();
+        if (!write_chunk(chunk_addr, chunk_size, p))
+        {
+            return false;
+        }
+        _diff_stats.write_usecs += diff_burn_now_usecs() - start;
+        _diff_stats.bytes_written += chunk_size;
+        _diff_sector_written = true;
+        memcpy(&_diff_flash[offset], p, chunk_size);
+        return true;
+    }
+    return diff_erase_and_program();
+}
+
+bool Flash::diff_burn_flush()
+{
+    if (_diff_sector == 0xffffffff)
+    {
+        return true;
+    }
+
+    // Bytes this burn didn't write are left blank by a regular burn.
+    for (u_int32_t i = 0; i < _diff_flash.size(); i++)
+    {
+        if (!_diff_touched[i] && _diff_flash[i] != 0xff)
+        {
+            if (!diff_erase_and_program())
             {
-                return errmsg("Flash write of %d bytes to address %s0x%x failed: %s",
-                              chunk_size,
-                              _log2_chunk_size ? "physical " : "",
-                              chunk_addr,
-                              mf_err2str(rc));
+                _diff_sector = 0xffffffff;
+                return false;
             }
+            break;
         }
-
-        // Loop advance
-        p += chunk_size;
     }
 
+    if (_diff_sector_erased)
+    {
+        _diff_stats.sectors_erased++;
+    }
+    else if (_diff_sector_written)
+    {
+        _diff_stats.sectors_written++;
+    }
+    else
+    {
+        _diff_stats.sectors_skipped++;
+    }
+    _diff_sector = 0xffffffff;
     return true;
 }
 
+const Flash::diff_burn_stats_t& Flash::get_diff_burn_stats()
+{
+    u_int32_t sect_size = get_current_sector_size();
+    u_int64_t erase_usecs = sect_size <= 0x1000 ? DIFF_BURN_NOMINAL_ERASE_4K_USECS : DIFF_BURN_NOMINAL_ERASE_64K_USECS;
+    u_int64_t erases_skipped = _diff_stats.sectors_skipped + _diff_stats.sectors_written;
+    u_int64_t saved_usecs;
+
+    // Prefer the timings measured during this burn.
+    if (_diff_stats.sectors_erased)
+    {
+        erase_usecs = _diff_stats.erase_usecs / _diff_stats.sectors_erased;
+    }
+    if (_diff_stats.bytes_written)
+    {
+        saved_usecs = _diff_stats.write_usecs * _diff_stats.bytes_skipped / _diff_stats.bytes_written;
+    }
+    else
+    {
+        saved_usecs = _diff_stats.bytes_skipped * DIFF_BURN_NOMINAL_PROGRAM_NSECS_PER_BYTE / 1000;
+    }
+    saved_usecs += erases_skipped * erase_usecs;
+    _diff_stats.saved_usecs = saved_usecs > _diff_stats.read_usecs ? saved_usecs - _diff_stats.read_usecs : 0;
+    return _diff_stats;
+}
+
 ////////////////////////////////////////////////////////////////////////
 bool Flash::write(u_int32_t addr, u_int32_t data)
 {
@@ -816,6 +1022,17 @@ bool Flash::write_with_erase(u_int32_t addr, void* data, int cnt)
 }
 
 bool Flash::erase_sector(u_int32_t addr)
+{
+    // The cached copy of an open differential burn sector would go stale.
+    if (_diff_sector != 0xffffffff && (addr & ~((u_int32_t)_diff_target.size() - 1)) == _diff_sector &&
+        !diff_burn_flush())
+    {
+        return false;
+    }
+    return erase_sector_int(addr);
+}
+
+bool Flash::erase_sector_int(u_int32_t addr)
 {
     int rc;
     u_int32_t phys_addr = cont2phys(addr);
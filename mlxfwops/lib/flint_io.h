@@ -369,9 +369,14 @@ public:
         _cr_space_locked(0),
         _flash_working_mode(FBase::Fwm_Default),
         _cputUtilizationApplied(false),
-        _cpuPercent(-1)
+        _cpuPercent(-1),
+        _diff_burn(false),
+        _diff_sector(0xffffffff),
+        _diff_sector_erased(false),
+        _diff_sector_written(false)
     {
         memset(&_attr, 0, sizeof(_attr));
+        memset(&_diff_stats, 0, sizeof(_diff_stats));
     }
 
     virtual ~Flash() { close(); };
@@ -459,6 +464,27 @@ public:
     bool is_flash_write_protected();
     static void deal_with_signal();
 
+    // Differential burn: write() reads each sector first, skips data already on the flash and
+    // erases only sectors whose current content can't be programmed over (not blank).
+    // The final flash content is the same as with a regular burn once diff_burn_flush() is called,
+    // close() drops a sector still pending.
+    struct diff_burn_stats_t
+    {
+        u_int32_t sectors_skipped; // already held the data, neither erased nor written
+        u_int32_t sectors_erased;
+        u_int32_t sectors_written; // programmed without erase, the target area was blank
+        u_int64_t bytes_skipped;
+        u_int64_t bytes_written;
+        u_int64_t read_usecs;
+        u_int64_t erase_usecs;
+        u_int64_t write_usecs;
+        u_int64_t saved_usecs; // estimated erase and program time not spent, minus the read back time
+    };
+    void set_differential_burn(bool val) { _diff_burn = val; }
+    bool get_differential_burn() { return _diff_burn; }
+    bool diff_burn_flush();
+    const diff_burn_stats_t& get_diff_burn_stats();
+
     mfile* getMfileObj() { return mf_get_mfile(_mfl); }
     mflash* getMflashObj() { return _mfl; }
 
@@ -484,6 +510,10 @@ public:
 protected:
     bool write_sector_with_erase(u_int32_t addr, void* data, int cnt);
     bool write_with_erase(u_int32_t addr, void* data, int cnt);
+    bool write_chunk(u_int32_t chunk_addr, u_int32_t chunk_size, u_int8_t* p);
+    bool erase_sector_int(u_int32_t addr);
+    bool diff_write_chunk(u_int32_t chunk_addr, u_int32_t chunk_size, u_int8_t* p);
+    bool diff_erase_and_program();
 
     mflash* _mfl;
     flash_attr _attr;
@@ -497,6 +527,16 @@ protected:
     int _flash_working_mode;
     bool _cputUtilizationApplied;
     int _cpuPercent;
+
+    // Differential burn state of the sector currently written
+    bool _diff_burn;
+    u_int32_t _diff_sector;               // 0xffffffff when no sector is open
+    bool _diff_sector_erased;             // erased during this burn
+    bool _diff_sector_written;            // programmed during this burn
+    std::vector<u_int8_t> _diff_flash;    // flash content of the sector
+    std::vector<u_int8_t> _diff_target;   // content a regular burn would leave, 0xff where nothing was written
+    std::vector<u_int8_t> _diff_touched;  // bytes written by this burn
+    diff_burn_stats_t _diff_stats;
 };
 
 #endif
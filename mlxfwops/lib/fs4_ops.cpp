@@ -39,6 +39,7 @@
 #include "common/tools_utils.h"
 #include "common/bit_slice.h"
 #include "common/tools_time.h"
+#include "common/tools_parallel.h"
 #include <mtcr.h>
 #include <reg_access/reg_access.h>
 #include <calc_hw_crc.h>
@@ -626,33 +627,20 @@ bool Fs4Operations::FwExtract4MBImage(vector<u_int8_t>& img,
     return res;
 }
 
-bool Fs4Operations::verifyTocEntries(u_int32_t tocAddr,
-                                     bool show_itoc,
-                                     bool isDtoc,
-                                     struct QueryOptions queryOptions,
-                                     VerifyCallBack verifyCallBackFunc,
-                                     bool verbose)
+bool Fs4Operations::readTocEntries(u_int32_t tocAddr,
+                                   bool show_itoc,
+                                   bool isDtoc,
+                                   struct QueryOptions queryOptions,
+                                   std::vector<TocSectionCheck>& sections,
+                                   int& numOfEntries,
+                                   bool verbose)
 {
     struct image_layout_itoc_entry tocEntry;
     int section_index = 0;
     u_int32_t entryAddr;
     u_int32_t entryCrc;
     u_int32_t entrySizeInBytes;
-    u_int32_t physAddr;
     u_int8_t entryBuffer[TOC_ENTRY_SIZE];
-    bool mfgExists = false;
-    int validDevInfoCount = 0;
-    bool retVal = true;
-    TocArray* tocArray;
-
-    if (isDtoc)
-    {
-        tocArray = &(_fs4ImgInfo.dtocArr);
-    }
-    else
-    {
-        tocArray = &(_fs4ImgInfo.itocArr);
-    }
 
     do
     {
@@ -672,10 +660,6 @@ bool Fs4Operations::verifyTocEntries(u_int32_t tocAddr,
 
         Fs3UpdateImgCache(entryBuffer, entryAddr, TOC_ENTRY_SIZE);
         image_layout_itoc_entry_unpack(&tocEntry, entryBuffer);
-        if (tocEntry.type == FS3_MFG_INFO)
-        {
-            mfgExists = true;
-        }
 
         if (tocEntry.type != FS3_END)
         {
@@ -704,166 +688,264 @@ bool Fs4Operations::verifyTocEntries(u_int32_t tocAddr,
 
             entrySizeInBytes = tocEntry.size * 4;
 
+            sections.push_back(TocSectionCheck());
+            TocSectionCheck& check = sections.back();
+            check.sectionIndex = section_index;
+            check.entryAddr = entryAddr;
+            check.tocEntry = tocEntry;
+            memcpy(check.entryBuffer, entryBuffer, TOC_ENTRY_SIZE);
+            check.actCrc = 0;
+            check.expCrc = 0;
+
             // Update last image address
             u_int32_t section_last_addr;
-            u_int32_t flash_addr = tocEntry.flash_addr << 2;
+            check.flashAddr = tocEntry.flash_addr << 2;
             if (isDtoc)
             {
-                physAddr = flash_addr;
+                check.physAddr = check.flashAddr;
                 _fs4ImgInfo.smallestDTocAddr =
-                  (_fs4ImgInfo.smallestDTocAddr < flash_addr && _fs4ImgInfo.smallestDTocAddr > 0) ?
+                  (_fs4ImgInfo.smallestDTocAddr < check.flashAddr && _fs4ImgInfo.smallestDTocAddr > 0) ?
                     _fs4ImgInfo.smallestDTocAddr :
-                    flash_addr;
+                    check.flashAddr;
             }
             else
             {
-                physAddr =
-                  _ioAccess->get_phys_from_cont(flash_addr, _fwImgInfo.cntxLog2ChunkSize, _fwImgInfo.imgStart != 0);
-                section_last_addr = physAddr + entrySizeInBytes;
+                check.physAddr = _ioAccess->get_phys_from_cont(check.flashAddr, _fwImgInfo.cntxLog2ChunkSize,
+                                                               _fwImgInfo.imgStart != 0);
+                section_last_addr = check.physAddr + entrySizeInBytes;
                 _fwImgInfo.lastImageAddr =
                   (_fwImgInfo.lastImageAddr >= section_last_addr) ? _fwImgInfo.lastImageAddr : section_last_addr;
             }
 
-            if (IsFs3SectionReadable(tocEntry.type, queryOptions))
+            // Only when we have full verify or the info of this section should be collected for query
+            check.readable = IsFs3SectionReadable(tocEntry.type, queryOptions);
+            if (check.readable && !show_itoc)
             {
-                // Only when we have full verify or the info of this section should be collected for query
-                std::vector<u_int8_t> buffv(entrySizeInBytes);
-                u_int8_t* buff = (u_int8_t*)(buffv.size() ? (&(buffv[0])) : NULL);
-
-                if (show_itoc)
+                //* Choosing the correct io access to read from
+                FBase* io = _ioAccess;
+                if (_encrypted_image_io_access)
                 {
-                    image_layout_itoc_entry_dump(&tocEntry, stdout);
-                    if (!DumpFs3CRCCheck(tocEntry.type, physAddr, entrySizeInBytes, 0, 0, true, verifyCallBackFunc))
-                    {
-                        retVal = false;
-                    }
+                    io = _encrypted_image_io_access; // If encrypted image was given we'll read from it
                 }
-                else
+                DPRINTF(("Fs4Operations::verifyTocEntries reading %s %s section from %simage\n",
+                         GetSectionNameByType(tocEntry.type),
+                         isDtoc ? "DTOC" : "ITOC",
+                         _encrypted_image_io_access ? "encrypted " : ""));
+
+                check.data.resize(entrySizeInBytes);
+                u_int8_t* buff = (u_int8_t*)(check.data.size() ? (&(check.data[0])) : NULL);
+                if (!(*io).read(check.flashAddr, buff, entrySizeInBytes, verbose))
                 {
-                    //* Choosing the correct io access to read from
-                    FBase* io = _ioAccess;
-                    if (_encrypted_image_io_access)
-                    {
-                        io = _encrypted_image_io_access; // If encrypted image was given we'll read from it
-                    }
-                    DPRINTF(("Fs4Operations::verifyTocEntries reading %s %s section from %simage\n",
-                             GetSectionNameByType(tocEntry.type),
-                             isDtoc ? "DTOC" : "ITOC",
-                             _encrypted_image_io_access ? "encrypted " : ""));
+                    sections.pop_back();
+                    return errmsg("%s - read error (%s)\n", "Section", (*io).err());
+                }
 
-                    if (!(*io).read(flash_addr, buff, entrySizeInBytes, verbose))
-                    {
-                        return errmsg("%s - read error (%s)\n", "Section", (*io).err());
-                    }
+                Fs3UpdateImgCache(buff, check.flashAddr, entrySizeInBytes);
+            }
+        }
+        if (nextBootFwVer)
+        {
+            // if nextBootFwVer, return after reading fw version
+            break;
+        }
+        section_index++;
+    } while (tocEntry.type != FS3_END);
 
-                    Fs3UpdateImgCache(buff, flash_addr, entrySizeInBytes);
-                    u_int32_t sect_act_crc = 0;
-                    u_int32_t sect_exp_crc = 0;
-                    if (tocEntry.crc == INITOCENTRY)
-                    {
-                        // crc is in the itoc entry
-                        sect_act_crc = CalcImageCRC((u_int32_t*)buff, tocEntry.size);
-                        sect_exp_crc = tocEntry.section_crc;
-                        // printf("-D-INITOCENTRY sect_act_crc=%d sect_exp_crc=%d\n", sect_act_crc, sect_exp_crc);
-                    }
-                    else if (tocEntry.crc == INSECTION)
+    numOfEntries = section_index;
+    return true;
+}
+
+void Fs4Operations::calcTocSectionsCrc(std::vector<TocSectionCheck>& sections)
+{
+    std::vector<TocSectionCheck*> pending;
+    u_int64_t totalSize = 0;
+    for (size_t i = 0; i < sections.size(); i++)
+    {
+        TocSectionCheck& check = sections[i];
+        if (check.readable && (check.tocEntry.crc == INITOCENTRY || check.tocEntry.crc == INSECTION))
+        {
+            pending.push_back(&check);
+            totalSize += check.data.size();
+        }
+    }
+
+    // The sections are in memory at this point, so their CRCs are independent of each other and of the IO
+    unsigned workers = 1;
+    if (totalSize >= FS4_PARALLEL_VERIFY_MIN_SIZE)
+    {
+        workers = mstflint::common::parallel::workers_from_env(FS4_VERIFY_THREADS_ENV, FS4_MAX_VERIFY_THREADS);
+    }
+    DPRINTF(("Fs4Operations::calcTocSectionsCrc %u sections, %llu bytes, %u workers\n", (unsigned)pending.size(),
+             (unsigned long long)totalSize, workers));
+
+    mstflint::common::parallel::for_each_index(pending.size(), workers, [this, &pending](size_t i) {
+        TocSectionCheck& check = *pending[i];
+        u_int32_t* buff = (u_int32_t*)(check.data.size() ? (&(check.data[0])) : NULL);
+        if (check.tocEntry.crc == INITOCENTRY)
+        {
+            // crc is in the itoc entry
+            check.actCrc = CalcImageCRC(buff, check.tocEntry.size);
+            check.expCrc = check.tocEntry.section_crc;
+        }
+        else
+        {
+            // calc crc on the section without the last dw which contains crc
+            check.actCrc = CalcImageCRC(buff, check.tocEntry.size - 1);
+            // crc is in the section, last two bytes
+            u_int32_t sect_exp_crc = buff[check.tocEntry.size - 1];
+            TOCPU1(sect_exp_crc)
+            check.expCrc = (u_int16_t)sect_exp_crc;
+        }
+    });
+}
+
+bool Fs4Operations::verifyTocEntries(u_int32_t tocAddr,
+                                     bool show_itoc,
+                                     bool isDtoc,
+                                     struct QueryOptions queryOptions,
+                                     VerifyCallBack verifyCallBackFunc,
+                                     bool verbose)
+{
+    std::vector<TocSectionCheck> sections;
+    int section_index = 0;
+    bool mfgExists = false;
+    int validDevInfoCount = 0;
+    bool retVal = true;
+    TocArray* tocArray;
+
+    if (isDtoc)
+    {
+        tocArray = &(_fs4ImgInfo.dtocArr);
+    }
+    else
+    {
+        tocArray = &(_fs4ImgInfo.itocArr);
+    }
+
+    // Read all entries and section data first, then check the sections in parallel and report them in TOC order.
+    // A read error is returned only after the sections before it were reported, as when checking one by one.
+    bool readOk = readTocEntries(tocAddr, show_itoc, isDtoc, queryOptions, sections, section_index, verbose);
+    std::string readErr;
+    int readErrCode = 0;
+    if (!readOk)
+    {
+        readErr = err() ? err() : "";
+        readErrCode = getErrorCode();
+    }
+    if (!show_itoc)
+    {
+        calcTocSectionsCrc(sections);
+    }
+
+    for (size_t i = 0; i < sections.size(); i++)
+    {
+        TocSectionCheck& check = sections[i];
+        struct image_layout_itoc_entry& tocEntry = check.tocEntry;
+        int sectionIndex = check.sectionIndex;
+        u_int32_t entrySizeInBytes = tocEntry.size * 4;
+        if (tocEntry.type == FS3_MFG_INFO)
+        {
+            mfgExists = true;
+        }
+
+        if (check.readable)
+        {
+            u_int8_t* buff = (u_int8_t*)(check.data.size() ? (&(check.data[0])) : NULL);
+
+            if (show_itoc)
+            {
+                image_layout_itoc_entry_dump(&tocEntry, stdout);
+                if (!DumpFs3CRCCheck(tocEntry.type, check.physAddr, entrySizeInBytes, 0, 0, true, verifyCallBackFunc))
+                {
+                    retVal = false;
+                }
+            }
+            else
+            {
+                if (tocEntry.type != FS3_DEV_INFO || CheckDevInfoSignature((u_int32_t*)buff))
+                {
+                    // Check if a cache_line_crc section (Ex. MAIN_CODE) is encrypted (has 4B AUTH-TAG) or not (has
+                    // 2B CRC)
+                    bool is_encrypted_cache_line_crc_section = false;
+                    if (tocEntry.cache_line_crc == 1)
                     {
-                        // calc crc on the section without the last dw which contains crc
-                        sect_act_crc = CalcImageCRC((u_int32_t*)buff, tocEntry.size - 1);
-                        // crc is in the section, last two bytes
-                        sect_exp_crc = ((u_int32_t*)buff)[tocEntry.size - 1];
-                        TOCPU1(sect_exp_crc)
-                        sect_exp_crc = (u_int16_t)sect_exp_crc;
-                        // printf("-D-INSECTION sect_act_crc=%d sect_exp_crc=%d\n", sect_act_crc, sect_exp_crc);
+                        u_int32_t first_line_crc_or_authtag = ((u_int32_t*)buff)[16]; // DWORD 16 is CRC or AUTH-TAG
+                        TOCPU1(first_line_crc_or_authtag)
+                        bool is_authtag = (first_line_crc_or_authtag & 0xffff0000) != 0x0;
+                        is_encrypted_cache_line_crc_section = is_authtag; // if encrypted section will have auth-tag
                     }
 
-                    if (tocEntry.type != FS3_DEV_INFO || CheckDevInfoSignature((u_int32_t*)buff))
+                    bool ignore_crc = (tocEntry.crc == NOCRC) ||
+                                      is_encrypted_cache_line_crc_section; // In case of encrypted MAIN_CODE section
+                                                                           // we'll ignore CRC
+                    if (!_encrypted_image_io_access && // In case of encrypted image we don't want to check section
+                                                       // CRC
+                        !DumpFs3CRCCheck(tocEntry.type, check.physAddr, entrySizeInBytes, check.actCrc, check.expCrc,
+                                         ignore_crc, verifyCallBackFunc))
                     {
-                        // Check if a cache_line_crc section (Ex. MAIN_CODE) is encrypted (has 4B AUTH-TAG) or not (has
-                        // 2B CRC)
-                        bool is_encrypted_cache_line_crc_section = false;
-                        if (tocEntry.cache_line_crc == 1)
+                        if (isDtoc)
                         {
-                            u_int32_t first_line_crc_or_authtag = ((u_int32_t*)buff)[16]; // DWORD 16 is CRC or AUTH-TAG
-                            TOCPU1(first_line_crc_or_authtag)
-                            bool is_authtag = (first_line_crc_or_authtag & 0xffff0000) != 0x0;
-                            is_encrypted_cache_line_crc_section = is_authtag; // if encrypted section will have auth-tag
+                            _badDevDataSections = true;
                         }
-
-                        bool ignore_crc = (tocEntry.crc == NOCRC) ||
-                                          is_encrypted_cache_line_crc_section; // In case of encrypted MAIN_CODE section
-                                                                               // we'll ignore CRC
-                        if (!_encrypted_image_io_access && // In case of encrypted image we don't want to check section
-                                                           // CRC
-                            !DumpFs3CRCCheck(tocEntry.type, physAddr, entrySizeInBytes, sect_act_crc, sect_exp_crc,
-                                             ignore_crc, verifyCallBackFunc))
+                        retVal = false;
+                    }
+                    else
+                    {
+                        // printf("-D- toc type : 0x%.8x\n" , toc_entry.type);
+                        GetSectData(tocArray->tocArr[sectionIndex].section_data, (u_int32_t*)buff, tocEntry.size * 4);
+                        bool isDevInfoSection = (tocEntry.type == FS3_DEV_INFO);
+                        bool isDevInfoValid = isDevInfoSection && CheckDevInfoSignature((u_int32_t*)buff);
+                        if (isDevInfoValid)
                         {
-                            if (isDtoc)
-                            {
-                                _badDevDataSections = true;
-                            }
-                            retVal = false;
+                            validDevInfoCount++;
                         }
-                        else
+                        if (!isDevInfoSection || isDevInfoValid)
                         {
-                            // printf("-D- toc type : 0x%.8x\n" , toc_entry.type);
-                            GetSectData(tocArray->tocArr[section_index].section_data, (u_int32_t*)buff,
-                                        tocEntry.size * 4);
-                            bool isDevInfoSection = (tocEntry.type == FS3_DEV_INFO);
-                            bool isDevInfoValid = isDevInfoSection && CheckDevInfoSignature((u_int32_t*)buff);
-                            if (isDevInfoValid)
-                            {
-                                validDevInfoCount++;
-                            }
-                            if (!isDevInfoSection || isDevInfoValid)
+                            if (IsGetInfoSupported(tocEntry.type))
                             {
-                                if (IsGetInfoSupported(tocEntry.type))
+                                u_int8_t* section_buff;
+                                section_buff = buff;
+                                vector<u_int8_t> non_encrypted_buff;
+                                if (_encrypted_image_io_access)
                                 {
-                                    u_int8_t* section_buff;
-                                    section_buff = buff;
-                                    vector<u_int8_t> non_encrypted_buff;
-                                    if (_encrypted_image_io_access)
-                                    {
-                                        // In case of encrypted image, parsing info section from the non-encrypted image
-                                        non_encrypted_buff.resize(tocEntry.size * 4);
-                                        READBUF((*_ioAccess), flash_addr, non_encrypted_buff.data(), entrySizeInBytes,
-                                                "Section");
-                                        section_buff = non_encrypted_buff.data();
-                                    }
-                                    if (!GetImageInfoFromSection(section_buff, tocEntry.type, tocEntry.size * 4))
-                                    {
-                                        retVal = false;
-                                        errmsg("Failed to get info from section %d, check the supported_hw_id section "
-                                               "in MLX file!\n",
-                                               tocEntry.type);
-                                    }
+                                    // In case of encrypted image, parsing info section from the non-encrypted image
+                                    non_encrypted_buff.resize(tocEntry.size * 4);
+                                    READBUF((*_ioAccess), check.flashAddr, non_encrypted_buff.data(), entrySizeInBytes,
+                                            "Section");
+                                    section_buff = non_encrypted_buff.data();
                                 }
-                                else if (tocEntry.type == FS3_DBG_FW_INI)
+                                if (!GetImageInfoFromSection(section_buff, tocEntry.type, tocEntry.size * 4))
                                 {
-                                    TOCPUn(buff, tocEntry.size);
-                                    GetSectData(_fwConfSect, (u_int32_t*)buff, tocEntry.size * 4);
+                                    retVal = false;
+                                    errmsg("Failed to get info from section %d, check the supported_hw_id section "
+                                           "in MLX file!\n",
+                                           tocEntry.type);
                                 }
                             }
+                            else if (tocEntry.type == FS3_DBG_FW_INI)
+                            {
+                                TOCPUn(buff, tocEntry.size);
+                                GetSectData(_fwConfSect, (u_int32_t*)buff, tocEntry.size * 4);
+                            }
                         }
                     }
-                    else
-                    {
-                        GetSectData(tocArray->tocArr[section_index].section_data, (u_int32_t*)buff, tocEntry.size * 4);
-                    }
+                }
+                else
+                {
+                    GetSectData(tocArray->tocArr[sectionIndex].section_data, (u_int32_t*)buff, tocEntry.size * 4);
                 }
             }
-
-            tocArray->tocArr[section_index].entry_addr = entryAddr;
-            tocArray->tocArr[section_index].toc_entry = tocEntry;
-            memcpy(tocArray->tocArr[section_index].data, entryBuffer, IMAGE_LAYOUT_ITOC_ENTRY_SIZE);
         }
-        if (nextBootFwVer)
-        {
-            // if nextBootFwVer, return after reading fw version
-            break;
-        }
-        section_index++;
-    } while (tocEntry.type != FS3_END);
+
+        tocArray->tocArr[sectionIndex].entry_addr = check.entryAddr;
+        tocArray->tocArr[sectionIndex].toc_entry = tocEntry;
+        memcpy(tocArray->tocArr[sectionIndex].data, check.entryBuffer, IMAGE_LAYOUT_ITOC_ENTRY_SIZE);
+    }
+
+    if (!readOk)
+    {
+        return errmsg(readErrCode, "%s", readErr.c_str());
+    }
 
     tocArray->numOfTocs = section_index - 1;
 
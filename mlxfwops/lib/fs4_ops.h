@@ -47,6 +47,10 @@
 #define HMAC_SIGNATURE_LENGTH 64
 #define ENCRYPTED_BURN_IMAGE_SIZE_LOCATION_IN_BYTES 0x1000000 // 16MB
 #define DELTA_IV_HW_POINTER_ADDR 0x88
+// Section CRCs are checked on worker threads once the sections read add up to this size
+#define FS4_PARALLEL_VERIFY_MIN_SIZE 0x100000
+#define FS4_MAX_VERIFY_THREADS 8
+#define FS4_VERIFY_THREADS_ENV "MLXFWOPS_VERIFY_THREADS" // 1 checks the sections serially
 enum SecureBootSignVersion
 {
     VERSION_1 = 1,
@@ -177,6 +181,21 @@ protected:
         u_int32_t smallestDTocAddr;
     };
 
+    // A TOC entry read by verifyTocEntries, with its section data when it is checked
+    struct TocSectionCheck
+    {
+        int sectionIndex;
+        u_int32_t entryAddr;
+        u_int32_t physAddr;
+        u_int32_t flashAddr;
+        struct image_layout_itoc_entry tocEntry;
+        u_int8_t entryBuffer[TOC_ENTRY_SIZE];
+        bool readable;
+        std::vector<u_int8_t> data;
+        u_int32_t actCrc;
+        u_int32_t expCrc;
+    };
+
     bool _is_hw_ptrs_initialized;
     u_int32_t _boot2_ptr;
     u_int32_t _itoc_ptr;
@@ -194,6 +213,14 @@ protected:
                           struct QueryOptions queryOptions,
                           VerifyCallBack verifyCallBackFunc,
                           bool verbose = false);
+    bool readTocEntries(u_int32_t tocAddr,
+                        bool show_itoc,
+                        bool isDtoc,
+                        struct QueryOptions queryOptions,
+                        std::vector<TocSectionCheck>& sections,
+                        int& numOfEntries,
+                        bool verbose);
+    void calcTocSectionsCrc(std::vector<TocSectionCheck>& sections);
     bool encryptedFwQuery(fw_info_t* fwInfo, bool quickQuery = true, bool ignoreDToc = false, bool verbose = false);
     bool getImgStart();
     bool AlignDeviceSections(FwOperations* imageOps);
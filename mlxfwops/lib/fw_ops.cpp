@@ -602,6 +602,7 @@ bool FwOperations::FwAccessCreate(fw_ops_params_t& fwParams, FBase** ioAccessP)
         }
         // set no flash verify if needed (default =false)
         (*ioAccessP)->set_no_flash_verify(fwParams.noFlashVerify);
+        ((Flash*)*ioAccessP)->set_differential_burn(fwParams.diffBurn);
         // work with 64KB sector size if possible to increase performace in full fw burn
         ((*ioAccessP)->set_flash_working_mode(Flash::Fwm_64KB));
     }
@@ -885,6 +886,7 @@ void FwOperations::BackUpFwParams(fw_ops_params_t& fwParams)
         strncpy((char*)(new char[(strlen(fwParams.mstHndl) + 1)]), fwParams.mstHndl, strlen(fwParams.mstHndl) + 1) :
         (char*)NULL;
     _fwParams.noFlashVerify = fwParams.noFlashVerify;
+    _fwParams.diffBurn = fwParams.diffBurn;
     _fwParams.numOfBanks = fwParams.numOfBanks;
     _fwParams.psid = fwParams.psid ? strncpy((char*)(new char[(strlen(fwParams.psid) + 1)]), fwParams.psid,
                                              strlen(fwParams.psid) + 1) :
@@ -448,6 +448,7 @@ public:
         flash_params_t* flashParams; // can be NULL
         int ignoreCacheRep;
         bool noFlashVerify;
+        bool diffBurn; // skip sectors already holding the data, erase only sectors that need it
         bool shortErrors; // show short/long error msgs (default shuold be false)
         int cx3FwAccess;
         int isCableFw;
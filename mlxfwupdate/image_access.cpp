@@ -56,6 +56,7 @@ using namespace std;
 ImageAccess::ImageAccess(int compareFFV)
 {
     _imgFwOps = NULL;
+    _mfaDesc = NULL;
     _compareFFV = compareFFV;
     memset(&_imgFwParams, 0, sizeof(_imgFwParams));
     memset(_errBuff, 0, sizeof(_errBuff));
@@ -68,6 +69,34 @@ ImageAccess::~ImageAccess()
         delete _imgFwOps;
         _imgFwOps = NULL;
     }
+    closeMfa();
+}
+
+mfa_desc* ImageAccess::openMfa(const string& fname)
+{
+    if (_mfaDesc != NULL) {
+        if (_mfaFile == fname) {
+            return _mfaDesc;
+        }
+        closeMfa();
+    }
+    if (mfa_open_file(&_mfaDesc, (char*)fname.c_str())) {
+        _mfaDesc = NULL;
+        return NULL;
+    }
+    _mfaFile = fname;
+    return _mfaDesc;
+}
+
+void ImageAccess::closeMfa()
+{
+    if (_mfaDesc != NULL) {
+        mfa_close(_mfaDesc);
+        _mfaDesc = NULL;
+    }
+    _mfaFile = "";
+    _lastImgKey = "";
+    _lastImg.clear();
 }
 
 bool ImageAccess::hasMFAs(string directory)
@@ -169,6 +198,13 @@ bool ImageAccess::openImg(fw_hndl_type_t hndlType, char* psid, char* fileHndl)
     return true;
 }
 
+bool ImageAccess::openImg(u_int32_t* buffHndl, u_int32_t buffSize, char* psid)
+{
+    _imgFwParams.buffHndl = buffHndl;
+    _imgFwParams.buffSize = buffSize;
+    return openImg(FHT_FW_BUFF, psid, NULL);
+}
+
 int ImageAccess::queryPsid(const string&  fname,
                            const string&  psid,
                            string&        selector_tag,
@@ -183,7 +219,20 @@ int ImageAccess::queryPsid(const string&  fname,
     vector < u_int8_t > sect; /* to get fw configuration. */
     vector < u_int8_t > dest;
 
-    if (!openImg(FHT_FW_FILE, (char*)psid.c_str(), (char*)fname.c_str())) {
+    if (getFileSignature(fname) == IMG_SIG_TYPE_MFA) {
+        /* Extract through the open archive rather than letting FwOperations reopen it for every PSID */
+        u_int8_t* imgbuf = NULL;
+        string    tag = "";
+        int       sz = getImage(fname, psid, tag, 1, &imgbuf);
+        if (sz < 0) {
+            return 0;
+        }
+        bool opened = openImg((u_int32_t*)imgbuf, (u_int32_t)sz, (char*)psid.c_str());
+        mfa_release_image(imgbuf);
+        if (!opened) {
+            return 0;
+        }
+    } else if (!openImg(FHT_FW_FILE, (char*)psid.c_str(), (char*)fname.c_str())) {
         return 0;
     }
 
@@ -223,7 +272,7 @@ int ImageAccess::queryPsid(const string&  fname,
             }
         }
         ri.iniName = iniName;
-        if (!mfa_open_file(&mfa_d, (char*)fname.c_str())) {
+        if ((mfa_d = openMfa(fname)) != NULL) {
             char* pn = mfa_get_board_metadata(mfa_d, (char*)psid.c_str(), (char*)"PN");
             if (pn != NULL) {
                 ri.pns = pn;
@@ -235,7 +284,6 @@ int ImageAccess::queryPsid(const string&  fname,
                 ri.description = desc;
                 free(desc);
             }
-            mfa_close(mfa_d);
         }
         if (!_compareFFV) {
             ImgVersion imgv;
@@ -286,13 +334,26 @@ int ImageAccess::getImage(const string& fname,
     int type = getFileSignature(fname);
 
     if (type == IMG_SIG_TYPE_MFA) {
-        mfa_desc* mfa_d;
-        int       rc = mfa_open_file(&mfa_d, (char*)fname.c_str());
-        if (!rc) {
-            res = mfa_get_image(mfa_d, (char*)psid.c_str(), image_type, (char*)selector_tag.c_str(), filebuf);
-            mfa_close(mfa_d);
-        } else {
+        mfa_desc* mfa_d = openMfa(fname);
+        string    key = psid + '\0' + selector_tag + '\0' + (char)image_type;
+        if (mfa_d == NULL) {
             res = -1;
+        } else if (key == _lastImgKey) {
+            *filebuf = (u_int8_t*)malloc(_lastImg.size());
+            if (*filebuf == NULL) {
+                return -1;
+            }
+            memcpy(*filebuf, &_lastImg[0], _lastImg.size());
+            res = _lastImg.size();
+        } else {
+            res = mfa_get_image(mfa_d, (char*)psid.c_str(), image_type, (char*)selector_tag.c_str(), filebuf);
+            if (res < 0) {
+                _errMsg = mfa_get_last_error(mfa_d);
+                _log += _errMsg;
+            } else if (res > 0) {
+                _lastImgKey = key;
+                _lastImg.assign(*filebuf, *filebuf + res);
+            }
         }
     } else if (type == IMG_SIG_TYPE_BIN) {
         res = getImage(fname, filebuf);
@@ -461,7 +522,7 @@ int ImageAccess::get_mfa_content(const string& fname, vector < PsidQueryItem >&
     map_entry_hdr* me = NULL;
     char           psid[33];
 
-    if (mfa_open_file(&mfa_d, (char*)fname.c_str())) {
+    if ((mfa_d = openMfa(fname)) == NULL) {
         return -1;
     }
     me = NULL;
@@ -527,7 +588,6 @@ int ImageAccess::get_mfa_content(const string& fname, vector < PsidQueryItem >&
         }
         riv.push_back(item);
     }
-    mfa_close(mfa_d);
     return 0;
 }
 #define ITOC_ASCII              0x49544f43
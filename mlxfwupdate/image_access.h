@@ -39,6 +39,7 @@
 #include <mlxfwops_com.h>
 #include <fw_ops.h>
 #include <compatibility.h>
+#include <mfa.h>
 #include "psid_query_item.h"
 #include "mlxfwmanager_common.h"
 #include "mlnx_dev.h"
@@ -61,6 +62,8 @@ public:
     int queryDirPsid(string& path, string& psid, string& selector_tag, int image_type, vector<PsidQueryItem>& riv);
     int queryPsid(const string& fname, const string& psid, string& selector_tag, int image_type, PsidQueryItem& ri);
     int getImage(const string& fname, u_int8_t** filebuf);
+    // The archive stays open until another one is accessed, so the images of a bundle are extracted after a single
+    // open and CRC check, and the last image is kept for the next device with the same PSID
     int getImage(const string& fname, const string& psid, string& selector_tag, int image_type, u_int8_t** filebuf);
     int get_file_content(const string& fname, vector<PsidQueryItem>& riv);
     static int getFileSignature(const string& fname);
@@ -83,6 +86,9 @@ private:
     void parse_image_info_data(u_int8_t* image_info_data, PsidQueryItem& query_item);
     static int getBufferSignature(u_int8_t* buf, u_int32_t size);
     bool openImg(fw_hndl_type_t hndlType, char* psid, char* fileHndl);
+    bool openImg(u_int32_t* buffHndl, u_int32_t buffSize, char* psid);
+    mfa_desc* openMfa(const string& fname);
+    void closeMfa();
     char _errBuff[MLNX_ERR_BUFF_SIZE];
     int _compareFFV;
     string _log;
@@ -90,6 +96,10 @@ private:
     string _warning;
     FwOperations::fw_ops_params_t _imgFwParams;
     FwOperations* _imgFwOps;
+    mfa_desc* _mfaDesc;
+    string _mfaFile;
+    string _lastImgKey;
+    vector<u_int8_t> _lastImg;
 };
 
 #endif
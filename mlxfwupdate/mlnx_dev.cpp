@@ -530,6 +530,7 @@ bool MlnxDev::openImg(u_int32_t* fileBuffer, u_int32_t bufferSize)
 }
 
 int MlnxDev::preBurn(string mfa_file,
+                     ImageAccess& imgacc,
                      f_prog_func prog_cb,
                      bool burnFailsafe,
                      bool& isTimeConsumingFixesNeeded,
@@ -539,13 +540,21 @@ int MlnxDev::preBurn(string mfa_file,
     string cmd;
     int rc;
     u_int8_t* filebuf = NULL;
-    ImageAccess imgacc(_compareFFV);
+    string selector_tag = "";
     fw_info_t dev_fw_query;
     fw_info_t img_fw_query;
     memset(&dev_fw_query, 0, sizeof(dev_fw_query));
     memset(&img_fw_query, 0, sizeof(img_fw_query));
     _burnSuccess = 0;
-    int sza = imgacc.getImage(mfa_file, &filebuf);
+    int sza;
+    if (ImageAccess::getFileSignature(mfa_file) == IMG_SIG_TYPE_MFA)
+    {
+        sza = imgacc.getImage(mfa_file, _psid, selector_tag, 1, &filebuf);
+    }
+    else
+    {
+        sza = imgacc.getImage(mfa_file, &filebuf);
+    }
     if (sza < 0)
     {
         _errMsg = imgacc.getLastErrMsg();
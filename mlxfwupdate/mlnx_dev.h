@@ -52,6 +52,8 @@
 using namespace std;
 #define MLNX_ERR_BUFF_SIZE 1024
 
+class ImageAccess;
+
 class MlnxDev
 {
 public:
@@ -60,7 +62,9 @@ public:
     ~MlnxDev();
 
     int query();
+    // imgacc is shared by the devices being updated, so an archive is opened and checked once for all of them
     int preBurn(string mfa_file,
+                ImageAccess& imgacc,
                 f_prog_func prog_cb,
                 bool burnFailsafe,
                 bool& isTimeConsumingFixesNeeded,
@@ -92,6 +92,7 @@ int mainEntry(int argc, char* argv[])
     int (*progressCB)(int);
     int (*advProgressCB)(int, const char*, prog_t, void*);
     ServerRequest* srq = NULL;
+    ImageAccess* imgacc = NULL;
     initHandler();
     CmdLineParser cmdParser(&cmd_params, argv, argc);
     logDir = getLogDir(toolName);
@@ -563,6 +564,8 @@ int mainEntry(int argc, char* argv[])
             }
         }
     }
+    // Devices with the same archive share its open descriptor and extracted image
+    imgacc = new ImageAccess(CompareFFV);
     for (int i = 0; i < (int)devs.size(); i++)
     {
         if (status_strings[i].size() != 0)
@@ -594,8 +597,8 @@ int mainEntry(int argc, char* argv[])
         bool imageWasCached = false;
         vector<string> questions;
         bool isTimeConsumingFixesNeeded = false;
-        rc0 = devs[i]->preBurn(mfa_file, progressCB, cmd_params.burnFailsafe, isTimeConsumingFixesNeeded, questions,
-                               advProgressCB);
+        rc0 = devs[i]->preBurn(mfa_file, *imgacc, progressCB, cmd_params.burnFailsafe, isTimeConsumingFixesNeeded,
+                               questions, advProgressCB);
         if (rc0)
         {
             if (abort_request)
@@ -712,6 +715,10 @@ early_err_clean_up:
     {
         delete srq;
     }
+    if (imgacc != NULL)
+    {
+        delete imgacc;
+    }
     if (FLog != NULL)
     {
         fclose(FLog);
@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2020-2021 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*
+ * Multi-port amBER collection of a switch against a mock register backend: every access register takes the
+ * injected latency and returns the request unchanged. The ports are collected serially, then over the given
+ * number of workers, and the CSV rows of both runs are compared (but for their time stamps).
+ *
+ * The mock device goes through a mailbox taking one access register at a time, the collection fails if the
+ * workers ever have two in flight. With -i it is an inband device taking them concurrently.
+ *
+ * Usage: amber_collector_bench [-i] [-p ports] [-l latency_usecs] [-w workers] <register_access_table.adb>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <common/tools_bench.h>
+#include <common/tools_utils.h>
+#include "mlxlink_amBER_collector.h"
+
+#define BENCH_ARGS "[-i] [-p ports] [-l latency_usecs] [-w workers] <register_access_table.adb>"
+
+static std::atomic<unsigned long> bench_registers(0);
+static std::atomic<unsigned> bench_in_flight(0);
+static std::atomic<unsigned long> bench_overlaps(0);
+static long bench_latency_us = 500;
+static bool bench_inband = false;
+
+class BenchCollector : public MlxlinkAmBerCollector
+{
+public:
+    BenchCollector(Json::Value& jsonRoot, const string& adbFile) : MlxlinkAmBerCollector(jsonRoot), _adbFile(adbFile)
+    {
+    }
+
+protected:
+    virtual bool isRegAccessConcurrent() { return bench_inband; }
+
+    // The device is waited on, not spun on, so that the workers overlap as they would on a real device
+    virtual void sendDeviceRegister(const string& regName, maccess_reg_method_t method)
+    {
+        (void)method;
+        _buffer = genBuffUnknown();
+        if (++bench_in_flight > 1)
+        {
+            bench_overlaps++;
+        }
+        struct timespec latency = {bench_latency_us / 1000000, (bench_latency_us % 1000000) * 1000};
+        nanosleep(&latency, NULL);
+        bench_in_flight--;
+        bench_registers++;
+
+        if (regName == ACCESS_REG_PDDR)
+        {
+            // An InfiniBand port, for the sheets to be laid out as on a switch
+            for (size_t i = 0; i < _buffer.size(); i++)
+            {
+                _buffer[i] = BE32_TO_CPU(_buffer[i]);
+            }
+            RegAccessParser::updateField("proto_active", IB);
+            for (size_t i = 0; i < _buffer.size(); i++)
+            {
+                _buffer[i] = CPU_TO_BE32(_buffer[i]);
+            }
+        }
+    }
+
+    virtual MlxlinkAmBerCollector* newPortCollector()
+    {
+        BenchCollector* collector = new BenchCollector(*this);
+        collector->setPortContext(NULL, new MlxRegLib(NULL, _adbFile, true));
+        return collector;
+    }
+
+private:
+    string _adbFile;
+};
+
+static vector<string> bench_split_row(const string& line)
+{
+    vector<string> values;
+    stringstream row(line);
+    string value;
+    while (getline(row, value, ','))
+    {
+        values.push_back(value);
+    }
+    return values;
+}
+
+static bool bench_read_rows(const string& fileName, vector<string>& rows)
+{
+    ifstream csv(fileName.c_str());
+    string header;
+    if (!getline(csv, header))
+    {
+        return false;
+    }
+
+    // Blank the time stamps, they differ between the runs
+    vector<string> titles = bench_split_row(header);
+    size_t timeStampIdx = find(titles.begin(), titles.end(), "TimeStamp") - titles.begin();
+    rows.clear();
+    rows.push_back(header);
+    string line;
+    while (getline(csv, line))
+    {
+        vector<string> values = bench_split_row(line);
+        if (timeStampIdx < values.size())
+        {
+            values[timeStampIdx] = "";
+        }
+        string row;
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            row += (i ? "," : "") + values[i];
+        }
+        rows.push_back(row);
+    }
+    return true;
+}
+
+static int bench_collect(const string& adbFile, u_int32_t ports, u_int32_t workers, vector<string>& rows)
+{
+    Json::Value jsonRoot;
+    string csvFileName = "/tmp/amber_collector_bench." + to_string(getpid()) + ".csv";
+    unlink(csvFileName.c_str());
+    setenv(AMBER_PORT_WORKERS_ENV, to_string(workers).c_str(), 1);
+
+    double time = 0;
+    try
+    {
+        BenchCollector collector(jsonRoot, adbFile);
+        MlxRegLib regLib(NULL, adbFile, true);
+        collector._regLib = &regLib;
+        collector._mlxlinkMaps = MlxlinkMaps::getInstance();
+        collector._devID = DeviceQuantum2;
+        collector._productTechnology = PRODUCT_7NM;
+        collector._csvFileName = csvFileName;
+        for (u_int32_t port = 1; port <= ports; port++)
+        {
+            collector._localPorts.push_back(PortGroup(port, port, 0, 1));
+        }
+
+        bench_registers = 0;
+        bench_overlaps = 0;
+        double start = bench_now_secs();
+        collector.startCollector();
+        time = bench_now_secs() - start;
+    }
+    catch (MlxRegException& exc)
+    {
+        fprintf(stderr, "-E- %s\n", exc.what());
+        unlink(csvFileName.c_str());
+        return 1;
+    }
+
+    if (bench_overlaps && !bench_inband)
+    {
+        fprintf(stderr, "-E- %lu access registers were issued while the device mailbox was busy\n",
+                (unsigned long)bench_overlaps);
+        unlink(csvFileName.c_str());
+        return 1;
+    }
+    bool rowsRead = bench_read_rows(csvFileName, rows);
+    unlink(csvFileName.c_str());
+    if (!rowsRead || rows.size() != ports + 1)
+    {
+        fprintf(stderr, "-E- Expected %u rows in the CSV file\n", ports);
+        return 1;
+    }
+    printf("%2u workers: %10.1f msecs for %u ports, %lu registers, %.1f msecs per port\n", workers, time * 1e3, ports,
+           (unsigned long)bench_registers, time * 1e3 / ports);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    u_int32_t ports = 64;
+    u_int32_t workers = AMBER_DEFAULT_PORT_WORKERS;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "ip:l:w:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'i':
+                bench_inband = true;
+                break;
+            case 'p':
+                ports = atoi(optarg);
+                break;
+            case 'l':
+                bench_latency_us = atol(optarg);
+                break;
+            case 'w':
+                workers = atoi(optarg);
+                break;
+            default:
+                return bench_usage(argv[0], BENCH_ARGS);
+        }
+    }
+    if (optind >= argc || ports == 0 || workers == 0 || bench_latency_us < 0)
+    {
+        return bench_usage(argv[0], BENCH_ARGS);
+    }
+
+    vector<string> serialRows;
+    vector<string> parallelRows;
+    if (bench_collect(argv[optind], ports, 1, serialRows) || bench_collect(argv[optind], ports, workers, parallelRows))
+    {
+        return 1;
+    }
+    if (serialRows != parallelRows)
+    {
+        fprintf(stderr, "-E- The rows collected by %u workers differ from the serial ones\n", workers);
+        return 1;
+    }
+    return 0;
+}
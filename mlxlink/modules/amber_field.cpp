@@ -34,8 +34,8 @@
 #include "mlxlink_utils.h"
 #include "mlxlink_reg_parser.h"
 
-u_int32_t AmberField::_lastFieldIndex = 1;
-bool AmberField::_dataValid = true;
+thread_local u_int32_t AmberField::_lastFieldIndex = 1;
+thread_local bool AmberField::_dataValid = true;
 
 AmberField::AmberField(const string& uiField, const string& uiValue, bool visible) :
     _uiField(uiField), _visible(visible)
@@ -57,8 +57,9 @@ public:
     static void reset();
     static string getValueFromFields(const vector<AmberField>& fields, const string& uiField, bool matchUiField = true);
 
-    static u_int32_t _lastFieldIndex;
-    static bool _dataValid;
+    // Per thread, the ports of a switch are collected concurrently
+    static thread_local u_int32_t _lastFieldIndex;
+    static thread_local bool _dataValid;
 
 private:
     u_int32_t _fieldIndex;
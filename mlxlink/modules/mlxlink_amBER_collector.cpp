@@ -32,6 +32,8 @@
 
 #include "mlxlink_amBER_collector.h"
 #include <sys/time.h>
+#include <mutex>
+#include <common/tools_parallel.h>
 
 MlxlinkAmBerCollector::MlxlinkAmBerCollector(Json::Value& jsonRoot) : _jsonRoot(jsonRoot)
 {
@@ -56,22 +58,10 @@ MlxlinkAmBerCollector::MlxlinkAmBerCollector(Json::Value& jsonRoot) : _jsonRoot(
     _moduleIndex = 0;
     _slotIndex = 0;
 
-    _isPortIB = false;
-    _isPortETH = false;
-    _isPortNVLINK = false;
-    _isPortPCIE = false;
-    _isMCMSysValid = false;
-    _isGBSysValid = false;
-    _isValidSensorMvcap = false;
-    _isValidSensorMtcap = false;
     _isHca = false;
-
-    _isCmisCable = false;
-    _isQsfpCable = false;
-    _isSfpCable = false;
-    _cablePlugged = false;
-    _inPRBSMode = false;
-    _invalidate = false;
+    _useExtAdb = true;
+    _ownsPortContext = false;
+    resetPortState();
 
     _mlxlinkMaps = NULL;
 
@@ -99,7 +89,96 @@ MlxlinkAmBerCollector::MlxlinkAmBerCollector(Json::Value& jsonRoot) : _jsonRoot(
              });
 }
 
-MlxlinkAmBerCollector::~MlxlinkAmBerCollector() {}
+MlxlinkAmBerCollector::~MlxlinkAmBerCollector()
+{
+    if (_ownsPortContext)
+    {
+        delete _regLib;
+        delete _mlxlinkMaps;
+        if (_mf)
+        {
+            mclose(_mf);
+        }
+    }
+}
+
+void MlxlinkAmBerCollector::resetPortState()
+{
+    _isPortIB = false;
+    _isPortETH = false;
+    _isPortNVLINK = false;
+    _isPortPCIE = false;
+    _isMCMSysValid = false;
+    _isGBSysValid = false;
+    _isValidSensorMvcap = false;
+    _isValidSensorMtcap = false;
+
+    _isCmisCable = false;
+    _isQsfpCable = false;
+    _isSfpCable = false;
+    _cablePlugged = false;
+    _inPRBSMode = false;
+    _invalidate = false;
+}
+
+MlxlinkAmBerCollector* MlxlinkAmBerCollector::newPortCollector()
+{
+    mfile* mf = mopen(_mstDevName.c_str());
+    if (!mf)
+    {
+        return NULL;
+    }
+    MlxRegLib* regLib = NULL;
+    try
+    {
+        regLib = new MlxRegLib(mf, _extAdbFile, _useExtAdb);
+    }
+    catch (MlxRegException&)
+    {
+        mclose(mf);
+        return NULL;
+    }
+    MlxlinkAmBerCollector* collector = new MlxlinkAmBerCollector(*this);
+    collector->setPortContext(mf, regLib);
+    return collector;
+}
+
+void MlxlinkAmBerCollector::setPortContext(mfile* mf, MlxRegLib* regLib)
+{
+    _mf = mf;
+    _regLib = regLib;
+    // The maps are filled on lookup of a missing key, each worker gets its own
+    _mlxlinkMaps = new MlxlinkMaps(*_mlxlinkMaps);
+    _fieldIndexes.clear();
+    _localPorts.clear();
+    _amberCollection.clear();
+    _ownsPortContext = true;
+}
+
+bool MlxlinkAmBerCollector::isRegAccessConcurrent()
+{
+    // The ICMD mailbox serves one command at a time, handles contending for its semaphore only back off
+    u_int32_t mtype = 0;
+    return _mf && !mget_mdevs_type(_mf, &mtype) && (mtype & MST_IB);
+}
+
+void MlxlinkAmBerCollector::genBuffSendRegister(const string& regName, maccess_reg_method_t method)
+{
+    if (_regAccessLock)
+    {
+        std::lock_guard<std::mutex> guard(*_regAccessLock);
+        sendDeviceRegister(regName, method);
+    }
+    else
+    {
+        sendDeviceRegister(regName, method);
+    }
+}
+
+void MlxlinkAmBerCollector::sendDeviceRegister(const string& regName, maccess_reg_method_t method)
+{
+    MlxlinkRegParser::genBuffSendRegister(regName, method);
+}
 
 void MlxlinkAmBerCollector::resetLocalParser(const string& regName)
 {
@@ -185,6 +264,41 @@ u_int32_t MlxlinkAmBerCollector::getLocalFieldValue(const string& fieldName)
     return fieldVal;
 }
 
+u_int32_t MlxlinkAmBerCollector::getNumOfPortWorkers()
+{
+    const char* env = getenv(AMBER_PORT_WORKERS_ENV);
+    if (!env)
+    {
+        // Workers serialized on the device mailbox only overlap their parsing, not worth a handle each by default
+        return isRegAccessConcurrent() ? AMBER_DEFAULT_PORT_WORKERS : 1;
+    }
+    int workers = atoi(env);
+    if (workers < 1)
+    {
+        return 1;
+    }
+    return workers < AMBER_MAX_PORT_WORKERS ? workers : AMBER_MAX_PORT_WORKERS;
+}
+
+void MlxlinkAmBerCollector::collectPort(const PortGroup& port, string& header, string& values)
+{
+    _localPort = port.localPort;
+    _labelPort = port.labelPort;
+    _splitPort = port.split;
+    _secondSplit = port.secondSplit;
+
+    resetPortState();
+    _amberCollection.clear();
+    AmberField::reset();
+
+    init();
+    collect();
+    formatCSV(header, values);
+
+    _amberCollection.clear();
+    AmberField::reset();
+}
+
 void MlxlinkAmBerCollector::startCollector()
 {
     if (_localPorts.empty())
@@ -192,19 +306,83 @@ void MlxlinkAmBerCollector::startCollector()
         _localPorts.push_back(PortGroup(_localPort, _localPort, 0, 0));
     }
 
-    for (auto it = _localPorts.begin(); it != _localPorts.end(); it++)
+    // Worker 0 is this collector, the others get their own device handle, up to the number of ports. The workers
+    // share a lock serializing their access registers unless the device takes them concurrently.
+    vector<MlxlinkAmBerCollector*> collectors(1, this);
+    u_int32_t numOfWorkers = getNumOfPortWorkers();
+    if (numOfWorkers > 1 && _localPorts.size() > 1 && !isRegAccessConcurrent())
     {
-        _localPort = it->localPort;
-        _labelPort = it->labelPort;
-        _splitPort = it->split;
-        _secondSplit = it->secondSplit;
-
-        init();
-        collect();
-        exportToCSV();
-
-        _amberCollection.clear();
-        AmberField::reset();
+        _regAccessLock = std::make_shared<std::mutex>();
+    }
+    while (collectors.size() < numOfWorkers && collectors.size() < _localPorts.size())
+    {
+        MlxlinkAmBerCollector* collector = newPortCollector();
+        if (!collector)
+        {
+            break;
+        }
+        collectors.push_back(collector);
+    }
+
+    // Rows are written in port order as soon as all the ports before them are collected. A failure stops the
+    // collection at that port, after the rows before it are written.
+    size_t numOfPorts = _localPorts.size();
+    vector<string> headers(numOfPorts);
+    vector<string> values(numOfPorts);
+    vector<string> errors(numOfPorts);
+    vector<int> collected(numOfPorts, 0);
+    size_t nextRow = 0;
+    bool failed = false;
+    string failure;
+    std::atomic<bool> stop(false);
+    std::mutex rowsLock;
+
+    mstflint::common::parallel::for_each_index_worker(
+      numOfPorts, collectors.size(), [&](unsigned worker, size_t port) {
+          if (stop)
+          {
+              return;
+          }
+          bool portFailed = false;
+          try
+          {
+              collectors[worker]->collectPort(_localPorts[port], headers[port], values[port]);
+          }
+          catch (const std::exception& exc)
+          {
+              errors[port] = exc.what();
+              portFailed = true;
+          }
+
+          std::lock_guard<std::mutex> guard(rowsLock);
+          collected[port] = portFailed ? -1 : 1;
+          for (; !failed && nextRow < numOfPorts && collected[nextRow]; nextRow++)
+          {
+              try
+              {
+                  if (collected[nextRow] < 0)
+                  {
+                      throw MlxRegException(errors[nextRow]);
+                  }
+                  exportToCSV(headers[nextRow], values[nextRow]);
+              }
+              catch (const std::exception& exc)
+              {
+                  failure = exc.what();
+                  failed = true;
+                  stop = true;
+              }
+          }
+      });
+
+    for (size_t i = 1; i < collectors.size(); i++)
+    {
+        delete collectors[i];
+    }
+    _regAccessLock.reset();
+    if (failed)
+    {
+        throw MlxRegException(failure);
     }
 }
 
@@ -357,7 +535,8 @@ string MlxlinkAmBerCollector::getCurrentTimeStamp()
 
     char buffer[80];
     std::time_t curTime_secs = curTime.tv_sec;
-    strftime(buffer, 80, "%x-%X", localtime(&curTime_secs));
+    struct tm curTime_tm;
+    strftime(buffer, 80, "%x-%X", localtime_r(&curTime_secs, &curTime_tm));
 
     char currentTime[84] = "";
     sprintf(currentTime, "%s.%03d", buffer, millis);
@@ -2491,55 +2670,49 @@ u_int32_t MlxlinkAmBerCollector::getSheetIndex(AMBER_SHEET sheet)
     return index;
 }
 
-void MlxlinkAmBerCollector::exportToCSV()
+void MlxlinkAmBerCollector::formatCSV(string& header, string& values)
 {
-    const char* fileName = _csvFileName.c_str();
-    ifstream ifile(fileName);
-    ofstream berFile(fileName, std::ofstream::app);
-
     u_int32_t totalNumOfFields = fixFieldsData();
-    // Preparing CSV header line
-    if (!ifile.good())
-    {
-        if (!berFile.good())
-        {
-            throw MlxRegException("The provided file path does not exist!");
-        }
-        // Going over all groups inside _amberCollection and getting the field name for each one
-        for (const auto& sheet : _sheetsList)
-        {
-            for (const auto& field : _amberCollection[sheet.first])
-            {
-                if (field.isVisible())
-                {
-                    berFile << field.getUiField();
-                    if (field.getFieldIndex() < totalNumOfFields)
-                    {
-                        berFile << ",";
-                    }
-                }
-            }
-        }
-        berFile << endl;
-    }
-    // Preparing CSV values
-    // Going over all groups inside _amberCollection and getting the field value for each one
+    stringstream headerLine;
+    stringstream valuesLine;
+
+    // Going over all groups inside _amberCollection and getting the field name and value for each one
     for (const auto& sheet : _sheetsList)
     {
         for (const auto& field : _amberCollection[sheet.first])
         {
             if (field.isVisible())
             {
-                berFile << field.getUiValue();
+                headerLine << field.getUiField();
+                valuesLine << field.getUiValue();
                 if (field.getFieldIndex() < totalNumOfFields)
                 {
-                    berFile << ",";
+                    headerLine << ",";
+                    valuesLine << ",";
                 }
             }
         }
     }
+    header = headerLine.str();
+    values = valuesLine.str();
+}
+
+void MlxlinkAmBerCollector::exportToCSV(const string& header, const string& values)
+{
+    const char* fileName = _csvFileName.c_str();
+    ifstream ifile(fileName);
+    ofstream berFile(fileName, std::ofstream::app);
 
-    berFile << endl;
+    // Preparing CSV header line
+    if (!ifile.good())
+    {
+        if (!berFile.good())
+        {
+            throw MlxRegException("The provided file path does not exist!");
+        }
+        berFile << header << endl;
+    }
+    berFile << values << endl;
     berFile.close();
 }
 
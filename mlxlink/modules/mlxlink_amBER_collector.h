@@ -35,10 +35,19 @@
 
 #include "mlxlink_reg_parser.h"
 #include "amber_field.h"
+#include <memory>
+#include <mutex>
 
 // Un-comment to see access register failures
 // #define VALIDATE_REG_REQUEST
 
+// The ports of a switch are collected concurrently, each worker over its own device handle. Only inband access
+// registers are issued concurrently, the others go through the device mailbox one at a time and are collected
+// serially unless more workers are asked for.
+#define AMBER_DEFAULT_PORT_WORKERS 4
+#define AMBER_MAX_PORT_WORKERS 16
+#define AMBER_PORT_WORKERS_ENV "MLXLINK_AMBER_WORKERS" // 1 collects the ports serially
+
 using namespace std;
 
 struct FIELDS_COUNT
@@ -95,6 +104,8 @@ public:
     vector<PortGroup> _localPorts; // will be valid for switches
     bool _isHca;
     vector<AMBER_SHEET> _sheetsToDump;
+    string _extAdbFile;
+    bool _useExtAdb;
 
 private:
     string getRawFieldValue(const string fieldName);
@@ -131,9 +142,13 @@ private:
 
     void collect();
     vector<AmberField> collectSheet(AMBER_SHEET sheet);
+    void collectPort(const PortGroup& port, string& header, string& values);
+    void resetPortState();
+    u_int32_t getNumOfPortWorkers();
     void initAmberSheetsToDump();
     u_int32_t fixFieldsData();
-    void exportToCSV();
+    void formatCSV(string& header, string& values);
+    void exportToCSV(const string& header, const string& values);
     void exportToConsole();
 
     bool _isQsfpCable;
@@ -145,8 +160,18 @@ private:
     u_int32_t _secondSplit;
     map<AMBER_SHEET, vector<AmberField>> _amberCollection;
     map<AMBER_SHEET, FIELDS_COUNT> _baseSheetsList;
+    bool _ownsPortContext;
+    std::shared_ptr<std::mutex> _regAccessLock;
 
 protected:
+    // A copy of this collector for a worker of startCollector, over its own device and register library
+    virtual MlxlinkAmBerCollector* newPortCollector();
+    void setPortContext(mfile* mf, MlxRegLib* regLib);
+    // Whether the access registers of several handles of the device may be in flight at once
+    virtual bool isRegAccessConcurrent();
+    virtual void genBuffSendRegister(const string& regName, maccess_reg_method_t method);
+    // Issues an access register, under the device lock when the workers share one
+    virtual void sendDeviceRegister(const string& regName, maccess_reg_method_t method);
     void resetLocalParser(const string& regName);
     string getLocalFieldStr(const string& fieldName);
     u_int32_t getLocalFieldValue(const string& fieldName);
@@ -5264,6 +5264,8 @@ void MlxlinkCommander::setAmBerCollectorFields()
     _amberCollector->_devID = _devID;
     _amberCollector->_productTechnology = _productTechnology;
     _amberCollector->_mstDevName = _userInput._device;
+    _amberCollector->_extAdbFile = _extAdbFile;
+    _amberCollector->_useExtAdb = _useExtAdb;
 }
 
 void MlxlinkCommander::initAmBerCollector()
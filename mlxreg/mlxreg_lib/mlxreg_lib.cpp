@@ -78,7 +78,8 @@ MlxRegLib::MlxRegLib(mfile* mf, string extAdbFile, bool isExternal)
         rootNode = rootNode + "_ext";
     }
 
-    _regAccessRootNode = _adb->createLayout(rootNode);
+    // Registers are instantiated when first looked up, a run typically touches one
+    _regAccessRootNode = _adb->createLayout(rootNode, false, -1, false, false, false, 0, "", nullptr, true);
     if (!_regAccessRootNode)
     {
         throw MlxRegException("No supported access registers found");
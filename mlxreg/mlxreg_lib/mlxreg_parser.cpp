@@ -33,6 +33,7 @@
  */
 
 #include <sstream>
+#include <set>
 #include <common/bit_slice.h>
 #include <common/tools_utils.h>
 #include "mlxreg_parser.h"
@@ -208,7 +209,7 @@ void RegAccessParser::parseAccessType(std::vector<string> tokens,
                                       std::vector<string> validTokens,
                                       access_type_t accessType)
 {
-    std::vector<string> foundTokens;
+    std::set<string> foundTokens;
 
     // Update buffer with values (indexes/ops)
     for (std::vector<std::string>::size_type i = 0; i != tokens.size(); i++)
@@ -222,11 +223,10 @@ void RegAccessParser::parseAccessType(std::vector<string> tokens,
         // Make sure that the given field name is valid
         if (std::find(validTokens.begin(), validTokens.end(), name) != validTokens.end())
         {
-            if (std::find(foundTokens.begin(), foundTokens.end(), name) != foundTokens.end())
+            if (!foundTokens.insert(name).second)
             {
                 throw MlxRegException("Field: %s appears twice.", name.c_str());
             }
-            foundTokens.push_back(name);
         }
         else
         {
@@ -240,15 +240,7 @@ void RegAccessParser::parseAccessType(std::vector<string> tokens,
         // Make sure that all the indexes are set
         for (std::vector<std::string>::size_type i = 0; i != validTokens.size(); i++)
         {
-            bool idxFound = false;
-            for (std::vector<std::string>::size_type j = 0; j != foundTokens.size(); j++)
-            {
-                if (validTokens[i] == foundTokens[j])
-                {
-                    idxFound = true;
-                }
-            }
-            if (!idxFound)
+            if (!foundTokens.count(validTokens[i]))
             {
                 throw MlxRegException("Index: %s was not provided", validTokens[i].c_str());
             }
@@ -443,17 +435,70 @@ AdbInstance* RegAccessParser::getField(string name)
 {
     // this will allow to access the leaf field by specifying it's parent.
     std::vector<string> fieldsChain = strSplit(name, '.', false);
-    std::vector<AdbInstance*> subItems = _regNode->getLeafFields(true);
-    for (std::vector<AdbInstance*>::size_type i = 0; i != subItems.size(); i++)
+    if (!fieldsChain.empty())
     {
-        if (checkFieldWithPath(subItems[i], fieldsChain.size() - 1, fieldsChain))
+        const FieldIndex& index = getFieldIndex(_regNode);
+        std::unordered_map<string, std::vector<AdbInstance*> >::const_iterator it =
+          index.byName.find(fieldsChain.back());
+        if (it != index.byName.end())
         {
-            return subItems[i];
+            for (std::vector<AdbInstance*>::size_type i = 0; i != it->second.size(); i++)
+            {
+                if (checkFieldWithPath(it->second[i], fieldsChain.size() - 1, fieldsChain))
+                {
+                    return it->second[i];
+                }
+            }
         }
     }
     throw MlxRegException("Can't find field name: \"%s\"", name.c_str());
 }
 
+/************************************
+ * Function: getFieldIndex
+ ************************************/
+const RegAccessParser::FieldIndex& RegAccessParser::getFieldIndex(AdbInstance* node)
+{
+    std::map<const AdbInstance*, FieldIndex>::iterator it = _fieldIndexes.find(node);
+    if (it != _fieldIndexes.end())
+    {
+        return it->second;
+    }
+
+    FieldIndex& index = _fieldIndexes[node];
+    std::vector<AdbInstance*> subItems = node->getLeafFields(true);
+    for (std::vector<AdbInstance*>::size_type i = 0; i != subItems.size(); i++)
+    {
+        index.byName[subItems[i]->get_field_name()].push_back(subItems[i]);
+        string access = getAccess(subItems[i], index.access);
+        if (access == "INDEX")
+        {
+            index.indexes.push_back(subItems[i]->get_field_name());
+        }
+        else if (access == "OP")
+        {
+            index.ops.push_back(subItems[i]->get_field_name());
+        }
+    }
+    return index;
+}
+
+string RegAccessParser::getAccess(const AdbInstance* field, std::map<const AdbInstance*, string>& known)
+{
+    std::map<const AdbInstance*, string>::iterator it = known.find(field);
+    if (it != known.end())
+    {
+        return it->second;
+    }
+    string access = field->getInstanceAttr("access");
+    if (access.empty())
+    {
+        access = field->parent ? getAccess(field->parent, known) : "N/A";
+    }
+    known[field] = access;
+    return access;
+}
+
 string RegAccessParser::getAccess(const AdbInstance* field)
 {
     string access = field->getInstanceAttr("access");
@@ -470,6 +515,15 @@ string RegAccessParser::getAccess(const AdbInstance* field)
 
 bool RegAccessParser::checkAccess(const AdbInstance* field, const string accessStr)
 {
+    std::map<const AdbInstance*, FieldIndex>::iterator it = _fieldIndexes.find(_regNode);
+    if (it != _fieldIndexes.end())
+    {
+        std::map<const AdbInstance*, string>::iterator access = it->second.access.find(field);
+        if (access != it->second.access.end())
+        {
+            return access->second == accessStr;
+        }
+    }
     return getAccess(field) == accessStr;
 }
 
@@ -497,30 +551,12 @@ bool RegAccessParser::isOP(AdbInstance* field)
  ************************************/
 std::vector<string> RegAccessParser::getAllIndexes(AdbInstance* node)
 {
-    std::vector<string> indexes;
-    std::vector<AdbInstance*> subItems = node->getLeafFields(true);
-    for (std::vector<AdbInstance*>::size_type i = 0; i != subItems.size(); i++)
-    {
-        if (isIndex(subItems[i]))
-        {
-            indexes.push_back(subItems[i]->get_field_name());
-        }
-    }
-    return indexes;
+    return getFieldIndex(node).indexes;
 }
 
 std::vector<string> RegAccessParser::getAllOps(AdbInstance* node)
 {
-    std::vector<string> ops;
-    std::vector<AdbInstance*> subItems = node->getLeafFields(true);
-    for (std::vector<AdbInstance*>::size_type i = 0; i != subItems.size(); i++)
-    {
-        if (isOP(subItems[i]))
-        {
-            ops.push_back(subItems[i]->get_field_name());
-        }
-    }
-    return ops;
+    return getFieldIndex(node).ops;
 }
 
 void RegAccessParser::updateField(string field_name, u_int32_t value)
@@ -37,6 +37,8 @@
 
 #include <string>
 #include <algorithm>
+#include <map>
+#include <unordered_map>
 #include <adb_parser/adb_parser.h>
 #include "mlxreg_exception.h"
 
@@ -71,6 +73,15 @@ public:
     };
 
 protected:
+    // Leaf fields of a register by name, and the access attribute of each leaf and node under it
+    struct FieldIndex
+    {
+        std::unordered_map<string, std::vector<AdbInstance*> > byName; // in getLeafFields order
+        std::map<const AdbInstance*, string> access;
+        std::vector<string> indexes;
+        std::vector<string> ops;
+    };
+
     string _data;
     string _indexes;
     string _ops;
@@ -80,6 +91,7 @@ protected:
     string output_file;
     std::vector<u_int32_t> _buffer;
     bool _ignore_ro;
+    std::map<const AdbInstance*, FieldIndex> _fieldIndexes; // Built once per register node
     std::vector<u_int32_t> genBuffUnknown();
     std::vector<u_int32_t> genBuffKnown();
     void parseAccessType(std::vector<string> tokens, std::vector<string> validTokens, access_type_t accessType);
@@ -89,6 +101,7 @@ protected:
     void parseUnknown();
     bool checkFieldWithPath(AdbInstance* field, u_int32_t idx, std::vector<string>& fieldsChain);
     AdbInstance* getField(string name);
+    const FieldIndex& getFieldIndex(AdbInstance* node);
     std::vector<string> strSplit(string str, char delimiter, bool forcePairs);
     void updateBuffer(u_int32_t offset, u_int32_t size, u_int32_t val);
     void updateBufferUnknwon(std::vector<string> fieldTokens);
@@ -103,6 +116,7 @@ protected:
 
 private:
     bool checkAccess(const AdbInstance* field, const string accessStr);
+    static string getAccess(const AdbInstance* field, std::map<const AdbInstance*, string>& known);
 };
 
 } // namespace mlxreg
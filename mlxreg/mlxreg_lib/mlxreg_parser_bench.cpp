@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2021 NVIDIA CORPORATION & AFFILIATES. ALL RIGHTS RESERVED.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *  Version: $Id$
+ */
+
+/*
+ * Field lookup cost of RegAccessParser on a synthetic register with a growing number of fields: every field
+ * is looked up once by a scan of the register leaves (as getField used to do) and once through the field
+ * index, then a full --set buffer is generated for all the fields.
+ *
+ * Usage: mlxreg_parser_bench [-i iterations] [-n max_fields]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sstream>
+#include <common/tools_utils.h>
+#include <adb_parser/adb_parser.h>
+#include <common/tools_bench.h>
+#include "mlxreg_parser.h"
+
+using namespace mlxreg;
+
+class BenchParser : public RegAccessParser
+{
+public:
+    BenchParser(string data, string indexes, AdbInstance* regNode) :
+        RegAccessParser(data, indexes, "", regNode, (u_int32_t)0)
+    {
+    }
+
+    size_t lookupAll(std::vector<string>& names, bool scan)
+    {
+        size_t found = 0;
+        for (std::vector<string>::size_type i = 0; i != names.size(); i++)
+        {
+            found += scan ? scanField(names[i]) != NULL : getField(names[i]) != NULL;
+        }
+        return found;
+    }
+
+private:
+    AdbInstance* scanField(string name)
+    {
+        std::vector<string> fieldsChain = strSplit(name, '.', false);
+        std::vector<AdbInstance*> subItems = _regNode->getLeafFields(true);
+        for (std::vector<AdbInstance*>::size_type i = 0; i != subItems.size(); i++)
+        {
+            if (checkFieldWithPath(subItems[i], fieldsChain.size() - 1, fieldsChain))
+            {
+                return subItems[i];
+            }
+        }
+        return NULL;
+    }
+};
+
+static string bench_adb(int fields)
+{
+    std::ostringstream adb;
+    adb << "<NodesDefinition>\n"
+        << "<node name=\"bench_reg\" descr=\"\" size=\"0x" << std::hex << (fields + 1) * 4 << ".0\" >\n"
+        << "\t<field name=\"local_port\" descr=\"\" access=\"INDEX\" offset=\"0x0.0\" size=\"0x4.0\" />\n";
+    for (int i = 0; i < fields; i++)
+    {
+        adb << "\t<field name=\"field_" << std::dec << i << "\" descr=\"\" access=\"RW\" offset=\"0x" << std::hex
+            << (i + 1) * 4 << ".0\" size=\"0x4.0\" />\n";
+    }
+    adb << "</node>\n"
+        << "<node name=\"bench_root\" descr=\"\" size=\"0x" << (fields + 1) * 4 << ".0\" >\n"
+        << "\t<field name=\"bench_reg\" descr=\"\" subnode=\"bench_reg\" offset=\"0x0.0\" size=\"0x"
+        << (fields + 1) * 4 << ".0\" />\n"
+        << "</node>\n</NodesDefinition>\n";
+    return adb.str();
+}
+
+static int bench_fields(int fields, int iterations)
+{
+    Adb adb;
+    if (!adb.loadFromString(bench_adb(fields).c_str(), false, false, false))
+    {
+        fprintf(stderr, "-E- Failed to load the synthetic register: %s\n", adb.getLastError().c_str());
+        return 1;
+    }
+    AdbInstance* root = adb.createLayout("bench_root");
+    if (!root)
+    {
+        fprintf(stderr, "-E- Failed to create the synthetic register: %s\n", adb.getLastError().c_str());
+        return 1;
+    }
+    AdbInstance* regNode = root->getChildByPath("bench_reg");
+
+    std::vector<string> names;
+    std::ostringstream data;
+    for (int i = 0; i < fields; i++)
+    {
+        std::ostringstream name;
+        name << "field_" << i;
+        names.push_back(name.str());
+        data << (i ? "," : "") << name.str() << "=" << i;
+    }
+
+    double scan_time = 0;
+    double index_time = 0;
+    double set_time = 0;
+    try
+    {
+        for (int i = 0; i < iterations; i++)
+        {
+            BenchParser scanner("", "", regNode);
+            double start = bench_now_secs();
+            size_t found = scanner.lookupAll(names, true);
+            scan_time += bench_now_secs() - start;
+
+            BenchParser indexed("", "", regNode);
+            start = bench_now_secs();
+            found += indexed.lookupAll(names, false);
+            index_time += bench_now_secs() - start;
+            if (found != 2 * names.size())
+            {
+                fprintf(stderr, "-E- Lookup of %d fields found %zu\n", fields, found);
+                delete root;
+                return 1;
+            }
+
+            BenchParser setter(data.str(), "local_port=1", regNode);
+            start = bench_now_secs();
+            std::vector<u_int32_t> buff = setter.genBuff();
+            set_time += bench_now_secs() - start;
+            if (buff.size() != (size_t)fields + 1 || buff[fields] != CPU_TO_BE32(fields - 1))
+            {
+                fprintf(stderr, "-E- Wrong buffer generated for %d fields\n", fields);
+                delete root;
+                return 1;
+            }
+        }
+    }
+    catch (MlxRegException& exp)
+    {
+        fprintf(stderr, "-E- %s\n", exp.what_s().c_str());
+        delete root;
+        return 1;
+    }
+    delete root;
+    printf("%6d fields: %12.1f usecs to scan all, %10.1f to look up all, %10.1f to set all\n", fields,
+           scan_time * 1e6 / iterations, index_time * 1e6 / iterations, set_time * 1e6 / iterations);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    int iterations = 5;
+    int max_fields = 4096;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "i:n:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'i':
+                iterations = atoi(optarg);
+                break;
+            case 'n':
+                max_fields = atoi(optarg);
+                break;
+            default:
+                return bench_usage(argv[0], "[-i iterations] [-n max_fields]");
+        }
+    }
+    if (iterations <= 0 || max_fields <= 0)
+    {
+        return bench_usage(argv[0], "[-i iterations] [-n max_fields]");
+    }
+    for (int fields = 16; fields <= max_fields; fields *= 4)
+    {
+        if (bench_fields(fields, iterations))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
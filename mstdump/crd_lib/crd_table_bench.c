@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2013-2021 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+/*
+ * Startup cost of loading a dump table: parsing the csv vs loading its binary form.
+ *
+ * Usage: crd_table_bench [-i iterations] [-f] <Device>.csv
+ *   -f  count the dwords of a -full dump
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <common/tools_bench.h>
+#include "crdump.h"
+
+static int bench_load(const char* csv_path, int is_full, int use_binary, int iterations)
+{
+    u_int32_t block_count = 0;
+    u_int32_t number_of_dwords = 0;
+    double start = bench_now_secs();
+    int i;
+
+    for (i = 0; i < iterations; i++)
+    {
+        int rc = crd_load_dump_table(csv_path, is_full, use_binary, &block_count, &number_of_dwords);
+        if (rc)
+        {
+            fprintf(stderr, "-E- Failed to load %s: %s\n", csv_path, crd_err_str(rc));
+            return 1;
+        }
+    }
+    printf("%-8s %8.1f usecs per load, %u blocks, %u dwords\n", use_binary ? "binary" : "csv",
+           (bench_now_secs() - start) * 1e6 / iterations, block_count, number_of_dwords);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    int iterations = 200;
+    int is_full = 0;
+    u_int32_t block_count = 0;
+    u_int32_t number_of_dwords = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "i:f")) != -1)
+    {
+        switch (opt)
+        {
+            case 'i':
+                iterations = atoi(optarg);
+                break;
+            case 'f':
+                is_full = 1;
+                break;
+            default:
+                return bench_usage(argv[0], "[-i iterations] [-f] <Device>.csv");
+        }
+    }
+    if (optind >= argc || iterations <= 0)
+    {
+        return bench_usage(argv[0], "[-i iterations] [-f] <Device>.csv");
+    }
+
+    // First binary load compiles the table when it is missing or stale
+    if (crd_load_dump_table(argv[optind], is_full, 1, &block_count, &number_of_dwords))
+    {
+        fprintf(stderr, "-E- Failed to load %s\n", argv[optind]);
+        return 1;
+    }
+    if (bench_load(argv[optind], is_full, 0, iterations) || bench_load(argv[optind], is_full, 1, iterations))
+    {
+        return 1;
+    }
+    return 0;
+}
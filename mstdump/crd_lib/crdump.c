@@ -44,6 +44,14 @@
 #include <tools_layouts/reg_access_switch_layouts.h>
 #include <reg_access/reg_access.h>
 #include <stdbool.h>
+#if !defined(__WIN__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <common/tools_cache_dir.h>
+#define CRD_BINARY_TABLE
+#endif
 
 #define CRD_CHECK_NULL(var)                        \
     if (var == NULL)                               \
@@ -73,6 +81,7 @@
 #define CRD_MAXFLDSIZE 32 /* longest possible field + 1 = 31 byte field */
 #define CRD_CSV_PATH_SIZE 1024
 #define CRD_MAX_REG_ACCESS_BLOCK 256
+#define CRD_CAUSE_BATCH_DEFAULT 64 /* dwords read between two checks of the cause bit */
 
 // Scratchpad 2
 #define CRD_SP2_TLV_FIRST_ADDRESS 0x18         /* This first tlv address is valid only for HCA */
@@ -88,6 +97,35 @@ typedef struct crd_sp2_tlv
     u_int32_t address;
 } crd_sp2_tlv_t;
 
+/*
+   Binary form of a dump table, compiled from <Device>.csv on first use into the per-user cache directory, the
+   installed csv is only read. It is used only while the csv keeps the size, mtime and inode recorded in its header.
+ */
+#define CRD_TABLE_MAGIC 0x42445243 /* CRDB */
+#define CRD_TABLE_VERSION 1
+#define CRD_TABLE_SUFFIX ".crdb"
+#define CRD_TABLE_DISABLE_ENV "MSTDUMP_NO_BINARY_TABLE"
+#define CRD_TABLE_ENTRY_NO_ENABLE 0x1 /* dumped without -full */
+
+typedef struct crd_table_header
+{
+    u_int32_t magic;
+    u_int32_t version;
+    u_int64_t csv_size;
+    u_int64_t csv_mtime_sec;
+    u_int64_t csv_mtime_nsec;
+    u_int64_t csv_ino;
+    u_int32_t entry_count;
+    u_int32_t entries_hash;
+} crd_table_header_t;
+
+typedef struct crd_table_entry
+{
+    u_int32_t addr;
+    u_int32_t len;
+    u_int32_t flags;
+} crd_table_entry_t;
+
 typedef struct crd_parsed_csv
 {
     u_int32_t addr;
@@ -104,6 +142,8 @@ struct crd_ctxt
     int is_full;
     int cause_addr;
     int cause_off;
+    u_int32_t cause_batch;
+    crd_access_stats_t stats;
     char csv_path[CRD_CSV_PATH_SIZE];
     u_int32_t block_count;
     crd_parsed_csv_t* blocks;
@@ -122,13 +162,32 @@ static int crd_get_csv_path(IN dm_dev_id_t dev_type,
 /*
    count number of dwords, and store all needed data from csv file at parsed_csv
  */
-static int crd_count_double_word(IN mfile* mf,
-                                 IN char* csv_file_path,
+static int crd_count_double_word(IN char* csv_file_path,
                                  OUT u_int32_t* number_of_dwords,
                                  OUT crd_parsed_csv_t blocks[],
-                                 IN int is_full,
-                                 IN u_int8_t read_single_dword,
-                                 IN u_int8_t with_sp2);
+                                 IN int is_full);
+
+/*
+   Load the blocks of a dump table, from its binary form when valid, leaving room for extra_blocks more
+ */
+static int crd_load_table(IN char* csv_file_path,
+                          IN int is_full,
+                          IN int use_binary,
+                          IN u_int32_t extra_blocks,
+                          OUT crd_parsed_csv_t** blocks,
+                          OUT u_int32_t* block_count,
+                          OUT u_int32_t* number_of_dwords);
+
+#ifdef CRD_BINARY_TABLE
+static int crd_table_read(IN char* csv_file_path,
+                          IN int is_full,
+                          IN u_int32_t extra_blocks,
+                          OUT crd_parsed_csv_t** blocks,
+                          OUT u_int32_t* block_count,
+                          OUT u_int32_t* number_of_dwords);
+
+static void crd_table_write(IN char* csv_file_path, IN crd_parsed_csv_t blocks[], IN u_int32_t block_count);
+#endif
 
 /*
    Fill addresses at dword_arr
@@ -148,7 +207,7 @@ static void crd_parse(IN char* record, IN char* delim, OUT char arr[][CRD_MAXFLD
 
 static int crd_update_csv_path(IN OUT char* csv_file_path, IN const char* db_path);
 
-static int crd_count_blocks(IN char* csv_file_path, OUT u_int32_t* block_count, u_int8_t read_single_dword);
+static int crd_count_blocks(IN char* csv_file_path, OUT u_int32_t* block_count);
 
 static int crd_count_tlv_blocks_and_dwords(IN mfile* mf, OUT u_int32_t* block_count, OUT u_int32_t* number_of_dwords);
 
@@ -190,7 +249,6 @@ int crd_init(OUT crd_ctxt_t** context,
     u_int32_t block_count = 0;
     u_int32_t sp2_number_of_dwords = 0;
     u_int32_t sp2_block_count = 0;
-    u_int8_t read_single_dword = 0;
     char csv_file_path[CRD_CSV_PATH_SIZE] = {0x0};
 
     int rc = CRD_OK;
@@ -204,10 +262,6 @@ int crd_init(OUT crd_ctxt_t** context,
         return CRD_INVALID_PARM;
     }
 
-    if (cause_addr >= 0 && cause_off >= 0)
-    {
-        read_single_dword = 1;
-    }
     CRD_DEBUG("getting device id\n");
     if (dm_get_device_id(mf, &dev_type, &dev_id, &chip_rev))
     {
@@ -239,27 +293,21 @@ int crd_init(OUT crd_ctxt_t** context,
         }
     }
 
-    rc = crd_count_blocks(csv_file_path, &block_count, read_single_dword);
+    rc = crd_load_table(csv_file_path, is_full, getenv(CRD_TABLE_DISABLE_ENV) == NULL, sp2_block_count,
+                        &(*context)->blocks, &block_count, &number_of_dwords);
     if (rc)
     {
         free(*context);
         return rc;
     }
 
-    CRD_DEBUG("Block count : %d\n", block_count);
-    (*context)->blocks = (crd_parsed_csv_t*)malloc(sizeof(crd_parsed_csv_t) * (block_count + sp2_block_count));
-    if ((*context)->blocks == NULL)
-    {
-        CRD_DEBUG("Failed to allocate memmory for csv blocks\n");
-        free(*context);
-        return CRD_MEM_ALLOCATION_ERR;
-    }
-
-    rc = crd_count_double_word(mf, csv_file_path, &number_of_dwords, (*context)->blocks, is_full, read_single_dword,
-                               with_sp2);
-    if (rc)
+    if (with_sp2)
     {
-        goto Cleanup;
+        rc = crd_set_tlv_blocks(mf, (*context)->blocks, block_count);
+        if (rc)
+        {
+            goto Cleanup;
+        }
     }
 
     mset_addr_space(mf, AS_ND_CRSPACE);
@@ -272,6 +320,8 @@ int crd_init(OUT crd_ctxt_t** context,
     (*context)->block_count = block_count + sp2_block_count;
     (*context)->cause_addr = cause_addr;
     (*context)->cause_off = cause_off;
+    (*context)->cause_batch = CRD_CAUSE_BATCH_DEFAULT;
+    memset(&(*context)->stats, 0, sizeof((*context)->stats));
     strcpy((*context)->csv_path, csv_file_path);
     return rc;
 
@@ -296,24 +346,50 @@ int crd_get_addr_list(IN crd_ctxt_t* context, OUT crd_dword_t* dword_arr)
     return CRD_OK;
 }
 
-int crd_dump_data(IN crd_ctxt_t* context, OUT crd_dword_t* dword_arr, IN crd_callback_t func)
+static int crd_read_cause_bit(IN crd_ctxt_t* context, OUT u_int32_t* cause_bit)
+{
+    u_int32_t cause_reg = 0;
+
+    context->stats.cause_reads++;
+    if (mread4(context->mf, context->cause_addr, &cause_reg) != sizeof(u_int32_t))
+    {
+        CRD_DEBUG("Cr read (0x%08x) failed: %s(%d)\n", context->cause_addr, strerror(errno), (u_int32_t)errno);
+        sprintf(crd_error, "Cr read (0x%08x) failed: %s(%d)", context->cause_addr, strerror(errno), (u_int32_t)errno);
+        return CRD_CR_READ_ERR;
+    }
+    *cause_bit = EXTRACT(cause_reg, context->cause_off, 1);
+    return CRD_OK;
+}
+
+static int crd_dump(IN crd_ctxt_t* context,
+                    OUT crd_dword_t* dword_arr,
+                    IN crd_callback_t func,
+                    IN crd_block_callback_t block_func,
+                    IN void* user_data)
 {
     u_int32_t i = 0;
     u_int32_t j = 0;
     u_int32_t rc;
     u_int32_t addr;
-    u_int32_t cause_reg = 0;
+    u_int32_t cause_bit = 0;
+    u_int32_t chunk_start = 0;
+    u_int32_t chunk_len = 0;
+    u_int32_t chunk_max = 0;
+    u_int32_t max_len = 1;
 
     int total = 0;
-    char* data;
+    u_int32_t* data;
     crd_dword_t tmp_dword;
 
-    CRD_CHECK_NULL(context);
-
-    if (dword_arr == NULL && func == NULL)
+    // One buffer for all the blocks
+    for (i = 0; i < context->block_count; i++)
     {
-        CRD_DEBUG("Nothing to do\n");
-        return CRD_INVALID_PARM;
+        max_len = context->blocks[i].len > max_len ? context->blocks[i].len : max_len;
+    }
+    data = (u_int32_t*)malloc(max_len * sizeof(u_int32_t));
+    if (data == NULL)
+    {
+        return CRD_MEM_ALLOCATION_ERR;
     }
 
     for (i = 0; i < context->block_count; i++)
@@ -323,69 +399,135 @@ int crd_dump_data(IN crd_ctxt_t* context, OUT crd_dword_t* dword_arr, IN crd_cal
             continue;
         }
 
-        data = (char*)malloc(context->blocks[i].len * sizeof(u_int32_t));
-        if (data == NULL)
+        // Without a cause register the block is read at once. With one, the cause bit is checked after every
+        // cause_batch dwords, and the dwords of a range are reported only once it is known not to raise it.
+        chunk_max = context->cause_addr >= 0 ? context->cause_batch : context->blocks[i].len;
+        for (chunk_start = 0; chunk_start < context->blocks[i].len; chunk_start += chunk_len)
         {
-            return CRD_MEM_ALLOCATION_ERR;
-        }
-        memset(data, 0, context->blocks[i].len * sizeof(u_int32_t));
-
-        rc = mread4_block(context->mf, context->blocks[i].addr, (u_int32_t*)data,
-                          context->blocks[i].len * sizeof(u_int32_t));
-        if (context->blocks[i].len * sizeof(u_int32_t) != rc)
-        {
-            sprintf(crd_error, "Cr read (0x%08x) failed: %s(%d)", context->blocks[i].addr, strerror(errno),
-                    (u_int32_t)errno);
-            free(data);
-            return CRD_CR_READ_ERR;
-        }
+            chunk_len = context->blocks[i].len - chunk_start;
+            chunk_len = chunk_len > chunk_max ? chunk_max : chunk_len;
+            addr = context->blocks[i].addr + (chunk_start * sizeof(u_int32_t));
 
-        for (j = 0; j < context->blocks[i].len; j++)
-        {
-            if ((u_int32_t)total >= context->number_of_dwords)
-            { // dummy check tadah!
-                CRD_DEBUG("value exceeded, something wrong in calculation!");
+            context->stats.data_reads++;
+            rc = mread4_block(context->mf, addr, data + chunk_start, chunk_len * sizeof(u_int32_t));
+            if (chunk_len * sizeof(u_int32_t) != rc)
+            {
+                sprintf(crd_error, "Cr read (0x%08x) failed: %s(%d)", addr, strerror(errno), (u_int32_t)errno);
                 free(data);
-                return CRD_EXCEED_VALUE;
+                return CRD_CR_READ_ERR;
             }
-            addr = context->blocks[i].addr + (j * sizeof(u_int32_t));
 
             if (context->cause_addr >= 0)
             { // if we want to check cause bit - read it and verify it hasn't been raised
-                if (mread4(context->mf, context->cause_addr, &cause_reg) != sizeof(u_int32_t))
+                rc = crd_read_cause_bit(context, &cause_bit);
+                if (rc)
                 {
-                    CRD_DEBUG("Cr read (0x%08x) failed: %s(%d)\n", context->cause_addr, strerror(errno),
-                              (u_int32_t)errno);
-                    sprintf(crd_error, "Cr read (0x%08x) failed: %s(%d)", context->cause_addr, strerror(errno),
-                            (u_int32_t)errno);
                     free(data);
-                    return CRD_CR_READ_ERR;
+                    return rc;
                 }
-                cause_reg = EXTRACT(cause_reg, context->cause_off, 1);
-                if (cause_reg)
+                if (cause_bit)
                 {
-                    CRD_DEBUG("Cause bit set by read from address 0x%x\n", addr);
-                    sprintf(crd_error, "Cause bit set by read from address 0x%x", addr);
+                    if (chunk_len == 1)
+                    {
+                        CRD_DEBUG("Cause bit set by read from address 0x%x\n", addr);
+                        sprintf(crd_error, "Cause bit set by read from address 0x%x", addr);
+                    }
+                    else
+                    {
+                        CRD_DEBUG("Cause bit set by read from addresses 0x%x-0x%x\n", addr,
+                                  addr + (u_int32_t)((chunk_len - 1) * sizeof(u_int32_t)));
+                        sprintf(crd_error, "Cause bit set by read from addresses 0x%x-0x%x", addr,
+                                addr + (u_int32_t)((chunk_len - 1) * sizeof(u_int32_t)));
+                    }
                     free(data);
                     return CRD_CAUSE_BIT;
                 }
             }
 
-            if (dword_arr != NULL)
+            if ((u_int32_t)total + chunk_len > context->number_of_dwords)
+            { // dummy check tadah!
+                CRD_DEBUG("value exceeded, something wrong in calculation!");
+                free(data);
+                return CRD_EXCEED_VALUE;
+            }
+            if (block_func != NULL)
             {
-                dword_arr[total].addr = addr;
-                dword_arr[total].data = ((u_int32_t*)data)[j];
+                if (block_func(addr, data + chunk_start, chunk_len, user_data))
+                {
+                    free(data);
+                    return CRD_CALLBACK_ERR;
+                }
+                total += chunk_len;
+                context->stats.dwords += chunk_len;
+                continue;
             }
-            if (func != NULL)
+            for (j = chunk_start; j < chunk_start + chunk_len; j++)
             {
-                tmp_dword.addr = addr;
-                tmp_dword.data = ((u_int32_t*)data)[j];
-                func(&tmp_dword);
+                addr = context->blocks[i].addr + (j * sizeof(u_int32_t));
+
+                if (dword_arr != NULL)
+                {
+                    dword_arr[total].addr = addr;
+                    dword_arr[total].data = data[j];
+                }
+                if (func != NULL)
+                {
+                    tmp_dword.addr = addr;
+                    tmp_dword.data = data[j];
+                    func(&tmp_dword);
+                }
+                total += 1;
+                context->stats.dwords++;
             }
-            total += 1;
         }
-        free(data);
     }
+    free(data);
+    return CRD_OK;
+}
+
+int crd_dump_data(IN crd_ctxt_t* context, OUT crd_dword_t* dword_arr, IN crd_callback_t func)
+{
+    CRD_CHECK_NULL(context);
+
+    if (dword_arr == NULL && func == NULL)
+    {
+        CRD_DEBUG("Nothing to do\n");
+        return CRD_INVALID_PARM;
+    }
+    return crd_dump(context, dword_arr, func, NULL, NULL);
+}
+
+int crd_dump_data_blocks(IN crd_ctxt_t* context, IN crd_block_callback_t func, IN void* user_data)
+{
+    CRD_CHECK_NULL(context);
+    CRD_CHECK_NULL(func);
+    return crd_dump(context, NULL, NULL, func, user_data);
+}
+
+int crd_set_cause_batch(IN crd_ctxt_t* context, IN u_int32_t dwords)
+{
+    CRD_CHECK_NULL(context);
+    if (dwords == 0)
+    {
+        return CRD_INVALID_PARM;
+    }
+    context->cause_batch = dwords;
+    return CRD_OK;
+}
+
+int crd_get_access_stats(IN crd_ctxt_t* context, OUT crd_access_stats_t* stats)
+{
+    CRD_CHECK_NULL(context);
+    CRD_CHECK_NULL(stats);
+    *stats = context->stats;
+    return CRD_OK;
+}
+
+int crd_get_dev_type(IN crd_ctxt_t* context, OUT u_int32_t* dev_type)
+{
+    CRD_CHECK_NULL(context);
+    CRD_CHECK_NULL(dev_type);
+    *dev_type = context->dev_type;
     return CRD_OK;
 }
 
@@ -674,7 +816,7 @@ static int crd_get_tlv_from_address(IN mfile* mf, IN u_int32_t address, OUT crd_
     return CRD_OK;
 }
 
-static int crd_count_blocks(IN char* csv_file_path, OUT u_int32_t* block_count, u_int8_t read_single_dword)
+static int crd_count_blocks(IN char* csv_file_path, OUT u_int32_t* block_count)
 {
     char tmp[1024] = {0x0};
     char arr[CRD_MAXFLDS][CRD_MAXFLDSIZE];
@@ -713,34 +855,21 @@ static int crd_count_blocks(IN char* csv_file_path, OUT u_int32_t* block_count,
             fclose(fd);
             return CRD_CSV_BAD_FORMAT;
         }
-        if (read_single_dword)
-        {
-            *block_count += atoi(arr[1]);
-        }
-        else
-        {
-            *block_count += 1;
-        }
+        *block_count += 1;
     }
     fclose(fd);
     return CRD_OK;
 }
 
-static int crd_count_double_word(IN mfile* mf,
-                                 IN char* csv_file_path,
+static int crd_count_double_word(IN char* csv_file_path,
                                  OUT u_int32_t* number_of_dwords,
                                  OUT crd_parsed_csv_t blocks[],
-                                 IN int is_full,
-                                 IN u_int8_t read_single_dword,
-                                 IN u_int8_t with_sp2)
+                                 IN int is_full)
 {
-    int rc = 0;
     int field_count = 0;
     int block_count = 0;
     u_int32_t addr = 0;
     u_int32_t len = 0;
-    u_int32_t i = 0;
-    char enable_addr[100] = {0};
     char tmp[1024] = {0x0};
     char arr[CRD_MAXFLDS][CRD_MAXFLDSIZE];
 
@@ -782,63 +911,285 @@ static int crd_count_double_word(IN mfile* mf,
         }
         addr = (u_int32_t)strtol(arr[0], NULL, 0);
         len = atoi(arr[1]);
-        if (!read_single_dword)
+        blocks[block_count].addr = addr;
+        blocks[block_count].len = len;
+        if (field_count > 2)
         {
-            blocks[block_count].addr = addr;
-            blocks[block_count].len = len;
-            if (field_count > 2)
+            strcpy(blocks[block_count].enable_addr, arr[2]);
+            if (is_full || (!is_full && !strcmp(blocks[block_count].enable_addr, CRD_EMPTY)))
             {
-                strcpy(blocks[block_count].enable_addr, arr[2]);
-                if (is_full || (!is_full && !strcmp(blocks[block_count].enable_addr, CRD_EMPTY)))
-                {
-                    *number_of_dwords += len;
-                }
-            }
-            else
-            {
-                strcpy(blocks[block_count].enable_addr, CRD_EMPTY);
                 *number_of_dwords += len;
             }
-            block_count += 1;
         }
         else
         {
-            if (field_count > 2)
-            {
-                strcpy(enable_addr, arr[2]);
-            }
-            else
-            {
-                strcpy(enable_addr, CRD_EMPTY);
-            }
-            if (is_full || (!is_full && !strcmp(enable_addr, CRD_EMPTY)))
-            {
-                *number_of_dwords += len;
-            }
-            for (i = 0; i < len; i++)
-            {
-                blocks[block_count].addr = addr;
-                blocks[block_count].len = 1;
-                strcpy(blocks[block_count].enable_addr, enable_addr);
-                block_count += 1;
-                addr += 4;
-            }
+            strcpy(blocks[block_count].enable_addr, CRD_EMPTY);
+            *number_of_dwords += len;
         }
+        block_count += 1;
     }
     fclose(fd);
+    return CRD_OK;
+}
 
-    if (with_sp2)
+static int crd_load_table(IN char* csv_file_path,
+                          IN int is_full,
+                          IN int use_binary,
+                          IN u_int32_t extra_blocks,
+                          OUT crd_parsed_csv_t** blocks,
+                          OUT u_int32_t* block_count,
+                          OUT u_int32_t* number_of_dwords)
+{
+    int rc;
+
+    *blocks = NULL;
+#ifdef CRD_BINARY_TABLE
+    if (use_binary &&
+        crd_table_read(csv_file_path, is_full, extra_blocks, blocks, block_count, number_of_dwords) == CRD_OK)
     {
-        rc = crd_set_tlv_blocks(mf, blocks, block_count);
-        if (rc)
+        return CRD_OK;
+    }
+#else
+    (void)use_binary;
+#endif
+
+    rc = crd_count_blocks(csv_file_path, block_count);
+    if (rc)
+    {
+        return rc;
+    }
+
+    CRD_DEBUG("Block count : %d\n", *block_count);
+    *blocks = (crd_parsed_csv_t*)malloc(sizeof(crd_parsed_csv_t) * (*block_count + extra_blocks));
+    if (*blocks == NULL)
+    {
+        CRD_DEBUG("Failed to allocate memmory for csv blocks\n");
+        return CRD_MEM_ALLOCATION_ERR;
+    }
+
+    rc = crd_count_double_word(csv_file_path, number_of_dwords, *blocks, is_full);
+    if (rc)
+    {
+        free(*blocks);
+        *blocks = NULL;
+        return rc;
+    }
+
+#ifdef CRD_BINARY_TABLE
+    if (use_binary)
+    {
+        crd_table_write(csv_file_path, *blocks, *block_count);
+    }
+#endif
+    return CRD_OK;
+}
+
+#ifdef CRD_BINARY_TABLE
+static int crd_table_path(IN const char* csv_file_path, OUT char* table_path)
+{
+    return tools_cache_file(csv_file_path, CRD_TABLE_SUFFIX, table_path, CRD_CSV_PATH_SIZE);
+}
+
+static u_int32_t crd_table_hash(IN const crd_table_entry_t* entries, IN u_int32_t entry_count)
+{
+    const u_int8_t* p = (const u_int8_t*)entries;
+    size_t size = entry_count * sizeof(crd_table_entry_t);
+    u_int32_t hash = 2166136261u; /* FNV-1a */
+    size_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        hash = (hash ^ p[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void crd_table_set_csv_id(IN const struct stat* csv_stat, OUT crd_table_header_t* header)
+{
+    header->csv_size = (u_int64_t)csv_stat->st_size;
+    header->csv_mtime_sec = (u_int64_t)csv_stat->st_mtim.tv_sec;
+    header->csv_mtime_nsec = (u_int64_t)csv_stat->st_mtim.tv_nsec;
+    header->csv_ino = (u_int64_t)csv_stat->st_ino;
+}
+
+static int crd_table_read(IN char* csv_file_path,
+                          IN int is_full,
+                          IN u_int32_t extra_blocks,
+                          OUT crd_parsed_csv_t** blocks,
+                          OUT u_int32_t* block_count,
+                          OUT u_int32_t* number_of_dwords)
+{
+    char table_path[CRD_CSV_PATH_SIZE] = {0x0};
+    struct stat csv_stat;
+    struct stat table_stat;
+    crd_table_header_t csv_id;
+    const crd_table_header_t* header;
+    const crd_table_entry_t* entries;
+    void* map;
+    int fd;
+    u_int32_t i;
+    int rc = CRD_SKIP;
+
+    if (crd_table_path(csv_file_path, table_path) || stat(csv_file_path, &csv_stat))
+    {
+        return CRD_SKIP;
+    }
+    fd = open(table_path, O_RDONLY);
+    if (fd < 0)
+    {
+        return CRD_SKIP;
+    }
+    // The table decides which addresses are read, only trust one no other user could have written
+    if (fstat(fd, &table_stat) || !S_ISREG(table_stat.st_mode) ||
+        (table_stat.st_uid != 0 && table_stat.st_uid != geteuid()) || (table_stat.st_mode & (S_IWGRP | S_IWOTH)) ||
+        (size_t)table_stat.st_size < sizeof(crd_table_header_t))
+    {
+        CRD_DEBUG("Ignoring binary table %s\n", table_path);
+        close(fd);
+        return CRD_SKIP;
+    }
+    map = mmap(NULL, table_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        return CRD_SKIP;
+    }
+
+    header = (const crd_table_header_t*)map;
+    entries = (const crd_table_entry_t*)(header + 1);
+    crd_table_set_csv_id(&csv_stat, &csv_id);
+    if (header->magic != CRD_TABLE_MAGIC || header->version != CRD_TABLE_VERSION ||
+        header->csv_size != csv_id.csv_size || header->csv_mtime_sec != csv_id.csv_mtime_sec ||
+        header->csv_mtime_nsec != csv_id.csv_mtime_nsec || header->csv_ino != csv_id.csv_ino ||
+        (u_int64_t)table_stat.st_size !=
+          sizeof(crd_table_header_t) + (u_int64_t)header->entry_count * sizeof(crd_table_entry_t) ||
+        header->entries_hash != crd_table_hash(entries, header->entry_count))
+    {
+        CRD_DEBUG("Binary table %s is stale, using %s\n", table_path, csv_file_path);
+        goto Unmap;
+    }
+
+    *blocks = (crd_parsed_csv_t*)malloc(sizeof(crd_parsed_csv_t) * (header->entry_count + extra_blocks));
+    if (*blocks == NULL)
+    {
+        goto Unmap;
+    }
+    *number_of_dwords = 0;
+    for (i = 0; i < header->entry_count; i++)
+    {
+        int no_enable = entries[i].flags & CRD_TABLE_ENTRY_NO_ENABLE;
+        (*blocks)[i].addr = entries[i].addr;
+        (*blocks)[i].len = entries[i].len;
+        strcpy((*blocks)[i].enable_addr, no_enable ? CRD_EMPTY : CRD_UNKOWN);
+        if (is_full || no_enable)
         {
-            return rc;
+            *number_of_dwords += entries[i].len;
         }
     }
+    *block_count = header->entry_count;
+    CRD_DEBUG("Loaded %u blocks from binary table %s\n", *block_count, table_path);
+    rc = CRD_OK;
 
-    return CRD_OK;
+Unmap:
+    munmap(map, table_stat.st_size);
+    return rc;
 }
 
+static void crd_table_write(IN char* csv_file_path, IN crd_parsed_csv_t blocks[], IN u_int32_t block_count)
+{
+    char table_path[CRD_CSV_PATH_SIZE] = {0x0};
+    char tmp_path[CRD_CSV_PATH_SIZE + 32] = {0x0};
+    struct stat csv_stat;
+    crd_table_header_t header;
+    crd_table_entry_t* entries;
+    u_int32_t entry_count = 0;
+    u_int32_t i;
+    size_t entries_size;
+    int fd;
+    int ok;
+
+    if (stat(csv_file_path, &csv_stat))
+    {
+        return;
+    }
+    entries = (crd_table_entry_t*)calloc(block_count ? block_count : 1, sizeof(crd_table_entry_t));
+    if (entries == NULL)
+    {
+        return;
+    }
+    // Coalesce adjacent ranges that are dumped under the same condition
+    for (i = 0; i < block_count; i++)
+    {
+        u_int32_t flags = strcmp(blocks[i].enable_addr, CRD_EMPTY) ? 0 : CRD_TABLE_ENTRY_NO_ENABLE;
+        crd_table_entry_t* last = entry_count ? &entries[entry_count - 1] : NULL;
+        if (last && last->flags == flags && last->addr + last->len * sizeof(u_int32_t) == blocks[i].addr)
+        {
+            last->len += blocks[i].len;
+            continue;
+        }
+        entries[entry_count].addr = blocks[i].addr;
+        entries[entry_count].len = blocks[i].len;
+        entries[entry_count].flags = flags;
+        entry_count++;
+    }
+
+    memset(&header, 0, sizeof(header));
+    header.magic = CRD_TABLE_MAGIC;
+    header.version = CRD_TABLE_VERSION;
+    crd_table_set_csv_id(&csv_stat, &header);
+    header.entry_count = entry_count;
+    header.entries_hash = crd_table_hash(entries, entry_count);
+
+    // Written aside and renamed, so concurrent runs see either no table or a whole one
+    if (crd_table_path(csv_file_path, table_path))
+    {
+        free(entries);
+        return;
+    }
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%d", table_path, (int)getpid());
+    fd = open(tmp_path, O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (fd < 0)
+    {
+        CRD_DEBUG("Cannot create binary table %s\n", tmp_path);
+        free(entries);
+        return;
+    }
+    entries_size = entry_count * sizeof(crd_table_entry_t);
+    ok = write(fd, &header, sizeof(header)) == (ssize_t)sizeof(header) &&
+         write(fd, entries, entries_size) == (ssize_t)entries_size;
+    ok = !close(fd) && ok;
+    if (!ok || rename(tmp_path, table_path))
+    {
+        unlink(tmp_path);
+    }
+    else
+    {
+        CRD_DEBUG("Wrote binary table %s: %u blocks from %u\n", table_path, entry_count, block_count);
+    }
+    free(entries);
+}
+#endif
+
+int crd_load_dump_table(IN const char* csv_path,
+                        IN int is_full,
+                        IN int use_binary,
+                        OUT u_int32_t* block_count,
+                        OUT u_int32_t* number_of_dwords)
+{
+    char csv_file_path[CRD_CSV_PATH_SIZE] = {0x0};
+    crd_parsed_csv_t* blocks = NULL;
+    int rc;
+
+    CRD_CHECK_NULL(csv_path);
+    CRD_CHECK_NULL(block_count);
+    CRD_CHECK_NULL(number_of_dwords);
+    strncpy(csv_file_path, csv_path, CRD_CSV_PATH_SIZE - 1);
+    rc = crd_load_table(csv_file_path, is_full, use_binary, 0, &blocks, block_count, number_of_dwords);
+    free(blocks);
+    return rc;
+}
+
+
 static int crd_fill_address(IN crd_ctxt_t* context, OUT crd_dword_t* dword_arr)
 {
     u_int32_t i = 0;
@@ -1128,6 +1479,9 @@ const char* crd_err_str(int rc)
         case CRD_CAUSE_BIT:
             return crd_error;
 
+        case CRD_CALLBACK_ERR:
+            return "Dump callback failed";
+
         default:
             return "Unknown error";
     }
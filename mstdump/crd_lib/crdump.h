@@ -61,6 +61,7 @@ extern "C"
         CRD_CAUSE_BIT,
         CRD_TLV_SIGNATURE_INVALID,
         CRD_TLV_ADDRESS_INVALID,
+        CRD_CALLBACK_ERR,
     };
 
     typedef struct crd_ctxt crd_ctxt_t;
@@ -73,6 +74,37 @@ extern "C"
 
     typedef void (*crd_callback_t)(crd_dword_t*); // call back
 
+    // Called with consecutive dwords starting at addr, non zero stops the dump
+    typedef int (*crd_block_callback_t)(u_int32_t addr, const u_int32_t* data, u_int32_t num_dwords, void* user_data);
+
+    /*
+       Binary dump: a crd_bin_header_t, then for each range a crd_bin_range_t followed by its dwords. All fields are
+       in the byte order of the host that dumped, a byte swapped magic tells the reader to swap
+     */
+#define CRD_BIN_MAGIC 0x50445243 /* CRDP */
+#define CRD_BIN_VERSION 1
+
+    typedef struct crd_bin_header
+    {
+        u_int32_t magic;
+        u_int32_t version;
+        u_int32_t dev_type;
+        u_int32_t reserved;
+    } crd_bin_header_t;
+
+    typedef struct crd_bin_range
+    {
+        u_int32_t addr;
+        u_int32_t num_dwords;
+    } crd_bin_range_t;
+
+    typedef struct crd_access_stats
+    {
+        u_int32_t data_reads;  // block reads of dumped addresses
+        u_int32_t cause_reads; // reads of the cause register
+        u_int32_t dwords;      // dwords dumped
+    } crd_access_stats_t;
+
 #ifndef IN
 #define IN
 #endif
@@ -124,6 +156,38 @@ extern "C"
                                      OUT crd_dword_t* dword_arr,
                                      IN crd_callback_t func); // values will be filled.
 
+    /*
+       Read the same dwords as crd_dump_data, passing each range read to func
+     */
+    CRD_DLL_EXPORT int crd_dump_data_blocks(IN crd_ctxt_t* context, IN crd_block_callback_t func, IN void* user_data);
+
+    /*
+       Device type of the dump, for crd_bin_header_t
+     */
+    CRD_DLL_EXPORT int crd_get_dev_type(IN crd_ctxt_t* context, OUT u_int32_t* dev_type);
+
+    /*
+       Number of dwords read between two checks of the cause bit (default 64). A raised bit is reported for the
+       whole range, 1 pins it to a single address at the cost of a cause read per dword
+     */
+    CRD_DLL_EXPORT int crd_set_cause_batch(IN crd_ctxt_t* context, IN u_int32_t dwords);
+
+    /*
+       Device accesses done by crd_dump_data so far
+     */
+    CRD_DLL_EXPORT int crd_get_access_stats(IN crd_ctxt_t* context, OUT crd_access_stats_t* stats);
+
+    /*
+       Load the dump table of csv_path without a device and return its size. With use_binary, the binary form
+       in the user's cache directory is used when up to date, and (re)compiled otherwise. For precompiling tables
+       and timing startup
+     */
+    CRD_DLL_EXPORT int crd_load_dump_table(IN const char* csv_path,
+                                           IN int is_full,
+                                           IN int use_binary,
+                                           OUT u_int32_t* block_count,
+                                           OUT u_int32_t* number_of_dwords);
+
     /*
        Return string representation of the error code
      */
@@ -37,7 +37,12 @@
 #include <common/bit_slice.h>
 
 #define CAUSE_FLAG "--cause"
+#define BINARY_FLAG "--binary"
+#define BIN2TXT_FLAG "--bin2txt"
+#define ACCESS_STATS_ENV "MSTDUMP_ACCESS_STATS"
 #define MAX_DEV_LEN 512
+#define DUMP_LINE_LEN 22 // "0x%8.8x 0x%8.8x\n"
+#define DUMP_BUF_SIZE (1 << 20)
 
 #ifndef MSTDUMP_NAME
 #define MSTDUMP_NAME "mstdump"
@@ -49,18 +54,146 @@
 
 // string explaining the cmd-line structure
 char correct_cmdline[] = "   Mellanox " MSTDUMP_NAME " utility, dumps device internal configuration data\n\
-   Usage: " MSTDUMP_NAME " [-full] <device> [i2c-slave] [-v[ersion] [-h[elp]]]\n\n\
+   Usage: " MSTDUMP_NAME " [-full] <device> [i2c-slave] [--binary] [-v[ersion] [-h[elp]]]\n\
+          " MSTDUMP_NAME " --bin2txt <file>\n\n\
    -full              :  Dump more expanded list of addresses\n\
                          Note : be careful when using this flag, None safe addresses might be read.\n\
+   --binary           :  Write the dump to stdout in binary form\n\
+   --bin2txt <file>   :  Print a binary dump in the text form\n\
    -v | --version     :  Display version info\n\
    -h | --help        :  Print this help message\n\
    i2c_slave          :   I2C slave [0-127]\n\
    Example :\n\
             " MSTDUMP_NAME " " DEV_EXAMPLE "\n";
 
-void print_dword(crd_dword_t* dword)
+static const char hex_digits[] = "0123456789abcdef";
+
+static void format_hex(char* p, u_int32_t val)
+{
+    int k;
+
+    p[0] = '0';
+    p[1] = 'x';
+    for (k = 9; k >= 2; k--)
+    {
+        p[k] = hex_digits[val & 0xf];
+        val >>= 4;
+    }
+}
+
+// Same text as printf("0x%8.8x 0x%8.8x\n") for each dword, formatted into one buffer per range
+static int print_block(u_int32_t addr, const u_int32_t* data, u_int32_t num_dwords, void* user_data)
 {
-    printf("0x%8.8x 0x%8.8x\n", dword->addr, dword->data);
+    static char buf[DUMP_LINE_LEN * 1024];
+    u_int32_t i;
+    u_int32_t n = 0;
+    (void)user_data;
+
+    for (i = 0; i < num_dwords; i++)
+    {
+        format_hex(buf + n, addr + i * sizeof(u_int32_t));
+        buf[n + 10] = ' ';
+        format_hex(buf + n + 11, data[i]);
+        buf[n + 21] = '\n';
+        n += DUMP_LINE_LEN;
+        if (n == sizeof(buf))
+        {
+            if (fwrite(buf, 1, n, stdout) != n)
+            {
+                return 1;
+            }
+            n = 0;
+        }
+    }
+    return fwrite(buf, 1, n, stdout) != n;
+}
+
+static int write_block(u_int32_t addr, const u_int32_t* data, u_int32_t num_dwords, void* user_data)
+{
+    crd_bin_range_t range;
+    (void)user_data;
+
+    range.addr = addr;
+    range.num_dwords = num_dwords;
+    if (fwrite(&range, sizeof(range), 1, stdout) != 1)
+    {
+        return 1;
+    }
+    return fwrite(data, sizeof(u_int32_t), num_dwords, stdout) != num_dwords;
+}
+
+static u_int32_t swap_dword(u_int32_t val)
+{
+    return (val >> 24) | ((val >> 8) & 0xff00) | ((val << 8) & 0xff0000) | (val << 24);
+}
+
+static int bin_to_text(const char* path)
+{
+    FILE* fp;
+    crd_bin_header_t header;
+    crd_bin_range_t range;
+    u_int32_t data[1024];
+    u_int32_t chunk;
+    u_int32_t i;
+    int swap;
+    int rc = 0;
+
+    fp = fopen(path, "rb");
+    if (fp == NULL)
+    {
+        fprintf(stderr, "-E- Failed to open %s: %s\n", path, strerror(errno));
+        return 1;
+    }
+    if (fread(&header, sizeof(header), 1, fp) != 1 ||
+        (header.magic != CRD_BIN_MAGIC && header.magic != swap_dword(CRD_BIN_MAGIC)))
+    {
+        fprintf(stderr, "-E- %s is not a binary " MSTDUMP_NAME " file\n", path);
+        fclose(fp);
+        return 1;
+    }
+    swap = header.magic != CRD_BIN_MAGIC;
+    if ((swap ? swap_dword(header.version) : header.version) != CRD_BIN_VERSION)
+    {
+        fprintf(stderr, "-E- Unsupported binary " MSTDUMP_NAME " version in %s\n", path);
+        fclose(fp);
+        return 1;
+    }
+    setvbuf(stdout, NULL, _IOFBF, DUMP_BUF_SIZE);
+    while (!rc && fread(&range, sizeof(range), 1, fp) == 1)
+    {
+        if (swap)
+        {
+            range.addr = swap_dword(range.addr);
+            range.num_dwords = swap_dword(range.num_dwords);
+        }
+        while (range.num_dwords)
+        {
+            chunk = range.num_dwords > 1024 ? 1024 : range.num_dwords;
+            if (fread(data, sizeof(u_int32_t), chunk, fp) != chunk)
+            {
+                fprintf(stderr, "-E- %s is truncated\n", path);
+                rc = 1;
+                break;
+            }
+            for (i = 0; swap && i < chunk; i++)
+            {
+                data[i] = swap_dword(data[i]);
+            }
+            if (print_block(range.addr, data, chunk, NULL))
+            {
+                rc = 1;
+                break;
+            }
+            range.addr += chunk * sizeof(u_int32_t);
+            range.num_dwords -= chunk;
+        }
+    }
+    fclose(fp);
+    if (fflush(stdout))
+    {
+        rc = 1;
+    }
+    return rc;
 }
 
 bool check_device_name(const char* device)
@@ -85,11 +218,32 @@ int main(int argc, char* argv[])
     int rc;
     int full = 0;
     int cause_addr = -1, cause_off = -1;
+    unsigned int cause_batch = 0;
+    int cause_params = 0;
     crd_ctxt_t* context = NULL;
     u_int32_t arr_size = 0;
     char* endptr;
     u_int8_t new_i2c_slave = 0;
     char device[MAX_DEV_LEN] = {0};
+    int binary = 0;
+    crd_bin_header_t header;
+
+    if (argc == 3 && !strcmp(argv[1], BIN2TXT_FLAG))
+    {
+        return bin_to_text(argv[2]);
+    }
+
+    // --binary may come anywhere, drop it so the positional parsing below is unchanged
+    for (i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], BINARY_FLAG))
+        {
+            binary = 1;
+            memmove(&argv[i], &argv[i + 1], (argc - i) * sizeof(char*));
+            argc--;
+            i--;
+        }
+    }
 #if defined(__linux__) || defined(__FreeBSD__)
     if (geteuid() != 0)
     {
@@ -119,7 +273,9 @@ int main(int argc, char* argv[])
         }
         else if (!strncmp(argv[i], CAUSE_FLAG, strlen(CAUSE_FLAG)))
         {
-            if (sscanf(argv[i], CAUSE_FLAG "=%i.%d", &cause_addr, &cause_off) != 2)
+            // --cause=<addr>.<offset>[.<dwords read between cause checks>]
+            cause_params = sscanf(argv[i], CAUSE_FLAG "=%i.%d.%u", &cause_addr, &cause_off, &cause_batch);
+            if (cause_params != 2 && (cause_params != 3 || cause_batch == 0))
             {
                 fprintf(stderr, "Invalid parameters to " CAUSE_FLAG " flag\n");
                 fprintf(stdout, "%s", correct_cmdline);
@@ -193,6 +349,11 @@ int main(int argc, char* argv[])
         goto error;
     }
 
+    if (cause_batch)
+    {
+        crd_set_cause_batch(context, cause_batch);
+    }
+
     // printf("Number of blocks : 0x%d\n",(context)->block_count);
 
     rc = crd_get_dword_num(context, &arr_size);
@@ -203,7 +364,34 @@ int main(int argc, char* argv[])
         goto error;
     }
 
-    rc = crd_dump_data(context, NULL, print_dword);
+    setvbuf(stdout, NULL, _IOFBF, DUMP_BUF_SIZE);
+    if (binary)
+    {
+        memset(&header, 0, sizeof(header));
+        header.magic = CRD_BIN_MAGIC;
+        header.version = CRD_BIN_VERSION;
+        crd_get_dev_type(context, &header.dev_type);
+        rc = fwrite(&header, sizeof(header), 1, stdout) == 1 ? CRD_OK : CRD_CALLBACK_ERR;
+        if (rc == CRD_OK)
+        {
+            rc = crd_dump_data_blocks(context, write_block, NULL);
+        }
+    }
+    else
+    {
+        rc = crd_dump_data_blocks(context, print_block, NULL);
+    }
+    if (fflush(stdout) && rc == CRD_OK)
+    {
+        rc = CRD_CALLBACK_ERR;
+    }
+    if (getenv(ACCESS_STATS_ENV))
+    {
+        crd_access_stats_t stats;
+        crd_get_access_stats(context, &stats);
+        fprintf(stderr, "-I- %u device accesses (%u data reads, %u cause reads) for %u dwords\n",
+                stats.data_reads + stats.cause_reads, stats.data_reads, stats.cause_reads, stats.dwords);
+    }
     if (rc)
     {
         crd_free(context);
@@ -215,6 +403,7 @@ int main(int argc, char* argv[])
     return 0;
 
 error:
-    printf("-E- %s\n", crd_err_str(rc));
+    // Keep the binary stream clean
+    fprintf(binary ? stderr : stdout, "-E- %s\n", crd_err_str(rc));
     return rc;
 }
@@ -0,0 +1,704 @@
+/*
+ * Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <ctype.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include "mtcr_ib_keys.h"
+
+#define KEY_GUID_SIZE 32
+#define IB_KEYS_PATH_SIZE 256
+#define IB_KEYS_NUM_LIDS 0x10000
+#define IB_KEYS_MIN_HASH_SIZE 1024
+
+#define CHECK_NULL(pointer) \
+    if (pointer == NULL)    \
+    {                       \
+        return -1;          \
+    }
+
+/* Identity of a parsed file, the cached index is valid as long as it matches */
+typedef struct ib_keys_file_t
+{
+    int valid;
+    char path[IB_KEYS_PATH_SIZE];
+    dev_t dev;
+    ino_t ino;
+    off_t size;
+    struct timespec mtime; // nanosecond precision, a same-second rewrite must not look unchanged
+} ib_keys_file;
+
+typedef struct ib_keys_guid_entry_t
+{
+    u_int64_t guid; // 0 marks an empty slot
+    u_int64_t key;
+} ib_keys_guid_entry;
+
+typedef struct ib_keys_guid_map_t
+{
+    ib_keys_guid_entry* entries;
+    u_int32_t size; // power of 2
+    u_int32_t count;
+} ib_keys_guid_map;
+
+typedef struct ib_keys_mft_cfg_t
+{
+    ib_keys_file file;
+    int ret_value;
+    char sm_config_path[IB_KEYS_PATH_SIZE];
+} ib_keys_mft_cfg;
+
+static struct
+{
+    ib_keys_mft_cfg mft_cfg[2];
+    ib_keys_file guid2lid;
+    u_int64_t* lid2guid; // IB_KEYS_NUM_LIDS entries, 0 means no guid
+    ib_keys_file guid2key[2];
+    ib_keys_guid_map keys[2];
+    ib_keys_stats stats;
+} ib_keys_cache;
+
+// Devices can be opened from several threads (mtserver serves each connection on its own)
+static pthread_mutex_t ib_keys_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Line scanning parsers, used when the cache is disabled.
+ */
+
+static char* trim(char* string)
+{
+    char* back;
+
+    // Left trim.
+    while (isspace(*string))
+    {
+        string++;
+    }
+
+    int len = strlen(string);
+
+    if (len == 0)
+    {
+        return (string);
+    }
+
+    // Right trim.
+    back = string + len;
+
+    while (isspace(*--back))
+    {
+    }
+
+    *(back + 1) = '\0';
+
+    return string;
+}
+
+static int get_mft_conf_field_value(char* line, const char* field_name, char* value, int size, int* is_empty)
+{
+    char* delimiter = "=";
+    char* tmp_value;
+
+    if (strstr(line, field_name) != NULL)
+    {
+        // Get the value.
+        tmp_value = strtok(line, delimiter);
+        tmp_value = strtok(NULL, delimiter);
+
+        // Remove spaces.
+        tmp_value = tmp_value ? trim(tmp_value) : "";
+
+        if (strlen(tmp_value))
+        {
+            snprintf(value, size, "%s", tmp_value);
+        }
+        else
+        {
+            *is_empty = 1;
+        }
+
+        return 0;
+    }
+
+    return -1;
+}
+
+static int load_file(FILE** file_descriptor, const char* file_name_path)
+{
+    // Open the file.
+    *file_descriptor = fopen(file_name_path, "r");
+
+    if (!(*file_descriptor))
+    {
+        // Failed to open the file.
+        return -1;
+    }
+
+    return 0;
+}
+
+static const char* key_enabled_field_name(key_type key)
+{
+    return key == MKEY ? "mkey_enable" : "vskey_enable";
+}
+
+static const char* guid2key_file_name(key_type key)
+{
+    return key == MKEY ? "guid2mkey" : "guid2vskey";
+}
+
+static int parse_mft_cfg_file(const char* mft_conf_file_path, char* sm_config_path, int size, key_type key)
+{
+    const char* sm_config_default_path = "/var/cache/opensm/";
+    const char* key_enabled_field = key_enabled_field_name(key);
+    int is_key_enabled = 0;
+    int is_empty = 0;
+    int ret_value = -1;
+    char line[1024] = {0};
+    char value[IB_KEYS_PATH_SIZE] = {0};
+    FILE* mft_conf_file_descriptor = NULL;
+
+    // Load the mft configuration file.
+    if (load_file(&mft_conf_file_descriptor, mft_conf_file_path))
+    {
+        // Failed to open the file.
+        return -1;
+    }
+
+    // Go over the content file.
+    while ((fgets(line, 1024, mft_conf_file_descriptor)))
+    {
+        // Check if the mkey feature is enable.
+        if (!get_mft_conf_field_value(line, key_enabled_field, value, sizeof(value), &is_empty))
+        {
+            // key feature is supported ?
+            if (strcmp(value, "yes"))
+            {
+                // Mkey is unsuppurted.
+                break;
+            }
+
+            is_key_enabled = 1;
+        }
+
+        // Check if the user changed the default mkey directory.
+        else if (!get_mft_conf_field_value(line, "sm_config_dir", value, sizeof(value), &is_empty))
+        {
+            if (!is_key_enabled)
+            {
+                // key feature is disabled.
+                break;
+            }
+
+            // Empty value ? Use the default sm path.
+            snprintf(sm_config_path, size, "%s", is_empty ? sm_config_default_path : value);
+
+            // sm_config_path found.
+            ret_value = 0;
+        }
+    }
+
+    // Close the file.
+    fclose(mft_conf_file_descriptor);
+
+    return ret_value;
+}
+
+static void get_lid_integer(char* lid, int* lid_integer)
+{
+    int base = 10;
+
+    // Check if we have '0x' in the beginning of the string.
+    if ((strlen(lid) > 1) && (lid[0] == '0') && ((lid[1] == 'x') || (lid[1] == 'X')))
+    {
+        base = 16;
+    }
+
+    *lid_integer = strtol(lid, NULL, base);
+}
+
+/* Split a "guid lid_low lid_high" line of the guid2lid file */
+static int split_guid2lid_line(char* line, char** guid, int* lid_lower_bound, int* lid_upper_bound)
+{
+    char* delimiter = " ";
+    char* tmp_value;
+
+    *guid = strtok(line, delimiter);
+    CHECK_NULL(*guid)
+
+    tmp_value = strtok(NULL, delimiter);
+    CHECK_NULL(tmp_value)
+
+    get_lid_integer(trim(tmp_value), lid_lower_bound);
+
+    tmp_value = strtok(NULL, delimiter);
+    CHECK_NULL(tmp_value)
+
+    get_lid_integer(trim(tmp_value), lid_upper_bound);
+
+    return 0;
+}
+
+static int parse_lid2guid_file(const char* sm_config_path, int lid, char* guid)
+{
+    FILE* file_descriptor = NULL;
+    char line[1024] = {0};
+    char conf_path[IB_KEYS_PATH_SIZE];
+    char* tmp_guid;
+    int lid_lower_bound;
+    int lid_upper_bound;
+    int ret_value = -1;
+
+    // Parse the guid2lid file.
+    snprintf(conf_path, sizeof(conf_path), "%sguid2lid", sm_config_path);
+
+    if (load_file(&file_descriptor, conf_path))
+    {
+        // Failed to open file.
+        return -1;
+    }
+
+    // Go over the content of the guid2lid file.
+    while ((fgets(line, 1024, file_descriptor)))
+    {
+        if (!split_guid2lid_line(line, &tmp_guid, &lid_lower_bound, &lid_upper_bound) && lid >= lid_lower_bound &&
+            lid <= lid_upper_bound)
+        {
+            snprintf(guid, KEY_GUID_SIZE, "%s", tmp_guid);
+            ret_value = 0;
+            break;
+        }
+    }
+
+    fclose(file_descriptor);
+
+    // No guid found.
+    return ret_value;
+}
+
+static int parse_guid2key_file(const char* sm_config_path, const char* guid, key_type key, u_int64_t* value)
+{
+    char* delimiter = " ";
+    char* tmp_value;
+    FILE* file_descriptor = NULL;
+    char line[1024] = {0};
+    char conf_path[IB_KEYS_PATH_SIZE];
+    int ret_value = -1;
+
+    // Parse the guid2key file.
+    snprintf(conf_path, sizeof(conf_path), "%s%s", sm_config_path, guid2key_file_name(key));
+
+    if (load_file(&file_descriptor, conf_path))
+    {
+        // Failed to open file.
+        return -1;
+    }
+
+    // Go over the content of the guid2key file.
+    while ((fgets(line, 1024, file_descriptor)))
+    {
+        // Get the key.
+        tmp_value = strtok(line, delimiter);
+
+        if (tmp_value && !strcmp(tmp_value, guid))
+        {
+            tmp_value = strtok(NULL, delimiter);
+            if (!tmp_value)
+            {
+                continue;
+            }
+
+            *value = strtoull(tmp_value, NULL, 0);
+            ret_value = 0;
+            break;
+        }
+    }
+
+    fclose(file_descriptor);
+
+    // Failed to get the key.
+    return ret_value;
+}
+
+/*
+ * Cached indexes.
+ */
+
+/* Returns 1 if the file must be (re)parsed, -1 if it can't be accessed */
+static int ib_keys_file_changed(ib_keys_file* file, const char* path)
+{
+    struct stat st;
+
+    if (stat(path, &st))
+    {
+        file->valid = 0;
+        return -1;
+    }
+    if (file->valid && !strcmp(file->path, path) && file->dev == st.st_dev && file->ino == st.st_ino &&
+        file->size == st.st_size && file->mtime.tv_sec == st.st_mtim.tv_sec &&
+        file->mtime.tv_nsec == st.st_mtim.tv_nsec)
+    {
+        return 0;
+    }
+    // Marked valid by the caller once the new content is indexed.
+    file->valid = 0;
+    snprintf(file->path, sizeof(file->path), "%s", path);
+    file->dev = st.st_dev;
+    file->ino = st.st_ino;
+    file->size = st.st_size;
+    file->mtime = st.st_mtim;
+    return 1;
+}
+
+static u_int64_t parse_guid(const char* guid)
+{
+    return strtoull(guid, NULL, 16);
+}
+
+static u_int32_t guid_hash(u_int64_t guid)
+{
+    // FNV-1a over the 8 guid bytes.
+    u_int32_t hash = 2166136261u;
+    int i;
+
+    for (i = 0; i < 8; i++)
+    {
+        hash ^= (u_int8_t)(guid >> (i * 8));
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static ib_keys_guid_entry* guid_map_slot(ib_keys_guid_map* map, u_int64_t guid)
+{
+    u_int32_t i = guid_hash(guid) & (map->size - 1);
+
+    while (map->entries[i].guid && map->entries[i].guid != guid)
+    {
+        i = (i + 1) & (map->size - 1);
+    }
+    return &map->entries[i];
+}
+
+static int guid_map_resize(ib_keys_guid_map* map, u_int32_t size)
+{
+    ib_keys_guid_map new_map;
+    u_int32_t i;
+
+    new_map.entries = (ib_keys_guid_entry*)calloc(size, sizeof(ib_keys_guid_entry));
+    if (!new_map.entries)
+    {
+        return -1;
+    }
+    new_map.size = size;
+    new_map.count = map->count;
+    for (i = 0; i < map->size; i++)
+    {
+        if (map->entries[i].guid)
+        {
+            *guid_map_slot(&new_map, map->entries[i].guid) = map->entries[i];
+        }
+    }
+    free(map->entries);
+    *map = new_map;
+    return 0;
+}
+
+static void guid_map_clear(ib_keys_guid_map* map)
+{
+    free(map->entries);
+    memset(map, 0, sizeof(*map));
+}
+
+/* Keeps the first occurrence of a guid, like the line scan does */
+static int guid_map_insert(ib_keys_guid_map* map, u_int64_t guid, u_int64_t key)
+{
+    ib_keys_guid_entry* entry;
+
+    if ((map->count + 1) * 2 > map->size &&
+        guid_map_resize(map, map->size ? map->size * 2 : IB_KEYS_MIN_HASH_SIZE))
+    {
+        return -1;
+    }
+    entry = guid_map_slot(map, guid);
+    if (!entry->guid)
+    {
+        entry->guid = guid;
+        entry->key = key;
+        map->count++;
+    }
+    return 0;
+}
+
+static int load_guid2lid_index(const char* sm_config_path)
+{
+    FILE* file_descriptor = NULL;
+    char line[1024] = {0};
+    char conf_path[IB_KEYS_PATH_SIZE];
+    char* tmp_guid;
+    int lid_lower_bound;
+    int lid_upper_bound;
+    int lid;
+    u_int64_t guid;
+    int rc;
+
+    snprintf(conf_path, sizeof(conf_path), "%sguid2lid", sm_config_path);
+    rc = ib_keys_file_changed(&ib_keys_cache.guid2lid, conf_path);
+    if (rc <= 0)
+    {
+        return rc;
+    }
+
+    if (!ib_keys_cache.lid2guid)
+    {
+        ib_keys_cache.lid2guid = (u_int64_t*)malloc(IB_KEYS_NUM_LIDS * sizeof(u_int64_t));
+        CHECK_NULL(ib_keys_cache.lid2guid)
+    }
+    memset(ib_keys_cache.lid2guid, 0, IB_KEYS_NUM_LIDS * sizeof(u_int64_t));
+
+    if (load_file(&file_descriptor, conf_path))
+    {
+        return -1;
+    }
+    ib_keys_cache.stats.loads++;
+    while ((fgets(line, 1024, file_descriptor)))
+    {
+        if (split_guid2lid_line(line, &tmp_guid, &lid_lower_bound, &lid_upper_bound))
+        {
+            continue;
+        }
+        guid = parse_guid(tmp_guid);
+        if (lid_lower_bound < 0)
+        {
+            lid_lower_bound = 0;
+        }
+        if (lid_upper_bound >= IB_KEYS_NUM_LIDS)
+        {
+            lid_upper_bound = IB_KEYS_NUM_LIDS - 1;
+        }
+        // An LMC range covers several lids, the first line covering a lid wins.
+        for (lid = lid_lower_bound; lid <= lid_upper_bound; lid++)
+        {
+            if (!ib_keys_cache.lid2guid[lid])
+            {
+                ib_keys_cache.lid2guid[lid] = guid;
+            }
+        }
+    }
+    fclose(file_descriptor);
+
+    ib_keys_cache.guid2lid.valid = 1;
+    return 0;
+}
+
+static int load_guid2key_index(const char* sm_config_path, key_type key)
+{
+    ib_keys_guid_map* map = &ib_keys_cache.keys[key];
+    FILE* file_descriptor = NULL;
+    char line[1024] = {0};
+    char conf_path[IB_KEYS_PATH_SIZE];
+    char* delimiter = " ";
+    char* tmp_guid;
+    char* tmp_value;
+    u_int64_t guid;
+    int rc;
+
+    snprintf(conf_path, sizeof(conf_path), "%s%s", sm_config_path, guid2key_file_name(key));
+    rc = ib_keys_file_changed(&ib_keys_cache.guid2key[key], conf_path);
+    if (rc <= 0)
+    {
+        return rc;
+    }
+
+    guid_map_clear(map);
+    if (load_file(&file_descriptor, conf_path))
+    {
+        return -1;
+    }
+    ib_keys_cache.stats.loads++;
+    while ((fgets(line, 1024, file_descriptor)))
+    {
+        tmp_guid = strtok(line, delimiter);
+        tmp_value = tmp_guid ? strtok(NULL, delimiter) : NULL;
+        if (!tmp_value || !(guid = parse_guid(tmp_guid)))
+        {
+            continue;
+        }
+        if (guid_map_insert(map, guid, strtoull(tmp_value, NULL, 0)))
+        {
+            fclose(file_descriptor);
+            guid_map_clear(map);
+            return -1;
+        }
+    }
+    fclose(file_descriptor);
+
+    ib_keys_cache.guid2key[key].valid = 1;
+    return 0;
+}
+
+static int cached_mft_cfg(const char* mft_conf_path, key_type key, char* sm_config_path, int size)
+{
+    ib_keys_mft_cfg* cfg = &ib_keys_cache.mft_cfg[key];
+    int rc = ib_keys_file_changed(&cfg->file, mft_conf_path);
+
+    if (rc < 0)
+    {
+        return -1;
+    }
+    if (rc)
+    {
+        ib_keys_cache.stats.loads++;
+        cfg->ret_value = parse_mft_cfg_file(mft_conf_path, cfg->sm_config_path, sizeof(cfg->sm_config_path), key);
+        cfg->file.valid = 1;
+    }
+    if (cfg->ret_value)
+    {
+        return cfg->ret_value;
+    }
+    snprintf(sm_config_path, size, "%s", cfg->sm_config_path);
+    return 0;
+}
+
+static int cached_lookup(const char* sm_config_path, int lid, key_type key, u_int64_t* value)
+{
+    ib_keys_guid_map* map = &ib_keys_cache.keys[key];
+    ib_keys_guid_entry* entry;
+    u_int64_t guid;
+
+    if (lid < 0 || lid >= IB_KEYS_NUM_LIDS || load_guid2lid_index(sm_config_path))
+    {
+        return -1;
+    }
+    guid = ib_keys_cache.lid2guid[lid];
+    if (!guid || load_guid2key_index(sm_config_path, key) || !map->count)
+    {
+        return -1;
+    }
+    entry = guid_map_slot(map, guid);
+    if (!entry->guid)
+    {
+        return -1;
+    }
+    *value = entry->key;
+    return 0;
+}
+
+int ib_keys_cache_enabled()
+{
+    const char* env = getenv("MTCR_IB_KEY_CACHE");
+
+    return !(env && !strcmp(env, "0"));
+}
+
+int ib_keys_parse_mft_cfg(const char* mft_conf_path, key_type key, char* sm_config_path, int size, int use_cache)
+{
+    if (!mft_conf_path || !sm_config_path || (key != MKEY && key != VSKEY))
+    {
+        return -1;
+    }
+    if (use_cache)
+    {
+        int rc;
+
+        pthread_mutex_lock(&ib_keys_cache_lock);
+        rc = cached_mft_cfg(mft_conf_path, key, sm_config_path, size);
+        pthread_mutex_unlock(&ib_keys_cache_lock);
+        return rc;
+    }
+    return parse_mft_cfg_file(mft_conf_path, sm_config_path, size, key);
+}
+
+int ib_keys_lookup(const char* sm_config_path, const char* lid, key_type key, u_int64_t* value, int use_cache)
+{
+    char lid_str[KEY_GUID_SIZE];
+    char guid[KEY_GUID_SIZE];
+    int lid_integer;
+
+    if (!sm_config_path || !lid || !value || (key != MKEY && key != VSKEY))
+    {
+        return -1;
+    }
+    pthread_mutex_lock(&ib_keys_cache_lock);
+    ib_keys_cache.stats.lookups++;
+    pthread_mutex_unlock(&ib_keys_cache_lock);
+
+    // Get the lid from device, remove spaces and convert to integer.
+    snprintf(lid_str, sizeof(lid_str), "%s", lid);
+    get_lid_integer(trim(lid_str), &lid_integer);
+
+    if (use_cache)
+    {
+        int rc;
+
+        pthread_mutex_lock(&ib_keys_cache_lock);
+        rc = cached_lookup(sm_config_path, lid_integer, key, value);
+        pthread_mutex_unlock(&ib_keys_cache_lock);
+        return rc;
+    }
+
+    // Parse the lid2guid file, then the guid2key file.
+    if (parse_lid2guid_file(sm_config_path, lid_integer, guid))
+    {
+        return -1;
+    }
+    return parse_guid2key_file(sm_config_path, guid, key, value);
+}
+
+void ib_keys_get_stats(ib_keys_stats* stats)
+{
+    pthread_mutex_lock(&ib_keys_cache_lock);
+    *stats = ib_keys_cache.stats;
+    pthread_mutex_unlock(&ib_keys_cache_lock);
+}
+
+void ib_keys_cache_flush()
+{
+    int key;
+
+    pthread_mutex_lock(&ib_keys_cache_lock);
+    for (key = MKEY; key <= VSKEY; key++)
+    {
+        ib_keys_cache.mft_cfg[key].file.valid = 0;
+        ib_keys_cache.guid2key[key].valid = 0;
+        guid_map_clear(&ib_keys_cache.keys[key]);
+    }
+    ib_keys_cache.guid2lid.valid = 0;
+    free(ib_keys_cache.lid2guid);
+    ib_keys_cache.lid2guid = NULL;
+    pthread_mutex_unlock(&ib_keys_cache_lock);
+}
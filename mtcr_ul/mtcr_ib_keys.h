@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+#ifndef _MTCR_IB_KEYS_H_
+#define _MTCR_IB_KEYS_H_
+
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define IB_KEYS_MFT_CONF_PATH "/etc/mft/mft.conf"
+
+    typedef enum key_type_t
+    {
+        MKEY,
+        VSKEY
+    } key_type;
+
+    typedef struct ib_keys_stats_t
+    {
+        u_int64_t lookups;
+        u_int64_t loads; // times one of the files was (re)parsed into the cache
+    } ib_keys_stats;
+
+    /*
+     * The mft.conf, guid2lid and guid2mkey/guid2vskey files are parsed once per process into an index
+     * (direct LID table, GUID hash) and re-parsed only when their mtime, size or inode change.
+     * Set MTCR_IB_KEY_CACHE=0 to fall back to scanning the files on every lookup.
+     */
+    int ib_keys_cache_enabled();
+
+    /* Get the SM config dir holding the guid2* files from mft_conf_path; fails if the key type is disabled */
+    int ib_keys_parse_mft_cfg(const char* mft_conf_path, key_type key, char* sm_config_path, int size, int use_cache);
+
+    /* Resolve lid -> guid -> key from the files under sm_config_path (which ends with '/') */
+    int ib_keys_lookup(const char* sm_config_path, const char* lid, key_type key, u_int64_t* value, int use_cache);
+
+    void ib_keys_get_stats(ib_keys_stats* stats);
+
+    /* Drop all cached indexes, the next lookup re-parses the files */
+    void ib_keys_cache_flush();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _MTCR_IB_KEYS_H_ */
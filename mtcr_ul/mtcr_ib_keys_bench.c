@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+/*
+ * Cost of resolving the mkey of N lids (one inband device open each) against
+ * generated OpenSM cache files, scanning the files per lookup vs the cached index.
+ *
+ * guid2mkey also holds stale guids of nodes that left the fabric, it grows past the lid space.
+ *
+ * Usage: mtcr_ib_keys_bench [-n nodes] [-s stale_guids] [-l lookups] [-d dir]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <common/tools_bench.h>
+#include "mtcr_ib_keys.h"
+
+#define BENCH_GUID_BASE 0x0002c90300000000ULL
+
+static u_int64_t bench_mkey(int node, int generation)
+{
+    return ((u_int64_t)(node + 1) * 0x9e3779b97f4a7c15ULL) ^ generation;
+}
+
+static int bench_write_files(const char* dir, int nodes, int stale, int generation)
+{
+    char path[512];
+    FILE* f;
+    int i;
+
+    snprintf(path, sizeof(path), "%s/mft.conf", dir);
+    if (!(f = fopen(path, "w")))
+    {
+        return -1;
+    }
+    fprintf(f, "mkey_enable = yes\nsm_config_dir = %s/\n", dir);
+    fclose(f);
+
+    // Lids are assigned with LMC 1, so every port owns a range of two lids.
+    snprintf(path, sizeof(path), "%s/guid2lid", dir);
+    if (!(f = fopen(path, "w")))
+    {
+        return -1;
+    }
+    for (i = 0; i < nodes; i++)
+    {
+        fprintf(f, "0x%016llx %d %d\n", (unsigned long long)(BENCH_GUID_BASE + i), 2 * i + 1, 2 * i + 2);
+    }
+    fclose(f);
+
+    // Written in reverse so guid2lid and guid2mkey orders differ, as they do on a real SM.
+    snprintf(path, sizeof(path), "%s/guid2mkey", dir);
+    if (!(f = fopen(path, "w")))
+    {
+        return -1;
+    }
+    for (i = 0; i < stale; i++)
+    {
+        fprintf(f, "0x%016llx 0x%llx\n", (unsigned long long)(BENCH_GUID_BASE + nodes + i),
+                (unsigned long long)bench_mkey(nodes + i, generation));
+    }
+    for (i = nodes - 1; i >= 0; i--)
+    {
+        fprintf(f, "0x%016llx 0x%llx\n", (unsigned long long)(BENCH_GUID_BASE + i),
+                (unsigned long long)bench_mkey(i, generation));
+    }
+    fclose(f);
+    return 0;
+}
+
+static int bench_run(const char* dir, int nodes, int lookups, int use_cache, int generation)
+{
+    char mft_conf[512];
+    char sm_config_path[256];
+    char lid[32];
+    ib_keys_stats stats;
+    u_int64_t start;
+    u_int64_t usecs;
+    u_int64_t value;
+    int node;
+    int i;
+
+    snprintf(mft_conf, sizeof(mft_conf), "%s/mft.conf", dir);
+    start = bench_now_usecs();
+    for (i = 0; i < lookups; i++)
+    {
+        node = (int)(((u_int64_t)i * 2654435761u) % nodes);
+        snprintf(lid, sizeof(lid), "0x%x", 2 * node + 1 + (i & 1));
+        if (ib_keys_parse_mft_cfg(mft_conf, MKEY, sm_config_path, sizeof(sm_config_path), use_cache) ||
+            ib_keys_lookup(sm_config_path, lid, MKEY, &value, use_cache) || value != bench_mkey(node, generation))
+        {
+            fprintf(stderr, "-E- %s: wrong or missing mkey for lid %s\n", use_cache ? "cached" : "scan", lid);
+            return -1;
+        }
+    }
+    usecs = bench_now_usecs() - start;
+    ib_keys_get_stats(&stats);
+    printf("%-7s %9d  %12.2f  %10.2f  %5llu\n", use_cache ? "cached" : "scan", lookups, (double)usecs / 1000,
+           (double)usecs / lookups, (unsigned long long)stats.loads);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    char template_dir[] = "/tmp/mtcr_ib_keys_XXXXXX";
+    const char* dir = NULL;
+    int nodes = 20000;
+    int stale = 200000;
+    int lookups = 500;
+    int rc = 1;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:s:l:d:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n':
+                nodes = strtol(optarg, NULL, 0);
+                break;
+
+            case 's':
+                stale = strtol(optarg, NULL, 0);
+                break;
+
+            case 'l':
+                lookups = strtol(optarg, NULL, 0);
+                break;
+
+            case 'd':
+                dir = optarg;
+                break;
+
+            default:
+                return bench_usage(argv[0], "[-n nodes] [-s stale_guids] [-l lookups] [-d dir]");
+        }
+    }
+    if (nodes <= 0 || nodes > 0x5fff || stale < 0 || lookups <= 0)
+    {
+        fprintf(stderr, "-E- nodes must be between 1 and %d (two unicast lids each)\n", 0x5fff);
+        return 1;
+    }
+    if (!dir && !(dir = mkdtemp(template_dir)))
+    {
+        perror("mkdtemp");
+        return 1;
+    }
+    if (bench_write_files(dir, nodes, stale, 0))
+    {
+        perror("write");
+        goto out;
+    }
+
+    printf("%d nodes, %d stale guids, %d lookups, files in %s\n", nodes, stale, lookups, dir);
+    printf("mode     lookups      total ms  usec/lookup  loads\n");
+    if (bench_run(dir, nodes, lookups, 0, 0) || bench_run(dir, nodes, lookups, 1, 0))
+    {
+        goto out;
+    }
+
+    // Rewriting the files must be picked up by the cache.
+    sleep(1);
+    if (bench_write_files(dir, nodes, stale, 1) || bench_run(dir, nodes, lookups, 1, 1))
+    {
+        goto out;
+    }
+    rc = 0;
+
+out:
+    if (dir == template_dir)
+    {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/mft.conf", dir);
+        unlink(path);
+        snprintf(path, sizeof(path), "%s/guid2lid", dir);
+        unlink(path);
+        snprintf(path, sizeof(path), "%s/guid2mkey", dir);
+        unlink(path);
+        rmdir(dir);
+    }
+    ib_keys_cache_flush();
+    return rc;
+}
@@ -59,6 +59,8 @@
 #ifdef MST_UL
 #include <errno.h>
 #include "mtcr_int_defs.h"
+#include "mtcr_ib_window.h"
+#include "mtcr_ib_keys.h"
 #endif
 
 #include "mtcr_ib.h"
@@ -188,8 +190,6 @@
 #define I2C_DEVICE_ID 0x56
 #define I2C_MEMORY_ADDR 0
 
-#define KEY_GUID_SIZE 32
-
 #define UNSUPP_DEVS_NUM 15
 #define DEVID_ADDRESS 0xf0014
 
@@ -218,12 +218,6 @@
         memcpy(bytes_dest, &tmp, 4);          \
     } while (0)
 
-#define CHECK_NULL(pointer) \
-    if (pointer == NULL)    \
-    {                       \
-        return -1;          \
-    }
-
 typedef struct ibmad_port*
   IBMAD_CALL_CONV (*f_mad_rpc_open_port)(char* dev_name, int dev_port, int* mgmt_classes, int num_classes);
 typedef void IBMAD_CALL_CONV (*f_mad_rpc_close_port)(struct ibmad_port* srcport);
@@ -282,6 +276,16 @@ typedef int IBMAD_CALL_CONV (
 typedef void* IBMAD_CALL_CONV (
   *f_mad_rpc)(const struct ibmad_port* srcport, ib_rpc_t* rpc, ib_portid_t* dport, void* payload, void* rcvdata);
 
+// Asynchronous MAD access used by the windowed block op (libibmad + libibumad)
+typedef int IBMAD_CALL_CONV (
+  *f_mad_build_pkt)(void* umad, ib_rpc_t* rpc, ib_portid_t* dport, ib_rmpp_hdr_t* rmpp, void* data);
+typedef int IBMAD_CALL_CONV (*f_mad_rpc_portid)(struct ibmad_port* srcport);
+typedef int IBMAD_CALL_CONV (*f_mad_rpc_class_agent)(struct ibmad_port* srcport, int cls);
+typedef int IBMAD_CALL_CONV (*f_umad_send)(int portid, int agentid, void* umad, int length, int timeout_ms, int retries);
+typedef int IBMAD_CALL_CONV (*f_umad_recv)(int portid, void* umad, int* length, int timeout_ms);
+typedef void* IBMAD_CALL_CONV (*f_umad_get_mad)(void* umad);
+typedef int IBMAD_CALL_CONV (*f_umad_status)(void* umad);
+
 struct __ibvsmad_hndl_t
 {
     struct ibmad_port* srcport;
@@ -318,8 +322,18 @@ struct __ibvsmad_hndl_t
     f_smp_mkey_set smp_mkey_set;
     f_mad_send_via mad_send_via;
     f_mad_rpc mad_rpc;
+    f_mad_build_pkt mad_build_pkt;
+    f_mad_rpc_portid mad_rpc_portid;
+    f_mad_rpc_class_agent mad_rpc_class_agent;
+    f_umad_send umad_send;
+    f_umad_recv umad_recv;
+    f_umad_get_mad umad_get_mad;
+    f_umad_status umad_status;
 
     void* ibdebug;
+
+    int window_depth; // MTCR_IB_WINDOW: outstanding VS MADs per block op, 1 keeps the synchronous path
+    mad_window_stats window_stats;
 };
 
 typedef struct __ibvsmad_hndl_t ibvs_mad;
@@ -497,6 +511,48 @@ static uint64_t
 #define MAX_VS_DATA_SIZE (IB_VENDOR_RANGE1_DATA_SIZE - IB_DATA_INDEX)
 #define MAX_IB_VS_DATA_DW_NUM MAX_VS_DATA_SIZE / 4
 
+/*
+ * Fill the ConfigSpaceAccess VS MAD payload (VSkey, mode 2 records, data to write)
+ * and return the attribute modifier and the offset of the data inside each record.
+ */
+static void ibvsmad_craccess_build_vs(ibvs_mad* h,
+                                      u_int32_t memory_address,
+                                      int method,
+                                      u_int8_t num_of_dwords,
+                                      u_int32_t* data,
+                                      u_int8_t* vsmad_data,
+                                      u_int32_t* attribute_mod,
+                                      unsigned int* data_offset)
+{
+    int i;
+    u_int32_t mask = 0;
+    u_int64_t vskey = 0;
+
+    *attribute_mod = 0;
+    *data_offset = 0;
+    if (should_use_mode_2(memory_address, num_of_dwords))
+    {
+        set_mad_data_for_mode_2(memory_address, num_of_dwords, vsmad_data, attribute_mod, &mask, data_offset);
+    }
+    else
+    {
+        *attribute_mod = create_attribute_mode_0(memory_address, num_of_dwords);
+    }
+
+    // Set the VSkey.
+    vskey = __cpu_to_be64(h->vskey);
+    memcpy(vsmad_data, &vskey, 8);
+
+    for (i = 0; i < num_of_dwords; i++)
+    {
+        if (method == IB_MAD_METHOD_SET)
+        {
+            DWORD_TO_BYTES_BE(vsmad_data + IB_DATA_INDEX + *data_offset + (i * 4), data + i);
+            DWORD_TO_BYTES_BE(vsmad_data + IB_DATA_INDEX + CONFIG_ACCESS_MODE_2_BITMASK_OFFSET + (i * 4), &mask);
+        }
+    }
+}
+
 static uint64_t ibvsmad_craccess_rw_vs(ibvs_mad* h,
                                        u_int32_t memory_address,
                                        int method,
@@ -509,8 +565,6 @@ static uint64_t ibvsmad_craccess_rw_vs(ibvs_mad* h,
     int i;
     u_int8_t* p;
     u_int32_t attribute_mod = 0;
-    u_int32_t mask = 0;
-    u_int64_t vskey = 0;
     unsigned int data_offset = 0;
     int use_mode_2 = should_use_mode_2(memory_address, num_of_dwords);
 
@@ -525,14 +579,7 @@ static uint64_t ibvsmad_craccess_rw_vs(ibvs_mad* h,
         return BAD_RET_VAL;
     }
 
-    if (use_mode_2)
-    {
-        set_mad_data_for_mode_2(memory_address, num_of_dwords, vsmad_data, &attribute_mod, &mask, &data_offset);
-    }
-    else
-    {
-        attribute_mod = create_attribute_mode_0(memory_address, num_of_dwords);
-    }
+    ibvsmad_craccess_build_vs(h, memory_address, method, num_of_dwords, data, vsmad_data, &attribute_mod, &data_offset);
 
     call.method = method;
     call.mgmt_class = class;
@@ -557,19 +604,6 @@ static uint64_t ibvsmad_craccess_rw_vs(ibvs_mad* h,
     DEBUG(("Memory Address = 0x%08x\n", memory_address));
     DEBUG(("Number of dwords = %d\n", num_of_dwords));
 
-    // Set the VSkey.
-    vskey = __cpu_to_be64(h->vskey);
-    memcpy(vsmad_data, &vskey, 8);
-
-    for (i = 0; i < num_of_dwords; i++)
-    {
-        if (method == IB_MAD_METHOD_SET)
-        {
-            DWORD_TO_BYTES_BE(vsmad_data + IB_DATA_INDEX + data_offset + (i * 4), data + i);
-            DWORD_TO_BYTES_BE(vsmad_data + IB_DATA_INDEX + CONFIG_ACCESS_MODE_2_BITMASK_OFFSET + (i * 4), &mask);
-        }
-    }
-
     p = h->ib_vendor_call_via(vsmad_data, &h->portid, &call, h->srcport);
     if (!p)
     {
@@ -688,6 +722,15 @@ int process_dynamic_linking(ibvs_mad* ivm, int mad_init)
     MY_DLSYM(ivm, mad_send_via);
     MY_DLSYM(ivm, mad_rpc);
     MY_DLSYM(ivm, ibdebug);
+    // optional - without them MTCR_IB_WINDOW falls back to synchronous MADs
+    MY_DLSYM_IGNORE_FAIL(ivm, mad_build_pkt);
+    MY_DLSYM_IGNORE_FAIL(ivm, mad_rpc_portid);
+    MY_DLSYM_IGNORE_FAIL(ivm, mad_rpc_class_agent);
+    MY_DLSYM_IGNORE_FAIL(ivm, umad_send);
+    MY_DLSYM_IGNORE_FAIL(ivm, umad_recv);
+    MY_DLSYM_IGNORE_FAIL(ivm, umad_get_mad);
+    MY_DLSYM_IGNORE_FAIL(ivm, umad_status);
+    dlerror();
     return 0;
 }
 
@@ -722,6 +765,7 @@ char* my_strdup(const char* name)
 #define MTCR_IB_RETRIES "MTCR_IB_RETRIES"
 #define MTCR_IB_VKEY "MTCR_IB_VKEY"
 #define MTCR_IBMAD_DEBUG "MTCR_IBMAD_DEBUG"
+#define MTCR_IB_WINDOW "MTCR_IB_WINDOW"
 
 int get_env_var(char* env_name, int* env_var)
 {
@@ -749,6 +793,7 @@ int get_env_vars(ibvs_mad* ivm)
     get_env_var(MTCR_IB_TIMEOUT, &(ivm->timeout));
     get_env_var(MTCR_IB_RETRIES, &(ivm->retries_num));
     get_64_env_var(MTCR_IB_VKEY, &((ivm->vskey)));
+    get_env_var(MTCR_IB_WINDOW, &(ivm->window_depth));
     return 0;
 }
 
@@ -803,328 +848,11 @@ int is_vs_crspace_supported(ibvs_mad* h)
     return 0;
 }
 
-typedef enum key_type_t
-{
-    MKEY,
-    VSKEY
-} key_type;
-
-char* trim(char* string)
-{
-    char* back;
-
-    // Left trim.
-    while (isspace(*string))
-    {
-        string++;
-    }
-
-    int len = strlen(string);
-
-    if (len == 0)
-    {
-        return (string);
-    }
-
-    // Right trim.
-    back = string + len;
-
-    while (isspace(*--back))
-    {
-    }
-
-    *(back + 1) = '\0';
-
-    return string;
-}
-
-int get_mft_conf_field_value(char* line, char* field_name, char* value, int* is_empty)
-{
-    char* delimiter = "=";
-    char* tmp_value;
-
-    if (strstr(line, field_name) != NULL)
-    {
-        // Get the value.
-        tmp_value = strtok(line, delimiter);
-        tmp_value = strtok(NULL, delimiter);
-
-        // Remove spaces.
-        tmp_value = trim(tmp_value);
-
-        if (strlen(tmp_value))
-        {
-            memcpy(value, tmp_value, sizeof(strlen(tmp_value)));
-        }
-        else
-        {
-            *is_empty = 1;
-        }
-
-        return 0;
-    }
-
-    return -1;
-}
-
-int load_file(FILE** file_descriptor, const char* file_name_path)
-{
-    // Open the file.
-    *file_descriptor = fopen(file_name_path, "r");
-
-    if (!(*file_descriptor))
-    {
-        // Failed to open the file.
-        return -1;
-    }
-
-    return 0;
-}
-
-int parse_mft_cfg_file(char* sm_config_path, key_type key)
-{
-    const char* sm_config_default_path = "/var/cache/opensm/";
-    const char* mft_conf_file_path = "/etc/mft/mft.conf";
-    int is_key_enabled = 0;
-    int is_empty = 0;
-    int ret_value = -1;
-    char line[1024] = {0};
-    char value[256] = {0};
-    char* key_enabled_field;
-    if (key == MKEY)
-    {
-        key_enabled_field = "mkey_enable";
-    }
-
-    else
-    {
-        key_enabled_field = "vskey_enable";
-    }
-
-    FILE* mft_conf_file_descriptor = NULL;
-
-    // Load the mft configuration file.
-    if (load_file(&mft_conf_file_descriptor, mft_conf_file_path))
-    {
-        // Failed to open the file.
-        return -1;
-    }
-
-    // Go over the content file.
-    while ((fgets(line, 1024, mft_conf_file_descriptor)))
-    {
-        // Check if the mkey feature is enable.
-        if (!get_mft_conf_field_value(line, key_enabled_field, value, &is_empty))
-        {
-            // key feature is supported ?
-            if (strcmp(value, "yes"))
-            {
-                // Mkey is unsuppurted.
-                break;
-            }
-
-            is_key_enabled = 1;
-        }
-
-        // Check if the user changed the default mkey directory.
-        else if (!get_mft_conf_field_value(line, "sm_config_dir", value, &is_empty))
-        {
-            if (!is_key_enabled)
-            {
-                // key feature is disabled.
-                break;
-            }
-
-            // Empty value ?
-            if (is_empty)
-            {
-                // Use the default sm path.
-                memcpy(sm_config_path, sm_config_default_path, strlen(sm_config_default_path));
-            }
-            else
-            {
-                memcpy(sm_config_path, value, strlen(value));
-            }
-
-            // sm_config_path found.
-            ret_value = 0;
-        }
-    }
-
-    // Close the file.
-    fclose(mft_conf_file_descriptor);
-
-    return ret_value;
-}
-
-void get_lid_integer(char* lid, int* lid_integer)
-{
-    int base = 10;
-
-    // Check if we have '0x' in the beginning of the string.
-    if ((strlen(lid) > 1) && (lid[0] == '0') && ((lid[1] == 'x') || (lid[1] == 'X')))
-    {
-        base = 16;
-    }
-
-    *lid_integer = strtol(lid, NULL, base);
-}
-
-int find_guid(char* lid, char* guid, char* line)
-{
-    char* delimiter = " ";
-    char* tmp_value;
-    char* tmp_guid;
-    int ret_value = -1;
-    int lid_lower_bound;
-    int lid_upper_bound;
-    int lid_from_device;
-
-    CHECK_NULL(guid)
-
-    // Get the lid ranges from device,
-    // remove spaces and convert to integer
-    get_lid_integer(trim(lid), &lid_from_device);
-
-    tmp_guid = strtok(line, delimiter);
-    CHECK_NULL(tmp_guid)
-
-    tmp_value = strtok(NULL, delimiter);
-    CHECK_NULL(tmp_value)
-
-    get_lid_integer(trim(tmp_value), &lid_lower_bound);
-
-    tmp_value = strtok(NULL, delimiter);
-    CHECK_NULL(tmp_value)
-
-    get_lid_integer(trim(tmp_value), &lid_upper_bound);
-
-    if (lid_from_device >= lid_lower_bound && lid_from_device <= lid_upper_bound)
-    {
-        strcpy(guid, tmp_guid);
-        ret_value = 0;
-    }
-
-    return ret_value;
-}
-
-int parse_lid2guid_file(char* sm_config_path, char* lid, char* guid)
-{
-    const char* guid2lid = "guid2lid";
-    FILE* file_descriptor = NULL;
-    char line[1024] = {0};
-    char conf_path[256];
-    int ret_value = -1;
-
-    // Parse the guid2lid file.
-    strcpy(conf_path, sm_config_path);
-    strcat(conf_path, guid2lid);
-
-    if (load_file(&file_descriptor, conf_path))
-    {
-        // Failed to open file.
-        return -1;
-    }
-
-    // Go over the content of the guid2lid file.
-    while ((fgets(line, 1024, file_descriptor)))
-    {
-        if (!find_guid(lid, guid, line))
-        {
-            ret_value = 0;
-            break;
-        }
-    }
-
-    fclose(file_descriptor);
-
-    // No guid found.
-    return ret_value;
-}
-
-int parse_guid2key_file(ibvs_mad* ivm, char* sm_config_path, char* guid, key_type key)
-{
-    char* guid2key_filename;
-    char* delimiter = " ";
-    char* tmp_value;
-    FILE* file_descriptor = NULL;
-    char line[1024] = {0};
-    char conf_path[256];
-    int ret_value = -1;
-
-    if (key == MKEY)
-    {
-        guid2key_filename = "guid2mkey";
-    }
-
-    else
-    {
-        guid2key_filename = "guid2vskey";
-    }
-
-    // Parse the guid2lid file.
-    strcpy(conf_path, sm_config_path);
-    strcat(conf_path, guid2key_filename);
-
-    if (load_file(&file_descriptor, conf_path))
-    {
-        // Failed to open file.
-        return -1;
-    }
-
-    // Go over the content of the guid2key file.
-    while ((fgets(line, 1024, file_descriptor)))
-    {
-        // Get the key.
-        tmp_value = strtok(line, delimiter);
-
-        if (!strcmp(tmp_value, guid))
-        {
-            tmp_value = strtok(NULL, delimiter);
-
-            if (key == MKEY)
-            {
-                ivm->mkey = strtoull(tmp_value, NULL, 0);
-            }
-
-            else
-            {
-                ivm->vskey = strtoull(tmp_value, NULL, 0);
-            }
-
-            ret_value = 0;
-            break;
-        }
-    }
-
-    fclose(file_descriptor);
-
-    // Failed to get the mkey.
-    return ret_value;
-}
-
-int extract_key(ibvs_mad* ivm, char* sm_config_path, char* lid, key_type key)
-{
-    char guid[KEY_GUID_SIZE];
-
-    // Parse the lid2guid file.
-    if (parse_lid2guid_file(sm_config_path, lid, guid))
-    {
-        return -1;
-    }
-
-    // Parse the guid2key file.
-    if (parse_guid2key_file(ivm, sm_config_path, guid, key))
-    {
-        return -1;
-    }
-
-    return 0;
-}
-
 int get_key(ibvs_mad* ivm, char* lid, key_type key)
 {
     char sm_config_path[256] = {0};
+    int use_cache = ib_keys_cache_enabled();
+    u_int64_t value = 0;
 
     // Parameters validation.
     if (!ivm || !lid)
@@ -1133,20 +861,29 @@ int get_key(ibvs_mad* ivm, char* lid, key_type key)
     }
 
     // Parse the configuration file in order to extract the key info.
-    if (parse_mft_cfg_file(sm_config_path, key))
+    if (ib_keys_parse_mft_cfg(IB_KEYS_MFT_CONF_PATH, key, sm_config_path, sizeof(sm_config_path), use_cache))
     {
         // Failed to parse the key fields from
         //   the mft configuration file.
         return -1;
     }
 
-    // Extract the key.
-    if (extract_key(ivm, sm_config_path, lid, key))
+    // Extract the key through the guid2lid and guid2key files.
+    if (ib_keys_lookup(sm_config_path, lid, key, &value, use_cache))
     {
         // Failed to extract the key.
         return -1;
     }
 
+    if (key == MKEY)
+    {
+        ivm->mkey = value;
+    }
+    else
+    {
+        ivm->vskey = value;
+    }
+
     return 0;
 }
 
@@ -1416,6 +1153,13 @@ int mib_close(mfile* mf)
         {
             // TODO: free the ddl handlers
             ibvs_mad* h = (ibvs_mad*)(mf->ctx);
+            if (h->window_stats.mads_sent)
+            {
+                DEBUG(("windowed block ops: %llu bytes in %llu usec, %llu MADs, %llu retries, %llu reordered",
+                       (unsigned long long)h->window_stats.bytes, (unsigned long long)h->window_stats.usecs,
+                       (unsigned long long)h->window_stats.mads_sent, (unsigned long long)h->window_stats.retries,
+                       (unsigned long long)h->window_stats.reordered));
+            }
             h->mad_rpc_close_port(h->srcport);
 #ifndef IBVSMAD_DLOPEN
             free_dll_handle(mf);
@@ -1505,6 +1249,160 @@ enum
     BLOCKOP_WRITE
 };
 
+/********************************************************
+**
+*    Windowed ConfigSpaceAccess VS MADs: requests are posted with
+*    umad_send and matched back to their chunk by transaction id.
+*
+*/
+#define IB_WINDOW_UMAD_BUF_SIZE 1024
+
+typedef struct ibvsmad_window_ctx_t
+{
+    ibvs_mad* h;
+    int class;
+    u_int8_t rcv_buf[IB_WINDOW_UMAD_BUF_SIZE];
+} ibvsmad_window_ctx;
+
+static int ibvsmad_window_supported(ibvs_mad* h)
+{
+    return h->window_depth > 1 && !h->use_smp && h->mad_build_pkt && h->mad_rpc_portid && h->mad_rpc_class_agent &&
+           h->umad_send && h->umad_recv && h->umad_get_mad && h->umad_status;
+}
+
+static int ibvsmad_window_send(void* ctx, u_int32_t address, u_int8_t num_of_dwords, int write, u_int32_t* data, u_int32_t* tid)
+{
+    ibvsmad_window_ctx* w = (ibvsmad_window_ctx*)ctx;
+    ibvs_mad* h = w->h;
+    u_int8_t vsmad_data[2 * IB_VENDOR_RANGE1_DATA_SIZE] = {0};
+    u_int8_t snd_buf[IB_WINDOW_UMAD_BUF_SIZE] = {0};
+    static u_int32_t next_tid = 0;
+    u_int32_t attribute_mod = 0;
+    unsigned int data_offset = 0;
+    int method = write ? IB_MAD_METHOD_SET : IB_MAD_METHOD_GET;
+    ib_rpc_v1_t rpc;
+    u_int8_t* mad;
+
+    ibvsmad_craccess_build_vs(h, address, method, num_of_dwords, data, vsmad_data, &attribute_mod, &data_offset);
+
+    memset(&rpc, 0, sizeof(rpc));
+    rpc.mgtclass = w->class | IB_MAD_RPC_VERSION1;
+    rpc.method = method;
+    rpc.attr.id = IB_VS_ATTR_CR_ACCESS;
+    rpc.attr.mod = attribute_mod;
+    rpc.timeout = h->timeout;
+    rpc.datasz = IB_VENDOR_RANGE1_DATA_SIZE;
+    rpc.dataoffs = IB_VENDOR_RANGE1_DATA_OFFS;
+    // Shared by every inband handle of the process, which may send from several threads at once
+    if (!__atomic_load_n(&next_tid, __ATOMIC_RELAXED))
+    {
+        u_int32_t unseeded = 0;
+
+        __atomic_compare_exchange_n(&next_tid, &unseeded, (u_int32_t)time(NULL) << 16, 0, __ATOMIC_RELAXED,
+                                    __ATOMIC_RELAXED);
+    }
+    rpc.trid = __atomic_add_fetch(&next_tid, 1, __ATOMIC_RELAXED);
+
+    h->portid.qp = 1;
+    if (!h->portid.qkey)
+    {
+        h->portid.qkey = IB_DEFAULT_QP1_QKEY;
+    }
+    if (h->mad_build_pkt(snd_buf, (ib_rpc_t*)(void*)&rpc, &h->portid, NULL, vsmad_data) < 0)
+    {
+        return -1;
+    }
+    // the kernel owns the upper half of the TID, responses are matched on the lower one
+    mad = (u_int8_t*)h->umad_get_mad(snd_buf);
+    BYTES_TO_DWORD_BE(tid, mad + 12);
+
+    if (h->umad_send(h->mad_rpc_portid(h->srcport), h->mad_rpc_class_agent(h->srcport, w->class), snd_buf, IB_MAD_SIZE,
+                     h->timeout, 0) < 0)
+    {
+        IBERROR(("umad_send to %s failed", h->portid2str(&h->portid)));
+        return -1;
+    }
+    return 0;
+}
+
+static int ibvsmad_window_recv(void* ctx, int timeout_ms, u_int32_t* tid, int* status)
+{
+    ibvsmad_window_ctx* w = (ibvsmad_window_ctx*)ctx;
+    ibvs_mad* h = w->h;
+    int length = IB_MAD_SIZE;
+    u_int8_t* mad;
+    int rc;
+
+    rc = h->umad_recv(h->mad_rpc_portid(h->srcport), w->rcv_buf, &length, timeout_ms);
+    if (rc < 0)
+    {
+        if (rc == -ETIMEDOUT || rc == -EWOULDBLOCK || rc == -EAGAIN)
+        {
+            return MAD_WINDOW_RECV_TIMEOUT;
+        }
+        return -1;
+    }
+    mad = (u_int8_t*)h->umad_get_mad(w->rcv_buf);
+    BYTES_TO_DWORD_BE(tid, mad + 12);
+    if (h->umad_status(w->rcv_buf))
+    {
+        // our own request handed back by the kernel after its response timeout
+        *status = MAD_WINDOW_STATUS_LOST;
+    }
+    else if (mad[4] || mad[5])
+    {
+        *status = MAD_WINDOW_STATUS_ERROR;
+    }
+    else
+    {
+        *status = MAD_WINDOW_STATUS_OK;
+    }
+    return MAD_WINDOW_RECV_OK;
+}
+
+static void ibvsmad_window_unpack(void* ctx, u_int32_t address, u_int8_t num_of_dwords, u_int32_t* data)
+{
+    ibvsmad_window_ctx* w = (ibvsmad_window_ctx*)ctx;
+    u_int8_t* payload = (u_int8_t*)w->h->umad_get_mad(w->rcv_buf) + IB_VENDOR_RANGE1_DATA_OFFS;
+    unsigned int data_offset = should_use_mode_2(address, num_of_dwords) ? CONFIG_ACCESS_MODE_2_DATA_OFFSET : 0;
+    int i;
+
+    for (i = 0; i < num_of_dwords; i++)
+    {
+        BYTES_TO_DWORD_BE(data + i, payload + IB_DATA_INDEX + data_offset + (i * 4));
+    }
+}
+
+static int mib_block_op_windowed(mfile* mf, unsigned int offset, u_int32_t* data, int length, int op)
+{
+    ibvs_mad* h = (ibvs_mad*)(mf->ctx);
+    ibvsmad_window_ctx w;
+    mad_window_ops ops;
+    mad_window_params params;
+
+    memset(&w, 0, sizeof(w));
+    w.h = h;
+    w.class = h->use_class_a ? IB_VENDOR_SPECIFIC_CLASS_0xA : IB_VENDOR_SPECIFIC_CLASS_0x9;
+    ops.ctx = &w;
+    ops.send = ibvsmad_window_send;
+    ops.recv = ibvsmad_window_recv;
+    ops.unpack = ibvsmad_window_unpack;
+
+    params.depth = h->window_depth;
+    params.retries = h->retries_num;
+    params.timeout_ms = h->timeout;
+    params.chunk_size = MAX_VS_DATA_SIZE;
+    params.high_chunk_size = MODE_2_MAX_DATA_SIZE;
+    params.high_address = MODE_0_MAX_ADDRESS_RANGE;
+
+    if (mad_window_block_op(&ops, &params, offset, data, length, op == BLOCKOP_WRITE, &h->window_stats) != length)
+    {
+        IBERROR(("cr access %s to %s failed", op == BLOCKOP_READ ? "read" : "write", h->portid2str(&h->portid)));
+        return -1;
+    }
+    return length;
+}
+
 int mib_block_op(mfile* mf, unsigned int offset, u_int32_t* data, int length, int op)
 {
     if (!mf || !mf->ctx || !data)
@@ -1519,6 +1417,10 @@ int mib_block_op(mfile* mf, unsigned int offset, u_int32_t* data, int length, in
         method = IB_MAD_METHOD_SET;
     }
     CHECK_ALIGN(length);
+    if (ibvsmad_window_supported(h))
+    {
+        return mib_block_op_windowed(mf, offset, data, length, op);
+    }
     int chunk_size = mib_get_chunk_size(mf);
     // for addresses > 24 bits we use ConfigSpaceAccess mode 2
     // which is limited to 72 bytes.
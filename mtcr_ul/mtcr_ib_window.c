@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <string.h>
+#include <time.h>
+#include "mtcr_ib_window.h"
+
+typedef struct mad_window_slot_t
+{
+    int in_use;
+    int offset; // byte offset inside the block
+    u_int8_t num_of_dwords;
+    u_int32_t tid;
+    int retries;
+    u_int64_t sent_usecs;
+} mad_window_slot;
+
+static u_int64_t mad_window_now_usecs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u_int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int mad_window_chunk_len(const mad_window_params* params, u_int32_t address, int left)
+{
+    int len = left > params->chunk_size ? params->chunk_size : left;
+
+    if (address + len > params->high_address)
+    {
+        len = left > params->high_chunk_size ? params->high_chunk_size : left;
+    }
+    return len;
+}
+
+static int mad_window_post(mad_window_ops* ops,
+                           mad_window_slot* slot,
+                           u_int32_t offset,
+                           u_int32_t* data,
+                           int write,
+                           mad_window_stats* stats)
+{
+    if (ops->send(ops->ctx, offset + slot->offset, slot->num_of_dwords, write, data + slot->offset / 4, &slot->tid))
+    {
+        return -1;
+    }
+    slot->sent_usecs = mad_window_now_usecs();
+    stats->mads_sent++;
+    return 0;
+}
+
+int mad_window_block_op(mad_window_ops* ops,
+                        const mad_window_params* params,
+                        u_int32_t offset,
+                        u_int32_t* data,
+                        int length,
+                        int write,
+                        mad_window_stats* stats)
+{
+    mad_window_slot slots[MAD_WINDOW_MAX_DEPTH];
+    mad_window_stats local_stats;
+    int depth = params->depth;
+    int next = 0;
+    int in_flight = 0;
+    int rc = length;
+    int i;
+    u_int64_t start = mad_window_now_usecs();
+
+    if (!stats)
+    {
+        stats = &local_stats;
+    }
+    if ((length % 4) || (params->chunk_size <= 0) || (params->high_chunk_size <= 0))
+    {
+        return -1;
+    }
+    if (depth < 1)
+    {
+        depth = 1;
+    }
+    if (depth > MAD_WINDOW_MAX_DEPTH)
+    {
+        depth = MAD_WINDOW_MAX_DEPTH;
+    }
+    memset(slots, 0, sizeof(slots));
+
+    while (next < length || in_flight)
+    {
+        u_int32_t tid = 0;
+        int status = MAD_WINDOW_STATUS_OK;
+        int oldest = -1;
+        u_int64_t now;
+
+        // keep the window full
+        for (i = 0; i < depth && next < length; i++)
+        {
+            if (slots[i].in_use)
+            {
+                continue;
+            }
+            slots[i].offset = next;
+            slots[i].num_of_dwords = mad_window_chunk_len(params, offset + next, length - next) / 4;
+            slots[i].retries = 0;
+            if (mad_window_post(ops, &slots[i], offset, data, write, stats))
+            {
+                rc = -1;
+                goto out;
+            }
+            slots[i].in_use = 1;
+            next += slots[i].num_of_dwords * 4;
+            in_flight++;
+        }
+
+        switch (ops->recv(ops->ctx, params->timeout_ms, &tid, &status))
+        {
+            case MAD_WINDOW_RECV_OK:
+                for (i = 0; i < depth; i++)
+                {
+                    if (slots[i].in_use && (oldest < 0 || slots[i].offset < slots[oldest].offset))
+                    {
+                        oldest = i;
+                    }
+                }
+                for (i = 0; i < depth; i++)
+                {
+                    if (slots[i].in_use && slots[i].tid == tid)
+                    {
+                        break;
+                    }
+                }
+                if (i == depth)
+                {
+                    stats->stray++;
+                    break;
+                }
+                if (status == MAD_WINDOW_STATUS_ERROR)
+                {
+                    rc = -1;
+                    goto out;
+                }
+                if (status == MAD_WINDOW_STATUS_LOST)
+                {
+                    // force the resend below
+                    slots[i].sent_usecs = 0;
+                    break;
+                }
+                if (!write)
+                {
+                    ops->unpack(ops->ctx, offset + slots[i].offset, slots[i].num_of_dwords, data + slots[i].offset / 4);
+                }
+                if (i != oldest)
+                {
+                    stats->reordered++;
+                }
+                slots[i].in_use = 0;
+                in_flight--;
+                break;
+
+            case MAD_WINDOW_RECV_TIMEOUT:
+                break;
+
+            default:
+                rc = -1;
+                goto out;
+        }
+
+        // resend whatever was lost or timed out
+        now = mad_window_now_usecs();
+        for (i = 0; i < depth; i++)
+        {
+            if (!slots[i].in_use || now - slots[i].sent_usecs < (u_int64_t)params->timeout_ms * 1000)
+            {
+                continue;
+            }
+            if (slots[i].retries++ >= params->retries)
+            {
+                rc = -1;
+                goto out;
+            }
+            stats->retries++;
+            if (mad_window_post(ops, &slots[i], offset, data, write, stats))
+            {
+                rc = -1;
+                goto out;
+            }
+        }
+    }
+    stats->bytes += length;
+
+out:
+    stats->usecs += mad_window_now_usecs() - start;
+    return rc;
+}
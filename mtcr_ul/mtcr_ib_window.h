@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef _MTCR_IB_WINDOW_H_
+#define _MTCR_IB_WINDOW_H_
+
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define MAD_WINDOW_MAX_DEPTH 64
+
+    /* Return values of mad_window_ops.recv */
+    enum
+    {
+        MAD_WINDOW_RECV_OK = 0,
+        MAD_WINDOW_RECV_TIMEOUT = 1,
+    };
+
+    /* Completion status reported by mad_window_ops.recv for the request with the returned tid */
+    enum
+    {
+        MAD_WINDOW_STATUS_OK = 0,
+        MAD_WINDOW_STATUS_LOST,  // no response from the remote node, the request is retried
+        MAD_WINDOW_STATUS_ERROR, // the remote node answered with a bad MAD status
+    };
+
+    /*
+     * Transport used by the window engine. The engine never looks at MAD contents:
+     * send() builds and posts one ConfigSpaceAccess request, recv() waits for any
+     * completion and identifies it by transaction id, unpack() copies the dwords of
+     * the response returned by the last recv().
+     */
+    typedef struct mad_window_ops_t
+    {
+        void* ctx;
+        int (*send)(void* ctx, u_int32_t address, u_int8_t num_of_dwords, int write, u_int32_t* data, u_int32_t* tid);
+        int (*recv)(void* ctx, int timeout_ms, u_int32_t* tid, int* status);
+        void (*unpack)(void* ctx, u_int32_t address, u_int8_t num_of_dwords, u_int32_t* data);
+    } mad_window_ops;
+
+    typedef struct mad_window_params_t
+    {
+        int depth;                  // max outstanding MADs
+        int retries;                // resends of a single MAD before the block op fails
+        int timeout_ms;             // per MAD response timeout
+        int chunk_size;             // bytes per MAD
+        int high_chunk_size;        // bytes per MAD once the chunk reaches high_address
+        u_int32_t high_address;     // first address that needs high_chunk_size (mode 2)
+    } mad_window_params;
+
+    typedef struct mad_window_stats_t
+    {
+        u_int64_t mads_sent;
+        u_int64_t retries;
+        u_int64_t reordered; // completions that arrived before an older outstanding MAD
+        u_int64_t stray;     // completions that matched no outstanding MAD (late duplicates)
+        u_int64_t bytes;
+        u_int64_t usecs;
+    } mad_window_stats;
+
+    /*
+     * Read or write length bytes starting at offset with up to params->depth MADs in flight.
+     * Return length on success, -1 on failure. stats may be NULL, otherwise it is accumulated.
+     */
+    int mad_window_block_op(mad_window_ops* ops,
+                            const mad_window_params* params,
+                            u_int32_t offset,
+                            u_int32_t* data,
+                            int length,
+                            int write,
+                            mad_window_stats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+/*
+ * Throughput of mad_window_block_op over a loopback stand-in for umad:
+ * requests are answered from an in-memory cr-space after a configurable
+ * round trip time with jitter, so responses may arrive out of order and
+ * every N-th MAD can be dropped to exercise the retry path.
+ *
+ * Usage: mtcr_ib_window_bench [-s bytes] [-r rtt_usec] [-d drop_every] [-w depth]...
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <common/tools_bench.h>
+#include "mtcr_ib_window.h"
+
+#define BENCH_CRSPACE_SIZE (16 * 1024 * 1024)
+#define BENCH_MAX_PENDING 128
+#define BENCH_CHUNK_SIZE 224
+#define BENCH_HIGH_CHUNK_SIZE 72
+#define BENCH_HIGH_ADDRESS 0x7fffff
+#define BENCH_TIMEOUT_MS 20
+
+typedef struct bench_mad_t
+{
+    u_int32_t tid;
+    u_int32_t address;
+    u_int8_t num_of_dwords;
+    u_int64_t due_usecs;
+} bench_mad;
+
+typedef struct bench_loopback_t
+{
+    u_int32_t* crspace;
+    int rtt_usecs;
+    int drop_every;
+    u_int32_t next_tid;
+    u_int64_t sent;
+    bench_mad pending[BENCH_MAX_PENDING];
+    int num_pending;
+    bench_mad last;
+} bench_loopback;
+
+static int bench_send(void* ctx, u_int32_t address, u_int8_t num_of_dwords, int write, u_int32_t* data, u_int32_t* tid)
+{
+    bench_loopback* lb = (bench_loopback*)ctx;
+    bench_mad* mad;
+
+    *tid = ++lb->next_tid;
+    if (lb->drop_every && (++lb->sent % lb->drop_every) == 0)
+    {
+        return 0;
+    }
+    if (lb->num_pending == BENCH_MAX_PENDING)
+    {
+        return -1;
+    }
+    if (write)
+    {
+        memcpy(lb->crspace + address / 4, data, num_of_dwords * 4);
+    }
+    mad = &lb->pending[lb->num_pending++];
+    mad->tid = *tid;
+    mad->address = address;
+    mad->num_of_dwords = num_of_dwords;
+    mad->due_usecs = bench_now_usecs() + lb->rtt_usecs + (lb->rtt_usecs ? rand() % (lb->rtt_usecs / 2 + 1) : 0);
+    return 0;
+}
+
+static int bench_recv(void* ctx, int timeout_ms, u_int32_t* tid, int* status)
+{
+    bench_loopback* lb = (bench_loopback*)ctx;
+    u_int64_t now = bench_now_usecs();
+    int first = -1;
+    int i;
+
+    for (i = 0; i < lb->num_pending; i++)
+    {
+        if (first < 0 || lb->pending[i].due_usecs < lb->pending[first].due_usecs)
+        {
+            first = i;
+        }
+    }
+    if (first < 0 || lb->pending[first].due_usecs > now + (u_int64_t)timeout_ms * 1000)
+    {
+        usleep(timeout_ms * 1000);
+        return MAD_WINDOW_RECV_TIMEOUT;
+    }
+    if (lb->pending[first].due_usecs > now)
+    {
+        usleep(lb->pending[first].due_usecs - now);
+    }
+    lb->last = lb->pending[first];
+    lb->pending[first] = lb->pending[--lb->num_pending];
+    *tid = lb->last.tid;
+    *status = MAD_WINDOW_STATUS_OK;
+    return MAD_WINDOW_RECV_OK;
+}
+
+static void bench_unpack(void* ctx, u_int32_t address, u_int8_t num_of_dwords, u_int32_t* data)
+{
+    bench_loopback* lb = (bench_loopback*)ctx;
+
+    memcpy(data, lb->crspace + address / 4, num_of_dwords * 4);
+}
+
+static int bench_run(bench_loopback* lb, int depth, u_int32_t offset, int size)
+{
+    mad_window_ops ops = {lb, bench_send, bench_recv, bench_unpack};
+    mad_window_params params = {depth, 3, BENCH_TIMEOUT_MS, BENCH_CHUNK_SIZE, BENCH_HIGH_CHUNK_SIZE, BENCH_HIGH_ADDRESS};
+    mad_window_stats stats;
+    u_int32_t* data = (u_int32_t*)malloc(size);
+
+    if (!data)
+    {
+        return -1;
+    }
+    memset(&stats, 0, sizeof(stats));
+    lb->num_pending = 0;
+    if (mad_window_block_op(&ops, &params, offset, data, size, 0, &stats) != size ||
+        memcmp(data, lb->crspace + offset / 4, size))
+    {
+        fprintf(stderr, "-E- depth %d: block read failed or returned wrong data\n", depth);
+        free(data);
+        return -1;
+    }
+    printf("%5d  %10.2f  %8llu  %7llu  %9llu\n", depth, stats.usecs ? (double)stats.bytes / stats.usecs : 0.0,
+           (unsigned long long)stats.mads_sent, (unsigned long long)stats.retries,
+           (unsigned long long)stats.reordered);
+    free(data);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    bench_loopback lb;
+    int depths[MAD_WINDOW_MAX_DEPTH];
+    int num_depths = 0;
+    int size = 256 * 1024;
+    int opt;
+    int i;
+
+    memset(&lb, 0, sizeof(lb));
+    lb.rtt_usecs = 200;
+    while ((opt = getopt(argc, argv, "s:r:d:w:")) != -1)
+    {
+        switch (opt)
+        {
+            case 's':
+                size = strtol(optarg, NULL, 0) & ~3;
+                break;
+
+            case 'r':
+                lb.rtt_usecs = strtol(optarg, NULL, 0);
+                break;
+
+            case 'd':
+                lb.drop_every = strtol(optarg, NULL, 0);
+                break;
+
+            case 'w':
+                if (num_depths < MAD_WINDOW_MAX_DEPTH)
+                {
+                    depths[num_depths++] = strtol(optarg, NULL, 0);
+                }
+                break;
+
+            default:
+                return bench_usage(argv[0], "[-s bytes] [-r rtt_usec] [-d drop_every] [-w depth]...");
+        }
+    }
+    if (!num_depths)
+    {
+        depths[num_depths++] = 1;
+        depths[num_depths++] = 4;
+        depths[num_depths++] = 16;
+        depths[num_depths++] = 32;
+    }
+    if (size <= 0 || size > BENCH_CRSPACE_SIZE / 2)
+    {
+        fprintf(stderr, "-E- size must be between 4 and %d bytes\n", BENCH_CRSPACE_SIZE / 2);
+        return 1;
+    }
+
+    lb.crspace = (u_int32_t*)malloc(BENCH_CRSPACE_SIZE);
+    if (!lb.crspace)
+    {
+        return 1;
+    }
+    for (i = 0; i < BENCH_CRSPACE_SIZE / 4; i++)
+    {
+        lb.crspace[i] = i * 0x9e3779b9;
+    }
+
+    printf("size %d bytes, rtt %d usec, drop every %d MADs\n", size, lb.rtt_usecs, lb.drop_every);
+    printf("mode 0 (24 bit addresses):\n");
+    printf("depth  bytes/usec      MADs  retries  reordered\n");
+    for (i = 0; i < num_depths; i++)
+    {
+        if (bench_run(&lb, depths[i], 0, size))
+        {
+            return 1;
+        }
+    }
+    printf("mode 2 (above 24 bit addresses):\n");
+    printf("depth  bytes/usec      MADs  retries  reordered\n");
+    for (i = 0; i < num_depths; i++)
+    {
+        if (bench_run(&lb, depths[i], BENCH_CRSPACE_SIZE / 2, size))
+        {
+            return 1;
+        }
+    }
+    free(lb.crspace);
+    return 0;
+}
@@ -107,6 +107,26 @@ extern "C"
      **/
     int icmd_take_semaphore(mfile* mf);
 
+    /**
+     * Open an ICMD session: the semaphore is taken once and held by every
+     * command sent until <tt>icmd_session_close</tt>. Inside a session the
+     * busy-bit polling interval is learned from previous completions
+     * instead of restarting the exponential backoff for each command.
+     * Devices that lock the semaphore via a leased VS MAD keep taking it
+     * per command.
+     * @param[in] mf    Open mfile to the desired device.
+     * @return          zero value on success, non zero value on failure.
+     **/
+    int icmd_session_open(mfile* mf);
+
+    /**
+     * Close a session opened by <tt>icmd_session_open</tt> and release the
+     * semaphore. Statistics of the session are printed under MFT_DEBUG.
+     * @param[in] mf    Open mfile to the desired device.
+     * @return          zero value on success, non zero value on failure.
+     **/
+    int icmd_session_close(mfile* mf);
+
 #ifdef __cplusplus
 }
 #endif
@@ -43,6 +43,24 @@ typedef int (*f_mwrite4_block)(mfile* mf, unsigned int offset, u_int32_t* data,
 typedef int (*f_maccess_reg)(mfile* mf, u_int8_t* data);
 typedef int (*f_mclose)(mfile* mf);
 
+/* Register access transports, as tried by maccess_reg_ul */
+typedef enum
+{
+    REG_TRANSPORT_NONE = 0,
+    REG_TRANSPORT_SMP,
+    REG_TRANSPORT_CLS_A,
+    REG_TRANSPORT_GMP,
+} reg_transport_t;
+
+/* Register size classes, bounded by the SMP and class 0xA payload sizes */
+enum
+{
+    REG_SIZE_CLASS_SMP = 0,
+    REG_SIZE_CLASS_CLS_A,
+    REG_SIZE_CLASS_LARGE,
+    REG_SIZE_CLASS_NUM
+};
+
 typedef struct ul_ctx
 {
     int fdlock;
@@ -66,5 +84,16 @@ typedef struct ul_ctx
     f_mwrite4_block res_mwrite4_block;
     /*************************************************************/
     int via_driver;
+    /******** VSEC BLOCK TRANSPORT ********/
+    int vsec_legacy_block;        /* Per-dword VSEC block path (MTCR_VSEC_LEGACY_BLOCK=1) */
+    u_int64_t vsec_block_dwords;  /* Dwords moved through the VSEC block path */
+    u_int64_t vsec_block_usecs;   /* Time spent in the VSEC block path */
+    /******** REGISTER ACCESS TRANSPORT CACHE ********/
+    /* First transport that succeeded per size class and access method */
+    reg_transport_t reg_transport[REG_SIZE_CLASS_NUM][MACCESS_LAST_REG_METHOD];
+    int icmd_probe;        /* supports_icmd() result: 0 - unknown, 1 - yes, -1 - no */
+    int tools_cmdif_probe; /* supports_tools_cmdif_reg() result, same encoding */
+    u_int64_t reg_transport_hits;
+    u_int64_t reg_transport_misses;
 } ul_ctx_t;
 #endif
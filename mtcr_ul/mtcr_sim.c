@@ -0,0 +1,701 @@
+/*
+ * Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+/*
+ *
+ *  mtcr_sim.c - simulated PCI device behind libmtcr_ul
+ *
+ *  Only the SIMULATOR build of libmtcr_ul (libmtcr_ul_sim.la) links this file. Its configuration space has
+ *  a power management capability and, depending on the model, the vendor specific capability (VSEC) or the
+ *  old address/data gateway at 0x58/0x5c. Both gateways complete at once and reach the same cr-space.
+ *  Behind the VSEC there are also the ICMD and semaphore spaces: an ICMD completes after the command time
+ *  set with mtcr_sim_set_icmd_time() and leaves the mailbox as written, with a good status.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <compatibility.h>
+#include "tools_dev_types.h"
+#include "mtcr_sim.h"
+
+#define SIM_HW_DEV_ID_ADDR 0xf0014
+#define SIM_FLASH_SEMAPHORE 0xf03fc /* ConnectX-3 flash semaphore */
+
+/* Flash gateway: the 6th gen one moves the address register and gives the data size in bytes */
+#define SIM_GW_CMD 0xf0400
+#define SIM_GW_ADDR 0xf0404
+#define SIM_NEW_GW_ADDR 0xf0420
+#define SIM_GW_DATA 0xf0410
+#define SIM_GW_DATA_DWORDS 4
+#define SIM_GW_READ_OP (1 << 0)
+#define SIM_GW_CMD_PHASE (1 << 2)
+#define SIM_GW_ADDR_PHASE (1 << 3)
+#define SIM_GW_DATA_PHASE (1 << 4)
+#define SIM_GW_BUSY (1 << 30)
+#define SIM_GW_LOCK (1U << 31)
+#define SIM_GW_DATA_SIZE(cmd) (((cmd) >> 8) & 0x7)
+#define SIM_NEW_GW_DATA_SIZE(cmd) (((cmd) >> 8) & 0x1f)
+#define SIM_GW_OPCODE(cmd) (((cmd) >> 16) & 0xff)
+
+/* Configuration space */
+#define SIM_CFG_SIZE 0x100
+#define SIM_CFG_STATUS_CAP_LIST 0x00100000
+#define SIM_CFG_CAP_PTR 0x34
+#define SIM_CFG_PM_CAP 0x40
+#define SIM_CFG_OLD_GW_ADDR 0x58
+#define SIM_CFG_OLD_GW_DATA 0x5c
+#define SIM_CFG_VSEC 0x60
+
+/* VSEC registers, relative to the capability */
+#define SIM_VSEC_CTRL 0x4
+#define SIM_VSEC_COUNTER 0x8
+#define SIM_VSEC_SEMAPHORE 0xc
+#define SIM_VSEC_ADDR 0x10
+#define SIM_VSEC_DATA 0x14
+#define SIM_VSEC_SPACE(ctrl) ((ctrl) & 0xffff)
+#define SIM_VSEC_STATUS (1U << 29)
+#define SIM_VSEC_FLAG (1U << 31)
+#define SIM_VSEC_ADDR_MASK 0x3fffffff
+
+enum
+{
+    SIM_AS_ICMD_EXT = 0x1,
+    SIM_AS_CR_SPACE = 0x2,
+    SIM_AS_ICMD = 0x3,
+    SIM_AS_SEMAPHORE = 0xa,
+};
+
+/* ICMD space: control register (busy, status, opcode), mailbox size and mailbox */
+#define SIM_ICMD_CTRL 0x0
+#define SIM_ICMD_BUSY (1 << 0)
+#define SIM_ICMD_STATUS_MASK 0xff00
+#define SIM_ICMD_MB_SIZE_ADDR 0x1000
+#define SIM_ICMD_MB_ADDR 0x100000
+#define SIM_ICMD_MB_SIZE 0x340
+#define SIM_ICMD_SEMAPHORE 0x0 /* semaphore space */
+
+/* Winbond W25Q128: vendor, type and density as read by RDID */
+#define SIM_FLASH_JEDEC 0xef401800
+
+enum
+{
+    SIM_SFC_PP = 0x02,
+    SIM_SFC_READ = 0x03,
+    SIM_SFC_FAST_READ = 0x0b,
+    SIM_SFC_4PP = 0x12,
+    SIM_SFC_4READ = 0x13,
+    SIM_SFC_4FAST_READ = 0x0c,
+    SIM_SFC_SSE = 0x20,
+    SIM_SFC_4SSE = 0x21,
+    SIM_SFC_SE = 0xd8,
+    SIM_SFC_4SE = 0xdc,
+    SIM_SFC_JEDEC = 0x9f,
+};
+
+typedef struct sim_model
+{
+    u_int16_t hw_dev_id;
+    u_int8_t vsec;   /* VSEC in the configuration space, else the old gateway */
+    u_int8_t new_gw; /* 6th gen flash gateway */
+} sim_model_t;
+
+static const sim_model_t sim_models[] = {
+  {DeviceConnectX3_HwId, 0, 0},  {DeviceConnectX3Pro_HwId, 0, 0}, {DeviceConnectX7_HwId, 1, 1},
+  {DeviceBlueField3_HwId, 1, 1}, {DeviceQuantum2_HwId, 1, 1},     {DeviceSpectrum4_HwId, 1, 1},
+};
+
+/* Anything else has the VSEC and the old flash gateway, like ConnectX-4 to ConnectX-6 */
+static const sim_model_t sim_default_model = {0, 1, 0};
+
+static u_int32_t* sim_crspace; /* big endian, like a cr-space dump */
+static int sim_map_fd = -1;
+static u_int8_t* sim_flash;
+static u_int32_t sim_cfg[SIM_CFG_SIZE / 4];
+static const sim_model_t* sim_model;
+static u_int32_t sim_flash_ptr;
+static u_int32_t sim_flash_opcode;
+static u_int32_t sim_latency_ns;
+static u_int32_t sim_icmd_ctrl;
+static u_int32_t sim_icmd_mb[SIM_ICMD_MB_SIZE / 4];
+static u_int32_t sim_icmd_semaphore;
+static u_int32_t sim_icmd_ns;
+static u_int64_t sim_icmd_done_ns;
+static mtcr_sim_stats_t sim_stats;
+
+static int sim_alloc_flash(void)
+{
+    if (sim_flash)
+    {
+        return 0;
+    }
+    sim_flash = (u_int8_t*)malloc(MTCR_SIM_FLASH_SIZE);
+    if (!sim_flash)
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+    memset(sim_flash, 0xff, MTCR_SIM_FLASH_SIZE);
+    return 0;
+}
+
+static int sim_init(void)
+{
+    void* map;
+
+    if (sim_crspace)
+    {
+        return 0;
+    }
+    // Pages are only backed once touched
+    map = mmap(NULL, MTCR_SIM_CRSPACE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1,
+               0);
+    if (map == MAP_FAILED)
+    {
+        return -1;
+    }
+    sim_crspace = (u_int32_t*)map;
+    return sim_alloc_flash();
+}
+
+static u_int64_t sim_now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (u_int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+static void sim_delay(void)
+{
+    u_int64_t start;
+
+    if (!sim_latency_ns)
+    {
+        return;
+    }
+    // Spin, a sleep would add the scheduler's latency on top
+    start = sim_now_ns();
+    while (sim_now_ns() - start < sim_latency_ns)
+    {
+    }
+}
+
+static u_int32_t sim_cr_get(u_int32_t addr)
+{
+    return __be32_to_cpu(sim_crspace[addr / 4]);
+}
+
+static void sim_cr_set(u_int32_t addr, u_int32_t value)
+{
+    sim_crspace[addr / 4] = __cpu_to_be32(value);
+}
+
+/* Flash bytes travel through the gateway data dwords in big endian order */
+static void sim_gw_exec(u_int32_t cmd)
+{
+    u_int32_t data[SIM_GW_DATA_DWORDS];
+    u_int32_t len;
+    u_int32_t sector;
+    u_int32_t i;
+
+    sim_stats.gw_commands++;
+    if (cmd & SIM_GW_CMD_PHASE)
+    {
+        sim_flash_opcode = SIM_GW_OPCODE(cmd);
+    }
+    if (cmd & SIM_GW_ADDR_PHASE)
+    {
+        sim_flash_ptr = sim_cr_get(sim_model->new_gw ? SIM_NEW_GW_ADDR : SIM_GW_ADDR) % MTCR_SIM_FLASH_SIZE;
+    }
+    len = sim_model->new_gw ? SIM_NEW_GW_DATA_SIZE(cmd) : 1U << SIM_GW_DATA_SIZE(cmd);
+    len = len > SIM_GW_DATA_DWORDS * 4 ? SIM_GW_DATA_DWORDS * 4 : len;
+    for (i = 0; i < SIM_GW_DATA_DWORDS; i++)
+    {
+        data[i] = (cmd & SIM_GW_READ_OP) ? 0 : sim_cr_get(SIM_GW_DATA + i * 4);
+    }
+
+    switch (sim_flash_opcode)
+    {
+        case SIM_SFC_JEDEC:
+            data[0] = SIM_FLASH_JEDEC;
+            break;
+
+        case SIM_SFC_READ:
+        case SIM_SFC_FAST_READ:
+        case SIM_SFC_4READ:
+        case SIM_SFC_4FAST_READ:
+            if ((cmd & SIM_GW_DATA_PHASE) && (cmd & SIM_GW_READ_OP))
+            {
+                for (i = 0; i < len; i++, sim_flash_ptr = (sim_flash_ptr + 1) % MTCR_SIM_FLASH_SIZE)
+                {
+                    data[i / 4] |= (u_int32_t)sim_flash[sim_flash_ptr] << (24 - 8 * (i % 4));
+                }
+            }
+            break;
+
+        case SIM_SFC_PP:
+        case SIM_SFC_4PP:
+            if ((cmd & SIM_GW_DATA_PHASE) && !(cmd & SIM_GW_READ_OP))
+            {
+                // Programming can only clear bits
+                for (i = 0; i < len; i++, sim_flash_ptr = (sim_flash_ptr + 1) % MTCR_SIM_FLASH_SIZE)
+                {
+                    sim_flash[sim_flash_ptr] &= (u_int8_t)(data[i / 4] >> (24 - 8 * (i % 4)));
+                }
+            }
+            break;
+
+        case SIM_SFC_SSE:
+        case SIM_SFC_4SSE:
+        case SIM_SFC_SE:
+        case SIM_SFC_4SE:
+            sector = (sim_flash_opcode == SIM_SFC_SE || sim_flash_opcode == SIM_SFC_4SE) ? 0x10000 : 0x1000;
+            memset(sim_flash + (sim_flash_ptr & ~(sector - 1)), 0xff, sector);
+            break;
+
+        default:
+            // Status and configuration registers read as 0: never busy, nothing protected
+            break;
+    }
+    if (cmd & SIM_GW_READ_OP)
+    {
+        for (i = 0; i < SIM_GW_DATA_DWORDS; i++)
+        {
+            sim_cr_set(SIM_GW_DATA + i * 4, data[i]);
+        }
+    }
+}
+
+/* Reading a free semaphore takes it, writing 0 frees it */
+static u_int32_t sim_cr_read(u_int32_t addr)
+{
+    u_int32_t value;
+
+    if (addr >= MTCR_SIM_CRSPACE_SIZE)
+    {
+        return 0;
+    }
+    addr &= ~3;
+    value = sim_cr_get(addr);
+    if (addr == SIM_FLASH_SEMAPHORE && !value)
+    {
+        sim_cr_set(addr, 1);
+    }
+    else if (addr == SIM_GW_CMD)
+    {
+        sim_cr_set(addr, value | SIM_GW_LOCK);
+    }
+    return value;
+}
+
+static void sim_cr_write(u_int32_t addr, u_int32_t value)
+{
+    if (addr >= MTCR_SIM_CRSPACE_SIZE || (addr & ~3) == SIM_HW_DEV_ID_ADDR)
+    {
+        return; /* HW ID is read only */
+    }
+    addr &= ~3;
+    if (addr == SIM_GW_CMD && (value & SIM_GW_BUSY))
+    {
+        sim_gw_exec(value);
+        value &= ~SIM_GW_BUSY;
+    }
+    sim_cr_set(addr, value);
+}
+
+/* The busy bit stays up until the command time has passed since the go bit was set */
+static u_int32_t sim_icmd_read(u_int32_t addr)
+{
+    addr &= ~3;
+    if (addr == SIM_ICMD_CTRL)
+    {
+        if ((sim_icmd_ctrl & SIM_ICMD_BUSY) && sim_now_ns() >= sim_icmd_done_ns)
+        {
+            sim_icmd_ctrl &= ~(SIM_ICMD_BUSY | SIM_ICMD_STATUS_MASK);
+            sim_stats.icmd_commands++;
+        }
+        return sim_icmd_ctrl;
+    }
+    if (addr == SIM_ICMD_MB_SIZE_ADDR)
+    {
+        return SIM_ICMD_MB_SIZE;
+    }
+    if (addr >= SIM_ICMD_MB_ADDR && addr < SIM_ICMD_MB_ADDR + SIM_ICMD_MB_SIZE)
+    {
+        return sim_icmd_mb[(addr - SIM_ICMD_MB_ADDR) / 4];
+    }
+    return 0;
+}
+
+static void sim_icmd_write(u_int32_t addr, u_int32_t value)
+{
+    addr &= ~3;
+    if (addr == SIM_ICMD_CTRL)
+    {
+        if ((value & SIM_ICMD_BUSY) && !(sim_icmd_ctrl & SIM_ICMD_BUSY))
+        {
+            sim_icmd_done_ns = sim_now_ns() + sim_icmd_ns;
+        }
+        sim_icmd_ctrl = value;
+    }
+    else if (addr >= SIM_ICMD_MB_ADDR && addr < SIM_ICMD_MB_ADDR + SIM_ICMD_MB_SIZE)
+    {
+        sim_icmd_mb[(addr - SIM_ICMD_MB_ADDR) / 4] = value;
+    }
+}
+
+/* The ICMD semaphore is taken by the first key written, freed by 0, and reads back its owner's key */
+static u_int32_t sim_semaphore_read(u_int32_t addr)
+{
+    return (addr & ~3) == SIM_ICMD_SEMAPHORE ? sim_icmd_semaphore : 0;
+}
+
+static void sim_semaphore_write(u_int32_t addr, u_int32_t value)
+{
+    if ((addr & ~3) == SIM_ICMD_SEMAPHORE && (!value || !sim_icmd_semaphore))
+    {
+        sim_icmd_semaphore = value;
+    }
+}
+
+static void sim_select_model(void)
+{
+    u_int16_t hw_dev_id = (u_int16_t)sim_cr_get(SIM_HW_DEV_ID_ADDR);
+    const sim_model_t* model = &sim_default_model;
+    u_int32_t i;
+
+    for (i = 0; i < sizeof(sim_models) / sizeof(sim_models[0]); i++)
+    {
+        if (sim_models[i].hw_dev_id == hw_dev_id)
+        {
+            model = &sim_models[i];
+        }
+    }
+    if (model == sim_model)
+    {
+        return;
+    }
+    sim_model = model;
+    memset(sim_cfg, 0, sizeof(sim_cfg));
+    sim_cfg[0] = 0x15b3; /* Mellanox vendor ID */
+    sim_cfg[1] = SIM_CFG_STATUS_CAP_LIST;
+    sim_cfg[SIM_CFG_CAP_PTR / 4] = SIM_CFG_PM_CAP;
+    sim_cfg[SIM_CFG_PM_CAP / 4] = 0x01 | (sim_model->vsec ? SIM_CFG_VSEC << 8 : 0);
+    if (sim_model->vsec)
+    {
+        sim_cfg[SIM_CFG_VSEC / 4] = 0x09;
+    }
+}
+
+/* A VSEC address write runs the access and flips the flag: set when read data is ready, cleared once written */
+static void sim_vsec_access(u_int32_t value)
+{
+    u_int32_t addr = value & SIM_VSEC_ADDR_MASK;
+    u_int32_t* data = &sim_cfg[(SIM_CFG_VSEC + SIM_VSEC_DATA) / 4];
+    u_int16_t space = SIM_VSEC_SPACE(sim_cfg[(SIM_CFG_VSEC + SIM_VSEC_CTRL) / 4]);
+
+    if (value & SIM_VSEC_FLAG)
+    {
+        if (space == SIM_AS_CR_SPACE)
+        {
+            sim_cr_write(addr, *data);
+        }
+        else if (space == SIM_AS_ICMD)
+        {
+            sim_icmd_write(addr, *data);
+        }
+        else if (space == SIM_AS_SEMAPHORE)
+        {
+            sim_semaphore_write(addr, *data);
+        }
+        sim_cfg[(SIM_CFG_VSEC + SIM_VSEC_ADDR) / 4] = addr;
+    }
+    else
+    {
+        // The extended ICMD space reads as 0
+        switch (space)
+        {
+            case SIM_AS_CR_SPACE:
+                *data = sim_cr_read(addr);
+                break;
+
+            case SIM_AS_ICMD:
+                *data = sim_icmd_read(addr);
+                break;
+
+            case SIM_AS_SEMAPHORE:
+                *data = sim_semaphore_read(addr);
+                break;
+
+            default:
+                *data = 0;
+                break;
+        }
+        sim_cfg[(SIM_CFG_VSEC + SIM_VSEC_ADDR) / 4] = addr | SIM_VSEC_FLAG;
+    }
+}
+
+static u_int32_t sim_cfg_read4(u_int32_t offset)
+{
+    u_int32_t* reg = &sim_cfg[offset / 4];
+
+    if (sim_model->vsec && offset == SIM_CFG_VSEC + SIM_VSEC_COUNTER)
+    {
+        // A new ticket per read, never 0 which means free
+        *reg = *reg + 1 ? *reg + 1 : 1;
+    }
+    else if (!sim_model->vsec && offset == SIM_CFG_OLD_GW_DATA)
+    {
+        return sim_cr_read(sim_cfg[SIM_CFG_OLD_GW_ADDR / 4]);
+    }
+    return *reg;
+}
+
+static void sim_cfg_write4(u_int32_t offset, u_int32_t value)
+{
+    u_int32_t* reg = &sim_cfg[offset / 4];
+    u_int16_t space;
+
+    if (!sim_model->vsec)
+    {
+        if (offset == SIM_CFG_OLD_GW_ADDR)
+        {
+            *reg = value;
+        }
+        else if (offset == SIM_CFG_OLD_GW_DATA)
+        {
+            sim_cr_write(sim_cfg[SIM_CFG_OLD_GW_ADDR / 4], value);
+        }
+        return;
+    }
+    switch (offset)
+    {
+        case SIM_CFG_VSEC + SIM_VSEC_CTRL:
+            space = SIM_VSEC_SPACE(value);
+            *reg = space;
+            if (space == SIM_AS_CR_SPACE || space == SIM_AS_ICMD_EXT || space == SIM_AS_ICMD ||
+                space == SIM_AS_SEMAPHORE)
+            {
+                *reg |= SIM_VSEC_STATUS;
+            }
+            break;
+
+        case SIM_CFG_VSEC + SIM_VSEC_SEMAPHORE:
+            // Taken by the first ticket written, freed by 0
+            if (!value || !*reg)
+            {
+                *reg = value;
+            }
+            break;
+
+        case SIM_CFG_VSEC + SIM_VSEC_DATA:
+            *reg = value;
+            break;
+
+        case SIM_CFG_VSEC + SIM_VSEC_ADDR:
+            sim_vsec_access(value);
+            break;
+
+        default:
+            break; /* Read only */
+    }
+}
+
+int mtcr_sim_set_dev_id(u_int32_t hw_dev_id)
+{
+    if (sim_init())
+    {
+        return -1;
+    }
+    sim_cr_set(SIM_HW_DEV_ID_ADDR, hw_dev_id);
+    return 0;
+}
+
+int mtcr_sim_map_file(const char* path)
+{
+    void* map;
+
+    if (sim_crspace)
+    {
+        errno = EBUSY;
+        return -1;
+    }
+    sim_map_fd = open(path, O_RDWR | O_CREAT | O_TRUNC, (mode_t)0600);
+    if (sim_map_fd < 0)
+    {
+        return -1;
+    }
+    // The file was just truncated, so stretching it leaves it reading as zeros without taking space
+    if (ftruncate(sim_map_fd, MTCR_SIM_CRSPACE_SIZE) ||
+        (map = mmap(NULL, MTCR_SIM_CRSPACE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, sim_map_fd, 0)) == MAP_FAILED)
+    {
+        close(sim_map_fd);
+        sim_map_fd = -1;
+        return -1;
+    }
+    sim_crspace = (u_int32_t*)map;
+    return sim_alloc_flash();
+}
+
+void mtcr_sim_unmap_file(void)
+{
+    if (sim_map_fd < 0)
+    {
+        return;
+    }
+    munmap(sim_crspace, MTCR_SIM_CRSPACE_SIZE);
+    close(sim_map_fd);
+    sim_crspace = NULL;
+    sim_map_fd = -1;
+}
+
+int mtcr_sim_load_dump(const char* path)
+{
+    char line[64];
+    unsigned int addr, value;
+    FILE* fp;
+
+    if (sim_init())
+    {
+        return -1;
+    }
+    fp = fopen(path, "r");
+    if (!fp)
+    {
+        return -1;
+    }
+    while (fgets(line, sizeof(line), fp))
+    {
+        if (sscanf(line, "%x %x", &addr, &value) != 2 || addr >= MTCR_SIM_CRSPACE_SIZE)
+        {
+            fclose(fp);
+            errno = EINVAL;
+            return -1;
+        }
+        sim_cr_set(addr & ~3, value);
+    }
+    fclose(fp);
+    return 0;
+}
+
+void mtcr_sim_set_latency(u_int32_t nsecs)
+{
+    sim_latency_ns = nsecs;
+}
+
+void mtcr_sim_set_icmd_time(u_int32_t usecs)
+{
+    sim_icmd_ns = usecs * 1000;
+}
+
+void mtcr_sim_get_stats(mtcr_sim_stats_t* stats)
+{
+    *stats = sim_stats;
+}
+
+void mtcr_sim_reset_stats(void)
+{
+    memset(&sim_stats, 0, sizeof(sim_stats));
+}
+
+/*
+ * Configuration space. The fd only has to be closable, every access goes to the one simulated device.
+ */
+int mtcr_sim_open(const char* name, int flags)
+{
+    (void)name;
+    if (sim_init())
+    {
+        return -1;
+    }
+    sim_select_model();
+    return open("/dev/null", flags & O_ACCMODE);
+}
+
+ssize_t mtcr_sim_pread(int fd, void* buf, size_t count, u_int64_t offset)
+{
+    u_int8_t* bytes = (u_int8_t*)buf;
+    u_int32_t value;
+    size_t i;
+
+    (void)fd;
+    if (offset > SIM_CFG_SIZE || count > SIM_CFG_SIZE - offset)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    sim_stats.cfg_reads++;
+    sim_delay();
+    if (!(offset & 3) && !(count & 3))
+    {
+        for (i = 0; i < count; i += 4)
+        {
+            value = __cpu_to_le32(sim_cfg_read4((u_int32_t)(offset + i)));
+            memcpy(bytes + i, &value, 4);
+        }
+        return (ssize_t)count;
+    }
+    // Byte reads, as the capability walk does, have no side effects
+    for (i = 0; i < count; i++)
+    {
+        bytes[i] = (u_int8_t)(sim_cfg[(offset + i) / 4] >> (8 * ((offset + i) % 4)));
+    }
+    return (ssize_t)count;
+}
+
+ssize_t mtcr_sim_pwrite(int fd, const void* buf, size_t count, u_int64_t offset)
+{
+    u_int32_t value;
+    size_t i;
+
+    (void)fd;
+    if ((offset & 3) || (count & 3) || offset > SIM_CFG_SIZE || count > SIM_CFG_SIZE - offset)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    sim_stats.cfg_writes++;
+    sim_delay();
+    for (i = 0; i < count; i += 4)
+    {
+        memcpy(&value, (const u_int8_t*)buf + i, 4);
+        sim_cfg_write4((u_int32_t)(offset + i), __le32_to_cpu(value));
+    }
+    return (ssize_t)count;
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+/*
+ *
+ *  mtcr_sim.h - simulated PCI device behind libmtcr_ul
+ *
+ *  A SIMULATOR build of libmtcr_ul (libmtcr_ul_sim.la) opens every device name as this device and does
+ *  all of its configuration space accesses against it, so the real pciconf transports (the VSEC gateway,
+ *  or the old address/data gateway when there is no VSEC) run unchanged on top of it. The cr-space behind
+ *  the gateways is memory, except for the HW ID, the flash semaphores and the flash gateway, which runs its
+ *  commands on an in-memory NOR flash. The device model (VSEC or not, old or 6th gen flash gateway)
+ *  follows the HW ID. VSEC models also have the ICMD mailbox and its semaphore.
+ */
+
+#ifndef _MTCR_SIM_H
+#define _MTCR_SIM_H
+
+#include <sys/types.h>
+#include <mtcr.h>
+
+/* The 30 bit address range the VSEC gateway can reach */
+#define MTCR_SIM_CRSPACE_SIZE 0x40000000
+#define MTCR_SIM_FLASH_SIZE 0x1000000
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct mtcr_sim_stats
+{
+    u_int64_t cfg_reads;     /* configuration space reads */
+    u_int64_t cfg_writes;    /* configuration space writes */
+    u_int64_t gw_commands;   /* flash gateway commands executed */
+    u_int64_t icmd_commands; /* ICMDs completed */
+} mtcr_sim_stats_t;
+
+/*
+ * Set the HW ID the device reports at 0xf0014 and pick the matching model. Takes effect on the next open.
+ */
+int mtcr_sim_set_dev_id(u_int32_t hw_dev_id);
+
+/*
+ * Keep the cr-space in a shared mapping of the given file instead of private memory, in the big endian
+ * layout of a cr-space dump. Must be called before anything else touches the device.
+ */
+int mtcr_sim_map_file(const char* path);
+void mtcr_sim_unmap_file(void);
+
+/*
+ * Load a cr-space snapshot in the mstdump text format ("0x<addr> 0x<data>" per line)
+ */
+int mtcr_sim_load_dump(const char* path);
+
+/*
+ * Latency added to every configuration space access, in nanoseconds
+ */
+void mtcr_sim_set_latency(u_int32_t nsecs);
+
+/*
+ * Time the firmware takes to run an ICMD, in microseconds
+ */
+void mtcr_sim_set_icmd_time(u_int32_t usecs);
+
+void mtcr_sim_get_stats(mtcr_sim_stats_t* stats);
+void mtcr_sim_reset_stats(void);
+
+/*
+ * Configuration space of the device, in place of open/pread/pwrite on the sysfs config file
+ */
+int mtcr_sim_open(const char* name, int flags);
+ssize_t mtcr_sim_pread(int fd, void* buf, size_t count, u_int64_t offset);
+ssize_t mtcr_sim_pwrite(int fd, const void* buf, size_t count, u_int64_t offset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
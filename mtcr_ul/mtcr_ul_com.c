@@ -102,6 +102,13 @@
 #include "kernel/mst.h"
 #include "tools_dev_types.h"
 
+#ifdef SIMULATOR
+#include "mtcr_sim.h"
+/* Every configuration space access goes to the simulated device */
+#define pread  mtcr_sim_pread
+#define pwrite mtcr_sim_pwrite
+#endif
+
 #define CX3_SW_ID    4099
 #define CX3PRO_SW_ID 4103
 #define HW_ID_ADDR   0xf0014
@@ -1311,7 +1318,7 @@ int mtcr_pciconf_mwrite4(mfile* mf, unsigned int offset, u_int32_t value)
     return 4;
 }
 
-static int block_op_pciconf(mfile* mf, unsigned int offset, u_int32_t* data, int length, int rw)
+static int block_op_pciconf_legacy(mfile* mf, unsigned int offset, u_int32_t* data, int length, int rw)
 {
     int i;
     int rc = ME_OK;
@@ -1343,6 +1350,140 @@ cleanup:
     return wrote_or_read;
 }
 
+/* Raw VSEC accessors for the streaming block path: the caller already holds the config space file lock. */
+static int vsec_stream_write4(mfile* mf, u_int32_t val, unsigned int pci_offs)
+{
+    u_int32_t val_le = __cpu_to_le32(val);
+
+    if (pwrite(mf->fd, &val_le, 4, pci_offs) != 4) {
+        return ME_PCI_WRITE_ERROR;
+    }
+    return ME_OK;
+}
+
+/* ADDR and DATA are adjacent dwords, so a read poll fetches the flag and the data with a single config access. */
+static int vsec_stream_wait_on_flag(mfile* mf, u_int8_t expected_val, u_int32_t* data)
+{
+    u_int32_t regs[2];
+    size_t    len = data ? sizeof(regs) : sizeof(regs[0]);
+    int       retries = 0;
+
+    do{
+        if (retries > IFC_MAX_RETRIES) {
+            return ME_PCI_IFC_TOUT;
+        }
+        if (pread(mf->fd, regs, len, mf->vsec_addr + PCI_ADDR_OFFSET) != (ssize_t)len) {
+            return ME_PCI_READ_ERROR;
+        }
+        retries++;
+        if ((retries & 0xf) == 0) { /* dont sleep always */
+            msleep(1);
+        }
+    } while (EXTRACT(__le32_to_cpu(regs[0]), PCI_FLAG_BIT_OFFS, 1) != expected_val);
+
+    if (data) {
+        *data = __le32_to_cpu(regs[1]);
+    }
+    return ME_OK;
+}
+
+static int vsec_stream_rw(mfile* mf, unsigned int offset, u_int32_t* data, int rw)
+{
+    u_int32_t address = offset;
+
+    /* last 2 bits must be zero as we only allow 30 bits addresses */
+    if (EXTRACT(address, 30, 2)) {
+        if (errno == EEXIST) {
+            errno = EINVAL;
+        }
+        return ME_BAD_PARAMS;
+    }
+    address = MERGE(address, (rw ? 1 : 0), PCI_FLAG_BIT_OFFS, 1);
+    if (rw == WRITE_OP) {
+        if (vsec_stream_write4(mf, *data, mf->vsec_addr + PCI_DATA_OFFSET) ||
+            vsec_stream_write4(mf, address, mf->vsec_addr + PCI_ADDR_OFFSET)) {
+            return ME_PCI_WRITE_ERROR;
+        }
+        return vsec_stream_wait_on_flag(mf, 0, NULL);
+    }
+    if (vsec_stream_write4(mf, address, mf->vsec_addr + PCI_ADDR_OFFSET)) {
+        return ME_PCI_WRITE_ERROR;
+    }
+    return vsec_stream_wait_on_flag(mf, 1, data);
+}
+
+/*
+ * Streaming VSEC block transport: the cap9 semaphore, the address space and the config space
+ * file lock are set up once per block, then the dwords are moved back to back.
+ * A read dword costs one address write and one combined flag+data read.
+ */
+static int block_op_pciconf_stream(mfile* mf, unsigned int offset, u_int32_t* data, int length, int rw)
+{
+    int       i;
+    int       rc = ME_OK;
+    int       wrote_or_read = length;
+    ul_ctx_t* ctx = mf->ul_ctx;
+
+    if (length % 4) {
+        return -1;
+    }
+    /* lock semaphore and set address space */
+    rc = mtcr_pciconf_cap9_sem(mf, 1);
+    if (rc) {
+        return -1;
+    }
+    /* set address space */
+    rc = mtcr_pciconf_set_addr_space(mf, mf->address_space);
+    if (rc) {
+        wrote_or_read = -1;
+        goto cleanup;
+    }
+
+    if (_flock_int(ctx->fdlock, LOCK_EX)) {
+        wrote_or_read = -1;
+        goto cleanup;
+    }
+    for (i = 0; i < length; i += 4) {
+        if (vsec_stream_rw(mf, offset + i, &(data[(i >> 2)]), rw)) {
+            wrote_or_read = i;
+            break;
+        }
+    }
+    _flock_int(ctx->fdlock, LOCK_UN);
+cleanup:
+    mtcr_pciconf_cap9_sem(mf, 0);
+    return wrote_or_read;
+}
+
+/* MTCR_VSEC_LEGACY_BLOCK set to anything but empty or "0" selects the per-dword block path */
+static int vsec_legacy_block_requested(void)
+{
+    const char* env = getenv("MTCR_VSEC_LEGACY_BLOCK");
+
+    return env && *env && strcmp(env, "0");
+}
+
+static int block_op_pciconf(mfile* mf, unsigned int offset, u_int32_t* data, int length, int rw)
+{
+    ul_ctx_t      * ctx = mf->ul_ctx;
+    struct timespec start, end;
+    int             rc;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (ctx->vsec_legacy_block) {
+        rc = block_op_pciconf_legacy(mf, offset, data, length, rw);
+    } else {
+        rc = block_op_pciconf_stream(mf, offset, data, length, rw);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    if (rc > 0) {
+        ctx->vsec_block_dwords += rc / 4;
+    }
+    ctx->vsec_block_usecs += (end.tv_sec - start.tv_sec) * 1000000ULL + (end.tv_nsec - start.tv_nsec) / 1000;
+    return rc;
+}
+
 static int mread4_block_pciconf(mfile* mf, unsigned int offset, u_int32_t* data, int length)
 {
     return block_op_pciconf(mf, offset, data, length, READ_OP);
@@ -1446,6 +1587,14 @@ static int mtcr_pciconf_mclose(mfile* mf)
     unsigned int word;
 
     if (mf) {
+        ul_ctx_t* ctx = mf->ul_ctx;
+        if (ctx->vsec_block_usecs) {
+            DBG_PRINTF("-D- VSEC %s block transport: %llu dwords in %llu usec (%llu dwords/sec)\n",
+                       ctx->vsec_legacy_block ? "per-dword" : "streaming",
+                       (unsigned long long)ctx->vsec_block_dwords,
+                       (unsigned long long)ctx->vsec_block_usecs,
+                       (unsigned long long)(ctx->vsec_block_dwords * 1000000ULL / ctx->vsec_block_usecs));
+        }
         /* Adrianc: set address in PCI configuration space to be non-semaphore. */
         int rc = mread4_ul(mf, 0xf0014, &word);
         if (mf->fd > 0) {
@@ -1509,7 +1658,11 @@ static int mtcr_pciconf_open(mfile* mf, const char* name, u_int32_t adv_opt)
     ul_ctx_t* ctx = mf->ul_ctx;
 
     mf->fd = -1;
+#ifdef SIMULATOR
+    mf->fd = mtcr_sim_open(name, O_RDWR | O_SYNC);
+#else
     mf->fd = open(name, O_RDWR | O_SYNC);
+#endif
     if (mf->fd < 0) {
         return -1;
     }
@@ -1548,6 +1701,7 @@ static int mtcr_pciconf_open(mfile* mf, const char* name, u_int32_t adv_opt)
         ctx->mwrite4 = mtcr_pciconf_mwrite4;
         ctx->mread4_block = mread4_block_pciconf;
         ctx->mwrite4_block = mwrite4_block_pciconf;
+        ctx->vsec_legacy_block = vsec_legacy_block_requested();
     } else {
         ctx->wo_addr = is_wo_pciconf_gw(mf);
         /* printf("Write Only Address: %#x\n", ctx->wo_addr); */
@@ -2420,10 +2574,12 @@ mfile* mopen_ul_int(const char* name, u_int32_t adv_opt)
     int      err;
     int      rc;
 
+#ifndef SIMULATOR
     if (geteuid() != 0) {
         errno = EACCES;
         return NULL;
     }
+#endif
     mf = (mfile*)malloc(sizeof(mfile));
     if (!mf) {
         return NULL;
@@ -2447,6 +2603,15 @@ mfile* mopen_ul_int(const char* name, u_int32_t adv_opt)
     mf->fd = -1;
     mf->res_fd = -1;
     mf->mpci_change = mpci_change_ul;
+#ifdef SIMULATOR
+    /* Any name is the simulated device, which has no sysfs entry to look up */
+    mf->tp = MST_PCICONF;
+    mf->flags = MDEVS_TAVOR_CR;
+    if (mtcr_pciconf_open(mf, name, adv_opt)) {
+        goto open_failed;
+    }
+    return mf;
+#endif
     dev_type = mtcr_parse_name(name, &force, &domain, &bus, &dev, &func);
     switch (dev_type) {
     case MST_DRIVER_CR:
@@ -2721,6 +2886,11 @@ int mclose_ul(mfile* mf)
     if (mf != NULL) {
         ul_ctx_t* ctx = mf->ul_ctx;
         if (ctx) {
+            if (ctx->reg_transport_hits || ctx->reg_transport_misses) {
+                DBG_PRINTF("-D- Register access transport cache: %llu hits, %llu misses\n",
+                           (unsigned long long)ctx->reg_transport_hits,
+                           (unsigned long long)ctx->reg_transport_misses);
+            }
             if (ctx->mclose != NULL) {
                 /* close icmd if if needed */
                 if (mf->icmd.icmd_opened) {
@@ -2884,7 +3054,8 @@ enum {
     MAD_CLASS_A_REG_ACCESS = 0x0A,
 };
 
-u_int8_t class_to_use = MAD_CLASS_REG_ACCESS;
+/* Chosen per access register, each thread issuing them over its own handle has its own */
+__thread u_int8_t class_to_use = MAD_CLASS_REG_ACCESS;
 
 enum {
     TLV_END       = 0,
@@ -2967,6 +3138,95 @@ int return_by_reg_status(int reg_status)
     }
 }
 
+static int reg_size_class(u_int32_t reg_size)
+{
+    if (reg_size <= INBAND_MAX_REG_SIZE) {
+        return REG_SIZE_CLASS_SMP;
+    }
+    if (reg_size <= INBAND_MAX_REG_SIZE_CLS_A) {
+        return REG_SIZE_CLASS_CLS_A;
+    }
+    return REG_SIZE_CLASS_LARGE;
+}
+
+/* The cache slot of a size class and access method, NULL when the access is not cached */
+static reg_transport_t* mreg_transport_slot(mfile* mf, u_int32_t reg_size, maccess_reg_method_t reg_method)
+{
+    ul_ctx_t* ctx = mf->ul_ctx;
+
+    if (!ctx || (reg_method <= 0) || (reg_method >= MACCESS_LAST_REG_METHOD)) {
+        return NULL;
+    }
+    return &ctx->reg_transport[reg_size_class(reg_size)][reg_method];
+}
+
+static void mreg_cache_transport(mfile              * mf,
+                                 u_int32_t            reg_size,
+                                 maccess_reg_method_t reg_method,
+                                 reg_transport_t      transport)
+{
+    reg_transport_t* slot = mreg_transport_slot(mf, reg_size, reg_method);
+
+    if (slot) {
+        *slot = transport;
+    }
+}
+
+/* Forget the cached transports and the probes behind them, the next access reruns the full fallback chain */
+static void mreg_invalidate_transport_cache(mfile* mf)
+{
+    ul_ctx_t* ctx = mf->ul_ctx;
+
+    if (ctx) {
+        memset(ctx->reg_transport, 0, sizeof(ctx->reg_transport));
+        ctx->icmd_probe = 0;
+        ctx->tools_cmdif_probe = 0;
+    }
+}
+
+static int mreg_send_by_transport(mfile              * mf,
+                                  reg_transport_t      transport,
+                                  u_int16_t            reg_id,
+                                  maccess_reg_method_t reg_method,
+                                  void               * reg_data,
+                                  u_int32_t            reg_size,
+                                  u_int32_t            r_size_reg,
+                                  u_int32_t            w_size_reg,
+                                  int                * reg_status)
+{
+    int rc;
+
+    switch (transport) {
+    case REG_TRANSPORT_SMP:
+        class_to_use = MAD_CLASS_REG_ACCESS;
+        return mreg_send_raw(mf, reg_id, reg_method, reg_data, reg_size, r_size_reg, w_size_reg, reg_status);
+
+    case REG_TRANSPORT_CLS_A:
+        class_to_use = MAD_CLASS_A_REG_ACCESS;
+        rc = mreg_send_raw(mf, reg_id, reg_method, reg_data, reg_size, r_size_reg, w_size_reg, reg_status);
+        class_to_use = MAD_CLASS_REG_ACCESS;
+        return rc;
+
+    case REG_TRANSPORT_GMP:
+        return mib_send_gmp_access_reg_mad_ul(mf, (u_int32_t*)reg_data, reg_size, reg_id, reg_method, reg_status);
+
+    default:
+        return ME_REG_ACCESS_NOT_SUPPORTED;
+    }
+}
+
+void mget_reg_transport_stats_ul(mfile* mf, u_int64_t* hits, u_int64_t* misses)
+{
+    ul_ctx_t* ctx = mf ? mf->ul_ctx : NULL;
+
+    if (hits) {
+        *hits = ctx ? ctx->reg_transport_hits : 0;
+    }
+    if (misses) {
+        *misses = ctx ? ctx->reg_transport_misses : 0;
+    }
+}
+
 int supports_reg_access_smp(mfile* mf)
 {
     return (mf->flags & (MDEVS_IB | MDEVS_FWCTX)) ||
@@ -2986,12 +3246,15 @@ int maccess_reg_ul(mfile              * mf,
     DBG_PRINTF("Sending Access Register:\n");
     DBG_PRINTF("Register ID: 0x%04x\n", reg_id);
     DBG_PRINTF("Register Size: %d bytes\n", reg_size);
-    int rc = -1;
+    int              rc = -1;
+    ul_ctx_t*        ctx = NULL;
+    reg_transport_t* slot = NULL;
 
     class_to_use = MAD_CLASS_REG_ACCESS;
     if ((mf == NULL) || (reg_data == NULL) || (reg_status == NULL) || (reg_size <= 0)) {
         return ME_BAD_PARAMS;
     }
+    ctx = mf->ul_ctx;
     /* check register size */
     unsigned int max_size = (unsigned int)mget_max_reg_size_ul(mf, reg_method);
 
@@ -3024,12 +3287,35 @@ int maccess_reg_ul(mfile              * mf,
         return rc;
     }
 
+    /*
+     * Go straight to the transport that last worked for this size class and method. A transport error drops the
+     * cache, a non-zero register status reruns the chain below on its own, as an uncached access would.
+     */
+    slot = mreg_transport_slot(mf, reg_size, reg_method);
+    if (slot && (*slot != REG_TRANSPORT_NONE)) {
+        rc = mreg_send_by_transport(mf, *slot, reg_id, reg_method, reg_data, reg_size, r_size_reg, w_size_reg,
+                                    reg_status);
+        if ((rc == ME_OK) && (*reg_status == 0)) {
+            ctx->reg_transport_hits++;
+            return ME_OK;
+        }
+        if (rc != ME_OK) {
+            DBG_PRINTF("AccessRegister cached transport failed (0x%08x), dropping transport cache\n", rc);
+            mreg_invalidate_transport_cache(mf);
+        }
+        rc = -1;
+    }
+    if (ctx) {
+        ctx->reg_transport_misses++;
+    }
+
     if (reg_size <= INBAND_MAX_REG_SIZE) {
         if (supports_reg_access_smp(mf)) {
             rc = mreg_send_raw(mf, reg_id, reg_method, reg_data, reg_size, r_size_reg, w_size_reg, reg_status);
         }
         if ((rc == ME_OK) && (*reg_status == 0)) {
             DBG_PRINTF("AccessRegister SMP Sent Successfully!\n");
+            mreg_cache_transport(mf, reg_size, reg_method, REG_TRANSPORT_SMP);
             return ME_OK;
         } else {
             DBG_PRINTF("AccessRegister Class SMP Failed!\n");
@@ -3044,6 +3330,8 @@ int maccess_reg_ul(mfile              * mf,
         rc = mreg_send_raw(mf, reg_id, reg_method, reg_data, reg_size, r_size_reg, w_size_reg, reg_status);
         if ((rc == ME_OK) && (*reg_status == 0)) {
             DBG_PRINTF("AccessRegister Class 0xA Sent Successfully!\n");
+            class_to_use = MAD_CLASS_REG_ACCESS;
+            mreg_cache_transport(mf, reg_size, reg_method, REG_TRANSPORT_CLS_A);
             return ME_OK;
         } else {
             DBG_PRINTF("AccessRegister Class 0xA Failed!\n");
@@ -3057,6 +3345,7 @@ int maccess_reg_ul(mfile              * mf,
         rc = mib_send_gmp_access_reg_mad_ul(mf, (u_int32_t*)reg_data, reg_size, reg_id, reg_method, reg_status);
         if ((rc == ME_OK) && (*reg_status == 0)) {
             DBG_PRINTF("AccessRegisterGMP Sent Successfully!\n");
+            mreg_cache_transport(mf, reg_size, reg_method, REG_TRANSPORT_GMP);
             return ME_OK;
         }
         DBG_PRINTF("AccessRegisterGMP Failed!\n");
@@ -3077,6 +3366,7 @@ int maccess_reg_ul(mfile              * mf,
     } else if (*reg_status) {
         return return_by_reg_status(*reg_status);
     }
+    mreg_cache_transport(mf, reg_size, reg_method, REG_TRANSPORT_SMP);
     return ME_OK;
 }
 
@@ -3264,13 +3554,18 @@ static int mreg_send_raw(mfile              * mf,
 #define CONNECTX3_PRO_HW_ID 0x1f7
 #define CONNECTX3_HW_ID     0x1f5
 
+/* Probe results are kept in the ul context once the HW ID could be read, see mreg_invalidate_transport_cache */
 static int supports_icmd(mfile* mf)
 {
     u_int32_t dev_id = 0;
+    ul_ctx_t* ctx = mf->ul_ctx;
 
     if (mf->tp == MST_FWCTL_CONTROL_DRIVER) {
         return 1;
     }
+    if (ctx && ctx->icmd_probe) {
+        return ctx->icmd_probe > 0;
+    }
 
     if (mread4_ul(mf, HW_ID_ADDR, &dev_id) != 4) { /* cr might be locked and retured 0xbad0cafe but we dont care we search for device that supports icmd */
         return 0;
@@ -3278,17 +3573,29 @@ static int supports_icmd(mfile* mf)
     switch (dev_id & 0xffff) { /* that the hw device id */
     case CONNECTX3_HW_ID:
     case CONNECTX3_PRO_HW_ID:
+        if (ctx) {
+            ctx->icmd_probe = -1;
+        }
         return 0;
 
     default:
         break;
     }
+    if (ctx) {
+        ctx->icmd_probe = 1;
+    }
     return 1;
 }
 
 static int supports_tools_cmdif_reg(mfile* mf)
 {
     u_int32_t dev_id = 0;
+    int       supported = 0;
+    ul_ctx_t* ctx = mf->ul_ctx;
+
+    if (ctx && ctx->tools_cmdif_probe) {
+        return ctx->tools_cmdif_probe > 0;
+    }
 
     if (mread4_ul(mf, HW_ID_ADDR, &dev_id) != 4) { /* cr might be locked and retured 0xbad0cafe but we dont care we search for device that supports tools cmdif */
         return 0;
@@ -3297,14 +3604,17 @@ static int supports_tools_cmdif_reg(mfile* mf)
     case CONNECTX3_HW_ID:         /* Cx3 */
     case CONNECTX3_PRO_HW_ID:     /* Cx3-pro */
         if (tools_cmdif_is_supported(mf) == ME_OK) {
-            return 1;
+            supported = 1;
         }
         break;
 
     default:
         break;
     }
-    return 0;
+    if (ctx) {
+        ctx->tools_cmdif_probe = supported ? 1 : -1;
+    }
+    return supported;
 }
 
 int mget_max_reg_size_ul(mfile* mf, maccess_reg_method_t reg_method)
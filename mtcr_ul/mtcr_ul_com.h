@@ -142,6 +142,12 @@ extern "C"
     int tools_cmdif_unlock_semaphore_ul(mfile* mf);
 
     int mget_max_reg_size_ul(mfile* mf, maccess_reg_method_t reg_method);
+
+    /*
+     * Number of maccess_reg_ul calls answered by the cached transport (hits) and
+     * calls that had to walk the transport fallback chain (misses).
+     */
+    void mget_reg_transport_stats_ul(mfile* mf, u_int64_t* hits, u_int64_t* misses);
     int supports_reg_access_gmp_ul(mfile* mf, maccess_reg_method_t reg_method);
     int supports_reg_access_cls_a_ul(mfile* mf, maccess_reg_method_t reg_method);
     int mib_send_cls_a_access_reg_mad_ul(mfile* mf, u_int8_t* data);
@@ -468,6 +468,12 @@ static int set_and_poll_on_busy_bit(mfile* mf, int enhanced, int busy_bit_offset
 
     int icmd_timeout = set_icmd_timeout();
 
+    // inside a session the first poll is delayed by the learned completion time, then backs off from a fraction of it
+    int adaptive = mf->icmd.session_open && !enhanced && icmd_sleep <= 0;
+    u_int32_t poll_usecs = mf->icmd.poll_hint_usecs / 8 + 1;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
     // wait for command to execute
     i = 0;
     wait = 1;
@@ -505,6 +511,21 @@ static int set_and_poll_on_busy_bit(mfile* mf, int enhanced, int busy_bit_offset
                 msleep(10);
             }
         }
+        else if (adaptive && mf->icmd.poll_hint_usecs)
+        {
+            if (i == 1)
+            {
+                mft_usleep(mf->icmd.poll_hint_usecs - mf->icmd.poll_hint_usecs / 4);
+            }
+            else
+            {
+                mft_usleep(poll_usecs);
+                if (poll_usecs < 8000)
+                {
+                    poll_usecs *= 2; // exponential backoff - up-to 8ms between polls
+                }
+            }
+        }
         else
         {
             if (!enhanced)
@@ -529,6 +550,14 @@ static int set_and_poll_on_busy_bit(mfile* mf, int enhanced, int busy_bit_offset
 
     } while (busy);
 
+    if (adaptive)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        u_int32_t usecs = (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000;
+        mf->icmd.poll_hint_usecs =
+          mf->icmd.poll_hint_usecs ? (3 * mf->icmd.poll_hint_usecs + usecs) / 4 : usecs;
+    }
+
     DBG_PRINTF("Command completed!\n");
 
     return ME_OK;
@@ -683,21 +712,33 @@ static int icmd_take_semaphore_com(mfile* mf, u_int32_t expected_read_val)
     return ME_OK;
 }
 
+/*
+ * The VSEC semaphore is taken by writing a key and reading it back, so two handles of the same process writing the
+ * same key would both believe they own it. The key is the pid, which fits in 22 bits, with the index of the handle
+ * in the process above it.
+ */
+static u_int32_t icmd_semaphore_key(mfile* mf)
+{
+    static u_int32_t handles = 0;
+
+    if (!mf->icmd.semaphore_key)
+    {
+        u_int32_t handle = __sync_fetch_and_add(&handles, 1);
+        mf->icmd.semaphore_key = ((u_int32_t)getpid() & 0x3fffff) | ((handle & 0x3ff) << 22);
+    }
+    return mf->icmd.semaphore_key;
+}
+
 int icmd_take_semaphore(mfile* mf)
 {
     // open icmd interface by demand
     int ret;
-    static u_int32_t pid = 0;
     ret = icmd_open(mf);
     CHECK_RC(ret);
 
     if (mf->vsec_supp)
     {
-        if (!pid)
-        {
-            pid = getpid();
-        }
-        return icmd_take_semaphore_com(mf, pid);
+        return icmd_take_semaphore_com(mf, icmd_semaphore_key(mf));
     }
     else
     {
@@ -705,6 +746,32 @@ int icmd_take_semaphore(mfile* mf)
     }
 }
 
+/*
+ * A session keeps the semaphore between commands. Leased VS MAD locks may expire, so they are still taken per command.
+ */
+static int icmd_session_holds_semaphore(mfile* mf)
+{
+    return mf->icmd.session_open && !mf->icmd.ib_semaphore_lock_supported;
+}
+
+static int icmd_cmd_take_semaphore(mfile* mf, int enhanced)
+{
+    if (enhanced || (icmd_session_holds_semaphore(mf) && mf->icmd.took_semaphore))
+    {
+        return ME_OK;
+    }
+    return icmd_take_semaphore(mf);
+}
+
+static void icmd_cmd_clear_semaphore(mfile* mf, int enhanced)
+{
+    if (enhanced || icmd_session_holds_semaphore(mf))
+    {
+        return;
+    }
+    (void)icmd_clear_semaphore(mf);
+}
+
 static int check_msg_size(mfile* mf, int write_data_size, int read_data_size)
 {
     // check data size does not exceed mailbox size
@@ -736,15 +803,19 @@ static int icmd_send_command_com(mfile* mf,
 
     ret = icmd_is_cmd_ifc_ready(mf, enhanced);
     CHECK_RC(ret);
-    if (!enhanced)
+    ret = icmd_cmd_take_semaphore(mf, enhanced);
+    CHECK_RC(ret);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    // a session writes the opcode together with the go bit
+    if (!mf->icmd.session_open)
     {
-        ret = icmd_take_semaphore(mf);
-        CHECK_RC(ret);
+        ret = set_opcode(mf, opcode);
+        CHECK_RC_GO_TO(ret, cleanup);
     }
 
-    ret = set_opcode(mf, opcode);
-    CHECK_RC_GO_TO(ret, cleanup);
-
     if (!skip_write)
     {
         DBG_PRINTF("-D- Writing command to mailbox\n");
@@ -775,6 +846,12 @@ static int icmd_send_command_com(mfile* mf,
     // check go bit down
     ret = check_busy_bit(mf, BUSY_BITOFF, &reg);
     CHECK_RC(ret);
+    if (mf->icmd.session_open)
+    {
+        u_int8_t exmb = mf->icmd.dma_icmd;
+        reg = MERGE(reg, (u_int16_t)opcode, OPCODE_BITOFF, OPCODE_BITLEN);
+        reg = MERGE(reg, exmb, EXMB_BITOFF, EXMB_BITLEN);
+    }
 
     // set go bit + poll + returned status
     ret = set_and_poll_on_busy_bit(mf, enhanced, BUSY_BITOFF, &reg);
@@ -802,10 +879,13 @@ static int icmd_send_command_com(mfile* mf,
 
     ret = ME_OK;
 cleanup:
-    if (!enhanced)
+    if (mf->icmd.session_open)
     {
-        (void)icmd_clear_semaphore(mf);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        mf->icmd.session_cmds++;
+        mf->icmd.session_usecs += (end.tv_sec - start.tv_sec) * 1000000ULL + (end.tv_nsec - start.tv_nsec) / 1000;
     }
+    icmd_cmd_clear_semaphore(mf, enhanced);
     if (rollback_byte_order_conversion)
     {
         mtcr_fix_endianness((u_int32_t*)data, write_data_size);
@@ -864,11 +944,8 @@ static int
 
     ret = icmd_is_cmd_ifc_ready(mf, enhanced);
     CHECK_RC(ret);
-    if (!enhanced)
-    {
-        ret = icmd_take_semaphore(mf);
-        CHECK_RC(ret);
-    }
+    ret = icmd_cmd_take_semaphore(mf, enhanced);
+    CHECK_RC(ret);
 
     // check go bit down
     ret = check_busy_bit(mf, GBOX_BUSY_BITOFF, &reg);
@@ -909,10 +986,7 @@ static int
 
     ret = ME_OK;
 sem_cleanup:
-    if (!enhanced)
-    {
-        (void)icmd_clear_semaphore(mf);
-    }
+    icmd_cmd_clear_semaphore(mf, enhanced);
     return ret;
 }
 
@@ -1183,19 +1257,15 @@ static int icmd_init_vcr_crspace_addr(mfile* mf)
 static int icmd_init_vcr(mfile* mf)
 {
     int rc = ME_OK;
-    static u_int32_t pid = 0;
     static u_int32_t size = 0;
-    if (!pid)
-    {
-        pid = getpid();
-    }
+    u_int32_t key = icmd_semaphore_key(mf);
 
     mf->icmd.cmd_addr = VCR_CMD_ADDR;
     mf->icmd.ctrl_addr = VCR_CTRL_ADDR;
     mf->icmd.semaphore_addr = VCR_SEMAPHORE62;
     DBG_PRINTF("-D- Getting VCR_CMD_SIZE_ADDR\n");
 
-    rc = icmd_take_semaphore_com(mf, pid);
+    rc = icmd_take_semaphore_com(mf, key);
     CHECK_RC(rc);
     // get max command size
     rc = MREAD4_ICMD(mf, VCR_CMD_SIZE_ADDR, &mf->icmd.max_cmd_size);
@@ -1203,7 +1273,7 @@ static int icmd_init_vcr(mfile* mf)
     icmd_clear_semaphore_com(mf);
     CHECK_RC(rc);
     // adrianc: they should provide this bit as well in virtual cr-space atm get from cr-space
-    rc = icmd_take_semaphore_com(mf, pid);
+    rc = icmd_take_semaphore_com(mf, key);
     CHECK_RC(rc);
     rc = icmd_init_vcr_crspace_addr(mf);
     icmd_clear_semaphore_com(mf);
@@ -1351,6 +1421,51 @@ int icmd_open(mfile* mf)
 #endif
 }
 
+int icmd_session_open(mfile* mf)
+{
+    int ret = icmd_open(mf);
+    CHECK_RC(ret);
+
+    if (mf->icmd.session_open)
+    {
+        return ME_OK;
+    }
+    ret = icmd_is_cmd_ifc_ready(mf, 0);
+    CHECK_RC(ret);
+    mf->icmd.session_open = 1;
+    mf->icmd.session_cmds = 0;
+    mf->icmd.session_usecs = 0;
+    if (icmd_session_holds_semaphore(mf))
+    {
+        ret = icmd_take_semaphore(mf);
+        if (ret)
+        {
+            mf->icmd.session_open = 0;
+            return ret;
+        }
+    }
+    DBG_PRINTF("-D- ICMD session opened\n");
+    return ME_OK;
+}
+
+int icmd_session_close(mfile* mf)
+{
+    int ret = ME_OK;
+
+    if (!mf->icmd.session_open)
+    {
+        return ME_OK;
+    }
+    if (icmd_session_holds_semaphore(mf) && mf->icmd.took_semaphore)
+    {
+        ret = icmd_clear_semaphore(mf);
+    }
+    mf->icmd.session_open = 0;
+    DBG_PRINTF("-D- ICMD session closed: %u commands in %llu usec, learned completion time %u usec\n",
+               mf->icmd.session_cmds, (unsigned long long)mf->icmd.session_usecs, mf->icmd.poll_hint_usecs);
+    return ret;
+}
+
 /*
  * icmd_close
  */
@@ -1358,6 +1473,7 @@ void icmd_close(mfile* mf)
 {
     if (mf)
     {
+        mf->icmd.session_open = 0;
         if (mf->icmd.took_semaphore)
         {
             if (icmd_clear_semaphore(mf))
@@ -34,6 +34,7 @@
 #include "resource_dump_types.h"
 #include "resource_dump_segments.h"
 #include "resource_dump_error_handling.h"
+#include "buffer_stream.h"
 #include "utils.h"
 
 #include <vector>
@@ -72,12 +73,25 @@ DumpCommand::DumpCommand(device_attributes device_attrs, dump_request segment_pa
     _istream = ss;
 }
 
+DumpCommand::DumpCommand(device_attributes device_attrs,
+                         dump_request segment_params,
+                         uint32_t depth,
+                         unsigned char* buffer,
+                         size_t buffer_size,
+                         bool is_textual) :
+    ResourceDumpCommand{device_attrs, segment_params, depth, is_textual}
+{
+    auto bs = make_shared<BufferStream>(buffer, buffer_size);
+    _ostream = bs;
+    _istream = bs;
+}
+
 string DumpCommand::get_big_endian_string()
 {
     return _allocated_ostream ?
              get_big_endian_string_impl<ifstream, ofstream>(*(static_pointer_cast<ifstream>(_istream)),
                                                             *(static_pointer_cast<ofstream>(_ostream))) :
-             get_big_endian_string_impl<stringstream>(*(static_pointer_cast<stringstream>(_istream)));
+             get_big_endian_string_impl<iostream>(*(static_pointer_cast<iostream>(_istream)));
 }
 
 void DumpCommand::reverse_fstream_endianess()
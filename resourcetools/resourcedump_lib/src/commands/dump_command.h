@@ -54,6 +54,14 @@ public:
     // Buffer Stream c'tor
     DumpCommand(device_attributes device_attrs, dump_request segment_params, uint32_t depth, bool is_textual = false);
 
+    // Caller Buffer c'tor, the dump is fetched directly into buffer and fails with BUFFER_TOO_SMALL if it does not fit
+    DumpCommand(device_attributes device_attrs,
+                dump_request segment_params,
+                uint32_t depth,
+                unsigned char* buffer,
+                size_t buffer_size,
+                bool is_textual = false);
+
     std::string get_big_endian_string();
     void reverse_fstream_endianess();
 
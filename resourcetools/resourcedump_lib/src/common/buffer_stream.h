@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. ALL RIGHTS RESERVED.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef RESDUMP_BUFFER_STREAM_H
+#define RESDUMP_BUFFER_STREAM_H
+
+#include "resource_dump_error_handling.h"
+
+#include <cstddef>
+#include <climits>
+#include <iostream>
+#include <streambuf>
+
+namespace mft
+{
+namespace resource_dump
+{
+// A read/write stream over a caller supplied buffer, so that a dump can be fetched straight into its final
+// destination. Reads are bounded by what was written so far, and writing past the end of the buffer throws
+// BUFFER_TOO_SMALL instead of growing.
+class BufferStreamBuf : public std::streambuf
+{
+public:
+    BufferStreamBuf(char* buffer, size_t size)
+    {
+        setp(buffer, buffer + size);
+        setg(buffer, buffer, buffer);
+    }
+
+protected:
+    int_type overflow(int_type) override
+    {
+        throw ResourceDumpException(ResourceDumpException::Reason::BUFFER_TOO_SMALL);
+    }
+
+    int_type underflow() override
+    {
+        if (gptr() < pptr())
+        {
+            setg(eback(), gptr(), pptr());
+            return traits_type::to_int_type(*gptr());
+        }
+        return traits_type::eof();
+    }
+
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+    {
+        const bool is_out = which & std::ios_base::out;
+        const off_type written = pptr() - pbase();
+        const off_type limit = is_out ? epptr() - pbase() : written;
+        off_type base = 0;
+        if (dir == std::ios_base::cur)
+        {
+            base = is_out ? written : gptr() - eback();
+        }
+        else if (dir == std::ios_base::end)
+        {
+            base = written;
+        }
+
+        const off_type new_pos = base + off;
+        if (new_pos < 0 || new_pos > limit)
+        {
+            return pos_type(off_type(-1));
+        }
+
+        if (is_out)
+        {
+            set_put_position(new_pos);
+        }
+        if (which & std::ios_base::in)
+        {
+            setg(eback(), eback() + new_pos, pptr() > eback() + new_pos ? pptr() : eback() + new_pos);
+        }
+        return pos_type(new_pos);
+    }
+
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+    {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+
+private:
+    // pbump() takes an int, so large buffers are advanced in steps
+    void set_put_position(off_type pos)
+    {
+        setp(pbase(), epptr());
+        for (; pos > INT_MAX; pos -= INT_MAX)
+        {
+            pbump(INT_MAX);
+        }
+        pbump(static_cast<int>(pos));
+    }
+};
+
+class BufferStream : public std::iostream
+{
+public:
+    BufferStream(unsigned char* buffer, size_t size) :
+        std::iostream{nullptr}, _streambuf{reinterpret_cast<char*>(buffer), size}
+    {
+        rdbuf(&_streambuf);
+    }
+
+private:
+    BufferStreamBuf _streambuf;
+};
+
+} // namespace resource_dump
+} // namespace mft
+
+#endif // RESDUMP_BUFFER_STREAM_H
@@ -153,19 +153,7 @@ void RegAccessResourceDumpFetcher::retrieve_from_reg_access()
 
     do
     {
-        dm_dev_id_t dev_id = DeviceUnknown;
-        u_int32_t hw_id = 0, hw_rev = 0;
-        dm_get_device_id(_mf, &dev_id, &hw_id, &hw_rev);
-        /***********************************************************/
-        /*********************** ATTENTION *************************/
-        /******** The functions below must be equivalent ***********/
-        /** Changes in them should be made both in switch and nic **/
-        auto reg_access_func = dm_dev_is_hca(dev_id) ? reg_access_res_dump : reg_access_mord;
-        reg_access_status_t res = reg_access_func(_mf, REG_ACCESS_METHOD_GET, &_reg_access_layout);
-        if (res != ME_REG_ACCESS_OK)
-        {
-            throw ResourceDumpException(ResourceDumpException::Reason::SEND_REG_ACCESS_FAILED, res);
-        }
+        send_reg_access();
 
         // May throw ios::failure
         write_payload_data_to_ostream();
@@ -175,6 +163,29 @@ void RegAccessResourceDumpFetcher::retrieve_from_reg_access()
     } while (_reg_access_layout.more_dump);
 }
 
+void RegAccessResourceDumpFetcher::send_reg_access()
+{
+    if (!_device_type_resolved)
+    {
+        dm_dev_id_t dev_id = DeviceUnknown;
+        u_int32_t hw_id = 0, hw_rev = 0;
+        dm_get_device_id(_mf, &dev_id, &hw_id, &hw_rev);
+        _is_hca = dm_dev_is_hca(dev_id);
+        _device_type_resolved = true;
+    }
+
+    /***********************************************************/
+    /*********************** ATTENTION *************************/
+    /******** The functions below must be equivalent ***********/
+    /** Changes in them should be made both in switch and nic **/
+    auto reg_access_func = _is_hca ? reg_access_res_dump : reg_access_mord;
+    reg_access_status_t res = reg_access_func(_mf, REG_ACCESS_METHOD_GET, &_reg_access_layout);
+    if (res != ME_REG_ACCESS_OK)
+    {
+        throw ResourceDumpException(ResourceDumpException::Reason::SEND_REG_ACCESS_FAILED, res);
+    }
+}
+
 void RegAccessResourceDumpFetcher::init_reg_access_layout()
 {
     _reg_access_layout = {
@@ -72,6 +72,9 @@ protected:
 
     virtual void write_payload_data_to_ostream();
 
+    // Sends a single RESOURCE_DUMP/MORD GET with _reg_access_layout, throws on failure
+    virtual void send_reg_access();
+
     mfile_t* _mf;
     uint16_t _vhca;
 
@@ -96,6 +99,10 @@ private:
     std::ios::iostate _orig_is_exceptions;
     uint32_t _depth;
 
+    // The device type does not change during a dump, resolve it on the first access only
+    bool _device_type_resolved{false};
+    bool _is_hca{false};
+
 protected:
     uint8_t _current_seq_num{0};
 };
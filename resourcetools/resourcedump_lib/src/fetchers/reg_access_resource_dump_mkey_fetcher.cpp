@@ -149,12 +149,17 @@ void RegAccessResourceDumpMkeyFetcher::reset_reg_access_layout()
 
 void RegAccessResourceDumpMkeyFetcher::write_payload_data_to_ostream()
 {
+    if (_reg_access_layout.size > _umem_size)
+    {
+        throw ResourceDumpException(ResourceDumpException::Reason::REGISTER_DATA_SIZE_TOO_LONG);
+    }
+    // The buffer is rewritten by the next access, so convert it in place and hand it to the stream in one write
+    auto dwords = static_cast<uint32_t*>(_mkey_buffer);
     for (size_t i = 0; i < _reg_access_layout.size / 4; ++i)
     {
-        auto offset = adb2c_calc_array_field_address(0, 32, i, _reg_access_layout.size, 1);
-        auto dword = adb2c_pop_integer_from_buff(static_cast<const uint8_t*>(_mkey_buffer), offset, 4);
-        _ostream->write(reinterpret_cast<const char*>(&dword), 4);
+        dwords[i] = __be32_to_cpu(dwords[i]);
     }
+    _ostream->write(static_cast<const char*>(_mkey_buffer), _reg_access_layout.size / 4 * 4);
 }
 
 void RegAccessResourceDumpMkeyFetcher::init_ibv_context(const string rdma_name)
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. ALL RIGHTS RESERVED.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*
+ * Host side throughput of the inline resource dump path on a synthetic multi-megabyte dump. The register access is
+ * replaced by a generator of data segments, so only the fetcher and the streams are measured. Each mode runs in its
+ * own process to report its peak RSS:
+ *   stringstream - the dump is fetched into a stringstream and copied to the caller's buffer (the former
+ *                  dump_resource_to_buffer path)
+ *   buffer       - the dump is fetched straight into the caller's buffer
+ *
+ * Usage: resource_dump_fetch_bench [-i iterations] [-s size_mb]
+ */
+
+#include "reg_access_resource_dump_fetcher.h"
+#include "resource_dump_error_handling.h"
+#include "resource_dump_types.h"
+#include "buffer_stream.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <sstream>
+#include <vector>
+#include <common/tools_bench.h>
+
+using namespace std;
+using namespace mft::resource_dump;
+using namespace mft::resource_dump::fetchers;
+
+static const uint32_t SEGMENT_DWORDS = 256;
+static const uint16_t DATA_SEGMENT_TYPE = 0x1000;
+
+// Answers every access with the next inline chunk of num_segments data segments followed by a terminate segment
+class BenchFetcher : public RegAccessResourceDumpFetcher
+{
+public:
+    BenchFetcher(uint32_t num_segments) :
+        RegAccessResourceDumpFetcher{reinterpret_cast<mfile_t*>(this), {"bench", DEFAULT_VHCA, AUTO_RDMA_NAME},
+                                     {DATA_SEGMENT_TYPE, 0, 0, 0, 0}},
+        _total_dwords{num_segments * SEGMENT_DWORDS + 1}
+    {
+    }
+
+protected:
+    void send_reg_access() override
+    {
+        uint32_t count = 0;
+        for (; count < NUM_INLINE_DATA_DWORDS && _next_dword < _total_dwords; ++count, ++_next_dword)
+        {
+            _reg_access_layout.inline_data[count] = dword_at(_next_dword);
+        }
+        _reg_access_layout.size = count * 4;
+        _reg_access_layout.more_dump = _next_dword < _total_dwords;
+        _reg_access_layout.seq_num = (_current_seq_num + 1) % 16;
+    }
+
+private:
+    uint32_t dword_at(uint32_t idx) const
+    {
+        resource_dump_segment_header header{0, 0};
+        uint32_t dword = 0;
+        if (idx == _total_dwords - 1)
+        {
+            header.segment_type = static_cast<uint16_t>(SegmentType::terminate);
+            header.length_dw = 1;
+        }
+        else if (idx % SEGMENT_DWORDS == 0)
+        {
+            header.segment_type = DATA_SEGMENT_TYPE;
+            header.length_dw = SEGMENT_DWORDS;
+        }
+        else
+        {
+            return idx * 2654435761u;
+        }
+        memcpy(&dword, &header, sizeof(dword));
+        return dword;
+    }
+
+    uint32_t _total_dwords;
+    uint32_t _next_dword{0};
+};
+
+static uint32_t checksum(const unsigned char* data, size_t size)
+{
+    uint32_t sum = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        sum = sum * 31 + data[i];
+    }
+    return sum;
+}
+
+// Returns the dumped size
+static size_t run_once(bool use_buffer, uint32_t num_segments, unsigned char* buffer, size_t buffer_size)
+{
+    BenchFetcher fetcher{num_segments};
+    if (use_buffer)
+    {
+        auto bs = make_shared<BufferStream>(buffer, buffer_size);
+        fetcher.set_streams(bs, bs);
+        fetcher.fetch_data();
+        return bs->tellp();
+    }
+    auto ss = make_shared<stringstream>();
+    fetcher.set_streams(ss, ss);
+    fetcher.fetch_data();
+    size_t dumped_size = ss->tellp();
+    if (dumped_size > buffer_size)
+    {
+        throw ResourceDumpException(ResourceDumpException::Reason::BUFFER_TOO_SMALL);
+    }
+    ss->seekg(0);
+    ss->read(reinterpret_cast<char*>(buffer), dumped_size);
+    return dumped_size;
+}
+
+static void run_mode(const char* name, bool use_buffer, int iterations, uint32_t num_segments)
+{
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        perror("fork");
+        exit(1);
+    }
+    if (pid == 0)
+    {
+        size_t buffer_size = (num_segments * SEGMENT_DWORDS + 1) * 4;
+        unsigned char* buffer = static_cast<unsigned char*>(malloc(buffer_size));
+        memset(buffer, 0, buffer_size);
+        size_t dumped_size = 0;
+        double start = bench_now_secs();
+        for (int i = 0; i < iterations; ++i)
+        {
+            dumped_size = run_once(use_buffer, num_segments, buffer, buffer_size);
+        }
+        double secs = (bench_now_secs() - start) / iterations;
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        printf("%-14s %10zu %10.2f %10.1f %12.1f 0x%08x\n", name, dumped_size, secs * 1000,
+               dumped_size / secs / (1024 * 1024), usage.ru_maxrss / 1024.0, checksum(buffer, dumped_size));
+        free(buffer);
+        exit(0);
+    }
+    int status = 0;
+    if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status))
+    {
+        fprintf(stderr, "-E- %s run failed\n", name);
+        exit(1);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int iterations = 5;
+    int size_mb = 64;
+    int opt;
+    while ((opt = getopt(argc, argv, "i:s:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'i':
+                iterations = atoi(optarg);
+                break;
+            case 's':
+                size_mb = atoi(optarg);
+                break;
+            default:
+                return bench_usage(argv[0], "[-i iterations] [-s size_mb]");
+        }
+    }
+    if (iterations <= 0 || size_mb <= 0)
+    {
+        fprintf(stderr, "-E- iterations and size must be positive\n");
+        return 1;
+    }
+
+    uint32_t num_segments = static_cast<uint32_t>(size_mb) * 1024 * 1024 / (SEGMENT_DWORDS * 4);
+    printf("%-14s %10s %10s %10s %12s %s\n", "mode", "bytes", "msec", "MB/s", "peak RSS MB", "checksum");
+    run_mode("stringstream", false, iterations, num_segments);
+    run_mode("buffer", true, iterations, num_segments);
+    return 0;
+}
@@ -148,26 +148,20 @@ enum result_t dump_resource_to_buffer(device_attributes_t device_attrs,
 {
     try
     {
-        mft::resource_dump::DumpCommand dump_command{device_attrs, segment_params, depth};
+        // The dump is fetched straight into the caller's buffer, only the endianess conversion is done afterwards
+        mft::resource_dump::DumpCommand dump_command{device_attrs, segment_params, depth, buffer, buffer_size};
         dump_command.execute();
 
-        const size_t parsed_size = dump_command.get_dumped_size();
-
-        if (parsed_size > buffer_size)
-        {
-            throw mft::resource_dump::ResourceDumpException(
-              mft::resource_dump::ResourceDumpException::Reason::BUFFER_TOO_SMALL);
-        }
-
         if (__BYTE_ORDER != __BIG_ENDIAN && endianess == endianess_t::RD_BIG_ENDIAN)
         {
-            auto big_endian_data = dump_command.get_big_endian_string();
-            memcpy(reinterpret_cast<char*>(buffer), big_endian_data.c_str(), parsed_size);
-        }
-        else
-        {
-            istream& parsed_stream = dump_command.get_native_stream();
-            parsed_stream.read(reinterpret_cast<char*>(buffer), parsed_size);
+            const size_t parsed_size = dump_command.get_dumped_size();
+            uint32_t dword = 0;
+            for (size_t offset = 0; offset + 4 <= parsed_size; offset += 4)
+            {
+                memcpy(&dword, buffer + offset, 4);
+                dword = __cpu_to_be32(dword);
+                memcpy(buffer + offset, &dword, 4);
+            }
         }
     }
     catch (const mft::resource_dump::ResourceDumpException& rde)
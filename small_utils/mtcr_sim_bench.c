@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+
+/*
+ * Throughput and latency of the mtcr, mflash and crdump access paths over the
+ * simulated PCI device of libmtcr_ul_sim, with a given latency added to every
+ * configuration space access. The device follows the HW ID given with -d:
+ * ConnectX-3 (0x1f5) has the old pciconf gateway and flash gateway, ConnectX-5
+ * (0x20d) the VSEC and the old flash gateway, ConnectX-7 (0x218) the VSEC and
+ * the 6th gen flash gateway. Without -d the HW ID comes from the dump given
+ * with -f, or is ConnectX-7's. Set MTCR_VSEC_LEGACY_BLOCK=1 to time the per-dword
+ * VSEC block transport. On the VSEC models a batch of -n ICMDs, each taking the
+ * device -t usecs, is timed as independent commands and inside one ICMD session.
+ * Prints one JSON object per benchmark.
+ *
+ * Usage: mtcr_sim_bench [-d hw_dev_id] [-l nsecs] [-s bytes] [-b block] [-i iterations] [-n batch] [-t usecs]
+ *                       [-c csv] [-f dump]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <mflash.h>
+#include <crdump.h>
+#include <common/tools_bench.h>
+#include "mtcr_sim.h"
+
+/* cr-space window for the block benchmarks, clear of the flash gateway */
+#define BENCH_CR_BASE 0x100000
+#define BENCH_CR_MAX 0xf00000
+#define BENCH_DEF_HW_DEV_ID 0x218 /* ConnectX-7 */
+#define BENCH_SECTOR_SIZE 0x1000
+#define BENCH_ICMD_OPCODE 0x9001 /* access register */
+#define BENCH_ICMD_SIZE 0x40
+
+typedef struct bench_ctx
+{
+    mfile* mf;
+    mflash* mfl;
+    crd_ctxt_t* crd;
+    u_int32_t block;
+    u_int8_t* data;
+    u_int32_t batch;
+} bench_ctx_t;
+
+typedef int (*bench_op_t)(bench_ctx_t* ctx, u_int32_t index);
+
+static int bench_cmp_u64(const void* a, const void* b)
+{
+    u_int64_t x = *(const u_int64_t*)a;
+    u_int64_t y = *(const u_int64_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+/*
+ * Run op count times, timing each call, and report the results as one JSON line
+ */
+static int bench_run(const char* name, bench_ctx_t* ctx, bench_op_t op, u_int32_t count, u_int32_t op_bytes)
+{
+    u_int64_t* lat = (u_int64_t*)malloc(sizeof(u_int64_t) * count);
+    mtcr_sim_stats_t stats;
+    u_int64_t start, total;
+    u_int32_t i;
+
+    if (!lat || !count)
+    {
+        free(lat);
+        return 1;
+    }
+    mtcr_sim_reset_stats();
+    total = 0;
+    for (i = 0; i < count; i++)
+    {
+        start = bench_now_nsecs();
+        if (op(ctx, i))
+        {
+            fprintf(stderr, "-E- %s failed at op %u\n", name, i);
+            free(lat);
+            return 1;
+        }
+        lat[i] = bench_now_nsecs() - start;
+        total += lat[i];
+    }
+    mtcr_sim_get_stats(&stats);
+    qsort(lat, count, sizeof(u_int64_t), bench_cmp_u64);
+    total = total ? total : 1;
+    printf("{\"bench\": \"%s\", \"block\": %u, \"ops\": %u, \"ops_per_sec\": %.1f, \"mb_per_sec\": %.2f, "
+           "\"p50_us\": %.3f, \"p99_us\": %.3f, \"cfg_reads\": %llu, \"cfg_writes\": %llu, \"gw_commands\": %llu, "
+           "\"icmd_commands\": %llu}\n",
+           name, op_bytes, count, count * 1e9 / total, (double)count * op_bytes * 1e3 / total, lat[count / 2] / 1e3,
+           lat[(u_int64_t)count * 99 / 100] / 1e3, (unsigned long long)stats.cfg_reads,
+           (unsigned long long)stats.cfg_writes, (unsigned long long)stats.gw_commands,
+           (unsigned long long)stats.icmd_commands);
+    fflush(stdout);
+    free(lat);
+    return 0;
+}
+
+static int bench_mread4(bench_ctx_t* ctx, u_int32_t index)
+{
+    u_int32_t value;
+    return mread4(ctx->mf, BENCH_CR_BASE + (index * 4) % BENCH_CR_MAX, &value) != 4;
+}
+
+static int bench_mread4_block(bench_ctx_t* ctx, u_int32_t index)
+{
+    u_int32_t offset = BENCH_CR_BASE + (index * ctx->block) % BENCH_CR_MAX;
+    return mread4_block(ctx->mf, offset, (u_int32_t*)ctx->data, ctx->block) != (int)ctx->block;
+}
+
+static int bench_mwrite4_block(bench_ctx_t* ctx, u_int32_t index)
+{
+    u_int32_t offset = BENCH_CR_BASE + (index * ctx->block) % BENCH_CR_MAX;
+    return mwrite4_block(ctx->mf, offset, (u_int32_t*)ctx->data, ctx->block) != (int)ctx->block;
+}
+
+static int bench_mf_read(bench_ctx_t* ctx, u_int32_t index)
+{
+    return mf_read(ctx->mfl, (index * ctx->block) % MTCR_SIM_FLASH_SIZE, ctx->block, ctx->data, false) != MFE_OK;
+}
+
+static int bench_mf_erase(bench_ctx_t* ctx, u_int32_t index)
+{
+    return mf_erase(ctx->mfl, (index * BENCH_SECTOR_SIZE) % MTCR_SIM_FLASH_SIZE) != MFE_OK;
+}
+
+/* Writes go to the sectors erased by bench_mf_erase */
+static int bench_mf_write(bench_ctx_t* ctx, u_int32_t index)
+{
+    return mf_write(ctx->mfl, (index * ctx->block) % MTCR_SIM_FLASH_SIZE, ctx->block, ctx->data) != MFE_OK;
+}
+
+static int bench_icmd_batch(bench_ctx_t* ctx, u_int32_t index)
+{
+    u_int8_t cmd[BENCH_ICMD_SIZE];
+    u_int32_t i;
+
+    for (i = 0; i < ctx->batch; i++)
+    {
+        memset(cmd, 0, sizeof(cmd));
+        if (icmd_send_command(ctx->mf, BENCH_ICMD_OPCODE, cmd, sizeof(cmd), 0))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* The same batch with the semaphore held and the completion time learned across it */
+static int bench_icmd_session(bench_ctx_t* ctx, u_int32_t index)
+{
+    int rc;
+
+    if (icmd_session_open(ctx->mf))
+    {
+        return 1;
+    }
+    rc = bench_icmd_batch(ctx, index);
+    return icmd_session_close(ctx->mf) || rc;
+}
+
+static int bench_count_block(u_int32_t addr, const u_int32_t* data, u_int32_t num_dwords, void* user_data)
+{
+    *(u_int32_t*)user_data += num_dwords;
+    return 0;
+}
+
+static int bench_crdump(bench_ctx_t* ctx, u_int32_t index)
+{
+    u_int32_t dwords = 0;
+    return crd_dump_data_blocks(ctx->crd, bench_count_block, &dwords) != CRD_OK;
+}
+
+int main(int argc, char** argv)
+{
+    bench_ctx_t ctx;
+    const char* csv = NULL;
+    const char* dump = NULL;
+    u_int32_t hw_dev_id = 0;
+    u_int32_t latency = 0;
+    u_int32_t size = 4 * 1024 * 1024;
+    u_int32_t block = 4096;
+    u_int32_t iterations = 3;
+    u_int32_t batch = 32;
+    u_int32_t icmd_time = 100;
+    u_int32_t dword_num;
+    int open_rc;
+    int rc = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "d:l:s:b:i:n:t:c:f:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'd':
+                hw_dev_id = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'l':
+                latency = strtoul(optarg, NULL, 0);
+                break;
+
+            case 's':
+                size = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'b':
+                block = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'i':
+                iterations = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'n':
+                batch = strtoul(optarg, NULL, 0);
+                break;
+
+            case 't':
+                icmd_time = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'c':
+                csv = optarg;
+                break;
+
+            case 'f':
+                dump = optarg;
+                break;
+
+            default:
+                return bench_usage(argv[0], "[-d hw_dev_id] [-l nsecs] [-s bytes] [-b block] [-i iterations] "
+                                            "[-n batch] [-t usecs] [-c csv] [-f dump]");
+        }
+    }
+    if (!block || block % 4 || size < block || size > MTCR_SIM_FLASH_SIZE || size > BENCH_CR_MAX)
+    {
+        fprintf(stderr, "-E- block must be a multiple of 4 and not above size, size up to %d bytes\n", BENCH_CR_MAX);
+        return 1;
+    }
+    if (!hw_dev_id && !dump)
+    {
+        hw_dev_id = BENCH_DEF_HW_DEV_ID;
+    }
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.block = block;
+    ctx.batch = batch;
+    ctx.data = (u_int8_t*)malloc(block);
+    // The HW ID picks the device model, so it has to be in place before the first open
+    if (!ctx.data || (dump && mtcr_sim_load_dump(dump)) || (hw_dev_id && mtcr_sim_set_dev_id(hw_dev_id)) ||
+        !(ctx.mf = mopen("sim")))
+    {
+        fprintf(stderr, "-E- Failed to set up the simulated device\n");
+        free(ctx.data);
+        mclose(ctx.mf);
+        return 1;
+    }
+    memset(ctx.data, 0x5a, block);
+    mtcr_sim_set_latency(latency);
+
+    rc |= bench_run("mread4", &ctx, bench_mread4, size / 4, 4);
+    rc |= bench_run("mread4_block", &ctx, bench_mread4_block, size / block, block);
+    rc |= bench_run("mwrite4_block", &ctx, bench_mwrite4_block, size / block, block);
+
+    // mflash keeps its own mfile on the same simulated device
+    mtcr_sim_set_latency(0);
+    open_rc = mf_open(&ctx.mfl, "sim", 1, NULL, 0);
+    mtcr_sim_set_latency(latency);
+    if (open_rc != MFE_OK)
+    {
+        fprintf(stderr, "-E- mf_open failed: %s\n", mf_err2str(open_rc));
+        rc = 1;
+    }
+    else
+    {
+        rc |= bench_run("mf_read", &ctx, bench_mf_read, size / block, block);
+        rc |= bench_run("mf_erase", &ctx, bench_mf_erase, size / BENCH_SECTOR_SIZE, BENCH_SECTOR_SIZE);
+        // mf_read left erased flash in the buffer, which write_chunks would skip
+        memset(ctx.data, 0x5a, block);
+        rc |= bench_run("mf_write", &ctx, bench_mf_write, size / block, block);
+        if (mf_read(ctx.mfl, 0, block, ctx.data, false) != MFE_OK || ctx.data[0] != 0x5a ||
+            ctx.data[block - 1] != 0x5a)
+        {
+            fprintf(stderr, "-E- Flash contents don't match the data written\n");
+            rc = 1;
+        }
+    }
+    mf_close(ctx.mfl);
+
+    // Only the VSEC models have the ICMD mailbox
+    mtcr_sim_set_latency(0);
+    mtcr_sim_set_icmd_time(icmd_time);
+    if (icmd_session_open(ctx.mf) == ME_OK && icmd_session_close(ctx.mf) == ME_OK)
+    {
+        mtcr_sim_set_latency(latency);
+        rc |= bench_run("icmd", &ctx, bench_icmd_batch, iterations, batch * BENCH_ICMD_SIZE);
+        rc |= bench_run("icmd_session", &ctx, bench_icmd_session, iterations, batch * BENCH_ICMD_SIZE);
+    }
+
+    if (csv)
+    {
+        mtcr_sim_set_latency(0);
+        if (crd_init(&ctx.crd, ctx.mf, 0, -1, -1, NULL, csv) != CRD_OK)
+        {
+            fprintf(stderr, "-E- Failed to load the dump table %s\n", csv);
+            rc = 1;
+        }
+        else
+        {
+            crd_get_dword_num(ctx.crd, &dword_num);
+            mtcr_sim_set_latency(latency);
+            rc |= bench_run("crdump", &ctx, bench_crdump, iterations, dword_num * 4);
+            crd_free(ctx.crd);
+        }
+    }
+
+    mclose(ctx.mf);
+    free(ctx.data);
+    return rc != 0;
+}
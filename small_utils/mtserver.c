@@ -110,16 +110,21 @@
  *  Mset_addr_space:
  *       Send buff:  A   <AddressSpace>
  *       Rcv  buff:  O
+ *
+ *  Binary protocol (see mtserver_proto.h):
+ *       Send buff:  X
+ *       Rcv  buff:  O   BinVersion
+ *                   O   1
  */
 
 #ifndef __WIN__
-#define PREP_SIGNAL(signal_handler) signal(SIGPIPE, signal_handler);
+// A write to a closed connection fails instead of ending the server
+#define PREP_SIGNAL() signal(SIGPIPE, SIG_IGN);
 #define WIN_INIT()
 #define WIN_CLOSE(mf, cmd)
-#define WIN_WHILE()
 #else
 #include <winsock2.h>
-#define PREP_SIGNAL(signal_handler)
+#define PREP_SIGNAL()
 #define WIN_INIT()                                                                     \
     {                                                                                  \
         int rc;                                                                        \
@@ -138,8 +143,6 @@
             break;             \
         }                      \
     }
-
-#define WIN_WHILE() while (1)
 #endif
 
 #include <stdio.h>
@@ -147,10 +150,17 @@
 #include <string.h>
 #include <stdlib.h>
 #include <signal.h>
+#include <stdint.h>
 #include <compatibility.h>
+#ifndef __WIN__
+#include <pthread.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#endif
 
 #include "mtcr.h"
 #include "tcp.h"
+#include "mtserver_proto.h"
 #include "tools_version.h"
 #include "common/tools_utils.h"
 
@@ -161,9 +171,14 @@
 #define MAX_DWORDS 128
 #define BUF_LEN (MAX_DWORDS * 4 * 3)
 #define DEV_LEN 2048
+#define BIN_HDR_LEN ((u_int32_t)sizeof(mtsrv_bin_hdr_t))
+#define BIN_BUF_LEN (2 * (BIN_HDR_LEN + MTSRV_BIN_MAX_DATA))
+#define DEF_MAX_CONNECTIONS 16
 
 int sdebug = 0;
 int port = DEF_PORT; /* Default port */
+static char* local_dev = NULL;
+static int max_connections = DEF_MAX_CONNECTIONS;
 
 /* ////////////////////////////////////////////////////////////////////// */
 static void writes_deb(int con, char* s)
@@ -192,153 +207,20 @@ void write_ok(int con)
     writes_deb(con, "O");
 }
 
+extern void mpci_change(mfile* mf);
+
 // On windows we don't have simulator in the meantime!
 #if defined(SIMULATOR) && !defined(__WIN__)
 
-#include <sys/mman.h>
-#include <sys/types.h>
-#include <sys/stat.h>
-#include <fcntl.h>
-#include <unistd.h>
+#include "mtcr_sim.h"
 
+// Where the simulated device keeps its cr-space, so that other processes can map it too
 #define FILE_PATH "/tmp/mmap.log"
-#define NUM_INTS (0x20000000)
-#define FILE_SIZE (NUM_INTS * sizeof(int))
 
-u_int32_t* cr_space;
 char sim_str[] = "\t-i[d]   <id>   - set the device id.\n"
                  "\t-f[ile] <file> - load cr-space snapshot from dump file.\n";
 int id;
 char* dump_file = NULL;
-int fd;
-mfile* mopen(const char* name)
-{
-    TOOLS_UNUSED(name);
-    return (mfile*)0;
-}
-
-mfile* mopend(const char* name, DType dtype)
-{
-    TOOLS_UNUSED(name);
-    TOOLS_UNUSED(dtype);
-    return (mfile*)1;
-}
-
-int mclose(mfile* mf)
-{
-    TOOLS_UNUSED(mf);
-    return 0;
-}
-
-int mdevices(char* buf, int len, int mask)
-{
-    TOOLS_UNUSED(len);
-    TOOLS_UNUSED(mask);
-    strcpy(buf, "Simulator");
-    return 1;
-}
-
-int mread4(mfile* mf, unsigned int offset, u_int32_t* value)
-{
-    TOOLS_UNUSED(mf);
-    *value = __be32_to_cpu(cr_space[offset / 4]);
-    return 4;
-}
-
-int mwrite4(mfile* mf, unsigned int offset, u_int32_t value)
-{
-    TOOLS_UNUSED(mf);
-    cr_space[offset / 4] = __cpu_to_be32(value);
-    // cr_space[offset/4] = value;
-    return 4;
-}
-int mi2c_detect(mfile* mf, u_int8_t slv_arr[SLV_ADDRS_NUM])
-{
-    TOOLS_UNUSED(mf);
-    TOOLS_UNUSED(slv_arr);
-    return -1;
-}
-int mread_i2cblock(mfile* mf, unsigned char i2c_slave, u_int8_t addr_width, unsigned int offset, void* data, int length)
-{
-    TOOLS_UNUSED(mf);
-    TOOLS_UNUSED(i2c_slave);
-    TOOLS_UNUSED(addr_width);
-    TOOLS_UNUSED(offset);
-    TOOLS_UNUSED(data);
-    TOOLS_UNUSED(length);
-    return 0;
-}
-
-int mcables_remote_operation_server_side(mfile* mf, u_int32_t address, u_int32_t length, u_int8_t* data, int remote_op)
-{
-    TOOLS_UNUSED(mf);
-    TOOLS_UNUSED(address);
-    TOOLS_UNUSED(length);
-    TOOLS_UNUSED(data);
-    TOOLS_UNUSED(remote_op);
-    return 0;
-}
-
-int mwrite_i2cblock(mfile* mf, unsigned char i2c_slave, u_int8_t addr_width, unsigned int offset, void* data, int length)
-{
-    TOOLS_UNUSED(mf);
-    TOOLS_UNUSED(i2c_slave);
-    TOOLS_UNUSED(addr_width);
-    TOOLS_UNUSED(offset);
-    TOOLS_UNUSED(data);
-    TOOLS_UNUSED(length);
-    return 0;
-}
-
-int mwrite4_block(mfile* mf, unsigned int offset, u_int32_t* data, int byte_len)
-{
-    int i;
-    // printf("-D- inside mtserver\n");
-    if (byte_len % 4)
-    {
-        return EINVAL; // verify byte_len is multiplation of dword size
-    }
-    mf = NULL;
-    for (i = 0; i < byte_len; i += 4)
-    {
-        mwrite4(mf, offset + i, *(data++));
-    }
-    return byte_len;
-}
-
-static void fix_endianness(u_int32_t* buf, int len)
-{
-    int i;
-
-    for (i = 0; i < (len / 4); ++i)
-    {
-        // printf("-D- before: buf[%d] = %#x\n", i, buf[i]);
-        buf[i] = __be32_to_cpu(buf[i]);
-        // printf("-D- before: buf[%d] = %#x\n", i, buf[i]);
-    }
-}
-
-int mwrite_buffer(mfile* mf, unsigned int offset, u_int8_t* data, int byte_len)
-{
-    // printf("-D- inside: mstsim:mwrite_buffer\n");
-    fix_endianness((u_int32_t*)data, byte_len);
-    return mwrite4_block(mf, offset, (u_int32_t*)data, byte_len);
-}
-
-int mread4_block(mfile* mf, unsigned int offset, u_int32_t* data, int byte_len)
-{
-    int i;
-    if (byte_len % 4)
-    {
-        return EINVAL; // verify byte_len is multiplation of dword size
-    }
-    mf = NULL;
-    for (i = 0; i < byte_len; i += 4)
-    {
-        mread4(mf, offset + i, data++);
-    }
-    return byte_len;
-}
 
 int check_id_arg(char* av[], int ac, int* i)
 {
@@ -370,97 +252,25 @@ void check_file_arg(char* av[], int ac, int* i)
     dump_file = av[*i];
 }
 
-void load_dump_file()
-{
-#define BUFSIZE 40
-    char buf[BUFSIZE];
-    int line;
-    FILE* fh = fopen(dump_file, "r");
-
-    if (!fh)
-    {
-        printf("-E- Error opening dump file for reading: %s\n", strerror(errno));
-        exit(1);
-    }
-
-    for (line = 1;; ++line)
-    {
-        int address, value;
-
-        if (!fgets(buf, BUFSIZE, fh))
-        {
-            if (feof(fh))
-            {
-                break;
-            }
-            fclose(fh);
-            printf("-E- Error reading dump file: %s\n", strerror(errno));
-            exit(1);
-        }
-
-        if (sscanf(buf, "%x %x", &address, &value) < 2)
-        {
-            fclose(fh);
-            printf("-E- Error parsing dump file at line %d\n", line);
-            exit(1);
-        }
-
-        mwrite4(NULL, address, value);
-    }
-
-    fclose(fh);
-}
-
 int prepare_the_map_file(void)
 {
-    int i;
-    int result;
-    fd = open(FILE_PATH, O_RDWR | O_CREAT | O_TRUNC, (mode_t)0600);
-
-    if (fd == -1)
-    {
-        printf("-E- Error opening file for writing\n");
-        exit(1);
-    }
-
-    result = lseek(fd, FILE_SIZE - 1, SEEK_SET);
-    if (result == -1)
-    {
-        close(fd);
-        perror("Error calling lseek() to 'stretch' the file");
-        exit(1);
-    }
-
-    result = write(fd, "", 1);
-    if (result != 1)
-    {
-        close(fd);
-        perror("Error writing last byte of the file");
-        exit(1);
-    }
-
-    cr_space = mmap(0, FILE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
-    if (cr_space == MAP_FAILED)
+    if (mtcr_sim_map_file(FILE_PATH))
     {
-        close(fd);
-        perror("Error mmapping the file");
+        printf("-E- Error mapping %s: %s\n", FILE_PATH, strerror(errno));
         exit(1);
     }
-    for (i = 0; i < NUM_INTS; ++i)
-    {
-        cr_space[i] = 0;
-    }
 
     // load cr-space snapshot
-    if (dump_file)
+    if (dump_file && mtcr_sim_load_dump(dump_file))
     {
-        load_dump_file();
+        printf("-E- Error loading dump file %s: %s\n", dump_file, strerror(errno));
+        exit(1);
     }
 
     // write id
     if (id != 0)
     {
-        mwrite4(NULL, 0xf0014, id);
+        mtcr_sim_set_dev_id(id);
     }
 
     return 0;
@@ -468,51 +278,16 @@ int prepare_the_map_file(void)
 
 int unmap_and_close_file(void)
 {
-    if (munmap(cr_space, FILE_SIZE) == -1)
-    {
-        perror("Error un-mmapping the file");
-    }
-    close(fd);
+    mtcr_sim_unmap_file();
     return 0;
 }
-void mpci_change(mfile* mf)
-{
-    TOOLS_UNUSED(mf);
-}
 
 void get_devices_list(int con)
 {
-    char dev_buf[DEV_LEN];
-    int i, rc;
-    rc = mdevices(dev_buf, DEV_LEN, MDEVS_ALL);
-    if (rc < 0)
-    {
-        write_err(con);
-    }
-    else
-    {
-        char *p = &dev_buf[0], vbuf[16];
-        sprintf(vbuf, "O %d", rc);
-        writes_deb(con, vbuf);
-        for (i = 0; i < rc; i++, p += strlen(p) + 1)
-        {
-            writes_deb(con, p);
-        }
-    }
-}
-int mget_vsec_supp(mfile* mf)
-{
-    TOOLS_UNUSED(mf);
-    return 0;
-}
-int mset_addr_space(mfile* mf, int space)
-{
-    TOOLS_UNUSED(mf);
-    TOOLS_UNUSED(space);
-    return 0;
+    writes_deb(con, "O 1");
+    writes_deb(con, "Simulator");
 }
 #else
-extern void mpci_change(mfile* mf);
 
 #if defined(__linux__) && !defined(__VMKERNEL_UW_NATIVE__) && !defined(__VMKERNEL_UW_VMKLINUX__)
 extern int check_ul_mode();
@@ -600,18 +375,14 @@ void usage(const char* s)
     printf("Switches may be:\n");
     printf("\t-p[ort] <port> - Listen to specify port (default is %d).\n", port);
     printf("\t-d[ebug]       - Print all socket traffic (for debugging only).\n");
+    printf("\t-c[onnections] <n> - Maximal number of connections served at once (default is %d).\n",
+           DEF_MAX_CONNECTIONS);
     printf("%s", sim_str);
     printf("\t-h[elp]        - Print help message.\n");
     printf("\t-v[ersion]     - Print version.\n");
     exit(1);
 }
 
-/* ////////////////////////////////////////////////////////////////////// */
-void mySignal()
-{
-    exit(0);
-}
-
 #define GET_PARAM(param, str, type, param_name, err_msg)  \
     {                                                     \
         char* end;                                        \
@@ -747,575 +518,807 @@ int copy_buff_to_str(char* str, u_int8_t* data, int size)
             exit(1);   \
         }              \
     } while (0)
-#define MSTSERVER_VERSION "1.4"
+#define MSTSERVER_VERSION "1.5"
 #define MSTSERVER_NAME "mtserver"
 
-int main(int ac, char* av[])
+/* ////////////////////////////////////////////////////////////////////// */
+/*
+ * Serve binary requests until the connection is closed. Every request already received is served before
+ * the responses are written, so a client sending a batch of requests gets the responses in a single write
+ * instead of a round trip per request.
+ */
+static void serve_binary(int con, mfile* mf)
 {
-    char* end;
-    char* local_dev = NULL;
-    char buf[BUF_LEN], dev_buf[DEV_LEN];
-    int i, con, rc;
-    mfile* mf = 0;
+    u_int8_t* in = (u_int8_t*)malloc(BIN_BUF_LEN);
+    u_int8_t* out = (u_int8_t*)malloc(BIN_BUF_LEN);
+    u_int32_t in_start = 0, in_end = 0, out_len = 0;
+    mtsrv_bin_hdr_t req, *rsp;
+    u_int32_t* data;
+    u_int32_t i;
+    int rc;
+
+    if (!in || !out)
+    {
+        printf("-E- Failed to allocate binary protocol buffers\n");
+        goto cleanup;
+    }
 
-    /* Command line parsing. */
-    for (i = 1; i < ac; i++)
+    for (;;)
     {
-        switch (*av[i])
+        while (in_end - in_start >= BIN_HDR_LEN)
         {
-            case '-':
-                ++av[i];
-                if (!strcmp(av[i], "p") || !strcmp(av[i], "port"))
-                {
-                    if (++i >= ac)
-                    {
-                        printf("After switch \"%s\" port number is expected.\n", av[--i]);
-                        printf("Type \"%s -h\" for help.\n", av[0]);
-                        exit(1);
-                    }
-                    port = (int)strtol(av[i], &end, 0);
-                    if (*end)
-                    {
-                        printf("Invalid port: \"%s\" -- ?\n", end);
-                        printf("Type \"%s -h\" for help.\n", av[0]);
-                        exit(1);
-                    }
-                    if (port < 1 || port > 65535)
-                    {
-                        printf("-E- Invalid port value: %d, port should be 16-bit number (Range: 1-65535)\n", port);
-                        exit(1);
-                    }
-                }
-                else if (!strcmp(av[i], "dev"))
-                {
-                    if (++i >= ac)
-                    {
-                        printf("After switch \"%s\" a device is expected.\n", av[--i]);
-                        printf("Type \"%s -h\" for help.\n", av[0]);
-                        exit(1);
-                    }
-                    local_dev = av[i];
-                }
-                else if (!strcmp(av[i], "d") || !strcmp(av[i], "debug"))
-                {
-                    sdebug = 1;
-                }
-                else if (!strcmp(av[i], "h") || !strcmp(av[i], "help"))
+            memcpy(&req, in + in_start, BIN_HDR_LEN);
+            req.req_id = ntohl(req.req_id);
+            req.op = ntohs(req.op);
+            req.addr = ntohl(req.addr);
+            req.size = ntohl(req.size);
+            if ((req.op != MTSRV_BIN_READ && req.op != MTSRV_BIN_WRITE) || req.size > MTSRV_BIN_MAX_DATA ||
+                req.size % 4)
+            {
+                /*  The payload length is unknown, the stream can't be followed anymore */
+                printf("-E- Invalid binary request (id:%u op:%u size:0x%x) - closing connection\n", req.req_id,
+                       req.op, req.size);
+                goto cleanup;
+            }
+            if (req.op == MTSRV_BIN_WRITE && in_end - in_start < BIN_HDR_LEN + req.size)
+            {
+                break; /*  Wait for the rest of the payload */
+            }
+            if (out_len + BIN_HDR_LEN + req.size > BIN_BUF_LEN)
+            {
+                if (writen(con, out, out_len, PT_TCP) < 0)
                 {
-                    usage(av[0]);
+                    goto cleanup;
                 }
-                else if (!strcmp(av[i], "v") || !strcmp(av[i], "version"))
+                out_len = 0;
+            }
+
+            rsp = (mtsrv_bin_hdr_t*)(out + out_len);
+            rsp->req_id = htonl(req.req_id);
+            rsp->op = htons(req.op);
+            rsp->status = 0;
+            rsp->addr = htonl(req.addr);
+            rsp->size = 0;
+            if (req.op == MTSRV_BIN_READ)
+            {
+                data = (u_int32_t*)(out + out_len + BIN_HDR_LEN);
+                if (req.size && mread4_block(mf, req.addr, data, req.size) != (int)req.size)
                 {
-                    print_version_string(MSTSERVER_NAME, MSTSERVER_VERSION);
-                    exit(0);
+                    rsp->status = htons(errno ? errno : EIO);
                 }
-                else if (!strcmp(av[i], "i") || !strcmp(av[i], "id"))
+                else
                 {
-                    check_id_arg(av, ac, &i);
+                    for (i = 0; i < req.size / 4; i++)
+                    {
+                        data[i] = htonl(data[i]);
+                    }
+                    rsp->size = htonl(req.size);
                 }
-                else if (!strcmp(av[i], "f") || !strcmp(av[i], "file"))
+                in_start += BIN_HDR_LEN;
+            }
+            else
+            {
+                data = (u_int32_t*)(in + in_start + BIN_HDR_LEN);
+                for (i = 0; i < req.size / 4; i++)
                 {
-                    check_file_arg(av, ac, &i);
+                    data[i] = ntohl(data[i]);
                 }
-                else
+                if (req.size && mwrite4_block(mf, req.addr, data, req.size) != (int)req.size)
                 {
-                    printf("Invalid switch \"%s\".\n", av[i]);
-                    usage(av[0]);
-                    exit(1);
+                    rsp->status = htons(errno ? errno : EIO);
                 }
-                break;
+                in_start += BIN_HDR_LEN + req.size;
+            }
+            if (sdebug)
+            {
+                printf("<- %c id:%u addr:0x%08x size:0x%x status:%u\n", req.op == MTSRV_BIN_READ ? 'R' : 'W',
+                       req.req_id, req.addr, req.size, ntohs(rsp->status));
+            }
+            out_len += BIN_HDR_LEN + ntohl(rsp->size);
+        }
 
-            case '?':
-                usage(av[0]);
+        /*  No complete request is left - send the responses and wait for more */
+        if (out_len)
+        {
+            if (writen(con, out, out_len, PT_TCP) < 0)
+            {
                 break;
-
-            default:
-                printf("Invalid parameter \"%s\".\n", av[i]);
-                usage(av[0]);
-                exit(1);
+            }
+            out_len = 0;
         }
+        memmove(in, in + in_start, in_end - in_start);
+        in_end -= in_start;
+        in_start = 0;
+        do
+        {
+            rc = recv(con, (char*)in + in_end, BIN_BUF_LEN - in_end, 0);
+        } while (rc < 0 && errno == EINTR);
+        if (rc <= 0)
+        {
+            break;
+        }
+        in_end += rc;
     }
 
-#ifdef MST_UL
-    if (local_dev == NULL)
-    {
-        printf("When accessing via user level mst, -dev <bus:dev.fun> flag must be provided\n");
-        exit(1);
-    }
-
-#endif
+cleanup:
+    free(in);
+    free(out);
+}
 
-    prepare_the_map_file();
-    PREP_SIGNAL(mySignal);
-    WIN_INIT();
+/* ////////////////////////////////////////////////////////////////////// */
+static void serve_connection(int con)
+{
+    char* end;
+    char buf[BUF_LEN], dev_buf[DEV_LEN];
+    int rc;
+    int binary = 0;
+    mfile* mf = 0;
 
-    /* Now open and start work */
-    logset(1);
-    WIN_WHILE()
+    for (;;)
     {
-        con = open_serv_connection(port);
-        int addrInUseError = 0;
-        if (con < 0)
+        memset(buf, 0, BUF_LEN);
+        rc = reads(con, buf, BUF_LEN, PT_TCP);
+        if (rc <= 0)
         {
-#ifdef __WIN__
-            addrInUseError = WSAEADDRINUSE;
-#else
-            addrInUseError = EADDRINUSE;
-#endif
-            if (errno == addrInUseError)
+            if (sdebug)
             {
-                printf("Open connection (server side): Address already in use\n");
-                exit(1);
+                printf("-D- read failed - closing connection. rc=%d, %s\n", rc, strerror(errno));
             }
-        }
-        CHK2(con, "Open connection (server side)");
-
-        for (;;)
-        {
-            memset(buf, 0, BUF_LEN);
-            rc = reads(con, buf, BUF_LEN, PT_TCP);
-            if (rc <= 0)
-            {
-                if (sdebug)
-                {
-                    printf("-D- read failed - closing connection. rc=%d, %s\n", rc, strerror(errno));
-                }
-                close(con);
-
-                // In windows:
-                // A client socket is handled in teh main thread (single connection at a time).
-                // On a connection close the socket and mf are closed and a new listening socket is opened.
-                // In Linux:
-                // The client socket is handled in a child process - which exits when teh client connection closes.
-                //
-                // TODO: Move to thread handling and unify Win and Lin behavior.
-                //
 
+            // In windows:
+            // A client socket is handled in the main thread (single connection at a time).
+            // On a connection close the socket and mf are closed and a new listening socket is opened.
+            // In Linux:
+            // Every client socket is handled in its own thread - which ends when the client connection closes.
 #ifndef __WIN__
-                if (rc < 0)
-                {
-                    perror("");
-                    exit(1);
-                }
-#endif
-                break; /*  EOF */
-            }
-            if (sdebug)
+            if (rc < 0)
             {
-                printf("<- %s\n", buf);
+                perror("-E- Connection read failed");
             }
-            switch (*buf)
-            {
-                case 'O': /*  Open mfile */
+#endif
+            break; /*  EOF */
+        }
+        if (sdebug)
+        {
+            printf("<- %s\n", buf);
+        }
+        switch (*buf)
+        {
+            case 'O': /*  Open mfile */
 
-                    if (mf)
+                if (mf)
+                {
+                    writes_deb(con, "E Already opened");
+                }
+                else
+                {
+#ifndef MST_UL
+                    DType dtype = strtoul(buf + 2, &end, 0);
+                    if (*end != ' ')
                     {
-                        writes_deb(con, "E Already opened");
+                        /*  Old style (O DEV_NAME) */
+                        mf = mopen(buf + 2);
                     }
                     else
                     {
-#ifndef MST_UL
-                        DType dtype = strtoul(buf + 2, &end, 0);
-                        if (*end != ' ')
-                        {
-                            /*  Old style (O DEV_NAME) */
-                            mf = mopen(buf + 2);
-                        }
-                        else
-                        {
-                            /*  New style (O FLAG DEV_NAME) */
-                            mf = mopend(end + 1, dtype);
-                        }
+                        /*  New style (O FLAG DEV_NAME) */
+                        mf = mopend(end + 1, dtype);
+                    }
 #else
-                        mf = mopen(local_dev);
+                    // The simulator opens whatever the client names
+                    mf = mopen(local_dev ? local_dev : buf + 2);
 #endif
-                        if (mf)
-                        {
+                    if (mf)
+                    {
 #if defined(__linux__) && !defined(SIMULATOR)
-                            // set request came from client
-                            mf->is_mtserver_req = 1;
+                        // set request came from client
+                        mf->is_mtserver_req = 1;
 #endif
-                            // write Recv buffer
-                            char res_buf[16];
-                            snprintf(res_buf, 16, "O %d", mget_vsec_supp(mf));
-                            writes_deb(con, res_buf);
-                        }
-                        else
-                        {
-                            write_err(con);
-                        }
-                    }
-                    break;
-
-                case 'C': /*  Close mfile */
-                    if (!mf)
-                    {
-                        writes_deb(con, "E Not opened");
+                        // write Recv buffer
+                        char res_buf[16];
+                        snprintf(res_buf, 16, "O %d", mget_vsec_supp(mf));
+                        writes_deb(con, res_buf);
                     }
                     else
                     {
-                        if (mclose(mf) < 0)
-                        {
-                            write_err(con);
-                        }
-                        else
-                        {
-                            write_ok(con);
-                            mf = 0;
-                        }
+                        write_err(con);
                     }
-                    break;
-
-                case 'V': /*  Get version */
-                    writes_deb(con, "O " MSTSERVER_VERSION);
-                    break;
+                }
+                break;
 
-                case 'L': /*  Get devices list */
-                    if (local_dev == NULL)
+            case 'C': /*  Close mfile */
+                if (!mf)
+                {
+                    writes_deb(con, "E Not opened");
+                }
+                else
+                {
+                    if (mclose(mf) < 0)
                     {
-                        get_devices_list(con);
+                        write_err(con);
                     }
                     else
                     {
-                        strcpy(dev_buf, "/dev/mst/mt25204_pci_cr0");
-                        printf("-D- local_dev=%s dev_buf=%s\n", local_dev, dev_buf);
-                        writes_deb(con, "O 1");
-                        writes_deb(con, dev_buf);
+                        write_ok(con);
+                        mf = 0;
                     }
+                }
+                break;
 
-                    break;
+            case 'V': /*  Get version */
+                writes_deb(con, "O " MSTSERVER_VERSION);
+                break;
 
-                case 'R': /*  Read word */
-                    if (!mf)
+            case 'L': /*  Get devices list */
+                if (local_dev == NULL)
+                {
+                    get_devices_list(con);
+                }
+                else
+                {
+                    strcpy(dev_buf, "/dev/mst/mt25204_pci_cr0");
+                    printf("-D- local_dev=%s dev_buf=%s\n", local_dev, dev_buf);
+                    writes_deb(con, "O 1");
+                    writes_deb(con, dev_buf);
+                }
+
+                break;
+
+            case 'R': /*  Read word */
+                if (!mf)
+                {
+                    writes_deb(con, "E Not opened");
+                }
+                else
+                {
+                    unsigned int offset;
+                    u_int32_t value;
+                    offset = strtoul(buf + 2, &end, 0);
+                    if (*end)
                     {
-                        writes_deb(con, "E Not opened");
+                        writes_deb(con, "E Invalid offset");
                     }
                     else
                     {
-                        unsigned int offset;
-                        u_int32_t value;
-                        offset = strtoul(buf + 2, &end, 0);
-                        if (*end)
+                        if (mread4(mf, offset, &value) < 4)
                         {
-                            writes_deb(con, "E Invalid offset");
+                            write_err(con);
                         }
                         else
                         {
-                            if (mread4(mf, offset, &value) < 4)
-                            {
-                                write_err(con);
-                            }
-                            else
-                            {
-                                char vbuf[16];
-                                sprintf(vbuf, "O 0x%08x", value);
-                                writes_deb(con, vbuf);
-                            }
+                            char vbuf[16];
+                            sprintf(vbuf, "O 0x%08x", value);
+                            writes_deb(con, vbuf);
                         }
                     }
-                    break;
+                }
+                break;
 
 #ifndef MST_UL
-                case 'S': /*  Scan I2C bus */
-                    if (!mf)
+            case 'S': /*  Scan I2C bus */
+                if (!mf)
+                {
+                    writes_deb(con, "E Not opened");
+                }
+                else
+                {
+                    u_int8_t slv_arr[SLV_ADDRS_NUM] = {0};
+                    if (mi2c_detect(mf, slv_arr) < 0)
                     {
-                        writes_deb(con, "E Not opened");
+                        write_err(con);
                     }
                     else
                     {
-                        u_int8_t slv_arr[SLV_ADDRS_NUM] = {0};
-                        if (mi2c_detect(mf, slv_arr) < 0)
-                        {
-                            write_err(con);
-                        }
-                        else
+                        int i;
+                        char *p, buf[1024];
+                        sprintf(buf, "O");
+                        p = buf + 1;
+                        for (i = 0; i < SLV_ADDRS_NUM; i++)
                         {
-                            int i;
-                            char *p, buf[1024];
-                            sprintf(buf, "O");
-                            p = buf + 1;
-                            for (i = 0; i < SLV_ADDRS_NUM; i++)
+                            if (slv_arr[i])
                             {
-                                if (slv_arr[i])
-                                {
-                                    sprintf(p, " 0x%02x", i);
-                                    p += strlen(p);
-                                }
+                                sprintf(p, " 0x%02x", i);
+                                p += strlen(p);
                             }
-                            writes_deb(con, buf);
                         }
+                        writes_deb(con, buf);
                     }
-                    break;
+                }
+                break;
+
+#endif
 
-                case 'B':
-                    if (!mf)
+#if !defined(MST_UL) || defined(SIMULATOR)
+            // The simulator's clients get block access over libmtcr_ul as well
+            case 'B':
+                if (!mf)
+                {
+                    writes_deb(con, "E Not opened");
+                }
+                else
+                {
+                    unsigned int offset;
+                    int size;
+                    u_int32_t buf_data[MAX_DWORDS];
+
+                    offset = strtoul(buf + 2, &end, 0);
+                    if (*end != ' ')
                     {
-                        writes_deb(con, "E Not opened");
+                        writes_deb(con, "E Invalid offset");
                     }
-                    else
-                    {
-                        unsigned int offset;
-                        int size;
-                        u_int32_t buf_data[MAX_DWORDS];
 
-                        offset = strtoul(buf + 2, &end, 0);
-                        if (*end != ' ')
-                        {
-                            writes_deb(con, "E Invalid offset");
-                        }
-
-                        size = strtoul(end, &end, 0);
-                        if (*end != '\0')
-                        {
-                            writes_deb(con, "E Invalid size");
-                        }
+                    size = strtoul(end, &end, 0);
+                    if (*end != '\0')
+                    {
+                        writes_deb(con, "E Invalid size");
+                    }
 
-                        if (mread4_block(mf, offset, buf_data, size) != size)
+                    if (mread4_block(mf, offset, buf_data, size) != size)
+                    {
+                        write_err(con);
+                    }
+                    else
+                    {
+                        int i;
+                        int div4 = size >> 2;
+                        int mod4 = size % 4;
+                        sprintf(buf, "O");
+                        char* last = buf + 1;
+                        for (i = 0; i < div4; i++)
                         {
-                            write_err(con);
+                            last += sprintf(last, " 0x%08x", buf_data[i]);
                         }
-                        else
+                        /* If the size is not divided by 4 need to read the remained bytes */
+                        if (mod4)
                         {
-                            int i;
-                            int div4 = size >> 2;
-                            int mod4 = size % 4;
-                            sprintf(buf, "O");
-                            char* last = buf + 1;
-                            for (i = 0; i < div4; i++)
-                            {
-                                last += sprintf(last, " 0x%08x", buf_data[i]);
-                            }
-                            /* If the size is not divided by 4 need to read the remained bytes */
-                            if (mod4)
+                            last += sprintf(last, " 0x");
+                            for (i = mod4 - 1; i >= 0; i--)
                             {
-                                last += sprintf(last, " 0x");
-                                for (i = mod4 - 1; i >= 0; i--)
-                                {
-                                    last += sprintf(last, "%02x", ((u_int8_t*)buf_data)[div4 * 4 + i]);
-                                }
+                                last += sprintf(last, "%02x", ((u_int8_t*)buf_data)[div4 * 4 + i]);
                             }
-                            writes_deb(con, buf);
                         }
+                        writes_deb(con, buf);
                     }
-                    break;
+                }
+                break;
 
-                case 'U':
-                    if (!mf)
+            case 'U':
+                if (!mf)
+                {
+                    writes_deb(con, "E Not opened");
+                }
+                else
+                {
+                    unsigned int offset;
+                    int size;
+                    u_int32_t buf_data[MAX_DWORDS];
+                    int i;
+
+                    offset = strtoul(buf + 2, &end, 0);
+                    if (*end != ' ')
                     {
-                        writes_deb(con, "E Not opened");
+                        writes_deb(con, "E Invalid offset");
                     }
-                    else
-                    {
-                        unsigned int offset;
-                        int size;
-                        u_int32_t buf_data[MAX_DWORDS];
-                        int i;
 
-                        offset = strtoul(buf + 2, &end, 0);
-                        if (*end != ' ')
-                        {
-                            writes_deb(con, "E Invalid offset");
-                        }
+                    size = strtoul(end, &end, 0);
+                    if (*end != ' ' || size > (MAX_DWORDS << 2))
+                    {
+                        writes_deb(con, "E Invalid size");
+                    }
 
-                        size = strtoul(end, &end, 0);
-                        if (*end != ' ' || size > (MAX_DWORDS << 2))
-                        {
-                            writes_deb(con, "E Invalid size");
-                        }
+                    for (i = 0; i < ((size + 3) >> 2); i++)
+                    {
+                        ((u_int32_t*)buf_data)[i] = strtoul(end, &end, 0);
 
-                        for (i = 0; i < ((size + 3) >> 2); i++)
+                        if (*end != (i < ((size + 3) >> 2) - 1 ? ' ' : '\0'))
                         {
-                            ((u_int32_t*)buf_data)[i] = strtoul(end, &end, 0);
-
-                            if (*end != (i < ((size + 3) >> 2) - 1 ? ' ' : '\0'))
-                            {
-                                writes_deb(con, "E Invalid data");
-                            }
+                            writes_deb(con, "E Invalid data");
                         }
+                    }
 
-                        if (mwrite4_block(mf, offset, buf_data, size) != size)
-                        {
-                            write_err(con);
-                        }
-                        else
-                        {
-                            write_ok(con);
-                        }
+                    if (mwrite4_block(mf, offset, buf_data, size) != size)
+                    {
+                        write_err(con);
                     }
-                    break;
+                    else
+                    {
+                        write_ok(con);
+                    }
+                }
+                break;
 
-                case 'r': /*  Read I2C */
-                    if (!mf)
+#endif
+
+#ifndef MST_UL
+            case 'r': /*  Read I2C */
+                if (!mf)
+                {
+                    writes_deb(con, "E Not opened");
+                }
+                else
+                {
+                    u_int8_t data[64];
+                    char err_msg[256];
+                    u_int8_t addr_width, slave_addr;
+                    unsigned int offset;
+                    int size;
+
+                    rc = parse_i2c_cmd(buf, &addr_width, &slave_addr, &size, &offset, data, err_msg);
+                    if (rc)
                     {
-                        writes_deb(con, "E Not opened");
+                        writes_deb(con, err_msg);
                     }
                     else
                     {
-                        u_int8_t data[64];
-                        char err_msg[256];
-                        u_int8_t addr_width, slave_addr;
-                        unsigned int offset;
-                        int size;
-
-                        rc = parse_i2c_cmd(buf, &addr_width, &slave_addr, &size, &offset, data, err_msg);
-                        if (rc)
+                        if (mread_i2cblock(mf, slave_addr, addr_width, offset, data, size) < size)
                         {
-                            writes_deb(con, err_msg);
+                            write_err(con);
                         }
                         else
                         {
-                            if (mread_i2cblock(mf, slave_addr, addr_width, offset, data, size) < size)
-                            {
-                                write_err(con);
-                            }
-                            else
-                            {
-                                char vbuff[256];
-                                sprintf(vbuff, "O 0x%x ", size);
-                                copy_buff_to_str(&vbuff[strlen(vbuff)], data, size);
-                                writes_deb(con, vbuff);
-                            }
+                            char vbuff[256];
+                            sprintf(vbuff, "O 0x%x ", size);
+                            copy_buff_to_str(&vbuff[strlen(vbuff)], data, size);
+                            writes_deb(con, vbuff);
                         }
                     }
-                    break;
+                }
+                break;
 
-                case 'w': /*  Read I2C */
-                    if (!mf)
+            case 'w': /*  Read I2C */
+                if (!mf)
+                {
+                    writes_deb(con, "E Not opened");
+                }
+                else
+                {
+                    u_int8_t data[64];
+                    char err_msg[256];
+                    u_int8_t addr_width, slave_addr;
+                    unsigned int offset;
+                    int size;
+
+                    rc = parse_i2c_cmd(buf, &addr_width, &slave_addr, &size, &offset, data, err_msg);
+                    if (rc)
                     {
-                        writes_deb(con, "E Not opened");
+                        writes_deb(con, err_msg);
                     }
                     else
                     {
-                        u_int8_t data[64];
-                        char err_msg[256];
-                        u_int8_t addr_width, slave_addr;
-                        unsigned int offset;
-                        int size;
-
-                        rc = parse_i2c_cmd(buf, &addr_width, &slave_addr, &size, &offset, data, err_msg);
-                        if (rc)
+                        if (mwrite_i2cblock(mf, slave_addr, addr_width, offset, data, size) < size)
                         {
-                            writes_deb(con, err_msg);
+                            write_err(con);
                         }
                         else
                         {
-                            if (mwrite_i2cblock(mf, slave_addr, addr_width, offset, data, size) < size)
-                            {
-                                write_err(con);
-                            }
-                            else
-                            {
-                                write_ok(con);
-                            }
+                            write_ok(con);
                         }
                     }
-                    break;
+                }
+                break;
 #endif
 
-                case 'P':
-                    if (!mf)
-                    {
-                        writes_deb(con, "E Not opened");
-                    }
-                    else
-                    {
-                        mpci_change(mf);
-                        write_ok(con);
-                    }
-                    break;
+            case 'P':
+                if (!mf)
+                {
+                    writes_deb(con, "E Not opened");
+                }
+                else
+                {
+                    mpci_change(mf);
+                    write_ok(con);
+                }
+                break;
 
-                case 'W': /*  Write word */
-                    if (!mf)
+            case 'W': /*  Write word */
+                if (!mf)
+                {
+                    writes_deb(con, "E Not opened");
+                }
+                else
+                {
+                    unsigned int offset;
+                    u_int32_t value;
+                    char* p = strchr(buf + 2, ' ');
+                    if (!p)
                     {
-                        writes_deb(con, "E Not opened");
+                        writes_deb(con, "E Invalid format (should be OFFS DATA)");
                     }
                     else
                     {
-                        unsigned int offset;
-                        u_int32_t value;
-                        char* p = strchr(buf + 2, ' ');
-                        if (!p)
+                        *p = '\0';
+                        p++;
+                        offset = strtoul(buf + 2, &end, 0);
+                        if (*end)
                         {
-                            writes_deb(con, "E Invalid format (should be OFFS DATA)");
+                            writes_deb(con, "E Invalid offset");
                         }
                         else
                         {
-                            *p = '\0';
-                            p++;
-                            offset = strtoul(buf + 2, &end, 0);
+                            value = strtoul(p, &end, 0);
                             if (*end)
                             {
-                                writes_deb(con, "E Invalid offset");
+                                writes_deb(con, "E Invalid data");
                             }
                             else
                             {
-                                value = strtoul(p, &end, 0);
-                                if (*end)
+                                if (mwrite4(mf, offset, value) < 4)
                                 {
-                                    writes_deb(con, "E Invalid data");
+                                    write_err(con);
                                 }
                                 else
                                 {
-                                    if (mwrite4(mf, offset, value) < 4)
-                                    {
-                                        write_err(con);
-                                    }
-                                    else
-                                    {
-                                        write_ok(con);
-                                    }
+                                    write_ok(con);
                                 }
                             }
                         }
                     }
-                    break;
+                }
+                break;
 
-                case 'A':
-                    if (!mf)
+            case 'A':
+                if (!mf)
+                {
+                    writes_deb(con, "E Not opened");
+                }
+                else
+                {
+                    char* p = buf + 2;
+                    int space;
+                    space = strtol(p, &end, 0);
+                    if (*end)
                     {
-                        writes_deb(con, "E Not opened");
+                        writes_deb(con, "E Invalid offset");
+                    }
+                    if (mset_addr_space(mf, space))
+                    {
+                        write_err(con);
                     }
                     else
                     {
-                        char* p = buf + 2;
-                        int space;
-                        space = strtol(p, &end, 0);
-                        if (*end)
-                        {
-                            writes_deb(con, "E Invalid offset");
-                        }
-                        if (mset_addr_space(mf, space))
-                        {
-                            write_err(con);
-                        }
-                        else
-                        {
-                            write_ok(con);
-                        }
+                        write_ok(con);
                     }
-                    break;
+                }
+                break;
+
+            case MTSRV_BIN_CMD: /*  Switch to the binary protocol */
+                if (!mf)
+                {
+                    writes_deb(con, "E Not opened");
+                }
+                else
+                {
+                    char vbuf[16];
+                    sprintf(vbuf, "O %d", MTSRV_BIN_VERSION);
+                    writes_deb(con, vbuf);
+                    serve_binary(con, mf);
+                    binary = 1;
+                }
+                break;
+
+            default:
+                writes(con, "E Invalid command", PT_TCP);
+                if (sdebug)
+                {
+                    printf("-> E Invalid command (len:%d cmd:\"%s\")\n", (int)strlen(buf), buf);
+                }
+                break;
+        }
+        if (binary)
+        {
+            break; /*  The binary protocol lasts until the connection closes */
+        }
+        WIN_CLOSE(mf, *buf);
+    }
 
-                default:
-                    writes(con, "E Invalid command", PT_TCP);
-                    if (sdebug)
+    close(con);
+    if (mf)
+    {
+        if (sdebug)
+        {
+            printf("-D- mf opened by the connection - closing\n");
+        }
+        mclose(mf);
+    }
+}
+
+#ifndef __WIN__
+/*
+ * Every connection is served by its own thread, each binary connection holding about 4MB of buffers.
+ * Connections beyond max_connections are refused so a flood of clients can't exhaust the host.
+ */
+static pthread_mutex_t connections_lock = PTHREAD_MUTEX_INITIALIZER;
+static int active_connections = 0;
+
+static int reserve_connection()
+{
+    int ok;
+
+    pthread_mutex_lock(&connections_lock);
+    ok = active_connections < max_connections;
+    if (ok)
+    {
+        active_connections++;
+    }
+    pthread_mutex_unlock(&connections_lock);
+    return ok;
+}
+
+static void release_connection()
+{
+    pthread_mutex_lock(&connections_lock);
+    active_connections--;
+    pthread_mutex_unlock(&connections_lock);
+}
+
+static void* connection_thread(void* arg)
+{
+    serve_connection((int)(intptr_t)arg);
+    release_connection();
+    return NULL;
+}
+#endif
+
+int main(int ac, char* av[])
+{
+    char* end;
+    int i, con;
+#ifndef __WIN__
+    int sock, rc;
+#endif
+
+    /* Command line parsing. */
+    for (i = 1; i < ac; i++)
+    {
+        switch (*av[i])
+        {
+            case '-':
+                ++av[i];
+                if (!strcmp(av[i], "p") || !strcmp(av[i], "port"))
+                {
+                    if (++i >= ac)
                     {
-                        printf("-> E Invalid command (len:%d cmd:\"%s\")\n", (int)strlen(buf), buf);
+                        printf("After switch \"%s\" port number is expected.\n", av[--i]);
+                        printf("Type \"%s -h\" for help.\n", av[0]);
+                        exit(1);
                     }
-                    break;
-            }
-            WIN_CLOSE(mf, *buf);
+                    port = (int)strtol(av[i], &end, 0);
+                    if (*end)
+                    {
+                        printf("Invalid port: \"%s\" -- ?\n", end);
+                        printf("Type \"%s -h\" for help.\n", av[0]);
+                        exit(1);
+                    }
+                    if (port < 1 || port > 65535)
+                    {
+                        printf("-E- Invalid port value: %d, port should be 16-bit number (Range: 1-65535)\n", port);
+                        exit(1);
+                    }
+                }
+                else if (!strcmp(av[i], "c") || !strcmp(av[i], "connections"))
+                {
+                    if (++i >= ac)
+                    {
+                        printf("After switch \"%s\" a number of connections is expected.\n", av[--i]);
+                        printf("Type \"%s -h\" for help.\n", av[0]);
+                        exit(1);
+                    }
+                    max_connections = (int)strtol(av[i], &end, 0);
+                    if (*end || max_connections < 1)
+                    {
+                        printf("-E- Invalid number of connections: \"%s\"\n", av[i]);
+                        exit(1);
+                    }
+                }
+                else if (!strcmp(av[i], "dev"))
+                {
+                    if (++i >= ac)
+                    {
+                        printf("After switch \"%s\" a device is expected.\n", av[--i]);
+                        printf("Type \"%s -h\" for help.\n", av[0]);
+                        exit(1);
+                    }
+                    local_dev = av[i];
+                }
+                else if (!strcmp(av[i], "d") || !strcmp(av[i], "debug"))
+                {
+                    sdebug = 1;
+                }
+                else if (!strcmp(av[i], "h") || !strcmp(av[i], "help"))
+                {
+                    usage(av[0]);
+                }
+                else if (!strcmp(av[i], "v") || !strcmp(av[i], "version"))
+                {
+                    print_version_string(MSTSERVER_NAME, MSTSERVER_VERSION);
+                    exit(0);
+                }
+                else if (!strcmp(av[i], "i") || !strcmp(av[i], "id"))
+                {
+                    check_id_arg(av, ac, &i);
+                }
+                else if (!strcmp(av[i], "f") || !strcmp(av[i], "file"))
+                {
+                    check_file_arg(av, ac, &i);
+                }
+                else
+                {
+                    printf("Invalid switch \"%s\".\n", av[i]);
+                    usage(av[0]);
+                    exit(1);
+                }
+                break;
+
+            case '?':
+                usage(av[0]);
+                break;
+
+            default:
+                printf("Invalid parameter \"%s\".\n", av[i]);
+                usage(av[0]);
+                exit(1);
         }
+    }
+
+#if defined(MST_UL) && !defined(SIMULATOR)
+    if (local_dev == NULL)
+    {
+        printf("When accessing via user level mst, -dev <bus:dev.fun> flag must be provided\n");
+        exit(1);
+    }
 
-        if (mf)
+#endif
+
+    prepare_the_map_file();
+    PREP_SIGNAL();
+    WIN_INIT();
+
+    /* Now open and start work */
+    logset(1);
+#ifdef __WIN__
+    for (;;)
+    {
+        con = open_serv_connection(port);
+        if (con < 0 && errno == WSAEADDRINUSE)
         {
-            if (sdebug)
-            {
-                printf("-D- mf opened from a prev connection - closing\n");
-            }
-            mclose(mf);
-            mf = 0;
+            printf("Open connection (server side): Address already in use\n");
+            exit(1);
+        }
+        CHK2(con, "Open connection (server side)");
+        serve_connection(con);
+    }
+#else
+    sock = open_serv_socket(port);
+    if (sock < 0 && errno == EADDRINUSE)
+    {
+        printf("Open connection (server side): Address already in use\n");
+        exit(1);
+    }
+    CHK2(sock, "Open connection (server side)");
+    for (;;)
+    {
+        pthread_t thread;
+
+        con = accept_serv_connection(sock);
+        CHK2(con, "Accept connection (server side)");
+        if (!reserve_connection())
+        {
+            printf("-W- Refusing connection, %d connections are already served\n", max_connections);
+            writes(con, "E Too many connections", PT_TCP);
+            close(con);
+            continue;
         }
+        rc = pthread_create(&thread, NULL, connection_thread, (void*)(intptr_t)con);
+        if (rc)
+        {
+            printf("-E- Failed to create a connection thread: %s\n", strerror(rc));
+            release_connection();
+            close(con);
+            continue;
+        }
+        pthread_detach(thread);
     }
+#endif
 
     unmap_and_close_file();
     return 0;
@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+/*
+ * Read throughput of a running mtserver (e.g. a SIMULATOR build) over the text
+ * protocol ('B' requests of MAX_DWORDS) and over the binary protocol with a
+ * given block size and number of requests in flight.
+ *
+ * Usage: mtserver_bench [-H host] [-p port] [-d dev] [-s bytes] [-b block] [-w depth]...
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <common/tools_bench.h>
+#include "tcp.h"
+#include "mtserver_proto.h"
+
+#define BENCH_TEXT_BLOCK 512
+#define BENCH_MAX_DEPTH 64
+#define BENCH_MAX_DEPTHS 16
+#define BENCH_REPLY_LEN 8192
+
+static int bench_recv(int con, void* buf, u_int32_t len)
+{
+    u_int8_t* p = (u_int8_t*)buf;
+    int rc;
+
+    while (len)
+    {
+        rc = recv(con, p, len, 0);
+        if (rc < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (rc <= 0)
+        {
+            return -1;
+        }
+        p += rc;
+        len -= rc;
+    }
+    return 0;
+}
+
+static int bench_open(const char* host, int port, const char* dev)
+{
+    char buf[BENCH_REPLY_LEN];
+    int con = open_cli_connection(host, port, PT_TCP);
+
+    if (con < 0)
+    {
+        fprintf(stderr, "-E- Failed to connect to %s:%d: %s\n", host, port, strerror(errno));
+        return -1;
+    }
+    snprintf(buf, sizeof(buf), "O 0x1 %s", dev);
+    if (writes(con, buf, PT_TCP) < 0 || reads(con, buf, sizeof(buf), PT_TCP) <= 0 || buf[0] != 'O')
+    {
+        fprintf(stderr, "-E- Failed to open %s: %s\n", dev, buf);
+        close(con);
+        return -1;
+    }
+    return con;
+}
+
+static double bench_text(int con, u_int32_t size)
+{
+    char buf[BENCH_REPLY_LEN];
+    u_int32_t addr;
+    u_int64_t start = bench_now_usecs();
+
+    for (addr = 0; addr < size; addr += BENCH_TEXT_BLOCK)
+    {
+        snprintf(buf, sizeof(buf), "B 0x%x 0x%x", addr, BENCH_TEXT_BLOCK);
+        if (writes(con, buf, PT_TCP) < 0 || reads(con, buf, sizeof(buf), PT_TCP) <= 0 || buf[0] != 'O')
+        {
+            fprintf(stderr, "-E- Text read at 0x%x failed: %s\n", addr, buf);
+            return -1;
+        }
+    }
+    return (double)size / (bench_now_usecs() - start);
+}
+
+static int bench_send_read(int con, u_int32_t id, u_int32_t addr, u_int32_t block)
+{
+    mtsrv_bin_hdr_t req;
+
+    req.req_id = htonl(id);
+    req.op = htons(MTSRV_BIN_READ);
+    req.status = 0;
+    req.addr = htonl(addr);
+    req.size = htonl(block);
+    return writen(con, &req, sizeof(req), PT_TCP);
+}
+
+static double bench_binary(int con, u_int32_t size, u_int32_t block, int depth, u_int32_t* data)
+{
+    mtsrv_bin_hdr_t rsp;
+    u_int32_t sent = 0, received = 0;
+    u_int32_t count = (size + block - 1) / block;
+    u_int64_t start = bench_now_usecs();
+
+    while (received < count)
+    {
+        while (sent < count && sent - received < (u_int32_t)depth)
+        {
+            if (bench_send_read(con, sent, sent * block, block) < 0)
+            {
+                return -1;
+            }
+            sent++;
+        }
+        if (bench_recv(con, &rsp, sizeof(rsp)) || ntohl(rsp.req_id) != received || rsp.status ||
+            ntohl(rsp.size) != block || bench_recv(con, data, block))
+        {
+            fprintf(stderr, "-E- Binary read %u failed (status %u)\n", received, ntohs(rsp.status));
+            return -1;
+        }
+        received++;
+    }
+    return (double)count * block / (bench_now_usecs() - start);
+}
+
+int main(int argc, char** argv)
+{
+    const char* host = "localhost";
+    const char* dev = "sim";
+    char buf[BENCH_REPLY_LEN];
+    int port = 23108;
+    u_int32_t size = 16 * 1024 * 1024;
+    u_int32_t block = 64 * 1024;
+    int depths[BENCH_MAX_DEPTHS];
+    int num_depths = 0;
+    u_int32_t* data;
+    double rate;
+    int con;
+    int opt;
+    int i;
+
+    while ((opt = getopt(argc, argv, "H:p:d:s:b:w:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'H':
+                host = optarg;
+                break;
+
+            case 'p':
+                port = atoi(optarg);
+                break;
+
+            case 'd':
+                dev = optarg;
+                break;
+
+            case 's':
+                size = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'b':
+                block = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'w':
+                if (num_depths < BENCH_MAX_DEPTHS)
+                {
+                    depths[num_depths++] = atoi(optarg);
+                }
+                break;
+
+            default:
+                return bench_usage(argv[0], "[-H host] [-p port] [-d dev] [-s bytes] [-b block] [-w depth]...");
+        }
+    }
+    if (!block || block % 4 || block > MTSRV_BIN_MAX_DATA || size < block)
+    {
+        fprintf(stderr, "-E- block must be a multiple of 4 up to %d bytes, and not above size\n", MTSRV_BIN_MAX_DATA);
+        return 1;
+    }
+    for (i = 0; i < num_depths; i++)
+    {
+        if (depths[i] < 1 || depths[i] > BENCH_MAX_DEPTH)
+        {
+            fprintf(stderr, "-E- depth must be between 1 and %d\n", BENCH_MAX_DEPTH);
+            return 1;
+        }
+    }
+    if (!num_depths)
+    {
+        depths[num_depths++] = 1;
+        depths[num_depths++] = 4;
+        depths[num_depths++] = 16;
+    }
+    data = (u_int32_t*)malloc(block);
+    if (!data)
+    {
+        return 1;
+    }
+
+    printf("size %u bytes from %s:%d\n", size, host, port);
+    con = bench_open(host, port, dev);
+    if (con < 0)
+    {
+        free(data);
+        return 1;
+    }
+    rate = bench_text(con, size);
+    close(con);
+    if (rate < 0)
+    {
+        free(data);
+        return 1;
+    }
+    printf("protocol  block    depth  bytes/usec\n");
+    printf("text      %-7d  %5d  %10.2f\n", BENCH_TEXT_BLOCK, 1, rate);
+
+    for (i = 0; i < num_depths; i++)
+    {
+        con = bench_open(host, port, dev);
+        if (con < 0)
+        {
+            break;
+        }
+        snprintf(buf, sizeof(buf), "%c", MTSRV_BIN_CMD);
+        if (writes(con, buf, PT_TCP) < 0 || reads(con, buf, sizeof(buf), PT_TCP) <= 0 || buf[0] != 'O')
+        {
+            fprintf(stderr, "-E- Server does not support the binary protocol: %s\n", buf);
+            close(con);
+            break;
+        }
+        rate = bench_binary(con, size, block, depths[i], data);
+        close(con);
+        if (rate < 0)
+        {
+            break;
+        }
+        printf("binary    %-7u  %5d  %10.2f\n", block, depths[i], rate);
+    }
+    free(data);
+    return i < num_depths;
+}
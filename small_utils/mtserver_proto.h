@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2013-2021 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * This software is available to you under a choice of one of two
+ * licenses.  You may choose to be licensed under the terms of the GNU
+ * General Public License (GPL) Version 2, available from the file
+ * COPYING in the main directory of this source tree, or the
+ * OpenIB.org BSD license below:
+ *
+ *     Redistribution and use in source and binary forms, with or
+ *     without modification, are permitted provided that the following
+ *     conditions are met:
+ *
+ *      - Redistributions of source code must retain the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer.
+ *
+ *      - Redistributions in binary form must reproduce the above
+ *        copyright notice, this list of conditions and the following
+ *        disclaimer in the documentation and/or other materials
+ *        provided with the distribution.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*
+ *
+ *  mtserver_proto.h - mtserver binary protocol definitions
+ *
+ *  A client enters the binary protocol from the text protocol (see mtserver.c) after opening the device:
+ *       Send buff:  X
+ *       Rcv  buff:  O   BinVersion
+ *                   O   1
+ *  From then on, until the connection is closed, every request and every response is a mtsrv_bin_hdr_t in
+ *  network byte order, followed by its payload:
+ *       MTSRV_BIN_READ:   request has no payload, response carries size bytes when status is 0
+ *       MTSRV_BIN_WRITE:  request carries size bytes, response has no payload
+ *  Data is sent as dwords in network byte order, sizes are a multiple of 4 up to MTSRV_BIN_MAX_DATA.
+ *  Requests are served in order and responses echo req_id, so a client may send several requests before
+ *  reading their responses.
+ */
+
+#ifndef _MTSERVER_PROTO_H
+#define _MTSERVER_PROTO_H
+
+#include <compatibility.h>
+
+#define MTSRV_BIN_CMD 'X'
+#define MTSRV_BIN_VERSION 1
+#define MTSRV_BIN_MAX_DATA (1 << 20)
+
+enum
+{
+    MTSRV_BIN_READ = 1,
+    MTSRV_BIN_WRITE = 2,
+};
+
+typedef struct mtsrv_bin_hdr
+{
+    u_int32_t req_id;
+    u_int16_t op;
+    u_int16_t status; /* 0 in requests, 0 or errno in responses */
+    u_int32_t addr;
+    u_int32_t size;
+} mtsrv_bin_hdr_t;
+
+#endif
@@ -521,3 +521,59 @@ INSIDE_MTCR int open_serv_connection(const int port)
         }
     }
 }
+
+/* ////////////////////////////////////////////////////////////////////// */
+/*
+** open_serv_socket - open listening server TCP socket and return its fd
+*/
+INSIDE_MTCR int open_serv_socket(const int port)
+{
+    struct sockaddr_in serv_addr;
+    int SockFD;
+
+    if ((SockFD = socket(AF_INET, SOCK_STREAM, 0)) < 0)
+    {
+        return -1;
+    }
+
+    memset((char*)&serv_addr, 0, sizeof(serv_addr));
+    serv_addr.sin_family = AF_INET;
+    serv_addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    serv_addr.sin_port = (short)(htons((short)port));
+    if (bind(SockFD, (const struct sockaddr*)&serv_addr, (socklen_t)sizeof(serv_addr)) < 0)
+    {
+#ifdef __WIN__
+        errno = WSAGetLastError();
+#endif
+        COMP_CLOSE(SockFD);
+        return -1;
+    }
+
+    if (listen(SockFD, SOMAXCONN) < 0)
+    {
+        COMP_CLOSE(SockFD);
+        return -1;
+    }
+    return SockFD;
+}
+
+/* ////////////////////////////////////////////////////////////////////// */
+/*
+** accept_serv_connection - wait for a connection on a socket from open_serv_socket and return its fd
+*/
+INSIDE_MTCR int accept_serv_connection(const int sock)
+{
+    struct sockaddr_in cli_inet_addr;
+    int clilen = sizeof(cli_inet_addr);
+    int newsockfd;
+
+    while ((newsockfd = accept(sock, (struct sockaddr*)&cli_inet_addr, (socklen_t*)&clilen)) < 0)
+    {
+        if (errno != EINTR)
+        {
+            return -1;
+        }
+    }
+    plog("Accepted connection from %s\n", inet_ntoa(cli_inet_addr.sin_addr));
+    return newsockfd;
+}
@@ -72,6 +72,16 @@ int open_cli_connection(const char* host, const int port, proto_type_t proto);
 */
 int open_serv_connection(const int port);
 
+/*
+** open_serv_socket - open listening server TCP socket and return its fd
+*/
+int open_serv_socket(const int port);
+
+/*
+** accept_serv_connection - wait for a connection on a socket from open_serv_socket and return its fd
+*/
+int accept_serv_connection(const int sock);
+
 /*
 ** readn - read n bytes from the socket "fd"
 **
@@ -294,6 +294,16 @@ int32_t xz_decompress_crc32(u_int8_t* inbuf, u_int32_t insz, u_int8_t* outbuf, u
 {
     return xpress(1, 0, inbuf, insz, outbuf, outsz, LZMA_CHECK_CRC32);
 }
+u_int32_t xz_compress_bound(u_int32_t insz)
+{
+    size_t bound = lzma_stream_buffer_bound(insz);
+    if (bound > 0xFFFFFFFF)
+    {
+        return 0;
+    }
+    return (u_int32_t)bound;
+}
+
 const char* xz_get_error(int32_t error)
 {
     if (error == XZ_ERR_MEM_EXCEEDED)
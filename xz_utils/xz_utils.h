@@ -55,6 +55,9 @@ extern "C"
     int32_t xz_decompress(u_int8_t* inbuf, u_int32_t insz, u_int8_t* outbuf, u_int32_t outsz);
     int32_t xz_compress_crc32(u_int32_t preset, u_int8_t* inbuf, u_int32_t insz, u_int8_t* outbuf, u_int32_t outsz);
     int32_t xz_decompress_crc32(u_int8_t* inbuf, u_int32_t insz, u_int8_t* outbuf, u_int32_t outsz);
+    // Upper bound of the compressed size of insz bytes, so that a single xz_compress* call can be given a large enough
+    // output buffer. Returns 0 if the bound does not fit in 32 bits.
+    u_int32_t xz_compress_bound(u_int32_t insz);
     const char* xz_get_error(int32_t error);
 #ifdef __cplusplus
 }